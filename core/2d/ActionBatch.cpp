@@ -0,0 +1,432 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/ActionBatch.h"
+#include "2d/ActionEase.h"
+#include "2d/ActionInterval.h"
+#include "2d/Node.h"
+#include "2d/TweenFunction.h"
+
+#include <algorithm>
+#include <typeinfo>
+
+NS_AX_BEGIN
+
+namespace
+{
+using EaseFunction = float (*)(float time, const ActionInterval* ease);
+
+struct EaseType
+{
+    const std::type_info& type;
+    EaseFunction function;
+};
+
+#define AX_EASE_TYPE(CLASSNAME, TWEEN_FUNC) \
+    {typeid(CLASSNAME), [](float time, const ActionInterval*) { return TWEEN_FUNC(time); }}
+#define AX_EASE_RATE_TYPE(CLASSNAME, TWEEN_FUNC)                                                  \
+    {typeid(CLASSNAME), [](float time, const ActionInterval* ease) {                              \
+         return TWEEN_FUNC(time, static_cast<const EaseRateAction*>(ease)->getRate());            \
+     }}
+#define AX_EASE_ELASTIC_TYPE(CLASSNAME, TWEEN_FUNC)                                               \
+    {typeid(CLASSNAME), [](float time, const ActionInterval* ease) {                              \
+         return TWEEN_FUNC(time, static_cast<const EaseElastic*>(ease)->getPeriod());             \
+     }}
+
+// the eases run in batch, with the tween functions of their update, indexed by ease id - 1
+const EaseType easeTypes[] = {
+    AX_EASE_TYPE(EaseExponentialIn, tweenfunc::expoEaseIn),
+    AX_EASE_TYPE(EaseExponentialOut, tweenfunc::expoEaseOut),
+    AX_EASE_TYPE(EaseExponentialInOut, tweenfunc::expoEaseInOut),
+    AX_EASE_TYPE(EaseSineIn, tweenfunc::sineEaseIn),
+    AX_EASE_TYPE(EaseSineOut, tweenfunc::sineEaseOut),
+    AX_EASE_TYPE(EaseSineInOut, tweenfunc::sineEaseInOut),
+    AX_EASE_TYPE(EaseBounceIn, tweenfunc::bounceEaseIn),
+    AX_EASE_TYPE(EaseBounceOut, tweenfunc::bounceEaseOut),
+    AX_EASE_TYPE(EaseBounceInOut, tweenfunc::bounceEaseInOut),
+    AX_EASE_TYPE(EaseBackIn, tweenfunc::backEaseIn),
+    AX_EASE_TYPE(EaseBackOut, tweenfunc::backEaseOut),
+    AX_EASE_TYPE(EaseBackInOut, tweenfunc::backEaseInOut),
+    AX_EASE_TYPE(EaseQuadraticActionIn, tweenfunc::quadraticIn),
+    AX_EASE_TYPE(EaseQuadraticActionOut, tweenfunc::quadraticOut),
+    AX_EASE_TYPE(EaseQuadraticActionInOut, tweenfunc::quadraticInOut),
+    AX_EASE_TYPE(EaseQuarticActionIn, tweenfunc::quartEaseIn),
+    AX_EASE_TYPE(EaseQuarticActionOut, tweenfunc::quartEaseOut),
+    AX_EASE_TYPE(EaseQuarticActionInOut, tweenfunc::quartEaseInOut),
+    AX_EASE_TYPE(EaseQuinticActionIn, tweenfunc::quintEaseIn),
+    AX_EASE_TYPE(EaseQuinticActionOut, tweenfunc::quintEaseOut),
+    AX_EASE_TYPE(EaseQuinticActionInOut, tweenfunc::quintEaseInOut),
+    AX_EASE_TYPE(EaseCircleActionIn, tweenfunc::circEaseIn),
+    AX_EASE_TYPE(EaseCircleActionOut, tweenfunc::circEaseOut),
+    AX_EASE_TYPE(EaseCircleActionInOut, tweenfunc::circEaseInOut),
+    AX_EASE_TYPE(EaseCubicActionIn, tweenfunc::cubicEaseIn),
+    AX_EASE_TYPE(EaseCubicActionOut, tweenfunc::cubicEaseOut),
+    AX_EASE_TYPE(EaseCubicActionInOut, tweenfunc::cubicEaseInOut),
+    AX_EASE_RATE_TYPE(EaseIn, tweenfunc::easeIn),
+    AX_EASE_RATE_TYPE(EaseOut, tweenfunc::easeOut),
+    AX_EASE_RATE_TYPE(EaseInOut, tweenfunc::easeInOut),
+    AX_EASE_ELASTIC_TYPE(EaseElasticIn, tweenfunc::elasticEaseIn),
+    AX_EASE_ELASTIC_TYPE(EaseElasticOut, tweenfunc::elasticEaseOut),
+    AX_EASE_ELASTIC_TYPE(EaseElasticInOut, tweenfunc::elasticEaseInOut),
+};
+
+#undef AX_EASE_TYPE
+#undef AX_EASE_RATE_TYPE
+#undef AX_EASE_ELASTIC_TYPE
+
+uint8_t findEase(const std::type_info& type)
+{
+    for (size_t i = 0; i < std::size(easeTypes); ++i)
+    {
+        if (easeTypes[i].type == type)
+            return static_cast<uint8_t>(i + 1);
+    }
+    return 0;
+}
+
+// only the exact classes, a subclass may override update
+template <typename... _Types>
+bool isOneOf(const std::type_info& type)
+{
+    return ((type == typeid(_Types)) || ...);
+}
+}  // namespace
+
+bool ActionBatch::isBatchable(const Action* action)
+{
+    const Action* tween = action;
+    if (findEase(typeid(*action)))
+    {
+        tween = const_cast<ActionEase*>(static_cast<const ActionEase*>(action))->getInnerAction();
+        if (!tween)
+            return false;
+    }
+
+    const auto& type = typeid(*tween);
+    return isOneOf<MoveBy, MoveTo, ScaleBy, ScaleTo, FadeTo, FadeIn, FadeOut>(type);
+}
+
+template <typename _Fn>
+void ActionBatch::Pool::forEachColumn(_Fn&& fn)
+{
+    fn(actions);
+    fn(tweens);
+    fn(targets);
+    fn(elapsed);
+    fn(duration);
+    fn(time);
+    fn(ease);
+    fn(state);
+    fn(startX);
+    fn(startY);
+    fn(startZ);
+    fn(deltaX);
+    fn(deltaY);
+    fn(deltaZ);
+    fn(valueX);
+    fn(valueY);
+    fn(valueZ);
+    fn(previousX);
+    fn(previousY);
+    fn(previousZ);
+}
+
+void ActionBatch::add(Action* action, bool paused)
+{
+    AXASSERT(isBatchable(action), "The action can't be batched");
+    AXASSERT(!contains(action), "The action is already batched");
+
+    auto interval = static_cast<ActionInterval*>(action);
+    auto tween    = interval;
+    auto ease     = findEase(typeid(*action));
+    if (ease)
+        tween = static_cast<ActionEase*>(action)->getInnerAction();
+
+    Kind kind;
+    Vec3 start, delta, previous;
+    const auto& type = typeid(*tween);
+    if (isOneOf<MoveBy, MoveTo>(type))
+    {
+        auto move = static_cast<MoveBy*>(tween);
+        kind      = MOVE;
+        start     = move->_startPosition;
+        delta     = move->_positionDelta;
+        previous  = move->_previousPosition;
+    }
+    else if (isOneOf<ScaleBy, ScaleTo>(type))
+    {
+        auto scale = static_cast<ScaleTo*>(tween);
+        kind       = SCALE;
+        start.set(scale->_startScaleX, scale->_startScaleY, scale->_startScaleZ);
+        delta.set(scale->_deltaX, scale->_deltaY, scale->_deltaZ);
+    }
+    else
+    {
+        auto fade = static_cast<FadeTo*>(tween);
+        kind      = FADE;
+        start.x   = fade->_fromOpacity;
+        delta.x   = static_cast<float>(fade->_toOpacity - fade->_fromOpacity);
+    }
+
+    auto& pool = _pools[kind];
+    _slots.emplace(action, Slot{kind, static_cast<uint32_t>(pool.size())});
+
+    pool.actions.emplace_back(interval);
+    pool.tweens.emplace_back(tween);
+    pool.targets.emplace_back(action->getTarget());
+    pool.elapsed.emplace_back(interval->_elapsed);
+    pool.duration.emplace_back(interval->getDuration());
+    pool.time.emplace_back(0.0f);
+    pool.ease.emplace_back(ease);
+    pool.state.emplace_back((interval->_firstTick ? FIRST_TICK : 0) | (paused ? PAUSED : 0));
+    pool.startX.emplace_back(start.x);
+    pool.startY.emplace_back(start.y);
+    pool.startZ.emplace_back(start.z);
+    pool.deltaX.emplace_back(delta.x);
+    pool.deltaY.emplace_back(delta.y);
+    pool.deltaZ.emplace_back(delta.z);
+    pool.valueX.emplace_back(start.x);
+    pool.valueY.emplace_back(start.y);
+    pool.valueZ.emplace_back(start.z);
+    pool.previousX.emplace_back(previous.x);
+    pool.previousY.emplace_back(previous.y);
+    pool.previousZ.emplace_back(previous.z);
+}
+
+void ActionBatch::remove(Action* action)
+{
+    auto it = _slots.find(action);
+    if (it == _slots.end())
+        return;
+
+    const auto slot = it->second;
+    _slots.erase(it);
+    writeBack(slot.kind, slot.index);
+
+    // a node setter may remove actions while they're stepped, erase them once the step is over
+    if (_stepping)
+    {
+        _pools[slot.kind].state[slot.index] |= REMOVED;
+        _hasRemoved = true;
+    }
+    else
+        erase(slot.kind, slot.index);
+}
+
+void ActionBatch::setPaused(const Action* action, bool paused)
+{
+    auto it = _slots.find(action);
+    if (it == _slots.end())
+        return;
+
+    auto& state = _pools[it->second.kind].state[it->second.index];
+    state       = paused ? (state | PAUSED) : (state & ~PAUSED);
+}
+
+void ActionBatch::writeBack(Kind kind, size_t index)
+{
+    auto& pool = _pools[kind];
+
+    auto action        = pool.actions[index];
+    action->_elapsed   = pool.elapsed[index];
+    action->_firstTick = (pool.state[index] & FIRST_TICK) != 0;
+
+    if (kind == MOVE)
+    {
+        auto move               = static_cast<MoveBy*>(pool.tweens[index]);
+        move->_startPosition    = Vec3(pool.startX[index], pool.startY[index], pool.startZ[index]);
+        move->_previousPosition = Vec3(pool.previousX[index], pool.previousY[index], pool.previousZ[index]);
+    }
+}
+
+void ActionBatch::erase(Kind kind, size_t index)
+{
+    auto& pool      = _pools[kind];
+    const auto last = pool.size() - 1;
+    if (index != last)
+    {
+        pool.forEachColumn([index, last](auto& column) { column[index] = column[last]; });
+        _slots.find(pool.actions[index]).value().index = static_cast<uint32_t>(index);
+    }
+    pool.forEachColumn([](auto& column) { column.pop_back(); });
+}
+
+void ActionBatch::step(float dt, std::vector<Action*>& done)
+{
+    // the actions added by the node setters are stepped from the next frame
+    size_t counts[KIND_COUNT];
+    for (int kind = 0; kind < KIND_COUNT; ++kind)
+    {
+        counts[kind] = _pools[kind].size();
+        stepTimelines(_pools[kind], counts[kind], dt);
+    }
+    computeValues(_pools[SCALE], counts[SCALE]);
+    computeValues(_pools[FADE], counts[FADE]);
+#if !AX_ENABLE_STACKABLE_ACTIONS
+    computeValues(_pools[MOVE], counts[MOVE]);
+#endif
+
+    _stepping = true;
+    writeMoves(_pools[MOVE], counts[MOVE], done);
+    writeScales(_pools[SCALE], counts[SCALE], done);
+    writeFades(_pools[FADE], counts[FADE], done);
+    _stepping = false;
+
+    if (_hasRemoved)
+    {
+        _hasRemoved = false;
+        for (int kind = 0; kind < KIND_COUNT; ++kind)
+        {
+            auto& pool = _pools[kind];
+            for (size_t i = pool.size(); i-- > 0;)
+            {
+                if (pool.state[i] & REMOVED)
+                    erase(static_cast<Kind>(kind), i);
+            }
+        }
+    }
+}
+
+void ActionBatch::stepTimelines(Pool& pool, size_t count, float dt)
+{
+    auto elapsed     = pool.elapsed.data();
+    auto duration    = pool.duration.data();
+    auto time        = pool.time.data();
+    const auto state = pool.state.data();
+
+    // like ActionInterval::step, the first tick starts the timeline
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float e = (state[i] & FIRST_TICK) ? 0.0f : elapsed[i] + dt;
+        elapsed[i]    = (state[i] & PAUSED) ? elapsed[i] : e;
+        // needed for rewind. elapsed could be negative
+        time[i] = std::max(0.0f, std::min(1.0f, elapsed[i] / duration[i]));
+    }
+
+    auto actions    = pool.actions.data();
+    const auto ease = pool.ease.data();
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (ease[i])
+            time[i] = easeTypes[ease[i] - 1].function(time[i], actions[i]);
+    }
+}
+
+void ActionBatch::computeValues(Pool& pool, size_t count)
+{
+    const auto time      = pool.time.data();
+    const float* start[] = {pool.startX.data(), pool.startY.data(), pool.startZ.data()};
+    const float* delta[] = {pool.deltaX.data(), pool.deltaY.data(), pool.deltaZ.data()};
+    float* value[]       = {pool.valueX.data(), pool.valueY.data(), pool.valueZ.data()};
+
+    for (int c = 0; c < 3; ++c)
+    {
+        for (size_t i = 0; i < count; ++i)
+            value[c][i] = start[c][i] + delta[c][i] * time[i];
+    }
+}
+
+void ActionBatch::finishStep(Pool& pool, size_t index, std::vector<Action*>& done)
+{
+    auto action        = pool.actions[index];
+    action->_elapsed   = pool.elapsed[index];
+    action->_firstTick = false;
+    pool.state[index] &= ~FIRST_TICK;
+
+    if (pool.elapsed[index] >= pool.duration[index])
+    {
+        action->_done = true;
+        action->retain();
+        done.emplace_back(action);
+    }
+}
+
+// The write passes call the node setters, which may add or remove actions: the pools are indexed, not iterated, and
+// an action removed by its own setter isn't touched again.
+
+void ActionBatch::writeMoves(Pool& pool, size_t count, std::vector<Action*>& done)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (pool.state[i] & (PAUSED | REMOVED))
+            continue;
+
+        auto target = pool.targets[i];
+#if AX_ENABLE_STACKABLE_ACTIONS
+        // like MoveBy::update, follow the moves made by the other actions since the last step
+        const Vec3 current = target->getPosition3D();
+        pool.startX[i] += current.x - pool.previousX[i];
+        pool.startY[i] += current.y - pool.previousY[i];
+        pool.startZ[i] += current.z - pool.previousZ[i];
+
+        const float t = pool.time[i];
+        const Vec3 position(pool.startX[i] + pool.deltaX[i] * t, pool.startY[i] + pool.deltaY[i] * t,
+                            pool.startZ[i] + pool.deltaZ[i] * t);
+        target->setPosition3D(position);
+        if (pool.state[i] & REMOVED)
+            continue;
+        pool.previousX[i] = position.x;
+        pool.previousY[i] = position.y;
+        pool.previousZ[i] = position.z;
+#else
+        target->setPosition3D(Vec3(pool.valueX[i], pool.valueY[i], pool.valueZ[i]));
+        if (pool.state[i] & REMOVED)
+            continue;
+#endif
+        finishStep(pool, i, done);
+    }
+}
+
+void ActionBatch::writeScales(Pool& pool, size_t count, std::vector<Action*>& done)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (pool.state[i] & (PAUSED | REMOVED))
+            continue;
+
+        auto target = pool.targets[i];
+        target->setScaleX(pool.valueX[i]);
+        target->setScaleY(pool.valueY[i]);
+        target->setScaleZ(pool.valueZ[i]);
+        if (pool.state[i] & REMOVED)
+            continue;
+        finishStep(pool, i, done);
+    }
+}
+
+void ActionBatch::writeFades(Pool& pool, size_t count, std::vector<Action*>& done)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (pool.state[i] & (PAUSED | REMOVED))
+            continue;
+
+        pool.targets[i]->setOpacity(static_cast<uint8_t>(pool.valueX[i]));
+        if (pool.state[i] & REMOVED)
+            continue;
+        finishStep(pool, i, done);
+    }
+}
+
+NS_AX_END
@@ -0,0 +1,138 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "base/Config.h"
+#include "platform/PlatformDefine.h"
+#include "tsl/robin_map.h"
+
+NS_AX_BEGIN
+
+class Action;
+class ActionInterval;
+class Node;
+
+/**
+ * Steps the simple tweens of the ActionManager in batch.
+ *
+ * MoveBy, MoveTo, ScaleBy, ScaleTo, FadeTo, FadeIn and FadeOut, run alone or in one of the tween function eases, are
+ * kept in typed pools of contiguous columns: their targets, timelines, easing and start and delta values. A frame
+ * advances all the timelines and computes the values in tight loops, then writes them to the nodes in one pass,
+ * instead of a virtual step and update per action.
+ *
+ * The actions stay in the ActionManager, which still answers for them by tag or by target, and they're kept in sync
+ * with the batch: their elapsed time is written back every frame and the rest of their state when they leave it.
+ * Subclasses and actions inside a Sequence, a Spawn or any other composition step the usual way.
+ */
+class AX_DLL ActionBatch
+{
+public:
+    /** Whether the action is one of the tweens stepped in batch. */
+    static bool isBatchable(const Action* action);
+
+    /** Adds a batchable action once it started with its target. */
+    void add(Action* action, bool paused);
+
+    /** Removes an action, writing its state back. */
+    void remove(Action* action);
+
+    bool contains(const Action* action) const { return _slots.find(action) != _slots.end(); }
+
+    void setPaused(const Action* action, bool paused);
+
+    /** Gets the number of batched actions. */
+    size_t size() const { return _slots.size(); }
+
+    /**
+     * Steps the actions which aren't paused and writes them to their targets.
+     * @param done Gets the actions which finished, retained, for the ActionManager to stop and remove them.
+     */
+    void step(float dt, std::vector<Action*>& done);
+
+private:
+    enum Kind : uint8_t
+    {
+        MOVE,
+        SCALE,
+        FADE,
+        KIND_COUNT
+    };
+
+    enum State : uint8_t
+    {
+        FIRST_TICK = 1,
+        PAUSED     = 1 << 1,
+        // removed while stepping, erased once the step is over
+        REMOVED    = 1 << 2,
+    };
+
+    struct Slot
+    {
+        Kind kind;
+        uint32_t index;
+    };
+
+    struct Pool
+    {
+        // the actions run by the ActionManager, the ease or the tween itself
+        std::vector<ActionInterval*> actions;
+        // the tweens the values come from
+        std::vector<ActionInterval*> tweens;
+        std::vector<Node*> targets;
+        std::vector<float> elapsed;
+        std::vector<float> duration;
+        std::vector<float> time;
+        std::vector<uint8_t> ease;
+        std::vector<uint8_t> state;
+        // start, delta and computed values, x only for opacities
+        std::vector<float> startX, startY, startZ;
+        std::vector<float> deltaX, deltaY, deltaZ;
+        std::vector<float> valueX, valueY, valueZ;
+        // the last position set by a stackable move
+        std::vector<float> previousX, previousY, previousZ;
+
+        template <typename _Fn>
+        void forEachColumn(_Fn&& fn);
+        size_t size() const { return actions.size(); }
+    };
+
+    void stepTimelines(Pool& pool, size_t count, float dt);
+    void computeValues(Pool& pool, size_t count);
+    void writeMoves(Pool& pool, size_t count, std::vector<Action*>& done);
+    void writeScales(Pool& pool, size_t count, std::vector<Action*>& done);
+    void writeFades(Pool& pool, size_t count, std::vector<Action*>& done);
+    void finishStep(Pool& pool, size_t index, std::vector<Action*>& done);
+    void writeBack(Kind kind, size_t index);
+    void erase(Kind kind, size_t index);
+
+    Pool _pools[KIND_COUNT];
+    tsl::robin_map<const Action*, Slot> _slots;
+    bool _stepping = false;
+    bool _hasRemoved = false;
+};
+
+NS_AX_END
@@ -117,6 +117,7 @@ protected:
     float _elapsed;
     bool _firstTick;
     bool _done;
+    friend class ActionBatch;
 
 protected:
     bool sendUpdateEventToScript(float dt, Action* actionObject);
@@ -580,6 +581,7 @@ protected:
     Vec3 _positionDelta;
     Vec3 _startPosition;
     Vec3 _previousPosition;
+    friend class ActionBatch;
 
 private:
     AX_DISALLOW_COPY_AND_ASSIGN(MoveBy);
@@ -1066,6 +1068,7 @@ protected:
     float _deltaX;
     float _deltaY;
     float _deltaZ;
+    friend class ActionBatch;
 
 private:
     AX_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
@@ -1203,6 +1206,7 @@ protected:
     uint8_t _fromOpacity;
     friend class FadeOut;
     friend class FadeIn;
+    friend class ActionBatch;
 
 private:
     AX_DISALLOW_COPY_AND_ASSIGN(FadeTo);
@@ -72,6 +72,12 @@ void ActionManager::removeActionAtIndex(ssize_t index,
         element.currentActionSalvaged = true;
     }
 
+    if (element.batchedActions && _batch.contains(action))
+    {
+        _batch.remove(action);
+        --element.batchedActions;
+    }
+
     element.actions.erase(index);
 
     // update actionIndex in case we are in tick. looping over the actions
@@ -86,12 +92,24 @@ void ActionManager::removeActionAtIndex(ssize_t index,
         {
             _currentTargetSalvaged = true;
         }
-        else
+        else if (!_batchStepping)
         {
             eraseTargetActionHandle(actionIt);
         }
     }
 }
+
+void ActionManager::removeBatchedActions(ActionHandle& element)
+{
+    for (ssize_t i = 0, size = element.actions.size(); element.batchedActions && i < size; ++i)
+    {
+        if (_batch.contains(element.actions.at(i)))
+        {
+            _batch.remove(element.actions.at(i));
+            --element.batchedActions;
+        }
+    }
+}
 // pause / resume
 
 void ActionManager::pauseTarget(Node* target)
@@ -100,6 +118,8 @@ void ActionManager::pauseTarget(Node* target)
     if (it != _targets.end())
     {
         it->second.paused = true;
+        for (ssize_t i = 0; it->second.batchedActions && i < it->second.actions.size(); ++i)
+            _batch.setPaused(it->second.actions.at(i), true);
     }
 }
 
@@ -109,6 +129,8 @@ void ActionManager::resumeTarget(Node* target)
     if (it != _targets.end())
     {
         it->second.paused = false;
+        for (ssize_t i = 0; it->second.batchedActions && i < it->second.actions.size(); ++i)
+            _batch.setPaused(it->second.actions.at(i), false);
     }
 }
 
@@ -119,6 +141,8 @@ Vector<Node*> ActionManager::pauseAllRunningActions()
     for (auto& [target, element] : _targets)
     {
         element.paused = true;
+        for (ssize_t i = 0; element.batchedActions && i < element.actions.size(); ++i)
+            _batch.setPaused(element.actions.at(i), true);
         idsWithActions.pushBack(const_cast<Node*>(target));
     }
 
@@ -157,6 +181,26 @@ void ActionManager::addAction(Action* action, Node* target, bool paused)
     actionHandle.actions.pushBack(action);
 
     action->startWithTarget(target);
+
+    if (_batchingEnabled && ActionBatch::isBatchable(action))
+    {
+        _batch.add(action, actionHandle.paused);
+        ++actionHandle.batchedActions;
+    }
+}
+
+void ActionManager::setBatchingEnabled(bool enabled)
+{
+    AXASSERT(!_batchStepping, "Can't toggle the batching while the batch steps");
+    if (_batchingEnabled == enabled)
+        return;
+
+    _batchingEnabled = enabled;
+    if (!enabled)
+    {
+        for (auto& [_, element] : _targets)
+            removeBatchedActions(element);
+    }
 }
 
 // remove
@@ -189,12 +233,17 @@ void ActionManager::removeTargetActionHandle(std::unordered_map<Node*, ActionHan
         element.currentActionSalvaged = true;
     }
 
+    removeBatchedActions(element);
     element.actions.clear();
     if (_currentTarget == &element)
     {
         _currentTargetSalvaged = true;
         ++actionIt;
     }
+    else if (_batchStepping)
+    {
+        ++actionIt;
+    }
     else
     {
         eraseTargetActionHandle(actionIt);
@@ -203,6 +252,7 @@ void ActionManager::removeTargetActionHandle(std::unordered_map<Node*, ActionHan
 
 void ActionManager::eraseTargetActionHandle(std::unordered_map<Node*, ActionHandle>::iterator& actionIt)
 {
+    removeBatchedActions(actionIt->second);
     actionIt->first->release();
     actionIt = _targets.erase(actionIt);
 }
@@ -396,7 +446,8 @@ void ActionManager::update(float dt)
         _currentTarget         = elt;
         _currentTargetSalvaged = false;
 
-        if (!_currentTarget->paused)
+        // the batched actions are stepped after all the targets
+        if (!_currentTarget->paused && _currentTarget->batchedActions < _currentTarget->actions.size())
         {
             // The 'actions' MutableArray may change while inside this loop.
             for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions.size();
@@ -404,7 +455,8 @@ void ActionManager::update(float dt)
             {
                 _currentTarget->currentAction =
                     static_cast<Action*>(_currentTarget->actions[_currentTarget->actionIndex]);
-                if (_currentTarget->currentAction == nullptr)
+                if (_currentTarget->currentAction == nullptr ||
+                    (_currentTarget->batchedActions && _batch.contains(_currentTarget->currentAction)))
                 {
                     continue;
                 }
@@ -438,9 +490,10 @@ void ActionManager::update(float dt)
         // so it is safe to ask this here (issue #490)
         // elt = (tHashElement*)(elt->hh.next);
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
+        // only delete currentTarget if no actions were scheduled during the cycle (issue #481), the handles are only
+        // left empty when salvaged, here or by the batch step
         // if some node reference 'target', it's reference count >= 2 (issues #14050)
-        if ((_currentTargetSalvaged && _currentTarget->actions.empty()) || actionIt->first->getReferenceCount() == 1)
+        if (_currentTarget->actions.empty() || actionIt->first->getReferenceCount() == 1)
         {
             eraseTargetActionHandle(actionIt);
         }
@@ -450,6 +503,28 @@ void ActionManager::update(float dt)
 
     // issue #635
     _currentTarget = nullptr;
+
+    if (_batch.size())
+        stepBatch(dt);
+}
+
+void ActionManager::stepBatch(float dt)
+{
+    _batchStepping = true;
+    _batch.step(dt, _batchDone);
+    _batchStepping = false;
+
+    for (auto action : _batchDone)
+    {
+        // unless a node setter removed it, or ran it again
+        if (_batch.contains(action) && action->isDone())
+        {
+            action->stop();
+            removeAction(action);
+        }
+        action->release();
+    }
+    _batchDone.clear();
 }
 
 NS_AX_END
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #define __ACTION_CCACTION_MANAGER_H__
 
 #include "2d/Action.h"
+#include "2d/ActionBatch.h"
 #include "base/Vector.h"
 #include "base/Object.h"
 
@@ -43,6 +44,8 @@ struct ActionHandle
     Action* currentAction;
     bool currentActionSalvaged;
     bool paused;
+    // the number of actions stepped by the ActionBatch
+    int batchedActions;
 };
 
 /**
@@ -198,6 +201,14 @@ public:
      */
     virtual void update(float dt);
 
+    /** Sets whether the simple tweens (moves, scales and fades, eased or not) are stepped in batch, enabled by default.
+     * Disable it to step every action the usual way, e.g. to compare their behavior.
+     *
+     * @see ActionBatch
+     */
+    void setBatchingEnabled(bool enabled);
+    bool isBatchingEnabled() const { return _batchingEnabled; }
+
 protected:
     // declared in ActionManager.m
     void removeTargetActionHandle(std::unordered_map<Node*, ActionHandle>::iterator& actionIt);
@@ -210,10 +221,20 @@ protected:
 
     void eraseTargetActionHandle(std::unordered_map<Node*, ActionHandle>::iterator& actionIt);
 
+    void removeBatchedActions(ActionHandle& element);
+
+    void stepBatch(float dt);
+
 protected:
     std::unordered_map<Node*, ActionHandle> _targets;
     ActionHandle* _currentTarget;
     bool _currentTargetSalvaged;
+
+    ActionBatch _batch;
+    std::vector<Action*> _batchDone;
+    bool _batchingEnabled = true;
+    // the target handles emptied while the batch steps are erased by the next update
+    bool _batchStepping = false;
 };
 
 // end of actions group
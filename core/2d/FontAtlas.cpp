@@ -32,16 +32,21 @@
 #endif
 #include <algorithm>
 #include "2d/FontFreeType.h"
+#include "2d/FontAtlasCache.h"
+#include "2d/FontPrebaked.h"
 #include "base/UTF8.h"
 #include "base/Director.h"
 #include "base/EventListenerCustom.h"
 #include "base/EventDispatcher.h"
 #include "base/EventType.h"
+#include "base/Scheduler.h"
+#include "base/JobSystem.h"
 
 #include "simdjson/simdjson.h"
 #include "zlib.h"
 #include "fmt/format.h"
 #include "base/ZipUtils.h"
+#include "renderer/UploadQueue.h"
 
 #include "base/PaddedString.h"
 
@@ -52,6 +57,24 @@ const int FontAtlas::CacheTextureHeight    = 512;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__cc_RESET_FONTATLAS";
 
+bool FontAtlas::_asyncGlyphRasterization = false;
+unsigned int FontAtlas::_glyphGenerations = 0;
+
+// fewer new glyphs than that are rendered on the calling thread, it isn't worth waking the workers
+static const size_t PARALLEL_GLYPHS_MIN = 8;
+// glyphs rendered by a worker per chunk
+static const size_t GLYPHS_PER_CHUNK = 4;
+
+// glyphs rasterized on the JobSystem for one prepareLetterDefinitions call
+struct GlyphRasterBatch
+{
+    FontAtlas* atlas = nullptr;  // main thread only, cleared once committed or discarded
+    std::vector<char32_t> charCodes;
+    std::vector<unsigned int> glyphIndices;
+    std::vector<FontFreeType::GlyphBitmap> glyphs;  // filled by the workers
+    JobHandle handle;
+};
+
 void FontAtlas::loadFontAtlas(std::string_view fontatlasFile, hlookup::string_map<FontAtlas*>& outAtlasMap)
 {
     using namespace simdjson;
@@ -132,6 +155,7 @@ FontAtlas::FontAtlas(Font* theFont, int atlasWidth, int atlasHeight, float scale
     : _font(theFont), _width(atlasWidth), _height(atlasHeight), _scaleFactor(scaleFactor)
 {
     _font->retain();
+    _glyphGeneration = ++_glyphGenerations;
 
     _fontFreeType = dynamic_cast<FontFreeType*>(_font);
     if (_fontFreeType)
@@ -183,7 +207,7 @@ void FontAtlas::reinit()
 FontAtlas::~FontAtlas()
 {
 #if AX_ENABLE_CACHE_TEXTURE_DATA
-    if (_fontFreeType && _rendererRecreatedListener)
+    if (_rendererRecreatedListener)
     {
         auto eventDispatcher = Director::getInstance()->getEventDispatcher();
         eventDispatcher->removeEventListener(_rendererRecreatedListener);
@@ -191,6 +215,12 @@ FontAtlas::~FontAtlas()
     }
 #endif
 
+    // the workers use the font, it has to outlive them
+    discardGlyphBatches();
+
+    if (_uploadQueued)
+        Director::getInstance()->getUploadQueue()->cancel(this);
+
     _font->release();
     releaseTextures();
 
@@ -206,15 +236,48 @@ void FontAtlas::initWithSettings(void* opaque /*simdjson::ondemand::document*/)
     simdjson::ondemand::document& settings = *(simdjson::ondemand::document*)opaque;
 
     // pages
+    yasio::byte_buffer lastPage;
     for (auto page : settings["pages"].get_array())
     {
-        auto comprData   = utils::base64Decode(page);
-        auto uncomprData = ZipUtils::decompressGZ(std::span{comprData}, _currentPageDataSize);
-        addNewPageWithData(uncomprData.data(), uncomprData.size());
+        auto comprData = utils::base64Decode(page);
+        lastPage       = ZipUtils::decompressGZ(std::span{comprData}, _currentPageDataSize);
+        addNewPageWithData(lastPage.data(), lastPage.size());
     }
+    // the letters rendered later go on the last page, the rects uploaded then are copied from its pixels
+    if (!lastPage.empty())
+        memcpy(_currentPageData, lastPage.data(), _currentPageDataSize);
 
-    _currentPageOrigX = static_cast<float>(settings["pageX"].get_double());
-    _currentPageOrigY = static_cast<float>(settings["pageY"].get_double());
+    auto skyline = settings["skyline"];
+    if (skyline.error() == simdjson::SUCCESS)
+    {
+        // x, y, width of every segment
+        std::vector<SkylinePacker::Segment> segments;
+        int values[3];
+        int index = 0;
+        for (auto value : skyline.get_array())
+        {
+            values[index++] = static_cast<int>(value.get_int64());
+            if (index == 3)
+            {
+                segments.emplace_back(SkylinePacker::Segment{values[0], values[1], values[2]});
+                index = 0;
+            }
+        }
+        _pagePacker.restore(_width, _height, std::move(segments));
+    }
+    else
+    {
+        // saved by a row packer, the current row is assumed as high as a line
+        auto pageX     = static_cast<int>(settings["pageX"].get_double());
+        auto pageY     = static_cast<int>(settings["pageY"].get_double());
+        auto rowHeight = static_cast<int>(_lineHeight) + _letterPadding + _letterEdgeExtend;
+        std::vector<SkylinePacker::Segment> segments;
+        if (pageX > 0)
+            segments.emplace_back(SkylinePacker::Segment{0, (std::min)(pageY + rowHeight, _height), pageX});
+        if (pageX < _width)
+            segments.emplace_back(SkylinePacker::Segment{pageX, pageY, _width - pageX});
+        _pagePacker.restore(_width, _height, std::move(segments));
+    }
 
     // letters
     FontLetterDefinition tempDef;
@@ -245,20 +308,92 @@ void FontAtlas::initWithSettings(void* opaque /*simdjson::ondemand::document*/)
     }
 }
 
+void FontAtlas::initWithPrebakedFont(FontPrebaked* font)
+{
+    _prebakedFont = font;
+
+    auto& header         = font->getHeader();
+    _lineHeight          = header.lineHeight;
+    _fontAscender        = header.fontAscender;
+    _letterPadding       = header.letterPadding;
+    _letterEdgeExtend    = header.letterEdgeExtend;
+    _strideShift         = header.bytesPerPixel == 2 ? 1 : 0;
+    _pixelFormat         = _strideShift ? backend::PixelFormat::RG8 : backend::PixelFormat::R8;
+    _currentPageDataSize = _width * _height << _strideShift;
+
+    loadPrebakedPages();
+
+#if AX_ENABLE_CACHE_TEXTURE_DATA
+    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+
+    _rendererRecreatedListener = EventListenerCustom::create(
+        EVENT_RENDERER_RECREATED, AX_CALLBACK_1(FontAtlas::listenRendererRecreated, this));
+    eventDispatcher->addEventListenerWithFixedPriority(_rendererRecreatedListener, 1);
+#endif
+}
+
+void FontAtlas::loadPrebakedPages()
+{
+    if (!_currentPageData)
+        _currentPageData = new uint8_t[_currentPageDataSize];
+    _currentPage = -1;
+
+    // uploaded from the mapped file, the pages are read once
+    for (int page = 0; page < _prebakedFont->getPageCount(); ++page)
+        addNewPageWithData(_prebakedFont->getPageData(page), _currentPageDataSize);
+
+    auto skyline = _prebakedFont->getSkyline();
+    _pagePacker.restore(_width, _height, std::vector<SkylinePacker::Segment>(skyline.begin(), skyline.end()));
+
+    FontLetterDefinition tempDef;
+    tempDef.rotated = false;
+    for (auto&& letter : _prebakedFont->getLetters())
+    {
+        tempDef.U               = letter.U / _scaleFactor;
+        tempDef.V               = letter.V / _scaleFactor;
+        tempDef.width           = letter.width / _scaleFactor;
+        tempDef.height          = letter.height / _scaleFactor;
+        tempDef.offsetX         = letter.offsetX;
+        tempDef.offsetY         = letter.offsetY;
+        tempDef.textureID       = letter.page;
+        tempDef.xAdvance        = letter.xAdvance;
+        tempDef.validDefinition = letter.valid != 0;
+        _letterDefinitions.emplace(static_cast<char32_t>(letter.charCode), tempDef);
+    }
+
+    // the letters rendered later go on the last page, which is uploaded from the page data
+    if (_fontFreeType)
+        memcpy(_currentPageData, _prebakedFont->getPageData(_currentPage), _currentPageDataSize);
+}
+
+bool FontAtlas::openPrebakedSourceFont()
+{
+    _fontFreeType = _prebakedFont->getSourceFont();
+    if (!_fontFreeType)
+        return false;
+
+    if (_currentPage == _prebakedFont->getPageCount() - 1)
+        memcpy(_currentPageData, _prebakedFont->getPageData(_currentPage), _currentPageDataSize);
+    return true;
+}
+
 void FontAtlas::reset()
 {
+    discardGlyphBatches();
     releaseTextures();
 
-    _currLineHeight   = 0;
-    _currentPageOrigX = 0;
-    _currentPageOrigY = 0;
     _letterDefinitions.clear();
+    _glyphGeneration = ++_glyphGenerations;
 
-    reinit();
+    if (_prebakedFont)
+        loadPrebakedPages();
+    else
+        reinit();
 }
 
 void FontAtlas::releaseTextures()
 {
+    _dirtyStartX = _dirtyStartY = _dirtyEndX = _dirtyEndY = 0;
     for (auto&& item : _atlasTextures)
     {
         item.second->release();
@@ -268,7 +403,7 @@ void FontAtlas::releaseTextures()
 
 void FontAtlas::purgeTexturesAtlas()
 {
-    if (_fontFreeType)
+    if (_fontFreeType || _prebakedFont)
     {
         reset();
         auto eventDispatcher = Director::getInstance()->getEventDispatcher();
@@ -277,6 +412,49 @@ void FontAtlas::purgeTexturesAtlas()
     }
 }
 
+int FontAtlas::compactTextures()
+{
+    if (!_fontFreeType || _atlasTextures.empty())
+        return 0;
+
+    waitForPendingGlyphs();
+
+    // the labels release the atlas while they are purged and get it again when they are reset
+    retain();
+
+    _compacting = true;
+    _retainedLetters.clear();
+    std::u32string glyphCollection;
+    if (StringUtils::UTF8ToUTF32(_fontFreeType->getGlyphCollection(), glyphCollection))
+        retainLetters(glyphCollection);
+
+    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+    eventDispatcher->dispatchCustomEvent(CMD_PURGE_FONTATLAS, this);
+
+    const auto pageCount = static_cast<int>(_atlasTextures.size());
+    reset();
+
+    std::u32string letters(_retainedLetters.begin(), _retainedLetters.end());
+    prepareLetterDefinitions(letters);
+    _compacting = false;
+    _retainedLetters.clear();
+
+    const auto releasedPages = pageCount - static_cast<int>(_atlasTextures.size());
+
+    eventDispatcher->dispatchCustomEvent(CMD_RESET_FONTATLAS, this);
+
+    // may be the last reference when no label got the atlas again
+    FontAtlasCache::releaseFontAtlas(this);
+
+    return releasedPages;
+}
+
+void FontAtlas::retainLetters(const std::u32string& text)
+{
+    if (_compacting)
+        _retainedLetters.insert(text.begin(), text.end());
+}
+
 void FontAtlas::listenRendererRecreated(EventCustom* /*event*/)
 {
     purgeTexturesAtlas();
@@ -285,6 +463,7 @@ void FontAtlas::listenRendererRecreated(EventCustom* /*event*/)
 void FontAtlas::addLetterDefinition(char32_t utf32Char, const FontLetterDefinition& letterDefinition)
 {
     _letterDefinitions[utf32Char] = letterDefinition;
+    _glyphGeneration              = ++_glyphGenerations;
 }
 
 void FontAtlas::scaleFontLetterDefinition(float scaleFactor)
@@ -331,7 +510,7 @@ void FontAtlas::findNewCharacters(const std::u32string& u32Text, std::unordered_
 
 bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
 {
-    if (_fontFreeType == nullptr)
+    if (_fontFreeType == nullptr && _prebakedFont == nullptr)
     {
         return false;
     }
@@ -346,17 +525,40 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
         return false;
     }
 
-    int adjustForDistanceMap = _letterPadding / 2;
-    int adjustForExtend      = _letterEdgeExtend / 2;
-    int bitmapWidth          = 0;
-    int bitmapHeight         = 0;
-    int glyphHeight;
-    Rect tempRect;
-    FontLetterDefinition tempDef;
+    // a prebaked atlas opens its source font for the first letter it misses
+    if (_fontFreeType == nullptr && !openPrebakedSourceFont())
+    {
+        return false;
+    }
 
-    auto pixelFormat = _pixelFormat;
+    // the glyphs of the font's own face can be rendered by the workers, the missing ones go through the fallback
+    // fonts on this thread
+    std::vector<char32_t> concurrentCharCodes;
+    std::vector<unsigned int> concurrentGlyphIndices;
+    auto jobSystem = Director::getInstance()->getJobSystem();
+    if (_fontFreeType->isConcurrentRasterizationSupported() && jobSystem->getWorkerCount() > 0 &&
+        (isAsyncRasterization() || charCodeSet.size() >= PARALLEL_GLYPHS_MIN))
+    {
+        for (auto it = charCodeSet.begin(); it != charCodeSet.end();)
+        {
+            auto glyphIndex = _missingGlyphFallbackFonts.find(*it) == _missingGlyphFallbackFonts.end()
+                                  ? _fontFreeType->getCharIndex(*it)
+                                  : 0;
+            if (glyphIndex != 0)
+            {
+                concurrentCharCodes.emplace_back(*it);
+                concurrentGlyphIndices.emplace_back(glyphIndex);
+                it = charCodeSet.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
 
-    int startY = (int)_currentPageOrigY;
+    int bitmapWidth  = 0;
+    int bitmapHeight = 0;
+    int xAdvance     = 0;
+    Rect tempRect;
 
     for (auto&& charCode : charCodeSet)
     {
@@ -366,7 +568,7 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
         if (missingIt == _missingGlyphFallbackFonts.end())
         {
             FontFaceInfo* fallbackFaceInfo = nullptr;
-            bitmap = charRenderer->getGlyphBitmap(charCode, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance,
+            bitmap = charRenderer->getGlyphBitmap(charCode, bitmapWidth, bitmapHeight, tempRect, xAdvance,
                                                   &fallbackFaceInfo);
             if (!bitmap && fallbackFaceInfo)
             {
@@ -386,7 +588,7 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
                 {
                     unsigned int glyphIndex = fallbackFaceInfo->currentGlyphIndex;
                     bitmap =
-                        charRenderer->getGlyphBitmapByIndex(glyphIndex, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
+                        charRenderer->getGlyphBitmapByIndex(glyphIndex, bitmapWidth, bitmapHeight, tempRect, xAdvance);
                     _missingGlyphFallbackFonts.emplace(charCode, std::make_pair(charRenderer, glyphIndex));
                 }
             }
@@ -395,88 +597,274 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
         {  // found fallback font for missing charas, getGlyphBitmap without fallback
             charRenderer = missingIt->second.first;
             unsigned int glyphIndex = missingIt->second.second;
-            bitmap = charRenderer->getGlyphBitmapByIndex(glyphIndex, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
+            bitmap = charRenderer->getGlyphBitmapByIndex(glyphIndex, bitmapWidth, bitmapHeight, tempRect, xAdvance);
         }
-        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
-        {
-            tempDef.validDefinition = true;
-            tempDef.width           = tempRect.size.width + _letterPadding + _letterEdgeExtend;
-            tempDef.height          = tempRect.size.height + _letterPadding + _letterEdgeExtend;
-            tempDef.offsetX         = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
-            tempDef.offsetY         = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
 
-            if (_currentPageOrigX + tempDef.width > _width)
-            {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight   = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= _height)
-                {
-                    updateTextureContent(pixelFormat, startY);
+        insertLetter(charCode, charRenderer, bitmap, bitmapWidth, bitmapHeight, tempRect, xAdvance);
+        // the blend image of outlined glyphs is ours, the plain bitmap belongs to the face's glyph slot
+        if (charRenderer && charRenderer->getOutlineSize() > 0)
+            delete[] bitmap;
+    }
 
-                    startY = 0;
+    if (!concurrentCharCodes.empty())
+        rasterizeLetters(concurrentCharCodes, concurrentGlyphIndices);
 
-                    addNewPage();
-                }
-            }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
+    updateTextureContent();
+
+    return true;
+}
+
+void FontAtlas::rasterizeLetters(const std::vector<char32_t>& charCodes, const std::vector<unsigned int>& glyphIndices)
+{
+    auto jobSystem    = Director::getInstance()->getJobSystem();
+    auto fontFreeType = _fontFreeType;
+
+    if (!isAsyncRasterization())
+    {
+        // the workers and this thread render into their own bitmaps, packing them stays on this thread
+        std::vector<FontFreeType::GlyphBitmap> glyphs(charCodes.size());
+        jobSystem->parallel_for(0, charCodes.size(), GLYPHS_PER_CHUNK, [&](size_t first, size_t last) {
+            for (auto i = first; i < last; ++i)
+                fontFreeType->rasterizeGlyph(glyphIndices[i], glyphs[i]);
+        });
+        insertRasterizedLetters(charCodes, glyphIndices, glyphs);
+        return;
+    }
+
+    // placeholders with the final advance and no quad until the glyphs arrive
+    FontLetterDefinition tempDef{};
+    for (size_t i = 0; i < charCodes.size(); ++i)
+    {
+        tempDef.xAdvance                 = _fontFreeType->getGlyphAdvance(glyphIndices[i]);
+        tempDef.validDefinition          = !!tempDef.xAdvance;
+        _letterDefinitions[charCodes[i]] = tempDef;
+    }
+
+    auto batch          = std::make_shared<GlyphRasterBatch>();
+    batch->atlas        = this;
+    batch->charCodes    = charCodes;
+    batch->glyphIndices = glyphIndices;
+    batch->glyphs.resize(charCodes.size());
+
+    auto scheduler = Director::getInstance()->getScheduler();
+    batch->handle  = jobSystem->schedule(
+        [batch, fontFreeType, jobSystem, scheduler] {
+            jobSystem->parallel_for(0, batch->glyphIndices.size(), GLYPHS_PER_CHUNK, [&](size_t first, size_t last) {
+                for (auto i = first; i < last; ++i)
+                    fontFreeType->rasterizeGlyph(batch->glyphIndices[i], batch->glyphs[i]);
+            });
+            scheduler->runOnAxmolThread([batch] {
+                if (batch->atlas)
+                    batch->atlas->commitGlyphBatch(*batch);
+            });
+        },
+        JobSystem::Priority::HIGH);
+    _glyphBatches.emplace_back(std::move(batch));
+}
+
+void FontAtlas::commitGlyphBatch(GlyphRasterBatch& batch)
+{
+    batch.atlas = nullptr;
+    auto it     = std::find_if(_glyphBatches.begin(), _glyphBatches.end(),
+                               [&batch](const std::shared_ptr<GlyphRasterBatch>& item) { return item.get() == &batch; });
+    AXASSERT(it != _glyphBatches.end(), "The glyph batch was already committed");
+    // keeps the batch alive while its glyphs are packed
+    auto holder = std::move(*it);
+    _glyphBatches.erase(it);
+
+    insertRasterizedLetters(batch.charCodes, batch.glyphIndices, batch.glyphs);
+    updateTextureContent();
+    _glyphGeneration = ++_glyphGenerations;
+}
+
+void FontAtlas::waitForPendingGlyphs()
+{
+    while (!_glyphBatches.empty())
+    {
+        auto batch = _glyphBatches.front();
+        batch->handle.wait();
+        commitGlyphBatch(*batch);
+    }
+}
+
+void FontAtlas::discardGlyphBatches()
+{
+    for (auto&& batch : _glyphBatches)
+    {
+        batch->atlas = nullptr;
+        batch->handle.wait();
+    }
+    _glyphBatches.clear();
+}
+
+void FontAtlas::insertRasterizedLetters(const std::vector<char32_t>& charCodes,
+                                        const std::vector<unsigned int>& glyphIndices,
+                                        std::vector<FontFreeType::GlyphBitmap>& glyphs)
+{
+    // a worker which couldn't open a face of its own left the glyph unrendered
+    for (size_t i = 0; i < glyphs.size(); ++i)
+    {
+        if (!glyphs[i].rendered)
+            _fontFreeType->renderGlyphBitmap(glyphIndices[i], glyphs[i]);
+    }
+
+    // tallest first, the skyline stays flatter and wastes less room under it
+    std::vector<size_t> order(charCodes.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&glyphs](size_t lhs, size_t rhs) { return glyphs[lhs].height > glyphs[rhs].height; });
+
+    for (auto i : order)
+    {
+        auto& glyph = glyphs[i];
+        insertLetter(charCodes[i], _fontFreeType, glyph.pixels.empty() ? nullptr : glyph.pixels.data(), glyph.width,
+                     glyph.height, glyph.rect, glyph.xAdvance);
+    }
+}
+
+bool FontAtlas::insertLetter(char32_t charCode,
+                             FontFreeType* renderer,
+                             const uint8_t* bitmap,
+                             int bitmapWidth,
+                             int bitmapHeight,
+                             const Rect& rect,
+                             int xAdvance)
+{
+    int adjustForDistanceMap = _letterPadding / 2;
+    int adjustForExtend      = _letterEdgeExtend / 2;
+    FontLetterDefinition tempDef;
+    tempDef.xAdvance = xAdvance;
+    tempDef.rotated  = false;
+
+    const bool drawable = bitmap && bitmapWidth > 0 && bitmapHeight > 0;
+    if (drawable)
+    {
+        tempDef.validDefinition = true;
+        tempDef.width           = rect.size.width + _letterPadding + _letterEdgeExtend;
+        tempDef.height          = rect.size.height + _letterPadding + _letterEdgeExtend;
+        tempDef.offsetX         = rect.origin.x - adjustForDistanceMap - adjustForExtend;
+        tempDef.offsetY         = _fontAscender + rect.origin.y - adjustForDistanceMap - adjustForExtend;
+
+        // one pixel of gutter keeps linear filtering from bleeding into the neighbours
+        int glyphWidth  = static_cast<int>(std::ceil(tempDef.width));
+        int glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
+        int x = 0, y = 0;
+        if (!_pagePacker.pack(glyphWidth + 1, glyphHeight + 1, x, y))
+        {
+            addNewPage();
+            if (!_pagePacker.pack(glyphWidth + 1, glyphHeight + 1, x, y))
             {
-                _currLineHeight = glyphHeight;
+                AXLOGW("The glyph of char {:#x} is bigger than the atlas page", static_cast<uint32_t>(charCode));
+                _letterDefinitions[charCode] = FontLetterDefinition{0, 0, 0, 0, 0, 0, 0, !!xAdvance, xAdvance, false};
+                return false;
             }
-            charRenderer->renderCharAt(_currentPageData, (int)_currentPageOrigX + adjustForExtend,
-                                       (int)_currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight,
-                                        _width, _height);
-
-            tempDef.U         = _currentPageOrigX;
-            tempDef.V         = _currentPageOrigY;
-            tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
-            // take from pixels to points
-            tempDef.width   = tempDef.width / _scaleFactor;
-            tempDef.height  = tempDef.height / _scaleFactor;
-            tempDef.U       = tempDef.U / _scaleFactor;
-            tempDef.V       = tempDef.V / _scaleFactor;
-            tempDef.rotated = false;
-        }
-        else
-        {
-            if (bitmap)
-                delete[] bitmap;
-
-            tempDef.validDefinition = !!tempDef.xAdvance;
-            tempDef.width           = 0;
-            tempDef.height          = 0;
-            tempDef.U               = 0;
-            tempDef.V               = 0;
-            tempDef.offsetX         = 0;
-            tempDef.offsetY         = 0;
-            tempDef.textureID       = 0;
-            tempDef.rotated         = false;
-            _currentPageOrigX += 1;
         }
-
-        _letterDefinitions[charCode] = tempDef;
+        renderer->copyGlyphBitmap(_currentPageData, x + adjustForExtend, y + adjustForExtend, bitmap, bitmapWidth,
+                                  bitmapHeight, _width);
+        markDirty(x, y, glyphWidth, glyphHeight);
+
+        tempDef.U         = static_cast<float>(x);
+        tempDef.V         = static_cast<float>(y);
+        tempDef.textureID = _currentPage;
+        // take from pixels to points
+        tempDef.width  = tempDef.width / _scaleFactor;
+        tempDef.height = tempDef.height / _scaleFactor;
+        tempDef.U      = tempDef.U / _scaleFactor;
+        tempDef.V      = tempDef.V / _scaleFactor;
+    }
+    else
+    {
+        tempDef.validDefinition = !!tempDef.xAdvance;
+        tempDef.width           = 0;
+        tempDef.height          = 0;
+        tempDef.U               = 0;
+        tempDef.V               = 0;
+        tempDef.offsetX         = 0;
+        tempDef.offsetY         = 0;
+        tempDef.textureID       = 0;
     }
 
-    updateTextureContent(pixelFormat, startY);
+    _letterDefinitions[charCode] = tempDef;
+    return drawable;
+}
 
-    return true;
+void FontAtlas::markDirty(int x, int y, int width, int height)
+{
+    // 4 pixels aligned columns keep the rows of the uploaded rect within the default unpack alignment
+    int startX = (std::max)(x, 0) & ~3;
+    int endX   = (std::min)((x + width + 3) & ~3, _width);
+    int startY = (std::max)(y, 0);
+    int endY   = (std::min)(y + height, _height);
+    if (startX >= endX || startY >= endY)
+        return;
+
+    if (_dirtyStartY < _dirtyEndY)
+    {
+        _dirtyStartX = (std::min)(_dirtyStartX, startX);
+        _dirtyStartY = (std::min)(_dirtyStartY, startY);
+        _dirtyEndX   = (std::max)(_dirtyEndX, endX);
+        _dirtyEndY   = (std::max)(_dirtyEndY, endY);
+    }
+    else
+    {
+        _dirtyStartX = startX;
+        _dirtyStartY = startY;
+        _dirtyEndX   = endX;
+        _dirtyEndY   = endY;
+    }
 }
 
-void FontAtlas::updateTextureContent(backend::PixelFormat format, int startY)
+void FontAtlas::updateTextureContent()
 {
-    auto data = _currentPageData + (_width * (int)startY << _strideShift);
-    _atlasTextures[_currentPage]->updateWithSubData(data, 0, startY, _width,
-                                                    (std::min)((int)_currentPageOrigY - startY + _currLineHeight, _height));
+    // the labels laid out in a frame are uploaded at once, before the frame is drawn
+    if (!_uploadQueued && _dirtyStartY < _dirtyEndY)
+    {
+        _uploadQueued = true;
+        Director::getInstance()->getUploadQueue()->enqueueForFrame(
+            this, static_cast<size_t>((_dirtyEndY - _dirtyStartY) * (_dirtyEndX - _dirtyStartX)) << _strideShift,
+            [this] {
+                _uploadQueued = false;
+                flushTextureContent();
+            });
+    }
+}
+
+void FontAtlas::flushTextureContent()
+{
+    if (_dirtyStartY >= _dirtyEndY)
+        return;
+
+    auto it = _atlasTextures.find(_currentPage);
+    if (it != _atlasTextures.end())
+    {
+        const int width  = _dirtyEndX - _dirtyStartX;
+        const int height = _dirtyEndY - _dirtyStartY;
+        auto data        = _currentPageData + (_width * _dirtyStartY << _strideShift);
+        if (width != _width)
+        {
+            // the rows of the page are wider than the rect, pack the rect
+            const size_t rowSize = static_cast<size_t>(width) << _strideShift;
+            _uploadScratch.resize(rowSize * height);
+            for (int y = 0; y < height; ++y)
+                memcpy(_uploadScratch.data() + rowSize * y,
+                       _currentPageData + ((_width * (_dirtyStartY + y) + _dirtyStartX) << _strideShift), rowSize);
+            data = _uploadScratch.data();
+        }
+        it->second->updateWithSubData(data, _dirtyStartX, _dirtyStartY, width, height);
+    }
+    _dirtyStartX = _dirtyStartY = _dirtyEndX = _dirtyEndY = 0;
 }
 
 void FontAtlas::addNewPage()
 {
+    // the page data is reused, the previous page gets its last rows now
+    flushTextureContent();
+
     memset(_currentPageData, 0, _currentPageDataSize);
     addNewPageWithData(_currentPageData, _currentPageDataSize);
 
-    _currentPageOrigY = 0;
+    _pagePacker.reset(_width, _height);
 }
 
 void FontAtlas::addNewPageWithData(const uint8_t* data, size_t size)
@@ -513,7 +901,9 @@ void FontAtlas::setLineHeight(float newHeight)
 
 std::string_view FontAtlas::getFontName() const
 {
-    std::string_view fontName = _fontFreeType ? _fontFreeType->getFontName() : ""sv;
+    std::string_view fontName = _fontFreeType   ? _fontFreeType->getFontName()
+                                : _prebakedFont ? _prebakedFont->getSourceFontName()
+                                                : ""sv;
     if (fontName.empty())
         return fontName;
     auto idx = fontName.rfind('/');
@@ -32,6 +32,8 @@
 
 #include <string>
 #include <unordered_map>
+#include <memory>
+#include <vector>
 
 #include "platform/PlatformMacros.h"
 #include "base/Object.h"
@@ -40,6 +42,7 @@
 
 #include "base/Map.h"
 #include "2d/FontFreeType.h"
+#include "2d/SkylinePacker.h"
 
 NS_AX_BEGIN
 
@@ -47,6 +50,8 @@ class Font;
 class EventCustom;
 class EventListenerCustom;
 class FontFreeType;
+class FontPrebaked;
+struct GlyphRasterBatch;
 
 struct FontLetterDefinition
 {
@@ -70,6 +75,18 @@ public:
     static const char* CMD_PURGE_FONTATLAS;
     static const char* CMD_RESET_FONTATLAS;
     static void loadFontAtlas(std::string_view fontatlasFile, hlookup::string_map<FontAtlas*>& outAtlasMap);
+
+    /**
+     * Whether glyphs missing from the atlas are rasterized on the JobSystem without blocking
+     * prepareLetterDefinitions, disabled by default.
+     *
+     * A glyph in flight has a placeholder definition with the real advance and no quad, so the text is laid out
+     * with the final metrics and the glyph pops in when it arrives, labels waiting for glyphs lay out again then.
+     * When disabled, large batches of new glyphs are still rasterized in parallel, but waited for.
+     */
+    static void setAsyncGlyphRasterizationEnabled(bool enabled) { _asyncGlyphRasterization = enabled; }
+    static bool isAsyncGlyphRasterizationEnabled() { return _asyncGlyphRasterization; }
+
     /**
      * @js ctor
      */
@@ -88,6 +105,16 @@ public:
 
     const auto& getLetterDefinitions() const { return _letterDefinitions; }
 
+    /** Whether some letters are placeholders still being rasterized. */
+    bool hasPendingGlyphs() const { return !_glyphBatches.empty(); }
+
+    /** Changes every time letter definitions are replaced, e.g. when rasterized glyphs replace placeholders or
+     the pages are purged. Unique among all the atlases, so it identifies a state of the letter definitions. */
+    unsigned int getGlyphGeneration() const { return _glyphGeneration; }
+
+    /** Blocks until all the glyphs in flight replaced their placeholders. */
+    void waitForPendingGlyphs();
+
     const std::unordered_map<unsigned int, Texture2D*>& getTextures() const { return _atlasTextures; }
 
     virtual void addNewPage();
@@ -114,6 +141,19 @@ public:
      */
     void purgeTexturesAtlas();
 
+    /** Rebuilds the pages from the letters the labels using this atlas still show, the others are dropped.
+     The letters are rendered again and packed tallest first, so the atlas usually needs fewer pages, which
+     means fewer textures and fewer draw calls per label. The labels are laid out again like after a purge.
+     @return The number of pages released.
+     */
+    int compactTextures();
+
+    /** Keeps the letters of text when the atlas compacts, called by the labels while they are asked for them. */
+    void retainLetters(const std::u32string& text);
+
+    /** Gets the packer placing the letters on the current page. */
+    const SkylinePacker& getPagePacker() const { return _pagePacker; }
+
     /** sets font texture parameters:
      - GL_TEXTURE_MIN_FILTER = GL_LINEAR
      - GL_TEXTURE_MAG_FILTER = GL_LINEAR
@@ -129,6 +169,12 @@ public:
 protected:
     void initWithSettings(void* opaque /*simdjson::ondemand::document*/);
 
+    void initWithPrebakedFont(FontPrebaked* font);
+    // creates the baked pages again, from the mapped file
+    void loadPrebakedPages();
+    // opens the source font of a prebaked atlas for the letters not baked
+    bool openPrebakedSourceFont();
+
     void reset();
 
     void reinit();
@@ -144,7 +190,28 @@ protected:
      */
     void scaleFontLetterDefinition(float scaleFactor);
 
-    void updateTextureContent(backend::PixelFormat format, int startY);
+    // places a rendered glyph on the current page, returns false when it has nothing to draw
+    bool insertLetter(char32_t charCode,
+                      FontFreeType* renderer,
+                      const uint8_t* bitmap,
+                      int bitmapWidth,
+                      int bitmapHeight,
+                      const Rect& rect,
+                      int xAdvance);
+    // renders the glyphs the workers couldn't on this thread before placing them
+    void insertRasterizedLetters(const std::vector<char32_t>& charCodes,
+                                 const std::vector<unsigned int>& glyphIndices,
+                                 std::vector<FontFreeType::GlyphBitmap>& glyphs);
+    void rasterizeLetters(const std::vector<char32_t>& charCodes, const std::vector<unsigned int>& glyphIndices);
+    void commitGlyphBatch(GlyphRasterBatch& batch);
+    void discardGlyphBatches();
+
+    bool isAsyncRasterization() const { return _asyncGlyphRasterization && !_compacting; }
+
+    void markDirty(int x, int y, int width, int height);
+    void updateTextureContent();
+    // uploads the rect updated since the last upload of the current page
+    void flushTextureContent();
 
     std::unordered_map<unsigned int, Texture2D*> _atlasTextures;
     std::unordered_map<char32_t, FontLetterDefinition> _letterDefinitions;
@@ -154,6 +221,7 @@ protected:
 
     Font* _font                 = nullptr;
     FontFreeType* _fontFreeType = nullptr;
+    FontPrebaked* _prebakedFont = nullptr;  // _font when prebaked, owns the _fontFreeType it opens then
 
     int _width         = 0;  // atlas width
     int _height        = 0;  // atlas height
@@ -168,17 +236,35 @@ protected:
     uint8_t* _currentPageData         = nullptr;
     int _currentPageDataSize          = 0;
 
-    float _currentPageOrigX = 0;
-    float _currentPageOrigY = 0;
-    int _letterPadding      = 0;
-    int _letterEdgeExtend   = 0;
+    SkylinePacker _pagePacker;
+    int _letterPadding    = 0;
+    int _letterEdgeExtend = 0;
 
     int _fontAscender                               = 0;
     EventListenerCustom* _rendererRecreatedListener = nullptr;
     bool _antialiasEnabled                          = true;
-    int _currLineHeight                             = 0;
+
+    // letters kept by compactTextures
+    bool _compacting = false;
+    std::unordered_set<char32_t> _retainedLetters;
+
+    // rect of the current page waiting in the UploadQueue
+    int _dirtyStartX   = 0;
+    int _dirtyStartY   = 0;
+    int _dirtyEndX     = 0;
+    int _dirtyEndY     = 0;
+    bool _uploadQueued = false;
+    std::vector<uint8_t> _uploadScratch;
+
+    // glyphs rasterized on the JobSystem, in flight
+    std::vector<std::shared_ptr<GlyphRasterBatch>> _glyphBatches;
+    unsigned int _glyphGeneration = 0;
+
+    static bool _asyncGlyphRasterization;
+    static unsigned int _glyphGenerations;
 
     friend class Label;
+    friend class FontPrebaked;
 };
 
 NS_AX_END
@@ -31,6 +31,7 @@
 #include "2d/FontFreeType.h"
 #include "2d/FontAtlas.h"
 #include "2d/FontCharMap.h"
+#include "2d/FontPrebaked.h"
 #include "2d/Label.h"
 #include "platform/FileUtils.h"
 #include "base/format.h"
@@ -38,6 +39,7 @@
 NS_AX_BEGIN
 
 hlookup::string_map<FontAtlas*> FontAtlasCache::_atlasMap;
+hlookup::string_map<FontPrebaked*> FontAtlasCache::_prebakedFonts;
 
 void FontAtlasCache::purgeCachedData()
 {
@@ -52,31 +54,76 @@ void FontAtlasCache::purgeCachedData()
     _atlasMap.clear();
 }
 
+int FontAtlasCache::compactFontAtlases()
+{
+    // an atlas no label gets again leaves the map while it compacts
+    auto atlasMapCopy = _atlasMap;
+    int releasedPages = 0;
+    for (auto&& atlas : atlasMapCopy)
+        releasedPages += atlas.second->compactTextures();
+    return releasedPages;
+}
+
 void FontAtlasCache::preloadFontAtlas(std::string_view fontatlasFile)
 {
+    if (FileUtils::getInstance()->getFileExtension(fontatlasFile) == ".axfa")
+    {
+        auto font = FontPrebaked::create(fontatlasFile);
+        if (font)
+        {
+            font->retain();
+            auto it = _prebakedFonts.find(font->getAtlasName());
+            if (it != _prebakedFonts.end())
+            {
+                it->second->release();
+                _prebakedFonts.erase(it);
+            }
+            _prebakedFonts.emplace(font->getAtlasName(), font);
+        }
+        return;
+    }
+
     FontAtlas::loadFontAtlas(fontatlasFile, _atlasMap);
 }
 
-FontAtlas* FontAtlasCache::getFontAtlasTTF(_ttfConfig* config)
+std::string FontAtlasCache::getFontAtlasNameTTF(_ttfConfig* config, int* outScaledFaceSize)
 {
     auto& realFontFilename = config->fontFilePath;
-    bool useDistanceField  = config->distanceFieldEnabled;
-    int outlineSize        = useDistanceField ? 0 : config->outlineSize;
+    int outlineSize        = config->distanceFieldEnabled ? 0 : config->outlineSize;
 
     // underlaying font engine (freetype2) only support int type, so convert to int avoid precision issue
     if (!config->distanceFieldEnabled)
         config->faceSize = static_cast<int>(config->fontSize);
 
     auto scaledFaceSize = static_cast<int>(config->faceSize * AX_CONTENT_SCALE_FACTOR());
+    if (outScaledFaceSize)
+        *outScaledFaceSize = scaledFaceSize;
+
+    return config->distanceFieldEnabled ? fmt::format("df {} {}", scaledFaceSize, realFontFilename)
+                                        : fmt::format("{} {} {}", scaledFaceSize, outlineSize, realFontFilename);
+}
+
+FontAtlas* FontAtlasCache::getFontAtlasTTF(_ttfConfig* config)
+{
+    auto& realFontFilename = config->fontFilePath;
+    bool useDistanceField  = config->distanceFieldEnabled;
+    int outlineSize        = useDistanceField ? 0 : config->outlineSize;
 
-    std::string atlasName =
-        config->distanceFieldEnabled
-                                ? fmt::format("df {} {}", scaledFaceSize, realFontFilename)
-                                : fmt::format("{} {} {}", scaledFaceSize, outlineSize, realFontFilename);
+    int scaledFaceSize = 0;
+    std::string atlasName = getFontAtlasNameTTF(config, &scaledFaceSize);
     auto it = _atlasMap.find(atlasName);
 
     if (it == _atlasMap.end())
     {
+        // the prebaked pages are used as they are, FreeType is left alone until a letter isn't baked
+        auto prebakedIt = _prebakedFonts.find(atlasName);
+        if (prebakedIt != _prebakedFonts.end())
+        {
+            auto tempAtlas = prebakedIt->second->newFontAtlas();
+            if (tempAtlas)
+                return _atlasMap.emplace(std::move(atlasName), tempAtlas).first->second;
+        }
+
         auto font = FontFreeType::create(realFontFilename, scaledFaceSize, config->glyphs, config->customGlyphs,
                                          useDistanceField, static_cast<float>(outlineSize));
         if (font)
@@ -277,6 +324,17 @@ void FontAtlasCache::unloadFontAtlasTTF(std::string_view fontFileName)
         }
         ++iter;
     }
+
+    for (auto iter = _prebakedFonts.begin(); iter != _prebakedFonts.end();)
+    {
+        if (iter->first.find(fontFileName) != std::string::npos)
+        {
+            AX_SAFE_RELEASE_NULL(iter->second);
+            iter = _prebakedFonts.erase(iter);
+            continue;
+        }
+        ++iter;
+    }
 }
 
 NS_AX_END
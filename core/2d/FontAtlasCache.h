@@ -35,6 +35,7 @@
 NS_AX_BEGIN
 
 class FontAtlas;
+class FontPrebaked;
 class Texture2D;
 struct _ttfConfig;
 
@@ -44,10 +45,17 @@ public:
     /**
      * @brief preload a SDF fontatlas
      * since axmol-2.1.0, must call before creating any Label
+     *
+     * A .axfa file baked by FontPrebaked::bake is only registered, it's memory-mapped now but its atlas is
+     * created the first time a label asks for it, the registration survives purgeCachedData.
      */
     static void preloadFontAtlas(std::string_view fontatlasFile);
     static FontAtlas* getFontAtlasTTF(_ttfConfig* config);
 
+    /** Gets the name the atlas of a ttf config is cached with, the face size of the config is updated like
+     getFontAtlasTTF does. */
+    static std::string getFontAtlasNameTTF(_ttfConfig* config, int* outScaledFaceSize = nullptr);
+
     static FontAtlas* getFontAtlasFNT(std::string_view fontFileName);
     static FontAtlas* getFontAtlasFNT(std::string_view fontFileName, std::string_view subTextureKey);
     static FontAtlas* getFontAtlasFNT(std::string_view fontFileName, const Rect& imageRect, bool imageRotated);
@@ -67,6 +75,11 @@ public:
      */
     static void purgeCachedData();
 
+    /** Rebuilds the pages of every cached atlas from the letters still shown, see FontAtlas::compactTextures.
+     @return The number of pages released.
+     */
+    static int compactFontAtlases();
+
     /** Release current FNT texture and reload it.
      CAUTION : All component use this font texture should be reset font name, though the file name is same!
                otherwise, it will cause program crash!
@@ -84,6 +97,7 @@ public:
 
 private:
     static hlookup::string_map<FontAtlas*> _atlasMap;
+    static hlookup::string_map<FontPrebaked*> _prebakedFonts;
 };
 
 NS_AX_END
@@ -69,6 +69,10 @@ typedef struct _DataRef
 
 static hlookup::string_map<DataRef> s_cacheFontData;
 
+// The FT_Library is shared by all threads, FreeType requires creating and destroying faces and strokers on it to be
+// serialized, everything else is safe as long as every thread uses its own face
+static std::mutex s_faceMutex;
+
 // ------ freetype2 stream parsing support ---
 static unsigned long ft_stream_read_callback(FT_Stream stream,
                                              unsigned long offset,
@@ -106,11 +110,18 @@ FontFreeType* FontFreeType::createWithFaceInfo(FontFaceInfo* info, FontFreeType*
     {
         // create our new face for render
         FT_Face face;
-        auto error = FT_New_Face(getFTLibrary(), info->path.data(), info->face->face_index, &face);
+        FT_Error error;
+        {
+            std::lock_guard<std::mutex> lck(s_faceMutex);
+            error = FT_New_Face(getFTLibrary(), info->path.data(), info->face->face_index, &face);
+        }
         if (!error)
         {
             FontFreeType* tempFont = new FontFreeType(mainFont->isDistanceFieldEnabled(), mainFont->getOutlineSize());
             tempFont->setGlyphCollection(mainFont->_usedGlyphs, mainFont->getGlyphCollection());
+            tempFont->_faceSource     = FaceSource::FILE;
+            tempFont->_faceSourcePath = info->path;
+            tempFont->_faceIndex      = info->face->face_index;
             if (tempFont->initWithFontFace(face, info->path, mainFont->_faceSize))
             {
                 tempFont->autorelease();
@@ -197,6 +208,7 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outlin
     if (outline > 0.0f)
     {
         _outlineSize = outline * AX_CONTENT_SCALE_FACTOR();
+        std::lock_guard<std::mutex> lck(s_faceMutex);
         FT_Stroker_New(FontFreeType::getFTLibrary(), &_stroker);
         FT_Stroker_Set(_stroker,
             (int)(_outlineSize * 64),
@@ -211,6 +223,10 @@ FontFreeType::~FontFreeType()
 {
     if (_FTInitialized)
     {
+        for (auto&& context : _rasterContexts)
+            closeRasterContext(context);
+
+        std::lock_guard<std::mutex> lck(s_faceMutex);
         if (_stroker)
             FT_Stroker_Done(_stroker);
 
@@ -256,6 +272,10 @@ bool FontFreeType::initWithFontPath(std::string_view fontPath, int faceSize)
 
         _fontStream = fts;
 
+        _faceSource     = FaceSource::STREAM;
+        _faceSourcePath = fullPath;
+
+        std::lock_guard<std::mutex> lck(s_faceMutex);
         if (FT_Open_Face(getFTLibrary(), &args, 0, &face))
             return false;
     }
@@ -275,8 +295,16 @@ bool FontFreeType::initWithFontPath(std::string_view fontPath, int faceSize)
 
         ++sharableData->referenceCount;
         auto& data = sharableData->data;
-        if (data.isNull() ||
-            FT_New_Memory_Face(getFTLibrary(), data.getBytes(), static_cast<FT_Long>(data.getSize()), 0, &face))
+        if (data.isNull())
+            return false;
+
+        // the bytes stay alive until the last font referencing them is destroyed
+        _faceSource   = FaceSource::MEMORY;
+        _faceData     = data.getBytes();
+        _faceDataSize = static_cast<size_t>(data.getSize());
+
+        std::lock_guard<std::mutex> lck(s_faceMutex);
+        if (FT_New_Memory_Face(getFTLibrary(), _faceData, static_cast<FT_Long>(_faceDataSize), 0, &face))
             return false;
     }
 
@@ -290,19 +318,8 @@ bool FontFreeType::initWithFontFace(FT_Face face, std::string_view fontPath, int
         if (!face->charmap || face->charmap->encoding != FT_ENCODING_UNICODE)
             break;
 
-        if (_distanceFieldEnabled)
-        {
-            if (FT_Set_Pixel_Sizes(face, 0, faceSize))
-                break;
-        }
-        else
-        {
-            // set the requested font size
-            int dpi   = 72;
-            int units = faceSize << 6;
-            if (FT_Set_Char_Size(face, 0, units, dpi, dpi))
-                break;
-        }
+        if (!setFaceSize(face, faceSize))
+            break;
 
         // store the face globally
         _fontFace = face;
@@ -338,12 +355,169 @@ bool FontFreeType::initWithFontFace(FT_Face face, std::string_view fontPath, int
         return true;
     } while (false);
 
-    FT_Done_Face(face);
+    {
+        std::lock_guard<std::mutex> lck(s_faceMutex);
+        FT_Done_Face(face);
+    }
+    _faceSource = FaceSource::NONE;
 
     AXLOGI("Init font '{}' failed, only unicode ttf/ttc was supported.", fontPath);
     return false;
 }
 
+bool FontFreeType::setFaceSize(FT_Face face, int faceSize) const
+{
+    if (_distanceFieldEnabled)
+        return FT_Set_Pixel_Sizes(face, 0, faceSize) == 0;
+
+    // set the requested font size
+    int dpi   = 72;
+    int units = faceSize << 6;
+    return FT_Set_Char_Size(face, 0, units, dpi, dpi) == 0;
+}
+
+bool FontFreeType::openRasterContext(RasterContext& context)
+{
+    FT_Face face = nullptr;
+    switch (_faceSource)
+    {
+    case FaceSource::MEMORY:
+    {
+        std::lock_guard<std::mutex> lck(s_faceMutex);
+        if (FT_New_Memory_Face(getFTLibrary(), _faceData, static_cast<FT_Long>(_faceDataSize), 0, &face))
+            return false;
+        break;
+    }
+    case FaceSource::STREAM:
+    {
+        auto fs = FileUtils::getInstance()->openFileStream(_faceSourcePath, IFileStream::Mode::READ);
+        if (!fs)
+            return false;
+
+        FT_Stream fts           = new FT_StreamRec();
+        fts->read               = ft_stream_read_callback;
+        fts->close              = ft_stream_close_callback;
+        fts->size               = static_cast<unsigned long>(fs->size());
+        fts->descriptor.pointer = fs.release();
+
+        FT_Open_Args args = {};
+        args.flags        = FT_OPEN_STREAM;
+        args.stream       = fts;
+
+        context.stream = fts;
+
+        std::lock_guard<std::mutex> lck(s_faceMutex);
+        if (FT_Open_Face(getFTLibrary(), &args, 0, &face))
+        {
+            delete fts;
+            context.stream = nullptr;
+            return false;
+        }
+        break;
+    }
+    case FaceSource::FILE:
+    {
+        std::lock_guard<std::mutex> lck(s_faceMutex);
+        if (FT_New_Face(getFTLibrary(), _faceSourcePath.c_str(), _faceIndex, &face))
+            return false;
+        break;
+    }
+    default:
+        return false;
+    }
+
+    context.face = face;
+    if (!setFaceSize(face, _faceSize))
+    {
+        closeRasterContext(context);
+        return false;
+    }
+
+    if (_outlineSize > 0)
+    {
+        std::lock_guard<std::mutex> lck(s_faceMutex);
+        FT_Stroker_New(getFTLibrary(), &context.stroker);
+        FT_Stroker_Set(context.stroker, (int)(_outlineSize * 64), FT_STROKER_LINECAP_ROUND,
+                       FT_STROKER_LINEJOIN_ROUND, 0);
+    }
+    return true;
+}
+
+void FontFreeType::closeRasterContext(RasterContext& context)
+{
+    {
+        std::lock_guard<std::mutex> lck(s_faceMutex);
+        if (context.stroker)
+            FT_Stroker_Done(context.stroker);
+        if (context.face)
+            FT_Done_Face(context.face);
+    }
+    delete context.stream;
+    context = RasterContext{};
+}
+
+bool FontFreeType::rasterizeGlyph(unsigned int glyphIndex, GlyphBitmap& out)
+{
+    RasterContext context;
+    {
+        std::lock_guard<std::mutex> lck(_rasterContextsMutex);
+        if (!_rasterContexts.empty())
+        {
+            context = _rasterContexts.back();
+            _rasterContexts.pop_back();
+        }
+    }
+    if (!context.face && !openRasterContext(context))
+        return false;
+
+    renderGlyphBitmap(context.face, context.stroker, glyphIndex, out);
+
+    std::lock_guard<std::mutex> lck(_rasterContextsMutex);
+    _rasterContexts.emplace_back(context);
+    return true;
+}
+
+void FontFreeType::renderGlyphBitmap(unsigned int glyphIndex, GlyphBitmap& out)
+{
+    renderGlyphBitmap(_fontFace, _stroker, glyphIndex, out);
+}
+
+void FontFreeType::renderGlyphBitmap(FT_Face face, FT_Stroker stroker, unsigned int glyphIndex, GlyphBitmap& out)
+{
+    int width = 0, height = 0;
+    auto bitmap = renderGlyph(face, stroker, glyphIndex, width, height, out.rect, out.xAdvance);
+    out.width    = width;
+    out.height   = height;
+    out.rendered = true;
+    if (bitmap && width > 0 && height > 0)
+    {
+        const size_t size = static_cast<size_t>(width * height) << (_outlineSize > 0 ? 1 : 0);
+        out.pixels.assign(bitmap, bitmap + size);
+    }
+    else
+    {
+        out.width = out.height = 0;
+        out.pixels.clear();
+    }
+
+    // the blend image of outlined glyphs is ours, the plain bitmap belongs to the face's glyph slot
+    if (_outlineSize > 0)
+        delete[] bitmap;
+}
+
+unsigned int FontFreeType::getCharIndex(char32_t charCode) const
+{
+    return FT_Get_Char_Index(_fontFace, static_cast<FT_ULong>(charCode));
+}
+
+int FontFreeType::getGlyphAdvance(unsigned int glyphIndex) const
+{
+    // loads the outline only, same flags as renderGlyph so the advance matches the rendered one
+    if (FT_Load_Glyph(_fontFace, glyphIndex, FT_LOAD_NO_AUTOHINT))
+        return 0;
+    return static_cast<int>(_fontFace->glyph->metrics.horiAdvance >> 6);
+}
+
 FontAtlas* FontFreeType::newFontAtlas()
 {
     auto fontAtlas = new FontAtlas(this);
@@ -383,6 +557,11 @@ int* FontFreeType::getHorizontalKerningForTextUTF32(const std::u32string& text,
     return sizes;
 }
 
+bool FontFreeType::hasKerning() const
+{
+    return _fontFace && FT_HAS_KERNING(_fontFace) != 0;
+}
+
 int FontFreeType::getHorizontalKerningForChars(uint64_t firstChar, uint64_t secondChar) const
 {
     // get the ID to the char we need
@@ -473,32 +652,43 @@ unsigned char* FontFreeType::getGlyphBitmapByIndex(unsigned int glyphIndex,
                                                    int& outHeight,
                                                    Rect& outRect,
                                                    int& xAdvance)
+{
+    return renderGlyph(_fontFace, _stroker, glyphIndex, outWidth, outHeight, outRect, xAdvance);
+}
+
+unsigned char* FontFreeType::renderGlyph(FT_Face face,
+                                         FT_Stroker stroker,
+                                         unsigned int glyphIndex,
+                                         int& outWidth,
+                                         int& outHeight,
+                                         Rect& outRect,
+                                         int& xAdvance)
 {
     unsigned char* ret = nullptr;
 
     do
     {
-        if (FT_Load_Glyph(_fontFace, glyphIndex, FT_LOAD_RENDER | FT_LOAD_NO_AUTOHINT))
+        if (FT_Load_Glyph(face, glyphIndex, FT_LOAD_RENDER | FT_LOAD_NO_AUTOHINT))
             break;
 
-        if (_distanceFieldEnabled && _fontFace->glyph->bitmap.buffer)
+        if (_distanceFieldEnabled && face->glyph->bitmap.buffer)
         {
             // Require freetype version > 2.11.0, because freetype 2.11.0 sdf has memory access bug, see:
             // https://gitlab.freedesktop.org/freetype/freetype/-/issues/1077
-            FT_Render_Glyph(_fontFace->glyph, FT_Render_Mode::FT_RENDER_MODE_SDF);
+            FT_Render_Glyph(face->glyph, FT_Render_Mode::FT_RENDER_MODE_SDF);
         }
 
-        auto& metrics       = _fontFace->glyph->metrics;
+        auto& metrics       = face->glyph->metrics;
         outRect.origin.x    = static_cast<float>(metrics.horiBearingX >> 6);
         outRect.origin.y    = static_cast<float>(-(metrics.horiBearingY >> 6));
         outRect.size.width  = static_cast<float>((metrics.width >> 6));
         outRect.size.height = static_cast<float>((metrics.height >> 6));
 
-        xAdvance = (static_cast<int>(_fontFace->glyph->metrics.horiAdvance >> 6));
+        xAdvance = (static_cast<int>(face->glyph->metrics.horiAdvance >> 6));
 
-        outWidth  = _fontFace->glyph->bitmap.width;
-        outHeight = _fontFace->glyph->bitmap.rows;
-        ret       = _fontFace->glyph->bitmap.buffer;
+        outWidth  = face->glyph->bitmap.width;
+        outHeight = face->glyph->bitmap.rows;
+        ret       = face->glyph->bitmap.buffer;
 
         if (_outlineSize > 0 && outWidth > 0 && outHeight > 0)
         {
@@ -506,7 +696,7 @@ unsigned char* FontFreeType::getGlyphBitmapByIndex(unsigned int glyphIndex,
             memcpy(copyBitmap, ret, outWidth * outHeight * sizeof(unsigned char));
 
             FT_BBox bbox;
-            auto outlineBitmap = getGlyphBitmapWithOutline(glyphIndex, bbox);
+            auto outlineBitmap = getGlyphBitmapWithOutline(face, stroker, glyphIndex, bbox);
             if (outlineBitmap == nullptr)
             {
                 ret = nullptr;
@@ -587,17 +777,20 @@ unsigned char* FontFreeType::getGlyphBitmapByIndex(unsigned int glyphIndex,
     return nullptr;
 }
 
-unsigned char* FontFreeType::getGlyphBitmapWithOutline(unsigned int glyphIndex, FT_BBox& bbox)
+unsigned char* FontFreeType::getGlyphBitmapWithOutline(FT_Face face,
+                                                       FT_Stroker stroker,
+                                                       unsigned int glyphIndex,
+                                                       FT_BBox& bbox)
 {
     unsigned char* ret = nullptr;
-    if (FT_Load_Glyph(_fontFace, glyphIndex, FT_LOAD_NO_BITMAP) == 0)
+    if (FT_Load_Glyph(face, glyphIndex, FT_LOAD_NO_BITMAP) == 0)
     {
-        if (_fontFace->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+        if (face->glyph->format == FT_GLYPH_FORMAT_OUTLINE)
         {
             FT_Glyph glyph;
-            if (FT_Get_Glyph(_fontFace->glyph, &glyph) == 0)
+            if (FT_Get_Glyph(face->glyph, &glyph) == 0)
             {
-                FT_Glyph_StrokeBorder(&glyph, _stroker, 0, 1);
+                FT_Glyph_StrokeBorder(&glyph, stroker, 0, 1);
                 if (glyph->format == FT_GLYPH_FORMAT_OUTLINE)
                 {
                     FT_Outline* outline = &reinterpret_cast<FT_OutlineGlyph>(glyph)->outline;
@@ -620,7 +813,7 @@ unsigned char* FontFreeType::getGlyphBitmapWithOutline(unsigned int glyphIndex,
                     params.target = &bmp;
                     params.flags  = FT_RASTER_FLAG_AA;
                     FT_Outline_Translate(outline, -bbox.xMin, -bbox.yMin);
-                    FT_Outline_Render(_FTlibrary, outline, &params);
+                    FT_Outline_Render(face->glyph->library, outline, &params);
 
                     ret = bmp.buffer;
                 }
@@ -639,7 +832,20 @@ void FontFreeType::renderCharAt(unsigned char* dest,
                                 int bitmapWidth,
                                 int bitmapHeight,
                                 int atlasWidth,
-                                int atlasHeight)
+                                int /*atlasHeight*/)
+{
+    copyGlyphBitmap(dest, posX, posY, bitmap, bitmapWidth, bitmapHeight, atlasWidth);
+    if (_outlineSize > 0)
+        delete[] bitmap;
+}
+
+void FontFreeType::copyGlyphBitmap(uint8_t* dest,
+                                   int posX,
+                                   int posY,
+                                   const uint8_t* bitmap,
+                                   int bitmapWidth,
+                                   int bitmapHeight,
+                                   int atlasWidth) const
 {
     const int iX = posX;
     int iY       = posY;
@@ -652,7 +858,6 @@ void FontFreeType::renderCharAt(unsigned char* dest,
             memcpy(dest + (iX + (iY * atlasWidth)) * 2, bitmap + bitmap_y * 2, bitmapWidth * 2);
             ++iY;
         }
-        delete[] bitmap;
     }
     else
     {
@@ -29,6 +29,8 @@
 #include "2d/Font.h"
 #include "2d/IFontEngine.h"
 #include <string>
+#include <vector>
+#include <mutex>
 
 NS_AX_BEGIN
 
@@ -46,6 +48,17 @@ public:
     static const int DistanceMapSpread;
     static constexpr int DEFAULT_BASE_FONT_SIZE = 32;
 
+    /** A glyph rendered into memory owned by the caller, see rasterizeGlyph. */
+    struct GlyphBitmap
+    {
+        std::vector<uint8_t> pixels;  // 2 bytes per pixel when the font has an outline
+        int width    = 0;
+        int height   = 0;
+        int xAdvance = 0;
+        Rect rect;
+        bool rendered = false;  // false when no face could be opened for the rendering thread
+    };
+
     /**
      * Set font engine for ttf fallback render support
      * @since axmol-2.1.3
@@ -130,6 +143,39 @@ public:
                                          Rect& outRect,
                                          int& xAdvance);
 
+    /** Copies a glyph bitmap into the atlas page dest, unlike renderCharAt the bitmap is never deleted. */
+    void copyGlyphBitmap(uint8_t* dest,
+                         int posX,
+                         int posY,
+                         const uint8_t* bitmap,
+                         int bitmapWidth,
+                         int bitmapHeight,
+                         int atlasWidth) const;
+
+    /** Gets the glyph index of charCode in this face, 0 when the face doesn't contain it. */
+    unsigned int getCharIndex(char32_t charCode) const;
+
+    /** Gets the advance of a glyph in pixels, without rendering it. */
+    int getGlyphAdvance(unsigned int glyphIndex) const;
+
+    /**
+     * Whether rasterizeGlyph can be used, it needs to open the font source again for every thread.
+     */
+    bool isConcurrentRasterizationSupported() const { return _faceSource != FaceSource::NONE; }
+
+    /**
+     * Renders a glyph like getGlyphBitmapByIndex but into out, may be called from any thread concurrently:
+     * every caller borrows a private FT_Face of this font, so the face used by the main thread is never touched.
+     */
+    bool rasterizeGlyph(unsigned int glyphIndex, GlyphBitmap& out);
+
+    /** Renders a glyph into out with the face of the main thread, for the glyphs rasterizeGlyph failed on. */
+    void renderGlyphBitmap(unsigned int glyphIndex, GlyphBitmap& out);
+
+    /** Whether the face has a kerning table, getHorizontalKerningForChars is always 0 otherwise. */
+    bool hasKerning() const;
+    int getHorizontalKerningForChars(uint64_t firstChar, uint64_t secondChar) const;
+
     int getFontAscender() const;
     const char* getFontFamily() const;
     std::string_view getFontName() const { return _fontName; }
@@ -160,8 +206,28 @@ private:
 
     bool initWithFontFace(FT_Face face, std::string_view fontPath, int faceSize);
 
-    int getHorizontalKerningForChars(uint64_t firstChar, uint64_t secondChar) const;
-    unsigned char* getGlyphBitmapWithOutline(unsigned int glyphIndex, FT_BBox& bbox);
+    unsigned char* getGlyphBitmapWithOutline(FT_Face face, FT_Stroker stroker, unsigned int glyphIndex, FT_BBox& bbox);
+    unsigned char* renderGlyph(FT_Face face,
+                               FT_Stroker stroker,
+                               unsigned int glyphIndex,
+                               int& outWidth,
+                               int& outHeight,
+                               Rect& outRect,
+                               int& xAdvance);
+
+    void renderGlyphBitmap(FT_Face face, FT_Stroker stroker, unsigned int glyphIndex, GlyphBitmap& out);
+
+    bool setFaceSize(FT_Face face, int faceSize) const;
+
+    // a face and stroker which only one thread uses at a time, for rasterizeGlyph
+    struct RasterContext
+    {
+        FT_Face face       = nullptr;
+        FT_Stroker stroker = nullptr;
+        FT_Stream stream   = nullptr;
+    };
+    bool openRasterContext(RasterContext& context);
+    static void closeRasterContext(RasterContext& context);
 
     void setGlyphCollection(GlyphCollection glyphs, std::string_view customGlyphs);
 
@@ -179,6 +245,23 @@ private:
 
     GlyphCollection _usedGlyphs;
     std::string _customGlyphs;
+
+    // where rasterizeGlyph opens the faces of the other threads from
+    enum class FaceSource
+    {
+        NONE,
+        MEMORY,
+        STREAM,
+        FILE,
+    };
+    FaceSource _faceSource = FaceSource::NONE;
+    std::string _faceSourcePath;
+    const uint8_t* _faceData = nullptr;
+    size_t _faceDataSize     = 0;
+    long _faceIndex          = 0;
+
+    std::vector<RasterContext> _rasterContexts;
+    std::mutex _rasterContextsMutex;
 };
 
 // end of _2d group
@@ -0,0 +1,396 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/FontPrebaked.h"
+
+#include <algorithm>
+#include "2d/FontAtlas.h"
+#include "2d/FontAtlasCache.h"
+#include "2d/FontFreeType.h"
+#include "2d/Label.h"
+#include "base/Director.h"
+#include "base/UTF8.h"
+#include "platform/FileUtils.h"
+
+NS_AX_BEGIN
+
+static_assert(sizeof(FontPrebaked::FileHeader) % 4 == 0, "FileHeader must keep the sections aligned");
+static_assert(sizeof(FontPrebaked::LetterRecord) % 4 == 0, "LetterRecord must keep the sections aligned");
+static_assert(sizeof(FontPrebaked::KerningRecord) % 4 == 0, "KerningRecord must keep the sections aligned");
+static_assert(sizeof(SkylinePacker::Segment) == 3 * sizeof(int32_t), "Segment is stored as is");
+
+static const char PREBAKED_MAGIC[4] = {'A', 'X', 'F', 'A'};
+static const size_t PAGE_ALIGNMENT  = 16;
+
+namespace
+{
+// renders the letters to pages kept in memory, no texture is created
+class FontAtlasBaker : public FontAtlas
+{
+public:
+    using FontAtlas::FontAtlas;
+
+    void bake(const std::u32string& charset, FontPrebaked::Contents& contents)
+    {
+        prepareLetterDefinitions(charset);
+        waitForPendingGlyphs();
+        _pages.emplace_back(_currentPageData, _currentPageData + _currentPageDataSize);
+
+        contents.atlasWidth       = _width;
+        contents.atlasHeight      = _height;
+        contents.bytesPerPixel    = 1 << _strideShift;
+        contents.lineHeight       = _lineHeight;
+        contents.fontAscender     = _fontAscender;
+        contents.letterPadding    = _letterPadding;
+        contents.letterEdgeExtend = _letterEdgeExtend;
+
+        // the scale factor is 1, the definitions are in pixels
+        for (auto&& item : _letterDefinitions)
+        {
+            auto& def = item.second;
+            contents.letters.emplace_back(FontPrebaked::LetterRecord{
+                static_cast<uint32_t>(item.first), def.U, def.V, def.width, def.height, def.offsetX, def.offsetY,
+                def.textureID, def.xAdvance, def.validDefinition ? 1u : 0u});
+        }
+        contents.skyline = _pagePacker.getSkyline();
+        contents.pages   = std::move(_pages);
+    }
+
+    void addNewPage() override
+    {
+        if (_currentPage != -1)
+            _pages.emplace_back(_currentPageData, _currentPageData + _currentPageDataSize);
+
+        memset(_currentPageData, 0, _currentPageDataSize);
+        ++_currentPage;
+        _pagePacker.reset(_width, _height);
+    }
+
+private:
+    std::vector<std::vector<uint8_t>> _pages;
+};
+
+size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+}  // namespace
+
+FontPrebaked* FontPrebaked::create(std::string_view prebakedFile)
+{
+    auto view = FileUtils::getInstance()->getFileView(prebakedFile);
+    if (view.isNull())
+    {
+        AXLOGE("Load prebaked font atlas {} fail, the file can't be read", prebakedFile);
+        return nullptr;
+    }
+    return createWithFileView(std::move(view));
+}
+
+FontPrebaked* FontPrebaked::createWithFileView(FileView view)
+{
+    auto font = new FontPrebaked();
+    if (font->initWithFileView(std::move(view)))
+    {
+        font->autorelease();
+        return font;
+    }
+
+    delete font;
+    return nullptr;
+}
+
+FontPrebaked::~FontPrebaked()
+{
+    AX_SAFE_RELEASE(_sourceFont);
+}
+
+bool FontPrebaked::initWithFileView(FileView view)
+{
+    const uint64_t size = view.size();
+    if (size < sizeof(FileHeader))
+    {
+        AXLOGE("Load prebaked font atlas fail, the file is truncated");
+        return false;
+    }
+
+    auto header = reinterpret_cast<const FileHeader*>(view.data());
+    if (memcmp(header->magic, PREBAKED_MAGIC, sizeof(PREBAKED_MAGIC)) != 0 || header->version != FORMAT_VERSION)
+    {
+        AXLOGE("Load prebaked font atlas fail, not a version {} prebaked font atlas", FORMAT_VERSION);
+        return false;
+    }
+
+    auto fits = [size](uint64_t offset, uint64_t count, uint64_t itemSize) {
+        return offset <= size && count * itemSize <= size - offset;
+    };
+    const uint64_t pageSize = uint64_t{header->atlasWidth} * header->atlasHeight * header->bytesPerPixel;
+    if (header->atlasWidth == 0 || header->atlasHeight == 0 ||
+        (header->bytesPerPixel != 1 && header->bytesPerPixel != 2) || header->pageCount == 0 ||
+        header->lettersOffset % 4 != 0 || header->kerningsOffset % 4 != 0 || header->skylineOffset % 4 != 0 ||
+        header->pagesOffset % PAGE_ALIGNMENT != 0 ||
+        !fits(header->lettersOffset, header->letterCount, sizeof(LetterRecord)) ||
+        !fits(header->kerningsOffset, header->kerningCount, sizeof(KerningRecord)) ||
+        !fits(header->skylineOffset, header->skylineCount, sizeof(SkylinePacker::Segment)) ||
+        !fits(header->atlasNameOffset, header->atlasNameLength, 1) ||
+        !fits(header->sourceFontOffset, header->sourceFontLength, 1) ||
+        !fits(header->pagesOffset, header->pageCount, pageSize))
+    {
+        AXLOGE("Load prebaked font atlas fail, the file is corrupted");
+        return false;
+    }
+
+    auto data = view.data();
+    std::span<const LetterRecord> letters{reinterpret_cast<const LetterRecord*>(data + header->lettersOffset),
+                                          header->letterCount};
+    std::span<const SkylinePacker::Segment> skyline{
+        reinterpret_cast<const SkylinePacker::Segment*>(data + header->skylineOffset), header->skylineCount};
+
+    // the letters are drawn from their page, the next ones are packed under the skyline of the last page,
+    // which is sorted by x and covers the page width
+    bool valid = std::all_of(letters.begin(), letters.end(), [header](const LetterRecord& letter) {
+        return letter.page >= 0 && static_cast<uint32_t>(letter.page) < header->pageCount;
+    });
+    int64_t skylineEnd = 0;
+    for (auto&& segment : skyline)
+    {
+        valid = valid && segment.x == skylineEnd && segment.width > 0 && segment.y >= 0 &&
+                static_cast<uint32_t>(segment.y) <= header->atlasHeight;
+        skylineEnd += segment.width;
+    }
+    if (!valid || skylineEnd != header->atlasWidth)
+    {
+        AXLOGE("Load prebaked font atlas fail, the letters or the skyline don't fit the pages");
+        return false;
+    }
+
+    _header         = header;
+    _letters        = letters;
+    _kernings       = {reinterpret_cast<const KerningRecord*>(data + header->kerningsOffset), header->kerningCount};
+    _skyline        = skyline;
+    _atlasName      = {reinterpret_cast<const char*>(data + header->atlasNameOffset), header->atlasNameLength};
+    _sourceFontName = {reinterpret_cast<const char*>(data + header->sourceFontOffset), header->sourceFontLength};
+    _view           = std::move(view);
+    return true;
+}
+
+std::vector<uint8_t> FontPrebaked::encode(const Contents& contents)
+{
+    auto letters = contents.letters;
+    std::sort(letters.begin(), letters.end(),
+              [](const LetterRecord& lhs, const LetterRecord& rhs) { return lhs.charCode < rhs.charCode; });
+    auto kernings = contents.kernings;
+    std::sort(kernings.begin(), kernings.end(), [](const KerningRecord& lhs, const KerningRecord& rhs) {
+        return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+    });
+
+    FileHeader header{};
+    memcpy(header.magic, PREBAKED_MAGIC, sizeof(PREBAKED_MAGIC));
+    header.version          = FORMAT_VERSION;
+    header.flags            = contents.flags;
+    header.atlasWidth       = contents.atlasWidth;
+    header.atlasHeight      = contents.atlasHeight;
+    header.bytesPerPixel    = contents.bytesPerPixel;
+    header.faceSize         = contents.faceSize;
+    header.outlineSize      = contents.outlineSize;
+    header.lineHeight       = contents.lineHeight;
+    header.fontMaxHeight    = contents.fontMaxHeight;
+    header.fontAscender     = contents.fontAscender;
+    header.letterPadding    = contents.letterPadding;
+    header.letterEdgeExtend = contents.letterEdgeExtend;
+    header.letterCount      = static_cast<uint32_t>(letters.size());
+    header.kerningCount     = static_cast<uint32_t>(kernings.size());
+    header.skylineCount     = static_cast<uint32_t>(contents.skyline.size());
+    header.pageCount        = static_cast<uint32_t>(contents.pages.size());
+
+    size_t offset        = sizeof(FileHeader);
+    header.lettersOffset = static_cast<uint32_t>(offset);
+    offset += letters.size() * sizeof(LetterRecord);
+    header.kerningsOffset = static_cast<uint32_t>(offset);
+    offset += kernings.size() * sizeof(KerningRecord);
+    header.skylineOffset = static_cast<uint32_t>(offset);
+    offset += contents.skyline.size() * sizeof(SkylinePacker::Segment);
+    header.atlasNameOffset = static_cast<uint32_t>(offset);
+    header.atlasNameLength = static_cast<uint32_t>(contents.atlasName.size());
+    offset += contents.atlasName.size();
+    header.sourceFontOffset = static_cast<uint32_t>(offset);
+    header.sourceFontLength = static_cast<uint32_t>(contents.sourceFont.size());
+    offset += contents.sourceFont.size();
+    offset             = alignUp(offset, PAGE_ALIGNMENT);
+    header.pagesOffset = static_cast<uint32_t>(offset);
+
+    const size_t pageSize = static_cast<size_t>(contents.atlasWidth) * contents.atlasHeight * contents.bytesPerPixel;
+    std::vector<uint8_t> data(offset + pageSize * contents.pages.size());
+    memcpy(data.data(), &header, sizeof(header));
+    if (!letters.empty())
+        memcpy(data.data() + header.lettersOffset, letters.data(), letters.size() * sizeof(LetterRecord));
+    if (!kernings.empty())
+        memcpy(data.data() + header.kerningsOffset, kernings.data(), kernings.size() * sizeof(KerningRecord));
+    if (!contents.skyline.empty())
+        memcpy(data.data() + header.skylineOffset, contents.skyline.data(),
+               contents.skyline.size() * sizeof(SkylinePacker::Segment));
+    memcpy(data.data() + header.atlasNameOffset, contents.atlasName.data(), contents.atlasName.size());
+    memcpy(data.data() + header.sourceFontOffset, contents.sourceFont.data(), contents.sourceFont.size());
+    for (size_t i = 0; i < contents.pages.size(); ++i)
+    {
+        AXASSERT(contents.pages[i].size() == pageSize, "The page size doesn't match the atlas size");
+        memcpy(data.data() + offset + pageSize * i, contents.pages[i].data(),
+               (std::min)(pageSize, contents.pages[i].size()));
+    }
+    return data;
+}
+
+bool FontPrebaked::bake(const _ttfConfig& config, std::string_view outputFile, int atlasWidth, int atlasHeight)
+{
+    auto ttfConfig      = config;
+    int scaledFaceSize  = 0;
+    auto atlasName      = FontAtlasCache::getFontAtlasNameTTF(&ttfConfig, &scaledFaceSize);
+    const float outline = ttfConfig.distanceFieldEnabled ? 0.0f : static_cast<float>(ttfConfig.outlineSize);
+
+    auto font = FontFreeType::create(ttfConfig.fontFilePath, scaledFaceSize, ttfConfig.glyphs, ttfConfig.customGlyphs,
+                                     ttfConfig.distanceFieldEnabled, outline);
+    if (!font)
+    {
+        AXLOGE("Bake font atlas {} fail, can't open the font {}", outputFile, ttfConfig.fontFilePath);
+        return false;
+    }
+
+    std::u32string charset;
+    if (!StringUtils::UTF8ToUTF32(font->getGlyphCollection(), charset) || charset.empty())
+    {
+        AXLOGE("Bake font atlas {} fail, the charset is empty, use the ASCII, NEHE or CUSTOM glyph collection",
+               outputFile);
+        return false;
+    }
+    std::sort(charset.begin(), charset.end());
+    charset.erase(std::unique(charset.begin(), charset.end()), charset.end());
+
+    Contents contents;
+    contents.atlasName     = std::move(atlasName);
+    contents.sourceFont    = ttfConfig.fontFilePath;
+    contents.flags         = ttfConfig.distanceFieldEnabled ? DISTANCE_FIELD : 0;
+    contents.faceSize      = scaledFaceSize;
+    contents.outlineSize   = outline;
+    contents.fontMaxHeight = font->getFontMaxHeight();
+
+    auto baker = new FontAtlasBaker(font, atlasWidth, atlasHeight, 1.0f);
+    baker->bake(charset, contents);
+    baker->release();
+
+    // the pairs of the charset, the others are asked to the source font once it's open
+    if (font->hasKerning())
+    {
+        for (auto first : charset)
+        {
+            for (auto second : charset)
+            {
+                auto amount = font->getHorizontalKerningForChars(first, second);
+                if (amount != 0)
+                    contents.kernings.emplace_back(KerningRecord{first, second, amount});
+            }
+        }
+    }
+
+    auto data = encode(contents);
+    if (!FileUtils::writeBinaryToFile(data.data(), data.size(), outputFile))
+    {
+        AXLOGE("Bake font atlas {} fail, can't write the file", outputFile);
+        return false;
+    }
+    return true;
+}
+
+FontAtlas* FontPrebaked::newFontAtlas()
+{
+    auto atlas = new FontAtlas(this, _header->atlasWidth, _header->atlasHeight, AX_CONTENT_SCALE_FACTOR());
+    atlas->initWithPrebakedFont(this);
+    return atlas;
+}
+
+int* FontPrebaked::getHorizontalKerningForTextUTF32(const std::u32string& text, int& outNumLetters) const
+{
+    outNumLetters = static_cast<int>(text.length());
+    if (!outNumLetters)
+        return nullptr;
+
+    // the letters rendered at runtime may pair with any other, the source font knows them all
+    if (_sourceFont &&
+        std::any_of(text.begin(), text.end(), [this](char32_t charCode) { return !findLetter(charCode); }))
+        return _sourceFont->getHorizontalKerningForTextUTF32(text, outNumLetters);
+
+    int* sizes = new int[outNumLetters];
+    sizes[0]   = 0;
+    for (int c = 1; c < outNumLetters; ++c)
+        sizes[c] = _kernings.empty() ? 0 : getKerning(text[c - 1], text[c]);
+
+    return sizes;
+}
+
+size_t FontPrebaked::getPageSize() const
+{
+    return static_cast<size_t>(_header->atlasWidth) * _header->atlasHeight * _header->bytesPerPixel;
+}
+
+const uint8_t* FontPrebaked::getPageData(int page) const
+{
+    AXASSERT(page >= 0 && page < getPageCount(), "The page is out of range");
+    return _view.data() + _header->pagesOffset + getPageSize() * page;
+}
+
+const FontPrebaked::LetterRecord* FontPrebaked::findLetter(char32_t charCode) const
+{
+    auto it = std::lower_bound(_letters.begin(), _letters.end(), static_cast<uint32_t>(charCode),
+                               [](const LetterRecord& letter, uint32_t code) { return letter.charCode < code; });
+    return it != _letters.end() && it->charCode == charCode ? &*it : nullptr;
+}
+
+int FontPrebaked::getKerning(char32_t first, char32_t second) const
+{
+    const KerningRecord pair{static_cast<uint32_t>(first), static_cast<uint32_t>(second), 0};
+    auto it = std::lower_bound(_kernings.begin(), _kernings.end(), pair,
+                               [](const KerningRecord& lhs, const KerningRecord& rhs) {
+                                   return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+                               });
+    return it != _kernings.end() && it->first == pair.first && it->second == pair.second ? it->amount : 0;
+}
+
+FontFreeType* FontPrebaked::getSourceFont()
+{
+    if (!_sourceFont && !_sourceFontFailed)
+    {
+        _sourceFont = FontFreeType::create(_sourceFontName, _header->faceSize, GlyphCollection::DYNAMIC, ""sv,
+                                           (_header->flags & DISTANCE_FIELD) != 0, _header->outlineSize);
+        if (_sourceFont)
+            _sourceFont->retain();
+        else
+        {
+            _sourceFontFailed = true;
+            AXLOGE("The source font {} of the prebaked font atlas {} can't be opened, only the baked letters show",
+                   _sourceFontName, _atlasName);
+        }
+    }
+    return _sourceFont;
+}
+
+NS_AX_END
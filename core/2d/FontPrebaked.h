@@ -0,0 +1,204 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+/// @cond DO_NOT_SHOW
+
+#include <span>
+#include <string>
+#include <vector>
+#include "2d/Font.h"
+#include "2d/SkylinePacker.h"
+#include "platform/FileView.h"
+
+NS_AX_BEGIN
+
+class FontFreeType;
+struct _ttfConfig;
+
+/**
+ * A font atlas rendered offline, memory-mapped from a .axfa file.
+ *
+ * The file holds the glyph pages of a charset as raw pixels, with the letter metrics and the kerning pairs of
+ * the charset, so a label showing baked letters never touches FreeType: the pages are uploaded straight from
+ * the mapped file. The source font is opened the first time a letter outside the charset shows up, the new
+ * letters then go on after the baked ones.
+ *
+ * A file is baked for one variant (plain, outlined or distance field) at one scaled face size, the atlas name
+ * in its header matches the one FontAtlasCache::getFontAtlasTTF looks up, see FontAtlasCache::preloadFontAtlas.
+ *
+ * Layout, little endian, every section 4 bytes aligned, pages 16 bytes aligned:
+ * FileHeader, LetterRecord[] sorted by char code, KerningRecord[] sorted by pair,
+ * SkylinePacker::Segment[] of the last page, atlas name, source font path, pages.
+ */
+class AX_DLL FontPrebaked : public Font
+{
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    enum Flags : uint32_t
+    {
+        DISTANCE_FIELD = 1,
+    };
+
+    struct FileHeader
+    {
+        char magic[4];  // AXFA
+        uint32_t version;
+        uint32_t flags;
+        uint32_t atlasWidth;
+        uint32_t atlasHeight;
+        uint32_t bytesPerPixel;  // 1 for R8, 2 for RG8 when outlined
+        int32_t faceSize;        // scaled
+        float outlineSize;
+        float lineHeight;
+        int32_t fontMaxHeight;
+        int32_t fontAscender;
+        int32_t letterPadding;
+        int32_t letterEdgeExtend;
+        uint32_t letterCount;
+        uint32_t kerningCount;
+        uint32_t skylineCount;
+        uint32_t pageCount;
+        uint32_t lettersOffset;
+        uint32_t kerningsOffset;
+        uint32_t skylineOffset;
+        uint32_t atlasNameOffset;
+        uint32_t atlasNameLength;
+        uint32_t sourceFontOffset;
+        uint32_t sourceFontLength;
+        uint32_t pagesOffset;
+    };
+
+    // in pixels
+    struct LetterRecord
+    {
+        uint32_t charCode;
+        float U;
+        float V;
+        float width;
+        float height;
+        float offsetX;
+        float offsetY;
+        int32_t page;
+        int32_t xAdvance;
+        uint32_t valid;
+    };
+
+    struct KerningRecord
+    {
+        uint32_t first;
+        uint32_t second;
+        int32_t amount;
+    };
+
+    /** What a file holds, the pages are the raw pixels of the atlas pixel format. */
+    struct Contents
+    {
+        std::string atlasName;
+        std::string sourceFont;
+        uint32_t flags        = 0;
+        int atlasWidth        = 0;
+        int atlasHeight       = 0;
+        int bytesPerPixel     = 1;
+        int faceSize          = 0;
+        float outlineSize     = 0.0f;
+        float lineHeight      = 0.0f;
+        int fontMaxHeight     = 0;
+        int fontAscender      = 0;
+        int letterPadding     = 0;
+        int letterEdgeExtend  = 0;
+        std::vector<LetterRecord> letters;
+        std::vector<KerningRecord> kernings;
+        std::vector<SkylinePacker::Segment> skyline;
+        std::vector<std::vector<uint8_t>> pages;
+    };
+
+    static FontPrebaked* create(std::string_view prebakedFile);
+    /** Validates the content of the view, nothing is copied. */
+    static FontPrebaked* createWithFileView(FileView view);
+
+    /** Serializes the contents, the letters and the kerning pairs are sorted. */
+    static std::vector<uint8_t> encode(const Contents& contents);
+
+    /**
+     * Renders the glyphs of the charset of the config (GlyphCollection ASCII, NEHE or CUSTOM) and writes them
+     * to a .axfa file, to be shipped with the game. The face size is scaled by the current content scale factor
+     * like labels do, so bake with the one the game runs with. Needs a Director, nothing is uploaded though.
+     */
+    static bool bake(const _ttfConfig& config,
+                     std::string_view outputFile,
+                     int atlasWidth  = 512,
+                     int atlasHeight = 512);
+
+    virtual FontAtlas* newFontAtlas() override;
+    virtual int* getHorizontalKerningForTextUTF32(const std::u32string& text, int& outNumLetters) const override;
+    virtual int getFontMaxHeight() const override { return _header->fontMaxHeight; }
+
+    const FileHeader& getHeader() const { return *_header; }
+    std::string_view getAtlasName() const { return _atlasName; }
+    std::string_view getSourceFontName() const { return _sourceFontName; }
+
+    std::span<const LetterRecord> getLetters() const { return _letters; }
+    std::span<const KerningRecord> getKernings() const { return _kernings; }
+    std::span<const SkylinePacker::Segment> getSkyline() const { return _skyline; }
+
+    int getPageCount() const { return static_cast<int>(_header->pageCount); }
+    size_t getPageSize() const;
+    const uint8_t* getPageData(int page) const;
+
+    const LetterRecord* findLetter(char32_t charCode) const;
+    int getKerning(char32_t first, char32_t second) const;
+
+    /** Opens the source font for the letters not baked, once, nullptr when it can't be opened. */
+    FontFreeType* getSourceFont();
+    bool isSourceFontOpen() const { return _sourceFont != nullptr; }
+
+protected:
+    FontPrebaked() = default;
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual ~FontPrebaked();
+
+    bool initWithFileView(FileView view);
+
+private:
+    FileView _view;
+    const FileHeader* _header = nullptr;
+    std::span<const LetterRecord> _letters;
+    std::span<const KerningRecord> _kernings;
+    std::span<const SkylinePacker::Segment> _skyline;
+    std::string_view _atlasName;
+    std::string_view _sourceFontName;
+
+    FontFreeType* _sourceFont = nullptr;
+    bool _sourceFontFailed    = false;
+};
+
+NS_AX_END
+
+/// @endcond
@@ -32,6 +32,7 @@
 #include "2d/Font.h"
 #include "2d/FontAtlasCache.h"
 #include "2d/FontAtlas.h"
+#include "2d/LabelLayoutCache.h"
 #include "2d/Sprite.h"
 #include "2d/SpriteBatchNode.h"
 #include "2d/DrawNode.h"
@@ -517,6 +518,9 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
     _purgeTextureListener = EventListenerCustom::create(FontAtlas::CMD_PURGE_FONTATLAS, [this](EventCustom* event) {
         if (_fontAtlas && _currentLabelType == LabelType::TTF && event->getUserData() == _fontAtlas)
         {
+            // the letters shown survive when the atlas purges to compact its pages
+            _fontAtlas->retainLetters(_utf32Text);
+
             for (auto&& it : _letters)
             {
                 it.second->setTexture(nullptr);
@@ -1090,6 +1094,9 @@ bool Label::alignText()
     do
     {
         _fontAtlas->prepareLetterDefinitions(_utf32Text);
+        _waitingForGlyphs = _fontAtlas->hasPendingGlyphs();
+        _glyphGeneration  = _fontAtlas->getGlyphGeneration();
+
         auto& textures = _fontAtlas->getTextures();
         auto size      = textures.size();
         if (size > static_cast<size_t>(_batchNodes.size()))
@@ -1122,13 +1129,69 @@ bool Label::alignText()
         _lengthOfString    = 0;
         _textDesiredHeight = 0.f;
         _linesWidth.clear();
-        if (_maxLineWidth > 0.f && !_lineBreakWithoutSpaces)
-        {
-            multilineTextWrapByWord();
+
+        // shrinking wraps again at smaller sizes, it isn't cached
+        const bool wrapByWord = _maxLineWidth > 0.f && !_lineBreakWithoutSpaces;
+        auto layoutCache      = _overflow != Overflow::SHRINK ? LabelLayoutCache::getInstance() : nullptr;
+        LabelLayoutCache::Key layoutKey;
+        const LabelLayoutCache::Layout* layout = nullptr;
+        if (layoutCache)
+        {
+            updateFontScale();
+            layoutKey.text               = _utf32Text;
+            layoutKey.atlas              = _fontAtlas;
+            layoutKey.glyphGeneration    = _glyphGeneration;
+            layoutKey.fontScale          = _fontScale;
+            layoutKey.lineHeight         = _lineHeight;
+            layoutKey.lineSpacing        = _lineSpacing;
+            layoutKey.additionalKerning  = _additionalKerning;
+            layoutKey.maxLineWidth       = _maxLineWidth;
+            layoutKey.labelWidth         = _labelWidth;
+            layoutKey.labelHeight        = _labelHeight;
+            layoutKey.contentScaleFactor = AX_CONTENT_SCALE_FACTOR();
+            layoutKey.overflow           = static_cast<int>(_overflow);
+            layoutKey.enableWrap         = _enableWrap;
+            layoutKey.wrapByWord         = wrapByWord;
+            layout                       = layoutCache->find(layoutKey);
+        }
+
+        if (layout)
+        {
+            getStringLength();
+            if (_lettersInfo.size() < layout->letters.size())
+                _lettersInfo.resize(layout->letters.size());
+            std::copy(layout->letters.begin(), layout->letters.end(), _lettersInfo.begin());
+            _linesWidth        = layout->linesWidth;
+            _numberOfLines     = layout->numberOfLines;
+            _textDesiredHeight = layout->textDesiredHeight;
+            _tailoredTopY      = layout->tailoredTopY;
+            _tailoredBottomY   = layout->tailoredBottomY;
+            setContentSize(layout->contentSize);
         }
         else
         {
-            multilineTextWrapByChar();
+            if (wrapByWord)
+            {
+                multilineTextWrapByWord();
+            }
+            else
+            {
+                multilineTextWrapByChar();
+            }
+
+            if (layoutCache)
+            {
+                LabelLayoutCache::Layout newLayout;
+                auto letterCount = (std::min)(_lettersInfo.size(), static_cast<size_t>(_lengthOfString));
+                newLayout.letters.assign(_lettersInfo.begin(), _lettersInfo.begin() + letterCount);
+                newLayout.linesWidth        = _linesWidth;
+                newLayout.numberOfLines     = _numberOfLines;
+                newLayout.textDesiredHeight = _textDesiredHeight;
+                newLayout.contentSize       = _contentSize;
+                newLayout.tailoredTopY      = _tailoredTopY;
+                newLayout.tailoredBottomY   = _tailoredBottomY;
+                layoutCache->insert(layoutKey, std::move(newLayout));
+            }
         }
         computeAlignmentOffset();
 
@@ -2037,6 +2100,10 @@ void Label::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t pare
         return;
     }
 
+    // the placeholders of the atlas were replaced by the real glyphs
+    if (_waitingForGlyphs && _fontAtlas && _fontAtlas->getGlyphGeneration() != _glyphGeneration)
+        _contentDirty = true;
+
     if (_systemFontDirty || _contentDirty)
     {
         // Label overflow shrink fix #566
@@ -734,6 +734,8 @@ public:
                      int maxLineWidth          = 0);
 
 protected:
+    friend class LabelLayoutCache;
+
     struct LetterInfo
     {
         char32_t utf32Char;
@@ -823,6 +825,9 @@ protected:
     void updateBatchCommand(BatchCommand& batch);
     
     bool _contentDirty;
+    // laid out with placeholders of glyphs the atlas was still rasterizing, at that glyph generation
+    bool _waitingForGlyphs        = false;
+    unsigned int _glyphGeneration = 0;
     bool _useDistanceField;
     bool _useA8Shader;
     bool _shadowDirty;
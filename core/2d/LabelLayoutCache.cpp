@@ -0,0 +1,175 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "2d/LabelLayoutCache.h"
+
+#include <functional>
+
+NS_AX_BEGIN
+
+static LabelLayoutCache* s_sharedLabelLayoutCache = nullptr;
+
+LabelLayoutCache* LabelLayoutCache::getInstance()
+{
+    if (!s_sharedLabelLayoutCache)
+        s_sharedLabelLayoutCache = new LabelLayoutCache();
+    return s_sharedLabelLayoutCache;
+}
+
+void LabelLayoutCache::destroyInstance()
+{
+    delete s_sharedLabelLayoutCache;
+    s_sharedLabelLayoutCache = nullptr;
+}
+
+template <typename _Ty>
+static inline void hashCombine(size_t& seed, const _Ty& value)
+{
+    seed ^= std::hash<_Ty>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+size_t LabelLayoutCache::hashKey(const Key& key)
+{
+    size_t seed = std::hash<std::u32string_view>{}(key.text);
+    hashCombine(seed, key.atlas);
+    hashCombine(seed, key.glyphGeneration);
+    hashCombine(seed, key.fontScale);
+    hashCombine(seed, key.lineHeight);
+    hashCombine(seed, key.lineSpacing);
+    hashCombine(seed, key.additionalKerning);
+    hashCombine(seed, key.maxLineWidth);
+    hashCombine(seed, key.labelWidth);
+    hashCombine(seed, key.labelHeight);
+    hashCombine(seed, key.contentScaleFactor);
+    hashCombine(seed, key.overflow);
+    hashCombine(seed, key.enableWrap);
+    hashCombine(seed, key.wrapByWord);
+    return seed;
+}
+
+bool LabelLayoutCache::equals(const Key& lhs, const Key& rhs)
+{
+    return lhs.atlas == rhs.atlas && lhs.glyphGeneration == rhs.glyphGeneration && lhs.fontScale == rhs.fontScale &&
+           lhs.lineHeight == rhs.lineHeight && lhs.lineSpacing == rhs.lineSpacing &&
+           lhs.additionalKerning == rhs.additionalKerning && lhs.maxLineWidth == rhs.maxLineWidth &&
+           lhs.labelWidth == rhs.labelWidth && lhs.labelHeight == rhs.labelHeight &&
+           lhs.contentScaleFactor == rhs.contentScaleFactor && lhs.overflow == rhs.overflow &&
+           lhs.enableWrap == rhs.enableWrap && lhs.wrapByWord == rhs.wrapByWord && lhs.text == rhs.text;
+}
+
+const LabelLayoutCache::Layout* LabelLayoutCache::find(const Key& key)
+{
+    if (_capacity == 0)
+        return nullptr;
+
+    auto range = _index.equal_range(hashKey(key));
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        auto entry = it->second;
+        if (equals(entry->key, key))
+        {
+            ++_hits;
+            _entries.splice(_entries.begin(), _entries, entry);
+            return &entry->layout;
+        }
+    }
+    ++_misses;
+    return nullptr;
+}
+
+void LabelLayoutCache::insert(const Key& key, Layout layout)
+{
+    if (_capacity == 0)
+        return;
+
+    const auto hash = hashKey(key);
+    auto range      = _index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        auto entry = it->second;
+        if (equals(entry->key, key))
+        {
+            entry->layout = std::move(layout);
+            _entries.splice(_entries.begin(), _entries, entry);
+            return;
+        }
+    }
+
+    evict(_capacity - 1);
+
+    _entries.emplace_front();
+    auto& entry    = _entries.front();
+    entry.text     = key.text;
+    entry.key      = key;
+    entry.key.text = entry.text;
+    entry.layout   = std::move(layout);
+    _index.emplace(hash, _entries.begin());
+}
+
+void LabelLayoutCache::evict(size_t capacity)
+{
+    while (_entries.size() > capacity)
+    {
+        auto last  = std::prev(_entries.end());
+        auto range = _index.equal_range(hashKey(last->key));
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == last)
+            {
+                _index.erase(it);
+                break;
+            }
+        }
+        _entries.pop_back();
+        ++_evictions;
+    }
+}
+
+void LabelLayoutCache::setCapacity(size_t capacity)
+{
+    _capacity = capacity;
+    evict(capacity);
+}
+
+void LabelLayoutCache::clear()
+{
+    _index.clear();
+    _entries.clear();
+}
+
+LabelLayoutCache::Stats LabelLayoutCache::getStats() const
+{
+    Stats stats;
+    stats.hits      = _hits;
+    stats.misses    = _misses;
+    stats.evictions = _evictions;
+    stats.entries   = _entries.size();
+    return stats;
+}
+
+void LabelLayoutCache::resetStats()
+{
+    _hits = _misses = _evictions = 0;
+}
+
+NS_AX_END
@@ -0,0 +1,129 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "2d/Label.h"
+
+NS_AX_BEGIN
+
+class FontAtlas;
+
+/**
+ * Caches the result of the Label text wrapping, process wide, main thread only.
+ *
+ * Shaping and wrapping a string is the costly part of Label::setString, UIs often cycle through a few known
+ * strings (timers, scores, toggled buttons), which are laid out once and then reused from the cache.
+ * A layout is keyed by the text and everything the wrapping reads: the atlas and its glyph generation, the font
+ * scale, the line metrics and the dimensions. The alignment offsets are cheap and computed on every use.
+ * The least recently used layouts are evicted past the capacity.
+ */
+class AX_DLL LabelLayoutCache
+{
+public:
+    struct Key
+    {
+        std::u32string_view text;
+        const FontAtlas* atlas       = nullptr;
+        unsigned int glyphGeneration = 0;
+        float fontScale              = 1.0f;
+        float lineHeight             = 0.0f;
+        float lineSpacing            = 0.0f;
+        float additionalKerning      = 0.0f;
+        float maxLineWidth           = 0.0f;
+        float labelWidth             = 0.0f;
+        float labelHeight            = 0.0f;
+        float contentScaleFactor     = 1.0f;
+        int overflow                 = 0;
+        bool enableWrap              = false;
+        bool wrapByWord              = false;
+    };
+
+    struct Layout
+    {
+        std::vector<Label::LetterInfo> letters;
+        std::vector<float> linesWidth;
+        int numberOfLines       = 0;
+        float textDesiredHeight = 0.0f;
+        Vec2 contentSize;
+        float tailoredTopY    = 0.0f;
+        float tailoredBottomY = 0.0f;
+    };
+
+    struct Stats
+    {
+        size_t hits      = 0;
+        size_t misses    = 0;
+        size_t evictions = 0;
+        size_t entries   = 0;
+    };
+
+    static constexpr size_t DEFAULT_CAPACITY = 128;
+
+    static LabelLayoutCache* getInstance();
+    static void destroyInstance();
+
+    /** Gets the layout of key, nullptr on a miss. The layout stays valid until the next insert or clear. */
+    const Layout* find(const Key& key);
+
+    /** Stores the layout of key, evicts the least recently used layouts past the capacity. */
+    void insert(const Key& key, Layout layout);
+
+    /** Sets the number of layouts kept, 0 disables the cache. */
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const { return _capacity; }
+
+    /** Removes all the layouts, the counters are kept. */
+    void clear();
+
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    struct Entry
+    {
+        std::u32string text;
+        Key key;  // its text views the entry's text
+        Layout layout;
+    };
+
+    static size_t hashKey(const Key& key);
+    static bool equals(const Key& lhs, const Key& rhs);
+
+    void evict(size_t capacity);
+
+    // most recently used first
+    std::list<Entry> _entries;
+    std::unordered_multimap<size_t, std::list<Entry>::iterator> _index;
+
+    size_t _capacity  = DEFAULT_CAPACITY;
+    size_t _hits      = 0;
+    size_t _misses    = 0;
+    size_t _evictions = 0;
+};
+
+NS_AX_END
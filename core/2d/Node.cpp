@@ -44,6 +44,7 @@ THE SOFTWARE.
 #include "2d/Scene.h"
 #include "2d/Component.h"
 #include "renderer/Material.h"
+#include "renderer/Renderer.h"
 #include "math/TransformUtils.h"
 #include "renderer/backend/ProgramManager.h"
 #include "renderer/backend/ProgramStateRegistry.h"
@@ -119,6 +120,7 @@ Node::Node()
     , _cascadeColorEnabled(false)
     , _cascadeOpacityEnabled(false)
     , _childFollowCameraMask(false)
+    , _concurrentVisitEnabled(false)
     , _cameraMask(1)
     , _onEnterCallback(nullptr)
     , _onExitCallback(nullptr)
@@ -1278,17 +1280,28 @@ void Node::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t paren
 
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
 
+    // the matrix stack isn't thread safe, it's not maintained while recording concurrently
+    const bool concurrentRecording = Renderer::getThreadRecordingQueue() != nullptr;
+
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
     // but it is deprecated and your code should not rely on it
-    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    if (!concurrentRecording)
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
 
     bool visibleByCamera = isVisitableByVisitingCamera();
 
     int i = 0;
 
-    if (!_children.empty())
+    if (_concurrentVisitEnabled && !concurrentRecording && _children.size() > 1)
+    {
+        sortAllChildren();
+        visitChildrenConcurrently(renderer, flags, visibleByCamera);
+    }
+    else if (!_children.empty())
     {
         sortAllChildren();
         // draw children zOrder < 0
@@ -1313,7 +1326,8 @@ void Node::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t paren
         this->draw(renderer, _modelViewTransform, flags);
     }
 
-    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (!concurrentRecording)
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -1321,6 +1335,66 @@ void Node::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t paren
     // _orderOfArrival = 0;
 }
 
+void Node::visitChildrenConcurrently(Renderer* renderer, uint32_t flags, bool visibleByCamera)
+{
+    // at most this many ranges of children on each side of the self draw
+    constexpr int MAX_RANGES_PER_SIDE = 32;
+
+    struct VisitRange
+    {
+        int first;
+        int last;  // exclusive
+    };
+
+    const int count      = static_cast<int>(_children.size());
+    int firstNonNegative = 0;
+    while (firstNonNegative < count && _children.at(firstNonNegative)->_localZOrder < 0)
+        ++firstNonNegative;
+
+    std::vector<VisitRange> ranges;
+    auto splitRanges = [&ranges](int first, int last) {
+        const int size  = last - first;
+        const int chunk = (size + MAX_RANGES_PER_SIDE - 1) / MAX_RANGES_PER_SIDE;
+        for (int i = first; i < last; i += chunk)
+            ranges.emplace_back(VisitRange{i, (std::min)(i + chunk, last)});
+    };
+    splitRanges(0, firstNonNegative);
+    const auto selfIndex = ranges.size();
+    splitRanges(firstNonNegative, count);
+
+    // the extra last queue records the self draw, which always happens on this thread
+    const int rangeCount = static_cast<int>(ranges.size());
+    auto queues          = renderer->beginConcurrentRecording(rangeCount + 1);
+
+    // update the lazily cached camera matrices now, culling reads them from every worker
+    if (auto camera = Camera::getVisitingCamera())
+        camera->getViewProjectionMatrix();
+
+    if (visibleByCamera)
+    {
+        Renderer::setThreadRecordingQueue(&queues[rangeCount]);
+        this->draw(renderer, _modelViewTransform, flags);
+        Renderer::setThreadRecordingQueue(nullptr);
+    }
+
+    const auto& children = _children;
+    const auto& transform = _modelViewTransform;
+    _director->getJobSystem()->parallel_for(0, rangeCount, 1, [&](size_t first, size_t last) {
+        for (auto index = first; index < last; ++index)
+        {
+            auto& range = ranges[index];
+            Renderer::setThreadRecordingQueue(&queues[index]);
+            for (int i = range.first; i < range.last; ++i)
+                children.at(i)->visit(renderer, transform, flags);
+            Renderer::setThreadRecordingQueue(nullptr);
+        }
+    });
+
+    // merge in serial visit order: children with localZOrder < 0, self, the others
+    std::rotate(queues.begin() + selfIndex, queues.end() - 1, queues.end());
+    renderer->endConcurrentRecording();
+}
+
 Mat4 Node::transform(const Mat4& parentTransform)
 {
     return parentTransform * this->getNodeToParentTransform();
@@ -1141,6 +1141,19 @@ public:
     virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit();
 
+    /**
+     * Sets whether the children of this node are visited concurrently on the JobSystem workers.
+     * Each worker records into a private RenderQueue, the queues are merged in children order,
+     * so the rendering result is the same as a serial visit.
+     * @note Only enable it for subtrees which are safe to visit from another thread: nodes pushing
+     * render groups (ClippingNode, RenderTexture...), adding callback commands or reading the
+     * deprecated Director matrix stack must not be part of them.
+     *
+     * @param enabled true to visit children concurrently, default is false.
+     */
+    void setConcurrentVisitEnabled(bool enabled) { _concurrentVisitEnabled = enabled; }
+    bool isConcurrentVisitEnabled() const { return _concurrentVisitEnabled; }
+
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
      This function recursively calls parent->getScene() until parent is a Scene object. The results are not cached. It
@@ -1877,6 +1890,7 @@ protected:
 
     Mat4 transform(const Mat4& parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
+    void visitChildrenConcurrently(Renderer* renderer, uint32_t flags, bool visibleByCamera);
 
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
@@ -2000,6 +2014,7 @@ protected:
     bool _normalizedPositionDirty;
     
     bool _childFollowCameraMask;
+    bool _concurrentVisitEnabled;
     // camera mask, it is visible only when _cameraMask & current camera' camera flag is true
     unsigned short _cameraMask;
 
@@ -0,0 +1,177 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/ParticleKernels.h"
+
+#include <stddef.h>  // offsetof
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+
+// USE_SSE  : the SSE2 kernels run the particles by four, the plain loops the rest
+// USE_NEON : the NEON kernels run the particles by four, the plain loops the rest
+
+#if defined(AX_USE_SSE)
+#    define USE_SSE
+#    include "2d/ParticleKernelsSSE.inl"
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#    define USE_NEON
+#    include "2d/ParticleKernelsNeon.inl"
+#endif
+
+#include "2d/ParticleKernels.inl"
+
+NS_AX_BEGIN
+
+#if defined(USE_SSE)
+using ParticleKernelsSIMD = ParticleKernelsSSE;
+#elif defined(USE_NEON)
+using ParticleKernelsSIMD = ParticleKernelsNeon;
+#endif
+
+void ParticleKernels::addScalar(float* dst, float value, int count)
+{
+    int first = 0;
+#if defined(USE_SSE) || defined(USE_NEON)
+    first = ParticleKernelsSIMD::addScalar(dst, value, count);
+#endif
+    ParticleKernelsC::addScalar(dst, value, first, count);
+}
+
+void ParticleKernels::addScalarClamped(float* dst, float value, const float* limit, int count)
+{
+    int first = 0;
+#if defined(USE_SSE) || defined(USE_NEON)
+    first = ParticleKernelsSIMD::addScalarClamped(dst, value, limit, count);
+#endif
+    ParticleKernelsC::addScalarClamped(dst, value, limit, first, count);
+}
+
+void ParticleKernels::addScaled(float* dst, const float* delta, float dt, int count)
+{
+    int first = 0;
+#if defined(USE_SSE) || defined(USE_NEON)
+    first = ParticleKernelsSIMD::addScaled(dst, delta, dt, count);
+#endif
+    ParticleKernelsC::addScaled(dst, delta, dt, first, count);
+}
+
+void ParticleKernels::addScaledNonNegative(float* dst, const float* delta, float dt, int count)
+{
+    int first = 0;
+#if defined(USE_SSE) || defined(USE_NEON)
+    first = ParticleKernelsSIMD::addScaledNonNegative(dst, delta, dt, count);
+#endif
+    ParticleKernelsC::addScaledNonNegative(dst, delta, dt, first, count);
+}
+
+int ParticleKernels::findDead(const float* timeToLive, int start, int count)
+{
+    int first = start;
+#if defined(USE_SSE) || defined(USE_NEON)
+    first = ParticleKernelsSIMD::findDead(timeToLive, start, count);
+#endif
+    return ParticleKernelsC::findDead(timeToLive, first, count);
+}
+
+void ParticleKernels::integrateGravity(float* posx,
+                                       float* posy,
+                                       float* dirX,
+                                       float* dirY,
+                                       const float* radialAccel,
+                                       const float* tangentialAccel,
+                                       float gravityX,
+                                       float gravityY,
+                                       float dt,
+                                       float yCoordFlipped,
+                                       int count)
+{
+    int first = 0;
+#if defined(USE_SSE) || defined(USE_NEON)
+    first = ParticleKernelsSIMD::integrateGravity(posx, posy, dirX, dirY, radialAccel, tangentialAccel, gravityX,
+                                                  gravityY, dt, yCoordFlipped, count);
+#endif
+    ParticleKernelsC::integrateGravity(posx, posy, dirX, dirY, radialAccel, tangentialAccel, gravityX, gravityY, dt,
+                                       yCoordFlipped, first, count);
+}
+
+void ParticleKernels::integrateRadius(float* posx,
+                                      float* posy,
+                                      float* angle,
+                                      float* radius,
+                                      const float* degreesPerSecond,
+                                      const float* deltaRadius,
+                                      float dt,
+                                      float yCoordFlipped,
+                                      int count)
+{
+    int first = 0;
+#if defined(USE_SSE) || defined(USE_NEON)
+    first = ParticleKernelsSIMD::integrateRadius(posx, posy, angle, radius, degreesPerSecond, deltaRadius, dt,
+                                                 yCoordFlipped, count);
+#endif
+    ParticleKernelsC::integrateRadius(posx, posy, angle, radius, degreesPerSecond, deltaRadius, dt, yCoordFlipped,
+                                      first, count);
+}
+
+void ParticleKernels::updateQuadVertices(V3F_C4B_T2F_Quad* quads,
+                                         const float* posx,
+                                         const float* posy,
+                                         const float* startPosX,
+                                         const float* startPosY,
+                                         const AffineTransform& startTransform,
+                                         const float* size,
+                                         const float* scale,
+                                         const float* rotation,
+                                         const float* staticRotation,
+                                         int count)
+{
+    int first = 0;
+#if defined(USE_SSE) || defined(USE_NEON)
+    first = ParticleKernelsSIMD::updateQuadVertices(quads, posx, posy, startPosX, startPosY, startTransform, size,
+                                                    scale, rotation, staticRotation, count);
+#endif
+    ParticleKernelsC::updateQuadVertices(quads, posx, posy, startPosX, startPosY, startTransform, size, scale, rotation,
+                                         staticRotation, first, count);
+}
+
+void ParticleKernels::updateQuadColors(V3F_C4B_T2F_Quad* quads,
+                                       const float* r,
+                                       const float* g,
+                                       const float* b,
+                                       const float* a,
+                                       const float* fadeInDelta,
+                                       const float* fadeInLength,
+                                       bool premultiplyAlpha,
+                                       int count)
+{
+    int first = 0;
+#if defined(USE_SSE) || defined(USE_NEON)
+    first =
+        ParticleKernelsSIMD::updateQuadColors(quads, r, g, b, a, fadeInDelta, fadeInLength, premultiplyAlpha, count);
+#endif
+    ParticleKernelsC::updateQuadColors(quads, r, g, b, a, fadeInDelta, fadeInLength, premultiplyAlpha, first, count);
+}
+
+NS_AX_END
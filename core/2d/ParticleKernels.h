@@ -0,0 +1,115 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/Types.h"
+#include "math/AffineTransform.h"
+
+NS_AX_BEGIN
+
+/**
+ * @brief The particle update loops, over the arrays of ParticleData.
+ *
+ * Each kernel runs four particles at a time with SSE or NEON when the engine is built with them, and plain loops
+ * otherwise. The arrays don't need to be aligned.
+ */
+class AX_DLL ParticleKernels
+{
+public:
+    /** dst[i] += value */
+    static void addScalar(float* dst, float value, int count);
+
+    /** dst[i] = min(dst[i] + value, limit[i]) */
+    static void addScalarClamped(float* dst, float value, const float* limit, int count);
+
+    /** dst[i] += delta[i] * dt */
+    static void addScaled(float* dst, const float* delta, float dt, int count);
+
+    /** dst[i] = max(dst[i] + delta[i] * dt, 0) */
+    static void addScaledNonNegative(float* dst, const float* delta, float dt, int count);
+
+    /** The index of the first particle from start whose time to live is over, count when there is none. */
+    static int findDead(const float* timeToLive, int start, int count);
+
+    /** Accelerate and move the particles of the gravity mode. */
+    static void integrateGravity(float* posx,
+                                 float* posy,
+                                 float* dirX,
+                                 float* dirY,
+                                 const float* radialAccel,
+                                 const float* tangentialAccel,
+                                 float gravityX,
+                                 float gravityY,
+                                 float dt,
+                                 float yCoordFlipped,
+                                 int count);
+
+    /** Turn and move the particles of the radius mode. */
+    static void integrateRadius(float* posx,
+                                float* posy,
+                                float* angle,
+                                float* radius,
+                                const float* degreesPerSecond,
+                                const float* deltaRadius,
+                                float dt,
+                                float yCoordFlipped,
+                                int count);
+
+    /**
+     * Set the vertices of the particle quads.
+     *
+     * A particle is centered on its position plus startTransform applied to its start position.
+     * @param scale The scale of each particle, nullptr for none.
+     */
+    static void updateQuadVertices(V3F_C4B_T2F_Quad* quads,
+                                   const float* posx,
+                                   const float* posy,
+                                   const float* startPosX,
+                                   const float* startPosY,
+                                   const AffineTransform& startTransform,
+                                   const float* size,
+                                   const float* scale,
+                                   const float* rotation,
+                                   const float* staticRotation,
+                                   int count);
+
+    /**
+     * Set the colors of the particle quads.
+     *
+     * @param fadeInDelta, fadeInLength The opacity fade in of each particle, nullptr for none.
+     * @param premultiplyAlpha Whether the color channels are multiplied by the alpha.
+     */
+    static void updateQuadColors(V3F_C4B_T2F_Quad* quads,
+                                 const float* r,
+                                 const float* g,
+                                 const float* b,
+                                 const float* a,
+                                 const float* fadeInDelta,
+                                 const float* fadeInLength,
+                                 bool premultiplyAlpha,
+                                 int count);
+};
+
+NS_AX_END
@@ -0,0 +1,253 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+NS_AX_BEGIN
+
+/*
+ * The plain loops, they run the particles from first to count which the vectorized kernels leave over.
+ */
+class ParticleKernelsC
+{
+public:
+    inline static void addScalar(float* dst, float value, int first, int count);
+
+    inline static void addScalarClamped(float* dst, float value, const float* limit, int first, int count);
+
+    inline static void addScaled(float* dst, const float* delta, float dt, int first, int count);
+
+    inline static void addScaledNonNegative(float* dst, const float* delta, float dt, int first, int count);
+
+    inline static int findDead(const float* timeToLive, int first, int count);
+
+    inline static void integrateGravity(float* posx,
+                                        float* posy,
+                                        float* dirX,
+                                        float* dirY,
+                                        const float* radialAccel,
+                                        const float* tangentialAccel,
+                                        float gravityX,
+                                        float gravityY,
+                                        float dt,
+                                        float yCoordFlipped,
+                                        int first,
+                                        int count);
+
+    inline static void integrateRadius(float* posx,
+                                       float* posy,
+                                       float* angle,
+                                       float* radius,
+                                       const float* degreesPerSecond,
+                                       const float* deltaRadius,
+                                       float dt,
+                                       float yCoordFlipped,
+                                       int first,
+                                       int count);
+
+    inline static void updateQuadVertices(V3F_C4B_T2F_Quad* quads,
+                                          const float* posx,
+                                          const float* posy,
+                                          const float* startPosX,
+                                          const float* startPosY,
+                                          const AffineTransform& startTransform,
+                                          const float* size,
+                                          const float* scale,
+                                          const float* rotation,
+                                          const float* staticRotation,
+                                          int first,
+                                          int count);
+
+    inline static void updateQuadColors(V3F_C4B_T2F_Quad* quads,
+                                        const float* r,
+                                        const float* g,
+                                        const float* b,
+                                        const float* a,
+                                        const float* fadeInDelta,
+                                        const float* fadeInLength,
+                                        bool premultiplyAlpha,
+                                        int first,
+                                        int count);
+
+    inline static uint8_t toColorByte(float value);
+};
+
+inline void ParticleKernelsC::addScalar(float* dst, float value, int first, int count)
+{
+    for (int i = first; i < count; ++i)
+        dst[i] += value;
+}
+
+inline void ParticleKernelsC::addScalarClamped(float* dst, float value, const float* limit, int first, int count)
+{
+    for (int i = first; i < count; ++i)
+        dst[i] = std::min(dst[i] + value, limit[i]);
+}
+
+inline void ParticleKernelsC::addScaled(float* dst, const float* delta, float dt, int first, int count)
+{
+    for (int i = first; i < count; ++i)
+        dst[i] += delta[i] * dt;
+}
+
+inline void ParticleKernelsC::addScaledNonNegative(float* dst, const float* delta, float dt, int first, int count)
+{
+    for (int i = first; i < count; ++i)
+        dst[i] = std::max(dst[i] + delta[i] * dt, 0.0f);
+}
+
+inline int ParticleKernelsC::findDead(const float* timeToLive, int first, int count)
+{
+    for (int i = first; i < count; ++i)
+    {
+        if (timeToLive[i] <= 0.0f)
+            return i;
+    }
+    return count;
+}
+
+inline void ParticleKernelsC::integrateGravity(float* posx,
+                                               float* posy,
+                                               float* dirX,
+                                               float* dirY,
+                                               const float* radialAccel,
+                                               const float* tangentialAccel,
+                                               float gravityX,
+                                               float gravityY,
+                                               float dt,
+                                               float yCoordFlipped,
+                                               int first,
+                                               int count)
+{
+    const float moveScale = dt * yCoordFlipped;
+    for (int i = first; i < count; ++i)
+    {
+        // the direction away from the emitter, zero on it
+        float lengthSq = posx[i] * posx[i] + posy[i] * posy[i];
+        float invLength = lengthSq > 0.0f ? 1.0f / std::sqrt(lengthSq) : 0.0f;
+        float nx        = posx[i] * invLength;
+        float ny        = posy[i] * invLength;
+
+        // (gravity + radial + tangential) * dt
+        float accelX = nx * radialAccel[i] - ny * tangentialAccel[i] + gravityX;
+        float accelY = ny * radialAccel[i] + nx * tangentialAccel[i] + gravityY;
+        dirX[i] += accelX * dt;
+        dirY[i] += accelY * dt;
+
+        posx[i] += dirX[i] * moveScale;
+        posy[i] += dirY[i] * moveScale;
+    }
+}
+
+inline void ParticleKernelsC::integrateRadius(float* posx,
+                                              float* posy,
+                                              float* angle,
+                                              float* radius,
+                                              const float* degreesPerSecond,
+                                              const float* deltaRadius,
+                                              float dt,
+                                              float yCoordFlipped,
+                                              int first,
+                                              int count)
+{
+    for (int i = first; i < count; ++i)
+    {
+        angle[i] += degreesPerSecond[i] * dt;
+        radius[i] += deltaRadius[i] * dt;
+        posx[i] = -cosf(angle[i]) * radius[i];
+        posy[i] = -sinf(angle[i]) * radius[i] * yCoordFlipped;
+    }
+}
+
+inline void ParticleKernelsC::updateQuadVertices(V3F_C4B_T2F_Quad* quads,
+                                                 const float* posx,
+                                                 const float* posy,
+                                                 const float* startPosX,
+                                                 const float* startPosY,
+                                                 const AffineTransform& startTransform,
+                                                 const float* size,
+                                                 const float* scale,
+                                                 const float* rotation,
+                                                 const float* staticRotation,
+                                                 int first,
+                                                 int count)
+{
+    const AffineTransform& t = startTransform;
+    for (int i = first; i < count; ++i)
+    {
+        float x = posx[i] + (t.a * startPosX[i] + t.c * startPosY[i] + t.tx);
+        float y = posy[i] + (t.b * startPosX[i] + t.d * startPosY[i] + t.ty);
+
+        float half = size[i] * 0.5f;
+        if (scale)
+            half *= scale[i];
+
+        float r  = -AX_DEGREES_TO_RADIANS(rotation[i] + staticRotation[i]);
+        float hc = half * cosf(r);
+        float hs = half * sinf(r);
+
+        V3F_C4B_T2F_Quad& quad = quads[i];
+        quad.bl.vertices.x     = x - hc + hs;
+        quad.bl.vertices.y     = y - hs - hc;
+        quad.br.vertices.x     = x + hc + hs;
+        quad.br.vertices.y     = y + hs - hc;
+        quad.tl.vertices.x     = x - hc - hs;
+        quad.tl.vertices.y     = y - hs + hc;
+        quad.tr.vertices.x     = x + hc - hs;
+        quad.tr.vertices.y     = y + hs + hc;
+    }
+}
+
+inline void ParticleKernelsC::updateQuadColors(V3F_C4B_T2F_Quad* quads,
+                                               const float* r,
+                                               const float* g,
+                                               const float* b,
+                                               const float* a,
+                                               const float* fadeInDelta,
+                                               const float* fadeInLength,
+                                               bool premultiplyAlpha,
+                                               int first,
+                                               int count)
+{
+    for (int i = first; i < count; ++i)
+    {
+        float rgbScale = premultiplyAlpha ? a[i] * 255.0f : 255.0f;
+        float alpha    = fadeInDelta ? a[i] * (fadeInDelta[i] / fadeInLength[i]) : a[i];
+
+        Color4B color(toColorByte(r[i] * rgbScale), toColorByte(g[i] * rgbScale), toColorByte(b[i] * rgbScale),
+                      toColorByte(alpha * 255.0f));
+
+        V3F_C4B_T2F_Quad& quad = quads[i];
+        quad.bl.colors         = color;
+        quad.br.colors         = color;
+        quad.tl.colors         = color;
+        quad.tr.colors         = color;
+    }
+}
+
+inline uint8_t ParticleKernelsC::toColorByte(float value)
+{
+    // saturate like the vectorized kernels do, a color animated past 1 must not wrap around and NaN is 0
+    return value > 0.0f ? static_cast<uint8_t>(std::min(value, 255.0f)) : 0;
+}
+
+NS_AX_END
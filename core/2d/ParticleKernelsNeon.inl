@@ -0,0 +1,392 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <arm_neon.h>
+
+NS_AX_BEGIN
+
+/*
+ * The NEON kernels, four particles a step. Each returns the index of the first particle it didn't run.
+ */
+class ParticleKernelsNeon
+{
+public:
+    inline static int addScalar(float* dst, float value, int count);
+
+    inline static int addScalarClamped(float* dst, float value, const float* limit, int count);
+
+    inline static int addScaled(float* dst, const float* delta, float dt, int count);
+
+    inline static int addScaledNonNegative(float* dst, const float* delta, float dt, int count);
+
+    inline static int findDead(const float* timeToLive, int start, int count);
+
+    inline static int integrateGravity(float* posx,
+                                       float* posy,
+                                       float* dirX,
+                                       float* dirY,
+                                       const float* radialAccel,
+                                       const float* tangentialAccel,
+                                       float gravityX,
+                                       float gravityY,
+                                       float dt,
+                                       float yCoordFlipped,
+                                       int count);
+
+    inline static int integrateRadius(float* posx,
+                                      float* posy,
+                                      float* angle,
+                                      float* radius,
+                                      const float* degreesPerSecond,
+                                      const float* deltaRadius,
+                                      float dt,
+                                      float yCoordFlipped,
+                                      int count);
+
+    inline static int updateQuadVertices(V3F_C4B_T2F_Quad* quads,
+                                         const float* posx,
+                                         const float* posy,
+                                         const float* startPosX,
+                                         const float* startPosY,
+                                         const AffineTransform& startTransform,
+                                         const float* size,
+                                         const float* scale,
+                                         const float* rotation,
+                                         const float* staticRotation,
+                                         int count);
+
+    inline static int updateQuadColors(V3F_C4B_T2F_Quad* quads,
+                                       const float* r,
+                                       const float* g,
+                                       const float* b,
+                                       const float* a,
+                                       const float* fadeInDelta,
+                                       const float* fadeInLength,
+                                       bool premultiplyAlpha,
+                                       int count);
+
+    /* sin and cos of four angles, the cephes polynomials as in neon_mathfun */
+    inline static void sincos(float32x4_t x, float32x4_t& s, float32x4_t& c);
+
+    /* armv7 has no vector division nor square root, two newton steps on the estimates are float precise */
+    inline static float32x4_t divide(float32x4_t a, float32x4_t b);
+
+    inline static float32x4_t invSqrt(float32x4_t x);
+
+    inline static void storeCorners(V3F_C4B_T2F_Quad* quads, size_t offset, float32x4_t x, float32x4_t y);
+};
+
+inline int ParticleKernelsNeon::addScalar(float* dst, float value, int count)
+{
+    const float32x4_t v = vdupq_n_f32(value);
+    int i               = 0;
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), v));
+    return i;
+}
+
+inline int ParticleKernelsNeon::addScalarClamped(float* dst, float value, const float* limit, int count)
+{
+    const float32x4_t v = vdupq_n_f32(value);
+    int i               = 0;
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(dst + i, vminq_f32(vaddq_f32(vld1q_f32(dst + i), v), vld1q_f32(limit + i)));
+    return i;
+}
+
+inline int ParticleKernelsNeon::addScaled(float* dst, const float* delta, float dt, int count)
+{
+    const float32x4_t t = vdupq_n_f32(dt);
+    int i               = 0;
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vmulq_f32(vld1q_f32(delta + i), t)));
+    return i;
+}
+
+inline int ParticleKernelsNeon::addScaledNonNegative(float* dst, const float* delta, float dt, int count)
+{
+    const float32x4_t t    = vdupq_n_f32(dt);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    int i                  = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t v = vaddq_f32(vld1q_f32(dst + i), vmulq_f32(vld1q_f32(delta + i), t));
+        vst1q_f32(dst + i, vmaxq_f32(v, zero));
+    }
+    return i;
+}
+
+inline int ParticleKernelsNeon::findDead(const float* timeToLive, int start, int count)
+{
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    int i                  = start;
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32x4_t dead    = vcleq_f32(vld1q_f32(timeToLive + i), zero);
+        uint32x2_t anyDead = vorr_u32(vget_low_u32(dead), vget_high_u32(dead));
+        if (vget_lane_u32(vpmax_u32(anyDead, anyDead), 0))
+        {
+            while (timeToLive[i] > 0.0f)
+                ++i;
+            return i;
+        }
+    }
+    return i;
+}
+
+inline int ParticleKernelsNeon::integrateGravity(float* posx,
+                                                 float* posy,
+                                                 float* dirX,
+                                                 float* dirY,
+                                                 const float* radialAccel,
+                                                 const float* tangentialAccel,
+                                                 float gravityX,
+                                                 float gravityY,
+                                                 float dt,
+                                                 float yCoordFlipped,
+                                                 int count)
+{
+    const float32x4_t zero      = vdupq_n_f32(0.0f);
+    const float32x4_t gx        = vdupq_n_f32(gravityX);
+    const float32x4_t gy        = vdupq_n_f32(gravityY);
+    const float32x4_t t         = vdupq_n_f32(dt);
+    const float32x4_t moveScale = vdupq_n_f32(dt * yCoordFlipped);
+    int i                       = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t x = vld1q_f32(posx + i);
+        float32x4_t y = vld1q_f32(posy + i);
+
+        // the direction away from the emitter, zero on it
+        float32x4_t lengthSq = vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y));
+        uint32x4_t away      = vandq_u32(vreinterpretq_u32_f32(invSqrt(lengthSq)), vcgtq_f32(lengthSq, zero));
+        float32x4_t nx       = vmulq_f32(x, vreinterpretq_f32_u32(away));
+        float32x4_t ny       = vmulq_f32(y, vreinterpretq_f32_u32(away));
+
+        float32x4_t radial     = vld1q_f32(radialAccel + i);
+        float32x4_t tangential = vld1q_f32(tangentialAccel + i);
+        float32x4_t accelX     = vaddq_f32(vsubq_f32(vmulq_f32(nx, radial), vmulq_f32(ny, tangential)), gx);
+        float32x4_t accelY     = vaddq_f32(vaddq_f32(vmulq_f32(ny, radial), vmulq_f32(nx, tangential)), gy);
+
+        float32x4_t dx = vaddq_f32(vld1q_f32(dirX + i), vmulq_f32(accelX, t));
+        float32x4_t dy = vaddq_f32(vld1q_f32(dirY + i), vmulq_f32(accelY, t));
+        vst1q_f32(dirX + i, dx);
+        vst1q_f32(dirY + i, dy);
+
+        vst1q_f32(posx + i, vaddq_f32(x, vmulq_f32(dx, moveScale)));
+        vst1q_f32(posy + i, vaddq_f32(y, vmulq_f32(dy, moveScale)));
+    }
+    return i;
+}
+
+inline int ParticleKernelsNeon::integrateRadius(float* posx,
+                                                float* posy,
+                                                float* angle,
+                                                float* radius,
+                                                const float* degreesPerSecond,
+                                                const float* deltaRadius,
+                                                float dt,
+                                                float yCoordFlipped,
+                                                int count)
+{
+    const float32x4_t t     = vdupq_n_f32(dt);
+    const float32x4_t flipY = vdupq_n_f32(-yCoordFlipped);
+    int i                   = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t a = vaddq_f32(vld1q_f32(angle + i), vmulq_f32(vld1q_f32(degreesPerSecond + i), t));
+        float32x4_t r = vaddq_f32(vld1q_f32(radius + i), vmulq_f32(vld1q_f32(deltaRadius + i), t));
+        vst1q_f32(angle + i, a);
+        vst1q_f32(radius + i, r);
+
+        float32x4_t s, c;
+        sincos(a, s, c);
+        vst1q_f32(posx + i, vnegq_f32(vmulq_f32(c, r)));
+        vst1q_f32(posy + i, vmulq_f32(vmulq_f32(s, r), flipY));
+    }
+    return i;
+}
+
+inline int ParticleKernelsNeon::updateQuadVertices(V3F_C4B_T2F_Quad* quads,
+                                                   const float* posx,
+                                                   const float* posy,
+                                                   const float* startPosX,
+                                                   const float* startPosY,
+                                                   const AffineTransform& startTransform,
+                                                   const float* size,
+                                                   const float* scale,
+                                                   const float* rotation,
+                                                   const float* staticRotation,
+                                                   int count)
+{
+    const float32x4_t ta = vdupq_n_f32(startTransform.a);
+    const float32x4_t tb = vdupq_n_f32(startTransform.b);
+    const float32x4_t tc = vdupq_n_f32(startTransform.c);
+    const float32x4_t td = vdupq_n_f32(startTransform.d);
+    const float32x4_t tx = vdupq_n_f32(startTransform.tx);
+    const float32x4_t ty = vdupq_n_f32(startTransform.ty);
+    int i                = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t sx      = vld1q_f32(startPosX + i);
+        float32x4_t sy      = vld1q_f32(startPosY + i);
+        float32x4_t offsetX = vaddq_f32(vaddq_f32(vmulq_f32(ta, sx), vmulq_f32(tc, sy)), tx);
+        float32x4_t offsetY = vaddq_f32(vaddq_f32(vmulq_f32(tb, sx), vmulq_f32(td, sy)), ty);
+        float32x4_t x       = vaddq_f32(vld1q_f32(posx + i), offsetX);
+        float32x4_t y       = vaddq_f32(vld1q_f32(posy + i), offsetY);
+
+        float32x4_t extent = vmulq_n_f32(vld1q_f32(size + i), 0.5f);
+        if (scale)
+            extent = vmulq_f32(extent, vld1q_f32(scale + i));
+
+        float32x4_t s, c;
+        sincos(vmulq_n_f32(vaddq_f32(vld1q_f32(rotation + i), vld1q_f32(staticRotation + i)), -0.01745329252f), s, c);
+        float32x4_t hc = vmulq_f32(extent, c);
+        float32x4_t hs = vmulq_f32(extent, s);
+
+        float32x4_t xMinusHc = vsubq_f32(x, hc);
+        float32x4_t xPlusHc  = vaddq_f32(x, hc);
+        float32x4_t yMinusHs = vsubq_f32(y, hs);
+        float32x4_t yPlusHs  = vaddq_f32(y, hs);
+        storeCorners(quads + i, offsetof(V3F_C4B_T2F_Quad, bl), vaddq_f32(xMinusHc, hs), vsubq_f32(yMinusHs, hc));
+        storeCorners(quads + i, offsetof(V3F_C4B_T2F_Quad, br), vaddq_f32(xPlusHc, hs), vsubq_f32(yPlusHs, hc));
+        storeCorners(quads + i, offsetof(V3F_C4B_T2F_Quad, tl), vsubq_f32(xMinusHc, hs), vaddq_f32(yMinusHs, hc));
+        storeCorners(quads + i, offsetof(V3F_C4B_T2F_Quad, tr), vsubq_f32(xPlusHc, hs), vaddq_f32(yPlusHs, hc));
+    }
+    return i;
+}
+
+inline int ParticleKernelsNeon::updateQuadColors(V3F_C4B_T2F_Quad* quads,
+                                                 const float* r,
+                                                 const float* g,
+                                                 const float* b,
+                                                 const float* a,
+                                                 const float* fadeInDelta,
+                                                 const float* fadeInLength,
+                                                 bool premultiplyAlpha,
+                                                 int count)
+{
+    const float32x4_t byteScale = vdupq_n_f32(255.0f);
+    uint32_t colors[4];
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t alpha    = vld1q_f32(a + i);
+        float32x4_t rgbScale = premultiplyAlpha ? vmulq_f32(alpha, byteScale) : byteScale;
+        if (fadeInDelta)
+            alpha = vmulq_f32(alpha, divide(vld1q_f32(fadeInDelta + i), vld1q_f32(fadeInLength + i)));
+
+        // saturate to 0..255 and truncate like a float to byte cast, the unsigned conversion turns NaN to 0
+        uint32x4_t cr = vcvtq_u32_f32(vminq_f32(vmulq_f32(vld1q_f32(r + i), rgbScale), byteScale));
+        uint32x4_t cg = vcvtq_u32_f32(vminq_f32(vmulq_f32(vld1q_f32(g + i), rgbScale), byteScale));
+        uint32x4_t cb = vcvtq_u32_f32(vminq_f32(vmulq_f32(vld1q_f32(b + i), rgbScale), byteScale));
+        uint32x4_t ca = vcvtq_u32_f32(vminq_f32(vmulq_f32(alpha, byteScale), byteScale));
+
+        uint32x4_t rg = vorrq_u32(cr, vshlq_n_u32(cg, 8));
+        uint32x4_t ba = vorrq_u32(vshlq_n_u32(cb, 16), vshlq_n_u32(ca, 24));
+        vst1q_u32(colors, vorrq_u32(rg, ba));
+
+        for (int k = 0; k < 4; ++k)
+        {
+            V3F_C4B_T2F_Quad& quad = quads[i + k];
+            memcpy(&quad.bl.colors, &colors[k], sizeof(uint32_t));
+            memcpy(&quad.br.colors, &colors[k], sizeof(uint32_t));
+            memcpy(&quad.tl.colors, &colors[k], sizeof(uint32_t));
+            memcpy(&quad.tr.colors, &colors[k], sizeof(uint32_t));
+        }
+    }
+    return i;
+}
+
+inline void ParticleKernelsNeon::sincos(float32x4_t x, float32x4_t& s, float32x4_t& c)
+{
+    uint32x4_t signSin = vcltq_f32(x, vdupq_n_f32(0.0f));
+    x                  = vabsq_f32(x);
+
+    // the octant, rounded up to even, and the angle reduced into -pi/4..pi/4
+    uint32x4_t j  = vcvtq_u32_f32(vmulq_n_f32(x, 1.27323954473516f));
+    j             = vandq_u32(vaddq_u32(j, vdupq_n_u32(1)), vdupq_n_u32(~1u));
+    float32x4_t y = vcvtq_f32_u32(j);
+    x             = vaddq_f32(x, vmulq_n_f32(y, -0.78515625f));
+    x             = vaddq_f32(x, vmulq_n_f32(y, -2.4187564849853515625e-4f));
+    x             = vaddq_f32(x, vmulq_n_f32(y, -3.77489497744594108e-8f));
+
+    signSin               = veorq_u32(signSin, vtstq_u32(j, vdupq_n_u32(4)));
+    uint32x4_t signCos    = vtstq_u32(vsubq_u32(j, vdupq_n_u32(2)), vdupq_n_u32(4));
+    uint32x4_t useCosPoly = vtstq_u32(j, vdupq_n_u32(2));
+
+    float32x4_t z = vmulq_f32(x, x);
+
+    float32x4_t cosPoly = vdupq_n_f32(2.443315711809948e-5f);
+    cosPoly             = vaddq_f32(vmulq_f32(cosPoly, z), vdupq_n_f32(-1.388731625493765e-3f));
+    cosPoly             = vaddq_f32(vmulq_f32(cosPoly, z), vdupq_n_f32(4.166664568298827e-2f));
+    cosPoly             = vmulq_f32(vmulq_f32(cosPoly, z), z);
+    cosPoly             = vaddq_f32(vsubq_f32(cosPoly, vmulq_n_f32(z, 0.5f)), vdupq_n_f32(1.0f));
+
+    float32x4_t sinPoly = vdupq_n_f32(-1.9515295891e-4f);
+    sinPoly             = vaddq_f32(vmulq_f32(sinPoly, z), vdupq_n_f32(8.3321608736e-3f));
+    sinPoly             = vaddq_f32(vmulq_f32(sinPoly, z), vdupq_n_f32(-1.6666654611e-1f));
+    sinPoly             = vaddq_f32(vmulq_f32(vmulq_f32(sinPoly, z), x), x);
+
+    float32x4_t sinValue = vbslq_f32(useCosPoly, cosPoly, sinPoly);
+    float32x4_t cosValue = vbslq_f32(useCosPoly, sinPoly, cosPoly);
+    s                    = vbslq_f32(signSin, vnegq_f32(sinValue), sinValue);
+    c                    = vbslq_f32(signCos, cosValue, vnegq_f32(cosValue));
+}
+
+inline float32x4_t ParticleKernelsNeon::divide(float32x4_t a, float32x4_t b)
+{
+#if defined(__aarch64__)
+    return vdivq_f32(a, b);
+#else
+    float32x4_t inv = vrecpeq_f32(b);
+    inv             = vmulq_f32(vrecpsq_f32(b, inv), inv);
+    inv             = vmulq_f32(vrecpsq_f32(b, inv), inv);
+    return vmulq_f32(a, inv);
+#endif
+}
+
+inline float32x4_t ParticleKernelsNeon::invSqrt(float32x4_t x)
+{
+#if defined(__aarch64__)
+    return vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(x));
+#else
+    float32x4_t inv = vrsqrteq_f32(x);
+    inv             = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, inv), inv), inv);
+    inv             = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, inv), inv), inv);
+    return inv;
+#endif
+}
+
+inline void ParticleKernelsNeon::storeCorners(V3F_C4B_T2F_Quad* quads, size_t offset, float32x4_t x, float32x4_t y)
+{
+    float32x4x2_t xy = vzipq_f32(x, y);  // x0 y0 x1 y1, x2 y2 x3 y3
+    auto* base       = reinterpret_cast<char*>(quads) + offset;
+    vst1_f32(reinterpret_cast<float*>(base), vget_low_f32(xy.val[0]));
+    vst1_f32(reinterpret_cast<float*>(base + sizeof(V3F_C4B_T2F_Quad)), vget_high_f32(xy.val[0]));
+    vst1_f32(reinterpret_cast<float*>(base + 2 * sizeof(V3F_C4B_T2F_Quad)), vget_low_f32(xy.val[1]));
+    vst1_f32(reinterpret_cast<float*>(base + 3 * sizeof(V3F_C4B_T2F_Quad)), vget_high_f32(xy.val[1]));
+}
+
+NS_AX_END
@@ -0,0 +1,377 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <emmintrin.h>
+
+NS_AX_BEGIN
+
+/*
+ * The SSE2 kernels, four particles a step. Each returns the index of the first particle it didn't run.
+ */
+class ParticleKernelsSSE
+{
+public:
+    inline static int addScalar(float* dst, float value, int count);
+
+    inline static int addScalarClamped(float* dst, float value, const float* limit, int count);
+
+    inline static int addScaled(float* dst, const float* delta, float dt, int count);
+
+    inline static int addScaledNonNegative(float* dst, const float* delta, float dt, int count);
+
+    inline static int findDead(const float* timeToLive, int start, int count);
+
+    inline static int integrateGravity(float* posx,
+                                       float* posy,
+                                       float* dirX,
+                                       float* dirY,
+                                       const float* radialAccel,
+                                       const float* tangentialAccel,
+                                       float gravityX,
+                                       float gravityY,
+                                       float dt,
+                                       float yCoordFlipped,
+                                       int count);
+
+    inline static int integrateRadius(float* posx,
+                                      float* posy,
+                                      float* angle,
+                                      float* radius,
+                                      const float* degreesPerSecond,
+                                      const float* deltaRadius,
+                                      float dt,
+                                      float yCoordFlipped,
+                                      int count);
+
+    inline static int updateQuadVertices(V3F_C4B_T2F_Quad* quads,
+                                         const float* posx,
+                                         const float* posy,
+                                         const float* startPosX,
+                                         const float* startPosY,
+                                         const AffineTransform& startTransform,
+                                         const float* size,
+                                         const float* scale,
+                                         const float* rotation,
+                                         const float* staticRotation,
+                                         int count);
+
+    inline static int updateQuadColors(V3F_C4B_T2F_Quad* quads,
+                                       const float* r,
+                                       const float* g,
+                                       const float* b,
+                                       const float* a,
+                                       const float* fadeInDelta,
+                                       const float* fadeInLength,
+                                       bool premultiplyAlpha,
+                                       int count);
+
+    /* sin and cos of four angles, the cephes polynomials as in sse_mathfun */
+    inline static void sincos(__m128 x, __m128& s, __m128& c);
+
+    inline static void storeCorners(V3F_C4B_T2F_Quad* quads, size_t offset, __m128 x, __m128 y);
+};
+
+inline int ParticleKernelsSSE::addScalar(float* dst, float value, int count)
+{
+    const __m128 v = _mm_set1_ps(value);
+    int i          = 0;
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), v));
+    return i;
+}
+
+inline int ParticleKernelsSSE::addScalarClamped(float* dst, float value, const float* limit, int count)
+{
+    const __m128 v = _mm_set1_ps(value);
+    int i          = 0;
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(dst + i, _mm_min_ps(_mm_add_ps(_mm_loadu_ps(dst + i), v), _mm_loadu_ps(limit + i)));
+    return i;
+}
+
+inline int ParticleKernelsSSE::addScaled(float* dst, const float* delta, float dt, int count)
+{
+    const __m128 t = _mm_set1_ps(dt);
+    int i          = 0;
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(delta + i), t)));
+    return i;
+}
+
+inline int ParticleKernelsSSE::addScaledNonNegative(float* dst, const float* delta, float dt, int count)
+{
+    const __m128 t    = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    int i             = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(delta + i), t));
+        _mm_storeu_ps(dst + i, _mm_max_ps(v, zero));
+    }
+    return i;
+}
+
+inline int ParticleKernelsSSE::findDead(const float* timeToLive, int start, int count)
+{
+    const __m128 zero = _mm_setzero_ps();
+    int i             = start;
+    for (; i + 4 <= count; i += 4)
+    {
+        int dead = _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(timeToLive + i), zero));
+        if (dead)
+        {
+            while (!(dead & 1))
+            {
+                dead >>= 1;
+                ++i;
+            }
+            return i;
+        }
+    }
+    return i;
+}
+
+inline int ParticleKernelsSSE::integrateGravity(float* posx,
+                                                float* posy,
+                                                float* dirX,
+                                                float* dirY,
+                                                const float* radialAccel,
+                                                const float* tangentialAccel,
+                                                float gravityX,
+                                                float gravityY,
+                                                float dt,
+                                                float yCoordFlipped,
+                                                int count)
+{
+    const __m128 zero      = _mm_setzero_ps();
+    const __m128 one       = _mm_set1_ps(1.0f);
+    const __m128 gx        = _mm_set1_ps(gravityX);
+    const __m128 gy        = _mm_set1_ps(gravityY);
+    const __m128 t         = _mm_set1_ps(dt);
+    const __m128 moveScale = _mm_set1_ps(dt * yCoordFlipped);
+    int i                  = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(posx + i);
+        __m128 y = _mm_loadu_ps(posy + i);
+
+        // the direction away from the emitter, zero on it
+        __m128 lengthSq  = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+        __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+        invLength        = _mm_and_ps(invLength, _mm_cmpgt_ps(lengthSq, zero));
+        __m128 nx        = _mm_mul_ps(x, invLength);
+        __m128 ny        = _mm_mul_ps(y, invLength);
+
+        __m128 radial     = _mm_loadu_ps(radialAccel + i);
+        __m128 tangential = _mm_loadu_ps(tangentialAccel + i);
+        __m128 accelX     = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(nx, radial), _mm_mul_ps(ny, tangential)), gx);
+        __m128 accelY     = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ny, radial), _mm_mul_ps(nx, tangential)), gy);
+
+        __m128 dx = _mm_add_ps(_mm_loadu_ps(dirX + i), _mm_mul_ps(accelX, t));
+        __m128 dy = _mm_add_ps(_mm_loadu_ps(dirY + i), _mm_mul_ps(accelY, t));
+        _mm_storeu_ps(dirX + i, dx);
+        _mm_storeu_ps(dirY + i, dy);
+
+        _mm_storeu_ps(posx + i, _mm_add_ps(x, _mm_mul_ps(dx, moveScale)));
+        _mm_storeu_ps(posy + i, _mm_add_ps(y, _mm_mul_ps(dy, moveScale)));
+    }
+    return i;
+}
+
+inline int ParticleKernelsSSE::integrateRadius(float* posx,
+                                               float* posy,
+                                               float* angle,
+                                               float* radius,
+                                               const float* degreesPerSecond,
+                                               const float* deltaRadius,
+                                               float dt,
+                                               float yCoordFlipped,
+                                               int count)
+{
+    const __m128 t     = _mm_set1_ps(dt);
+    const __m128 flipX = _mm_set1_ps(-1.0f);
+    const __m128 flipY = _mm_set1_ps(-yCoordFlipped);
+    int i              = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(angle + i), _mm_mul_ps(_mm_loadu_ps(degreesPerSecond + i), t));
+        __m128 r = _mm_add_ps(_mm_loadu_ps(radius + i), _mm_mul_ps(_mm_loadu_ps(deltaRadius + i), t));
+        _mm_storeu_ps(angle + i, a);
+        _mm_storeu_ps(radius + i, r);
+
+        __m128 s, c;
+        sincos(a, s, c);
+        _mm_storeu_ps(posx + i, _mm_mul_ps(_mm_mul_ps(c, r), flipX));
+        _mm_storeu_ps(posy + i, _mm_mul_ps(_mm_mul_ps(s, r), flipY));
+    }
+    return i;
+}
+
+inline int ParticleKernelsSSE::updateQuadVertices(V3F_C4B_T2F_Quad* quads,
+                                                  const float* posx,
+                                                  const float* posy,
+                                                  const float* startPosX,
+                                                  const float* startPosY,
+                                                  const AffineTransform& startTransform,
+                                                  const float* size,
+                                                  const float* scale,
+                                                  const float* rotation,
+                                                  const float* staticRotation,
+                                                  int count)
+{
+    const __m128 ta       = _mm_set1_ps(startTransform.a);
+    const __m128 tb       = _mm_set1_ps(startTransform.b);
+    const __m128 tc       = _mm_set1_ps(startTransform.c);
+    const __m128 td       = _mm_set1_ps(startTransform.d);
+    const __m128 tx       = _mm_set1_ps(startTransform.tx);
+    const __m128 ty       = _mm_set1_ps(startTransform.ty);
+    const __m128 half     = _mm_set1_ps(0.5f);
+    const __m128 toRadian = _mm_set1_ps(-0.01745329252f);
+    int i                 = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 sx = _mm_loadu_ps(startPosX + i);
+        __m128 sy = _mm_loadu_ps(startPosY + i);
+        __m128 offsetX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ta, sx), _mm_mul_ps(tc, sy)), tx);
+        __m128 offsetY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tb, sx), _mm_mul_ps(td, sy)), ty);
+        __m128 x       = _mm_add_ps(_mm_loadu_ps(posx + i), offsetX);
+        __m128 y       = _mm_add_ps(_mm_loadu_ps(posy + i), offsetY);
+
+        __m128 extent = _mm_mul_ps(_mm_loadu_ps(size + i), half);
+        if (scale)
+            extent = _mm_mul_ps(extent, _mm_loadu_ps(scale + i));
+
+        __m128 s, c;
+        sincos(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(rotation + i), _mm_loadu_ps(staticRotation + i)), toRadian), s, c);
+        __m128 hc = _mm_mul_ps(extent, c);
+        __m128 hs = _mm_mul_ps(extent, s);
+
+        __m128 xMinusHc = _mm_sub_ps(x, hc);
+        __m128 xPlusHc  = _mm_add_ps(x, hc);
+        __m128 yMinusHs = _mm_sub_ps(y, hs);
+        __m128 yPlusHs  = _mm_add_ps(y, hs);
+        storeCorners(quads + i, offsetof(V3F_C4B_T2F_Quad, bl), _mm_add_ps(xMinusHc, hs), _mm_sub_ps(yMinusHs, hc));
+        storeCorners(quads + i, offsetof(V3F_C4B_T2F_Quad, br), _mm_add_ps(xPlusHc, hs), _mm_sub_ps(yPlusHs, hc));
+        storeCorners(quads + i, offsetof(V3F_C4B_T2F_Quad, tl), _mm_sub_ps(xMinusHc, hs), _mm_add_ps(yMinusHs, hc));
+        storeCorners(quads + i, offsetof(V3F_C4B_T2F_Quad, tr), _mm_sub_ps(xPlusHc, hs), _mm_add_ps(yPlusHs, hc));
+    }
+    return i;
+}
+
+inline int ParticleKernelsSSE::updateQuadColors(V3F_C4B_T2F_Quad* quads,
+                                                const float* r,
+                                                const float* g,
+                                                const float* b,
+                                                const float* a,
+                                                const float* fadeInDelta,
+                                                const float* fadeInLength,
+                                                bool premultiplyAlpha,
+                                                int count)
+{
+    const __m128 byteScale = _mm_set1_ps(255.0f);
+    alignas(16) uint8_t colors[16];
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 alpha    = _mm_loadu_ps(a + i);
+        __m128 rgbScale = premultiplyAlpha ? _mm_mul_ps(alpha, byteScale) : byteScale;
+        if (fadeInDelta)
+            alpha = _mm_mul_ps(alpha, _mm_div_ps(_mm_loadu_ps(fadeInDelta + i), _mm_loadu_ps(fadeInLength + i)));
+
+        // saturate to 0..255 and truncate like a float to byte cast, NaN turns to 0
+        __m128i cr = _mm_cvttps_epi32(_mm_min_ps(byteScale, _mm_mul_ps(_mm_loadu_ps(r + i), rgbScale)));
+        __m128i cg = _mm_cvttps_epi32(_mm_min_ps(byteScale, _mm_mul_ps(_mm_loadu_ps(g + i), rgbScale)));
+        __m128i cb = _mm_cvttps_epi32(_mm_min_ps(byteScale, _mm_mul_ps(_mm_loadu_ps(b + i), rgbScale)));
+        __m128i ca = _mm_cvttps_epi32(_mm_min_ps(byteScale, _mm_mul_ps(alpha, byteScale)));
+
+        // r0..r3 b0..b3 g0..g3 a0..a3, then r0 g0 r1 g1 .. b0 a0 b1 a1 .., then r0 g0 b0 a0 r1 ..
+        __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(cr, cb), _mm_packs_epi32(cg, ca));
+        __m128i pairs = _mm_unpacklo_epi8(bytes, _mm_srli_si128(bytes, 8));
+        _mm_store_si128(reinterpret_cast<__m128i*>(colors), _mm_unpacklo_epi16(pairs, _mm_srli_si128(pairs, 8)));
+
+        for (int k = 0; k < 4; ++k)
+        {
+            const uint8_t* c       = colors + k * 4;
+            const Color4B color(c[0], c[1], c[2], c[3]);
+            V3F_C4B_T2F_Quad& quad = quads[i + k];
+            quad.bl.colors         = color;
+            quad.br.colors         = color;
+            quad.tl.colors         = color;
+            quad.tr.colors         = color;
+        }
+    }
+    return i;
+}
+
+inline void ParticleKernelsSSE::sincos(__m128 x, __m128& s, __m128& c)
+{
+    const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+
+    __m128 signSin = _mm_and_ps(x, signMask);
+    x              = _mm_andnot_ps(signMask, x);
+
+    // the octant, rounded up to even, and the angle reduced into -pi/4..pi/4
+    __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+    j         = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+    __m128 y  = _mm_cvtepi32_ps(j);
+    x         = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+    x         = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+    x         = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+
+    signSin = _mm_xor_ps(signSin, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29)));
+    __m128 signCos = _mm_castsi128_ps(
+        _mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+    __m128 useSinPoly = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+
+    __m128 z = _mm_mul_ps(x, x);
+
+    __m128 cosPoly = _mm_set1_ps(2.443315711809948e-5f);
+    cosPoly        = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(-1.388731625493765e-3f));
+    cosPoly        = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(4.166664568298827e-2f));
+    cosPoly        = _mm_mul_ps(_mm_mul_ps(cosPoly, z), z);
+    cosPoly        = _mm_add_ps(_mm_sub_ps(cosPoly, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+    __m128 sinPoly = _mm_set1_ps(-1.9515295891e-4f);
+    sinPoly        = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(8.3321608736e-3f));
+    sinPoly        = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(-1.6666654611e-1f));
+    sinPoly        = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, z), x), x);
+
+    __m128 sinValue = _mm_or_ps(_mm_and_ps(useSinPoly, sinPoly), _mm_andnot_ps(useSinPoly, cosPoly));
+    __m128 cosValue = _mm_or_ps(_mm_and_ps(useSinPoly, cosPoly), _mm_andnot_ps(useSinPoly, sinPoly));
+    s               = _mm_xor_ps(sinValue, signSin);
+    c               = _mm_xor_ps(cosValue, signCos);
+}
+
+inline void ParticleKernelsSSE::storeCorners(V3F_C4B_T2F_Quad* quads, size_t offset, __m128 x, __m128 y)
+{
+    __m128 lo = _mm_unpacklo_ps(x, y);  // x0 y0 x1 y1
+    __m128 hi = _mm_unpackhi_ps(x, y);  // x2 y2 x3 y3
+    auto* base = reinterpret_cast<char*>(quads) + offset;
+    _mm_storel_pi(reinterpret_cast<__m64*>(base), lo);
+    _mm_storeh_pi(reinterpret_cast<__m64*>(base + sizeof(V3F_C4B_T2F_Quad)), lo);
+    _mm_storel_pi(reinterpret_cast<__m64*>(base + 2 * sizeof(V3F_C4B_T2F_Quad)), hi);
+    _mm_storeh_pi(reinterpret_cast<__m64*>(base + 3 * sizeof(V3F_C4B_T2F_Quad)), hi);
+}
+
+NS_AX_END
@@ -49,6 +49,8 @@ THE SOFTWARE.
 #include <string>
 
 #include "2d/ParticleBatchNode.h"
+#include "2d/ParticleKernels.h"
+#include "2d/ParticleSystemManager.h"
 #include "renderer/TextureAtlas.h"
 #include "base/ZipUtils.h"
 #include "base/Director.h"
@@ -79,23 +81,6 @@ NS_AX_BEGIN
 //  cocos2d uses a another approach, but the results are almost identical.
 //
 
-inline void normalize_point(float x, float y, particle_point* out)
-{
-    float n = x * x + y * y;
-    // Already normalized.
-    if (n == 1.0f)
-        return;
-
-    n = sqrt(n);
-    // Too close to zero.
-    if (n < MATH_TOLERANCE)
-        return;
-
-    n      = 1.0f / n;
-    out->x = x * n;
-    out->y = y * n;
-}
-
 ParticleData::ParticleData()
 {
     memset(this, 0, sizeof(ParticleData));
@@ -252,6 +237,13 @@ ParticleSystem::ParticleSystem()
     , _fixedFPS(0)
     , _fixedFPSDelta(0)
     , _sourcePositionCompatible(true)  // In the furture this member's default value maybe false or be removed.
+    , _updateDelta(0)
+    , _updatePureDelta(0)
+    , _updateStepping(false)
+    , _updateTransformCaptured(false)
+    , _updateQueued(false)
+    , _updateRemovesSelf(false)
+    , _updateNow(false)
 {
     modeA.gravity.setZero();
     modeA.speed              = 0;
@@ -813,7 +805,7 @@ void ParticleSystem::addParticles(int count, int animationIndex, int animationCe
             }
             case EmissionShapeType::TEXTURE_ALPHA_MASK:
             {
-                auto& mask = ParticleEmissionMaskCache::getInstance()->getEmissionMask(shape.fourccId);
+                auto& mask = getEmitterEmissionMask(shape.fourccId);
 
                 Vec2 pos            = {shape.x, shape.y};
                 Vec2 size           = mask.size;
@@ -1019,7 +1011,7 @@ void ParticleSystem::addParticles(int count, int animationIndex, int animationCe
     Vec2 pos;
     if (_positionType == PositionType::FREE)
     {
-        pos = this->convertToWorldSpace(Vec2::ZERO);
+        pos = getEmitterWorldPosition();
     }
     else if (_positionType == PositionType::RELATIVE)
     {
@@ -1487,6 +1479,8 @@ void ParticleSystem::simulate(float seconds, float frameRate)
                               ? 1.0F / Director::getInstance()->getAnimationInterval()
                               : frameRate;
     auto delta          = 1.0F / frameRate;
+    // the caller expects the particles advanced on return, none of these updates is queued
+    _updateNow = true;
     if (seconds > delta)
     {
         while (seconds > 0.0F)
@@ -1498,6 +1492,7 @@ void ParticleSystem::simulate(float seconds, float frameRate)
     }
     else
         this->update(seconds);
+    _updateNow = false;
 }
 
 void ParticleSystem::resimulate(float seconds, float frameRate)
@@ -1519,6 +1514,7 @@ void ParticleSystem::onEnter()
 void ParticleSystem::onExit()
 {
     this->unscheduleUpdate();
+    _director->getParticleSystemManager()->cancel(this);
     Node::onExit();
 
     auto iter = std::find(std::begin(__allInstances), std::end(__allInstances), this);
@@ -1561,22 +1557,81 @@ void ParticleSystem::update(float dt)
         _componentContainer->visit(dt);
     }
 
+    auto particleSystemManager = _director->getParticleSystemManager();
+    // an update queued earlier in the frame goes first
+    if (_updateQueued)
+        particleSystemManager->flush(this);
+
+    bool queued = particleSystemManager->isEnabled() && !_updateNow;
+    beginUpdate(dt, queued);
+    if (queued)
+    {
+        particleSystemManager->enqueue(this);
+    }
+    else
+    {
+        runUpdate();
+        endUpdate();
+    }
+
+    AX_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles, "CCParticleSystem - update");
+}
+
+void ParticleSystem::beginUpdate(float dt, bool queued)
+{
+    _updateStepping = true;
     if (_fixedFPS != 0)
     {
         _fixedFPSDelta += dt;
         if (_fixedFPSDelta < 1.0F / _fixedFPS)
         {
-            updateParticleQuads();
-            _transformSystemDirty = false;
-            AX_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles, "CCParticleSystem - update");
-            return;
+            // until the next fixed step only the quads follow the node
+            _updateStepping = false;
+        }
+        else
+        {
+            dt             = _fixedFPSDelta;
+            _fixedFPSDelta = 0.0F;
         }
-        dt             = _fixedFPSDelta;
-        _fixedFPSDelta = 0.0F;
     }
+    _updatePureDelta = dt;
+    _updateDelta     = dt * _timeScale;
 
-    float pureDt = dt;
-    dt *= _timeScale;
+    if (!queued)
+        return;
+
+    // the node transforms are computed lazily, runUpdate must not walk the tree from a job thread
+    if (_positionType == PositionType::FREE)
+    {
+        _updateWorldPosition     = convertToWorldSpace(Vec2::ZERO);
+        _updateWorldToNode       = getWorldToNodeTransform();
+        _updateTransformCaptured = true;
+    }
+
+    // nor reach the mask cache, a missing mask is added to it
+    if (_isEmissionShapes)
+    {
+        auto cache = ParticleEmissionMaskCache::getInstance();
+        for (auto&& item : _emissionShapes)
+        {
+            auto& shape = item.second;
+            if (shape.type == EmissionShapeType::TEXTURE_ALPHA_MASK)
+                _updateEmissionMasks.emplace_back(shape.fourccId, &cache->getEmissionMask(shape.fourccId));
+        }
+    }
+}
+
+void ParticleSystem::runUpdate()
+{
+    if (!_updateStepping)
+    {
+        updateParticleQuads();
+        _transformSystemDirty = false;
+        return;
+    }
+
+    float dt     = _updateDelta;
+    float pureDt = _updatePureDelta;
 
     if (_isActive && _emissionRate)
     {
@@ -1610,28 +1665,18 @@ void ParticleSystem::update(float dt)
     // for the purpose of improving cache hit rate, we should process only one property in one for-loop.
     // It was proved to be effective especially for low-end devices.
     {
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.timeToLive[i] -= dt;
-        }
+        ParticleKernels::addScalar(_particleData.timeToLive, -dt, _particleCount);
 
         if (_isOpacityFadeInAllocated)
         {
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.opacityFadeInDelta[i] += dt;
-                _particleData.opacityFadeInDelta[i] =
-                    MIN(_particleData.opacityFadeInDelta[i], _particleData.opacityFadeInLength[i]);
-            }
+            ParticleKernels::addScalarClamped(_particleData.opacityFadeInDelta, dt, _particleData.opacityFadeInLength,
+                                              _particleCount);
         }
 
         if (_isScaleInAllocated)
         {
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.scaleInDelta[i] += dt;
-                _particleData.scaleInDelta[i] = MIN(_particleData.scaleInDelta[i], _particleData.scaleInLength[i]);
-            }
+            ParticleKernels::addScalarClamped(_particleData.scaleInDelta, dt, _particleData.scaleInLength,
+                                              _particleCount);
         }
 
         if (_isLifeAnimated || _isEmitterAnimated || _isLoopAnimated)
@@ -1701,145 +1746,109 @@ void ParticleSystem::update(float dt)
                 std::fill_n(_particleData.animTimeDelta, _particleCount, 0.f);
         }
 
-        for (int i = 0; i < _particleCount; ++i)
+        // swap each dead particle with the last live one, the kernel skips over the runs of live particles
+        int i = ParticleKernels::findDead(_particleData.timeToLive, 0, _particleCount);
+        while (i < _particleCount)
         {
-            if (_particleData.timeToLive[i] <= 0.0f)
+            int j = _particleCount - 1;
+            while (j > 0 && _particleData.timeToLive[j] <= 0)
             {
-                int j = _particleCount - 1;
-                while (j > 0 && _particleData.timeToLive[j] <= 0)
-                {
-                    _particleCount--;
-                    j--;
-                }
-                _particleData.copyParticle(i, _particleCount - 1);
-                if (_batchNode)
-                {
-                    // disable the switched particle
-                    int currentIndex = _particleData.atlasIndex[i];
-                    _batchNode->disableParticle(_atlasIndex + currentIndex);
-                    // switch indexes
-                    _particleData.atlasIndex[_particleCount - 1] = currentIndex;
-                }
-                --_particleCount;
-                if (_particleCount == 0 && _isAutoRemoveOnFinish)
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
+                _particleCount--;
+                j--;
             }
-        }
-
-        if (_emitterMode == Mode::GRAVITY)
-        {
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
-
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    normalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
-
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= -_particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
-            }
-        }
-        else
-        {
-            for (int i = 0; i < _particleCount; ++i)
+            _particleData.copyParticle(i, _particleCount - 1);
+            if (_batchNode)
             {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
+                // disable the switched particle
+                int currentIndex = _particleData.atlasIndex[i];
+                _batchNode->disableParticle(_atlasIndex + currentIndex);
+                // switch indexes
+                _particleData.atlasIndex[_particleCount - 1] = currentIndex;
             }
-
-            for (int i = 0; i < _particleCount; ++i)
+            --_particleCount;
+            if (_particleCount == 0 && _isAutoRemoveOnFinish)
             {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
-            }
-
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posx[i] = -cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
-            }
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posy[i] =
-                    -sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
+                // removed by endUpdate on the main thread
+                _updateRemovesSelf = true;
+                return;
             }
+            i = ParticleKernels::findDead(_particleData.timeToLive, i + 1, _particleCount);
         }
 
-        // color r,g,b,a
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
-        }
-
-        for (int i = 0; i < _particleCount; ++i)
+        if (_emitterMode == Mode::GRAVITY)
         {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
+            ParticleKernels::integrateGravity(_particleData.posx, _particleData.posy, _particleData.modeA.dirX,
+                                              _particleData.modeA.dirY, _particleData.modeA.radialAccel,
+                                              _particleData.modeA.tangentialAccel, modeA.gravity.x, modeA.gravity.y, dt,
+                                              _yCoordFlipped, _particleCount);
         }
-
-        for (int i = 0; i < _particleCount; ++i)
+        else
         {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
+            ParticleKernels::integrateRadius(_particleData.posx, _particleData.posy, _particleData.modeB.angle,
+                                             _particleData.modeB.radius, _particleData.modeB.degreesPerSecond,
+                                             _particleData.modeB.deltaRadius, dt, _yCoordFlipped, _particleCount);
         }
 
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
-        }
+        // color r,g,b,a
+        ParticleKernels::addScaled(_particleData.colorR, _particleData.deltaColorR, dt, _particleCount);
+        ParticleKernels::addScaled(_particleData.colorG, _particleData.deltaColorG, dt, _particleCount);
+        ParticleKernels::addScaled(_particleData.colorB, _particleData.deltaColorB, dt, _particleCount);
+        ParticleKernels::addScaled(_particleData.colorA, _particleData.deltaColorA, dt, _particleCount);
         // size
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.size[i] += (_particleData.deltaSize[i] * dt);
-            _particleData.size[i] = MAX(0, _particleData.size[i]);
-        }
+        ParticleKernels::addScaledNonNegative(_particleData.size, _particleData.deltaSize, dt, _particleCount);
         // angle
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
-        }
+        ParticleKernels::addScaled(_particleData.rotation, _particleData.deltaRotation, dt, _particleCount);
 
         updateParticleQuads();
         _transformSystemDirty = false;
     }
+}
+
+void ParticleSystem::endUpdate()
+{
+    _updateTransformCaptured = false;
+    _updateEmissionMasks.clear();
+
+    if (_updateRemovesSelf)
+    {
+        _updateRemovesSelf = false;
+        this->unscheduleUpdate();
+        _parent->removeChild(this, true);
+        return;
+    }
 
     // update and send gl buffer only when this node is visible.
-    if (_visible && !_batchNode)
+    if (_updateStepping && _visible && !_batchNode)
     {
         postStep();
     }
+}
 
-    AX_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles, "CCParticleSystem - update");
+Vec2 ParticleSystem::getEmitterWorldPosition()
+{
+    return _updateTransformCaptured ? _updateWorldPosition : convertToWorldSpace(Vec2::ZERO);
+}
+
+Mat4 ParticleSystem::getEmitterWorldToNodeTransform()
+{
+    return _updateTransformCaptured ? _updateWorldToNode : getWorldToNodeTransform();
+}
+
+const ParticleEmissionMaskDescriptor& ParticleSystem::getEmitterEmissionMask(uint32_t fourccId)
+{
+    for (auto&& item : _updateEmissionMasks)
+    {
+        if (item.first == fourccId)
+            return *item.second;
+    }
+    return ParticleEmissionMaskCache::getInstance()->getEmissionMask(fourccId);
 }
 
 void ParticleSystem::updateWithNoTime()
 {
+    _updateNow = true;
     this->update(0.0f);
+    _updateNow = false;
 }
 
 void ParticleSystem::updateParticleQuads()
@@ -2260,6 +2269,11 @@ void ParticleSystem::setTimeScale(float scale)
     _timeScale = scale;
 }
 
+void ParticleSystem::setRandomSeed(uint32_t seed)
+{
+    _rng.seed_rng(seed);
+}
+
 static ParticleEmissionMaskCache* emissionMaskCache;
 
 ParticleEmissionMaskCache* ParticleEmissionMaskCache::getInstance()
@@ -1455,11 +1455,36 @@ public:
      */
     virtual void setTimeScale(float scale = 1.0F);
 
+    /** Seeds the random generator of the emitter, a system seeded the same emits the same particles.
+     @param seed The seed, the creation time by default.
+     */
+    void setRandomSeed(uint32_t seed);
+
 protected:
     virtual void updateBlendFunc();
 
+    /** The main thread part of an update, a queued update also captures the emitter transform and the emission masks
+     the rest of the update uses. */
+    void beginUpdate(float dt, bool queued);
+
+    /** Simulates the particles and builds the quads, it only touches this system so it can run on a job thread. */
+    void runUpdate();
+
+    /** The main thread part after runUpdate, it removes a finished system and calls postStep. */
+    void endUpdate();
+
+    /** The world position of the emitter, the one captured by beginUpdate while an update runs. */
+    Vec2 getEmitterWorldPosition();
+
+    /** The world to node transform, the one captured by beginUpdate while an update runs. */
+    Mat4 getEmitterWorldToNodeTransform();
+
+    /** The emission mask, the one resolved by beginUpdate while a queued update runs. */
+    const ParticleEmissionMaskDescriptor& getEmitterEmissionMask(uint32_t fourccId);
+
 private:
     friend class EngineDataManager;
+    friend class ParticleSystemManager;
     /** Internal use only, it's used by EngineDataManager class for Android platform */
     static void setTotalParticleCountFactor(float factor);
 
@@ -1683,6 +1708,18 @@ protected:
 
     FastRNG _rng;
 
+    /** The update in progress, see beginUpdate */
+    float _updateDelta;
+    float _updatePureDelta;
+    bool _updateStepping;
+    bool _updateTransformCaptured;
+    bool _updateQueued;
+    bool _updateRemovesSelf;
+    bool _updateNow;
+    Vec2 _updateWorldPosition;
+    Mat4 _updateWorldToNode;
+    std::vector<std::pair<uint32_t, const ParticleEmissionMaskDescriptor*>> _updateEmissionMasks;
+
 private:
     AX_DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
 };
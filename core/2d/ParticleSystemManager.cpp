@@ -0,0 +1,137 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/ParticleSystemManager.h"
+
+#include <algorithm>
+#include "2d/ParticleSystem.h"
+#include "base/Director.h"
+#include "base/JobSystem.h"
+
+NS_AX_BEGIN
+
+ParticleSystemManager::~ParticleSystemManager()
+{
+    for (auto system : _queued)
+    {
+        system->_updateQueued = false;
+        system->release();
+    }
+}
+
+void ParticleSystemManager::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+    if (!_enabled)
+        update();
+}
+
+void ParticleSystemManager::setParallelThreshold(int systems)
+{
+    _parallelThreshold = std::max(systems, 1);
+}
+
+void ParticleSystemManager::enqueue(ParticleSystem* system)
+{
+    AXASSERT(!system->_updateQueued, "ParticleSystemManager: the system is queued already");
+
+    system->retain();
+    system->_updateQueued = true;
+    _queued.push_back(system);
+}
+
+void ParticleSystemManager::cancel(ParticleSystem* system)
+{
+    if (!system->_updateQueued)
+        return;
+
+    // a system update() is running is released by it
+    system->_updateQueued           = false;
+    system->_updateTransformCaptured = false;
+    system->_updateEmissionMasks.clear();
+    auto it                         = std::find(_queued.begin(), _queued.end(), system);
+    if (it != _queued.end())
+    {
+        _queued.erase(it);
+        system->release();
+    }
+}
+
+void ParticleSystemManager::flush(ParticleSystem* system)
+{
+    if (!system->_updateQueued)
+        return;
+
+    system->_updateQueued = false;
+    auto it               = std::find(_queued.begin(), _queued.end(), system);
+    if (it != _queued.end())
+    {
+        _queued.erase(it);
+        system->runUpdate();
+        system->endUpdate();
+        system->release();
+    }
+    else
+    {
+        // update() ran it already and hasn't reached its end yet
+        system->endUpdate();
+    }
+}
+
+void ParticleSystemManager::update()
+{
+    if (_queued.empty())
+        return;
+
+    _running.swap(_queued);
+
+    auto jobSystem = Director::getInstance()->getJobSystem();
+    if (static_cast<int>(_running.size()) < _parallelThreshold || jobSystem->getWorkerCount() == 0)
+    {
+        for (auto system : _running)
+            system->runUpdate();
+    }
+    else
+    {
+        // one system a chunk, the emitters differ too much in size for larger chunks to balance
+        jobSystem->parallel_for(0, _running.size(), 1, [this](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i)
+                _running[i]->runUpdate();
+        });
+    }
+
+    // ending a system may remove others from the scene, they are cancelled then
+    for (auto system : _running)
+    {
+        if (system->_updateQueued)
+        {
+            system->_updateQueued = false;
+            system->endUpdate();
+        }
+        system->release();
+    }
+    _running.clear();
+}
+
+NS_AX_END
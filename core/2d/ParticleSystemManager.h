@@ -0,0 +1,90 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "base/Config.h"
+#include "platform/PlatformDefine.h"
+
+NS_AX_BEGIN
+
+class ParticleSystem;
+
+/**
+ * Simulates the particle systems of a frame in parallel on the JobSystem.
+ *
+ * Once enabled, a scheduled ParticleSystem::update only captures the emitter transform and looks up its emission
+ * masks on the main thread, then queues the system. After the Scheduler update the Director runs the queued systems over the job threads, their
+ * particles and their quads, then finishes each system on the main thread in the order they were queued. Drawing
+ * stays on the main thread.
+ *
+ * A system only touches its own particles, its own quads or its range of the batch node atlas, and emits from its own
+ * random generator, so the result doesn't depend on the job threads. Don't bake or remove emission masks while the
+ * systems run. Seed the systems with
+ * ParticleSystem::setRandomSeed for the same emission on every run.
+ *
+ * ParticleSystem::simulate and updateWithNoTime are never queued, they advance the system right away.
+ */
+class AX_DLL ParticleSystemManager
+{
+public:
+    ~ParticleSystemManager();
+
+    /** Enables the parallel simulation, disabled by default. Disabling it runs the queued systems right away. */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    /**
+     * Sets the number of queued systems below which they run on the main thread, the jobs would cost more than
+     * they save. Default is 4.
+     */
+    void setParallelThreshold(int systems);
+    int getParallelThreshold() const { return _parallelThreshold; }
+
+    /** Gets the number of systems waiting for update(). */
+    size_t getQueueDepth() const { return _queued.size(); }
+
+    /** Queues the update a system began, called by ParticleSystem::update. */
+    void enqueue(ParticleSystem* system);
+
+    /** Drops the queued update of a system, called when it exits the scene. */
+    void cancel(ParticleSystem* system);
+
+    /** Finishes the queued update of a system now. */
+    void flush(ParticleSystem* system);
+
+    /** Runs the queued systems, called by the Director once per frame after the Scheduler. */
+    void update();
+
+private:
+    std::vector<ParticleSystem*> _queued;
+    // the systems update() runs, _queued takes the ones queued meanwhile
+    std::vector<ParticleSystem*> _running;
+
+    bool _enabled          = false;
+    int _parallelThreshold = 4;
+};
+
+NS_AX_END
@@ -169,6 +169,7 @@ protected:
 
     V3F_C4B_T2F_Quad* _quads = nullptr;  // quads to be rendered
     unsigned short* _indices = nullptr;  // indices
+    std::vector<float> _scaleIn;         // eased scale in of each particle, rebuilt by updateParticleQuads
 
     QuadCommand _quadCommand;  // quad command
 
@@ -0,0 +1,145 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "2d/SkylinePacker.h"
+
+#include <algorithm>
+#include <climits>
+
+NS_AX_BEGIN
+
+void SkylinePacker::reset(int width, int height)
+{
+    _width    = width;
+    _height   = height;
+    _usedArea = 0;
+    _skyline.clear();
+    if (width > 0)
+        _skyline.emplace_back(Segment{0, 0, width});
+}
+
+void SkylinePacker::restore(int width, int height, std::vector<Segment> skyline)
+{
+    _width   = width;
+    _height  = height;
+    _skyline = std::move(skyline);
+    size_t area = 0;
+    for (auto&& segment : _skyline)
+        area += static_cast<size_t>(segment.width) * segment.y;
+    _usedArea = area;
+}
+
+int SkylinePacker::fit(size_t index, int width, int height) const
+{
+    const int x = _skyline[index].x;
+    if (x + width > _width)
+        return -1;
+
+    int y         = _skyline[index].y;
+    int widthLeft = width;
+    while (widthLeft > 0)
+    {
+        y = (std::max)(y, _skyline[index].y);
+        if (y + height > _height)
+            return -1;
+        widthLeft -= _skyline[index].width;
+        ++index;
+    }
+    return y;
+}
+
+bool SkylinePacker::pack(int width, int height, int& outX, int& outY)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    size_t bestIndex = _skyline.size();
+    int bestY        = INT_MAX;
+    int bestWidth    = INT_MAX;
+    for (size_t i = 0; i < _skyline.size(); ++i)
+    {
+        int y = fit(i, width, height);
+        if (y >= 0 && (y < bestY || (y == bestY && _skyline[i].width < bestWidth)))
+        {
+            bestIndex = i;
+            bestY     = y;
+            bestWidth = _skyline[i].width;
+        }
+    }
+    if (bestIndex == _skyline.size())
+        return false;
+
+    outX = _skyline[bestIndex].x;
+    outY = bestY;
+
+    // the new segment covers the ones it lies on
+    _skyline.insert(_skyline.begin() + bestIndex, Segment{outX, bestY + height, width});
+    const int right = outX + width;
+    auto i          = bestIndex + 1;
+    while (i < _skyline.size() && _skyline[i].x < right)
+    {
+        auto& segment = _skyline[i];
+        int shrink    = right - segment.x;
+        if (segment.width <= shrink)
+        {
+            _skyline.erase(_skyline.begin() + i);
+            continue;
+        }
+        segment.x += shrink;
+        segment.width -= shrink;
+        break;
+    }
+
+    // neighbours of the same height are one segment
+    for (i = 0; i + 1 < _skyline.size();)
+    {
+        if (_skyline[i].y == _skyline[i + 1].y)
+        {
+            _skyline[i].width += _skyline[i + 1].width;
+            _skyline.erase(_skyline.begin() + i + 1);
+        }
+        else
+            ++i;
+    }
+
+    _usedArea += static_cast<size_t>(width) * height;
+    return true;
+}
+
+int SkylinePacker::getMaxHeight() const
+{
+    int height = 0;
+    for (auto&& segment : _skyline)
+        height = (std::max)(height, segment.y);
+    return height;
+}
+
+float SkylinePacker::getOccupancy() const
+{
+    size_t area = 0;
+    for (auto&& segment : _skyline)
+        area += static_cast<size_t>(segment.width) * segment.y;
+    return area ? static_cast<float>(_usedArea) / static_cast<float>(area) : 1.0f;
+}
+
+NS_AX_END
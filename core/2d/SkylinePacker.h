@@ -0,0 +1,90 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+
+#include <vector>
+#include "base/Config.h"
+#include "platform/PlatformDefine.h"
+
+NS_AX_BEGIN
+
+/**
+ * Packs rectangles into a fixed size area with the skyline bottom-left heuristic.
+ *
+ * The skyline is the top edge of the packed rectangles, stored as horizontal segments sorted by x.
+ * A rectangle goes where its top is the lowest, ties go to the narrowest segment to keep the waste
+ * under the skyline small. Mixed sizes pack much denser than rows of the height of their tallest item.
+ */
+class AX_DLL SkylinePacker
+{
+public:
+    struct Segment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    SkylinePacker(int width = 0, int height = 0) { reset(width, height); }
+
+    /** Empties the area and resizes it. */
+    void reset(int width, int height);
+
+    /**
+     * Resizes the area and restores a skyline, e.g. saved with getSkyline, the area under it is considered used.
+     * The segments must be sorted by x and cover the whole width.
+     */
+    void restore(int width, int height, std::vector<Segment> skyline);
+
+    /**
+     * Finds room for a rectangle.
+     * @return false when it doesn't fit anywhere, the packer is unchanged then.
+     */
+    bool pack(int width, int height, int& outX, int& outY);
+
+    const std::vector<Segment>& getSkyline() const { return _skyline; }
+
+    int getWidth() const { return _width; }
+    int getHeight() const { return _height; }
+
+    /** Gets the height of the highest segment. */
+    int getMaxHeight() const;
+
+    /** Gets the area of the packed rectangles. */
+    size_t getUsedArea() const { return _usedArea; }
+
+    /** Gets the packed area divided by the area under the skyline, 1 means no waste. */
+    float getOccupancy() const;
+
+private:
+    // the y a rectangle would be placed at on the segment index, -1 if it doesn't fit there
+    int fit(size_t index, int width, int height) const;
+
+    std::vector<Segment> _skyline;
+    int _width       = 0;
+    int _height      = 0;
+    size_t _usedArea = 0;
+};
+
+NS_AX_END
@@ -1062,6 +1062,20 @@ void Sprite::updateTransform()
 }
 
 // draw
+void Sprite::writeQuadVertices(const TrianglesCommand& command, V3F_C4B_T2F* out)
+{
+    const auto quad = command.getVertices();
+    const float* m  = command.getModelView().m;
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto& v = quad[i].vertices;
+        out[i].vertices.set(m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12], m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13],
+                            m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14]);
+        out[i].colors    = quad[i].colors;
+        out[i].texCoords = quad[i].texCoords;
+    }
+}
+
 void Sprite::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
 {
     if (_texture == nullptr || _texture->getBackendTexture() == nullptr)
@@ -1088,6 +1102,7 @@ void Sprite::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
 #endif
     {
         _trianglesCommand.init(_globalZOrder, _texture, _blendFunc, _polyInfo.triangles, transform, flags);
+        _trianglesCommand.setVertexWriter(_polyInfo.triangles.vertCount == 4 ? &Sprite::writeQuadVertices : nullptr);
         renderer->addCommand(&_trianglesCommand);
 
 #if AX_SPRITE_DEBUG_DRAW
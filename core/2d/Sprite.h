@@ -671,6 +671,8 @@ protected:
     void updateStretchFactor();
     void populateTriangle(int quadIndex, const V3F_C4B_T2F_Quad& quad);
     void setMVPMatrixUniform();
+    /** Writes the quad of a sprite command straight into the renderer's vertex stream. */
+    static void writeQuadVertices(const TrianglesCommand& command, V3F_C4B_T2F* out);
     //
     // Data used when the sprite is rendered using a SpriteSheet
     //
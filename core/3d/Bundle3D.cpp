@@ -1089,7 +1089,7 @@ bool Bundle3D::loadBinary(std::string_view path)
 
     // get file data
     _binaryBuffer.clear();
-    _binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
+    _binaryBuffer = FileUtils::getInstance()->getFileView(path);
     if (_binaryBuffer.isNull())
     {
         clear();
@@ -1098,7 +1098,7 @@ bool Bundle3D::loadBinary(std::string_view path)
     }
 
     // Initialise bundle reader
-    _binaryReader.init((char*)_binaryBuffer.getBytes(), _binaryBuffer.getSize());
+    _binaryReader.init((char*)_binaryBuffer.data(), static_cast<ssize_t>(_binaryBuffer.size()));
 
     // Read identifier info
     char identifier[] = {'C', '3', 'B', '\0'};
@@ -28,6 +28,7 @@
 #define __CCBUNDLE3D_H__
 
 #include "base/Data.h"
+#include "platform/FileView.h"
 #include "3d/Bundle3DData.h"
 #include "3d/BundleReader.h"
 #include "rapidjson/document-wrapper.h"
@@ -190,8 +191,8 @@ protected:
     std::string _jsonBuffer;
     rapidjson::Document _jsonReader;
 
-    // for binary reading
-    Data _binaryBuffer;
+    // for binary reading, mapped for large bundles
+    FileView _binaryBuffer;
     BundleReader _binaryReader;
     unsigned int _referenceCount;
     Reference* _references;
@@ -263,7 +263,7 @@ Mesh* Mesh::create(const std::vector<float>& vertices,
     meshdata.vertex  = vertices;
     meshdata.subMeshIndices.emplace_back(indices);
     meshdata.subMeshIds.emplace_back("");
-    auto meshvertexdata = MeshVertexData::create(meshdata, indices.format());
+    auto meshvertexdata = MeshVertexData::create(std::move(meshdata), indices.format());
     auto indexData      = meshvertexdata->getMeshIndexDataByIndex(0);
 
     auto mesh = create("", indexData);
@@ -436,6 +436,9 @@ void Mesh::draw(Renderer* renderer,
     if (!isVisible())
         return;
 
+    // a mesh created in this frame draws before the upload queue ran
+    _meshIndexData->getMeshVertexData()->flushUpload();
+
     bool isTransparent = (_material->isTransparent() || color.w < 1.f);
     float globalZ      = isTransparent ? 0 : globalZOrder;
     if (isTransparent)
@@ -140,7 +140,7 @@ void MeshRenderer::afterAsyncLoad(void* param)
             auto& meshdatas     = asyncParam->meshdatas;
             auto& materialdatas = asyncParam->materialdatas;
             auto& nodeDatas     = asyncParam->nodeDatas;
-            if (initFrom(*nodeDatas, *meshdatas, *materialdatas))
+            if (initFrom(*nodeDatas, std::move(*meshdatas), *materialdatas))
             {
                 auto meshdata = MeshRendererCache::getInstance()->getMeshRenderData(asyncParam->modelPath);
                 if (meshdata == nullptr)
@@ -309,7 +309,7 @@ bool MeshRenderer::initWithFile(std::string_view path)
     NodeDatas* nodeDatas         = new NodeDatas();
     if (loadFromFile(path, nodeDatas, meshdatas, materialdatas))
     {
-        if (initFrom(*nodeDatas, *meshdatas, *materialdatas))
+        if (initFrom(*nodeDatas, std::move(*meshdatas), *materialdatas))
         {
             // add to cache
             auto data             = new MeshRendererCache::MeshRenderData();
@@ -346,6 +346,24 @@ bool MeshRenderer::initFrom(const NodeDatas& nodeDatas, const MeshDatas& meshdat
             _meshVertexDatas.pushBack(meshvertex);
         }
     }
+    return initNodes(nodeDatas, materialdatas);
+}
+
+bool MeshRenderer::initFrom(const NodeDatas& nodeDatas, MeshDatas&& meshdatas, const MaterialDatas& materialdatas)
+{
+    for (const auto& it : meshdatas.meshDatas)
+    {
+        if (it)
+        {
+            auto meshvertex = MeshVertexData::create(std::move(*it));
+            _meshVertexDatas.pushBack(meshvertex);
+        }
+    }
+    return initNodes(nodeDatas, materialdatas);
+}
+
+bool MeshRenderer::initNodes(const NodeDatas& nodeDatas, const MaterialDatas& materialdatas)
+{
     _skeleton = Skeleton3D::create(nodeDatas.skeleton);
     AX_SAFE_RETAIN(_skeleton);
 
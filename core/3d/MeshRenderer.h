@@ -219,6 +219,9 @@ public:
 
     bool initFrom(const NodeDatas& nodedatas, const MeshDatas& meshdatas, const MaterialDatas& materialdatas);
 
+    /** same as above, the geometry is moved out of meshdatas instead of being copied for the upload */
+    bool initFrom(const NodeDatas& nodedatas, MeshDatas&& meshdatas, const MaterialDatas& materialdatas);
+
     /** load a mesh renderer from cache, returns true if succeeded, false otherwise. */
     bool loadFromCache(std::string_view path);
 
@@ -236,6 +239,8 @@ public:
     /** generate default material. */
     void genMaterial(bool useLight = false);
 
+    /** creates the skeleton, nodes and materials once the mesh vertex data exists */
+    bool initNodes(const NodeDatas& nodedatas, const MaterialDatas& materialdatas);
     void createNode(NodeData* nodedata, Node* root, const MaterialDatas& materialdatas, bool singleMesh);
     void createAttachMeshRendererNode(NodeData* nodedata, const MaterialDatas& materialdatas);
     MeshRenderer* createMeshRendererNode(NodeData* nodedata, ModelData* modeldata, const MaterialDatas& materialdatas);
@@ -41,6 +41,7 @@
 #include "base/EventType.h"
 #include "base/Director.h"
 
+#include "renderer/UploadQueue.h"
 #include "renderer/backend/Buffer.h"
 #include "renderer/backend/DriverBase.h"
 
@@ -108,7 +109,37 @@ void MeshVertexData::setVertexData(const std::vector<float>& vertexData)
 #endif
 }
 
-MeshVertexData* MeshVertexData::create(const MeshData& meshdata, CustomCommand::IndexFormat format)
+MeshVertexData* MeshVertexData::create(const MeshData& meshdata, CustomCommand::IndexFormat /*format*/)
+{
+    // the caller keeps the geometry, upload it now instead of copying it into the upload queue
+    auto vertexdata = createBuffers(meshdata);
+    vertexdata->uploadData(meshdata.vertex, meshdata.subMeshIndices);
+    vertexdata->autorelease();
+    return vertexdata;
+}
+
+MeshVertexData* MeshVertexData::create(MeshData&& meshdata, CustomCommand::IndexFormat /*format*/)
+{
+    auto vertexdata = createBuffers(meshdata);
+
+    // the buffers are filled by the upload queue, spread over frames when a lot of content streams in
+    size_t uploadBytes = vertexdata->_vertexBuffer ? meshdata.vertex.size() * sizeof(meshdata.vertex[0]) : 0;
+    for (auto&& indices : meshdata.subMeshIndices)
+        uploadBytes += indices.bsize();
+
+    vertexdata->_uploadPending = true;
+    Director::getInstance()->getUploadQueue()->enqueue(
+        vertexdata, uploadBytes,
+        [vertexdata, vertices = std::move(meshdata.vertex), subMeshIndices = std::move(meshdata.subMeshIndices)] {
+            vertexdata->uploadData(vertices, subMeshIndices);
+            vertexdata->_uploadPending = false;
+        });
+
+    vertexdata->autorelease();
+    return vertexdata;
+}
+
+MeshVertexData* MeshVertexData::createBuffers(const MeshData& meshdata)
 {
     auto vertexdata           = new MeshVertexData();
     vertexdata->_vertexBuffer = backend::DriverBase::getInstance()->newBuffer(
@@ -125,8 +156,6 @@ MeshVertexData* MeshVertexData::create(const MeshData& meshdata, CustomCommand::
         vertexdata->setVertexData(meshdata.vertex);
         vertexdata->_vertexBuffer->usingDefaultStoredData(false);
 #endif
-        vertexdata->_vertexBuffer->updateData((void*)&meshdata.vertex[0],
-                                              meshdata.vertex.size() * sizeof(meshdata.vertex[0]));
     }
 
     bool needCalcAABB = (meshdata.subMeshAABB.size() != meshdata.subMeshIndices.size());
@@ -139,7 +168,6 @@ MeshVertexData* MeshVertexData::create(const MeshData& meshdata, CustomCommand::
 #if AX_ENABLE_CACHE_TEXTURE_DATA
         indexBuffer->usingDefaultStoredData(false);
 #endif
-        indexBuffer->updateData((void*)indices.data(), indices.bsize());
 
         std::string id           = (i < meshdata.subMeshIds.size() ? meshdata.subMeshIds[i] : "");
         MeshIndexData* indexdata = nullptr;
@@ -155,11 +183,20 @@ MeshVertexData* MeshVertexData::create(const MeshData& meshdata, CustomCommand::
 #endif
         vertexdata->_indices.pushBack(indexdata);
     }
-
-    vertexdata->autorelease();
     return vertexdata;
 }
 
+void MeshVertexData::uploadData(const std::vector<float>& vertices, const std::vector<IndexArray>& subMeshIndices)
+{
+    if (_vertexBuffer)
+        _vertexBuffer->updateData((void*)vertices.data(), vertices.size() * sizeof(vertices[0]));
+    for (size_t i = 0, size = subMeshIndices.size(); i < size; ++i)
+    {
+        auto& indices = subMeshIndices[i];
+        _indices.at(i)->getIndexBuffer()->updateData((void*)indices.data(), indices.bsize());
+    }
+}
+
 MeshIndexData* MeshVertexData::getMeshIndexDataById(std::string_view id) const
 {
     for (auto&& it : _indices)
@@ -190,8 +227,16 @@ MeshVertexData::MeshVertexData()
 #endif
 }
 
+void MeshVertexData::flushUpload() const
+{
+    if (_uploadPending)
+        Director::getInstance()->getUploadQueue()->flush(this);
+}
+
 MeshVertexData::~MeshVertexData()
 {
+    if (_uploadPending)
+        Director::getInstance()->getUploadQueue()->cancel(this);
     AX_SAFE_RELEASE(_vertexBuffer);
     _indices.clear();
     _vertexData.clear();
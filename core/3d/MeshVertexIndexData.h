@@ -111,9 +111,12 @@ class AX_DLL MeshVertexData : public Object
     friend class Mesh;
 
 public:
-    /**create*/
+    /** create, the geometry is uploaded right away since the caller keeps it */
     static MeshVertexData* create(const MeshData& meshdata, CustomCommand::IndexFormat format = CustomCommand::IndexFormat::U_SHORT);
 
+    /** create, the geometry is moved out of meshdata and uploaded by the UploadQueue */
+    static MeshVertexData* create(MeshData&& meshdata, CustomCommand::IndexFormat format = CustomCommand::IndexFormat::U_SHORT);
+
     /** get vertexbuffer */
     backend::Buffer* getVertexBuffer() const { return _vertexBuffer; }
 
@@ -138,10 +141,19 @@ public:
 
     void setVertexData(const std::vector<float>& vertexData);
 
+    /** Whether the vertices and indices wait in the UploadQueue, they are uploaded at the latest when drawn. */
+    bool isUploadPending() const { return _uploadPending; }
+
+    /** Uploads the vertices and indices now if they are still queued. */
+    void flushUpload() const;
+
     MeshVertexData();
     virtual ~MeshVertexData();
 
 protected:
+    static MeshVertexData* createBuffers(const MeshData& meshdata);
+    void uploadData(const std::vector<float>& vertices, const std::vector<IndexArray>& subMeshIndices);
+
     backend::Buffer* _vertexBuffer = nullptr;  // vertex buffer
     ssize_t _sizePerVertex         = -1;
     Vector<MeshIndexData*> _indices;           // index data
@@ -149,6 +161,7 @@ protected:
 
     int _vertexCount = 0;  // vertex count
     std::vector<float> _vertexData;
+    bool _uploadPending = false;
 #if AX_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _backToForegroundListener = nullptr;
 #endif
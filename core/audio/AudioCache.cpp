@@ -53,14 +53,18 @@ AudioCache::AudioCache()
     , _duration(0.0f)
     , _alBufferId(INVALID_AL_BUFFER_ID)
     , _queBufferFrames(0)
+    , _queBufferNum(QUEUEBUFFER_NUM)
+    , _queBufferDuration(QUEUEBUFFER_TIME_STEP)
+    , _sizeInBytes(0)
     , _state(State::INITIAL)
     , _isDestroyed(std::make_shared<bool>(false))
     , _id(++__idIndex)
     , _isLoadingFinished(false)
     , _isSkipReadDataTask(false)
+    , _isInvokingLoadCallbacks(false)
 {
     AXLOGV("AudioCache() {}, id={}", fmt::ptr(this), _id);
-    for (int i = 0; i < QUEUEBUFFER_NUM; ++i)
+    for (int i = 0; i < QUEUEBUFFER_NUM_MAX; ++i)
     {
         _queBuffers[i]    = nullptr;
         _queBufferSize[i] = 0;
@@ -100,7 +104,7 @@ AudioCache::~AudioCache()
 
     if (_queBufferFrames > 0)
     {
-        for (int index = 0; index < QUEUEBUFFER_NUM; ++index)
+        for (int index = 0; index < _queBufferNum; ++index)
         {
             free(_queBuffers[index]);
         }
@@ -284,16 +288,17 @@ void AudioCache::readDataTask(unsigned int selfId)
                 break;
             }
 
-            _state = State::READY;
+            _sizeInBytes = dataSize;
+            _state       = State::READY;
         }
         else
         {
-            _queBufferFrames = sampleRate * QUEUEBUFFER_TIME_STEP;
+            _queBufferFrames = static_cast<uint32_t>(sampleRate * _queBufferDuration);
             BREAK_IF_ERR_LOG(_queBufferFrames == 0, "_queBufferFrames == 0");
 
             const uint32_t queBufferBytes = decoder->framesToBytes(_queBufferFrames);
 
-            for (int index = 0; index < QUEUEBUFFER_NUM; ++index)
+            for (int index = 0; index < _queBufferNum; ++index)
             {
                 _queBuffers[index]    = (char*)malloc(queBufferBytes);
                 _queBufferSize[index] = queBufferBytes;
@@ -301,7 +306,8 @@ void AudioCache::readDataTask(unsigned int selfId)
                 decoder->readFixedFrames(_queBufferFrames, _queBuffers[index]);
             }
 
-            _state = State::READY;
+            _sizeInBytes = queBufferBytes * _queBufferNum;
+            _state       = State::READY;
         }
 
     } while (false);
@@ -404,12 +410,18 @@ void AudioCache::invokingLoadCallbacks()
             return;
         }
 
-        for (auto&& cb : _loadCallbacks)
+        // a callback may uncache this file, so don't touch any member once it's destroyed
+        bool isSuccess           = _state == State::READY;
+        auto callbacks           = std::move(_loadCallbacks);
+        _isInvokingLoadCallbacks = true;
+        _loadCallbacks.clear();
+        for (auto&& cb : callbacks)
         {
-            cb(_state == State::READY);
+            cb(isSuccess);
+            if (*isDestroyed)
+                return;
         }
-
-        _loadCallbacks.clear();
+        _isInvokingLoadCallbacks = false;
     });
 }
 NS_AX_END
@@ -83,9 +83,15 @@ protected:
     /*Queue buffer related stuff
      *  Streaming in OpenAL when sizeInBytes greater then PCMDATA_CACHEMAXSIZE
      */
-    char* _queBuffers[QUEUEBUFFER_NUM];
-    ALsizei _queBufferSize[QUEUEBUFFER_NUM];
+    char* _queBuffers[QUEUEBUFFER_NUM_MAX];
+    ALsizei _queBufferSize[QUEUEBUFFER_NUM_MAX];
     uint32_t _queBufferFrames;
+    // snapshot of AudioEngine::StreamingConfig taken by AudioEngineImpl::preload
+    int _queBufferNum;
+    float _queBufferDuration;
+
+    // decoded bytes held by this cache, valid once loading finished
+    uint32_t _sizeInBytes;
 
     std::mutex _playCallbackMutex;
     std::vector<std::function<void()>> _playCallbacks;
@@ -102,6 +108,8 @@ protected:
     unsigned int _id;
     bool _isLoadingFinished;
     bool _isSkipReadDataTask;
+    // set on the Cocos thread while the load callbacks run, AudioEngineImpl::trimCaches leaves the cache alone
+    bool _isInvokingLoadCallbacks;
 
     friend class AudioEngineImpl;
     friend class AudioPlayer;
@@ -0,0 +1,108 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "audio/AudioCacheLRU.h"
+
+NS_AX_BEGIN
+
+void AudioCacheLRU::add(std::string_view key)
+{
+    auto it = _entries.find(key);
+    if (it != _entries.end())
+    {
+        touch(key);
+        return;
+    }
+
+    Entry entry;
+    entry.node = _order.emplace(_order.begin(), key);
+    _entries.emplace(key, entry);
+}
+
+void AudioCacheLRU::touch(std::string_view key)
+{
+    auto it = _entries.find(key);
+    if (it != _entries.end())
+        _order.splice(_order.begin(), _order, it->second.node);
+}
+
+void AudioCacheLRU::setSize(std::string_view key, uint32_t bytes)
+{
+    auto it = _entries.find(key);
+    if (it == _entries.end())
+        return;
+
+    _bytes -= it->second.bytes;
+    it.value().bytes = bytes;
+    _bytes += bytes;
+}
+
+void AudioCacheLRU::remove(std::string_view key)
+{
+    auto it = _entries.find(key);
+    if (it == _entries.end())
+        return;
+
+    _bytes -= it->second.bytes;
+    _order.erase(it->second.node);
+    _entries.erase(it);
+}
+
+void AudioCacheLRU::clear()
+{
+    _entries.clear();
+    _order.clear();
+    _bytes = 0;
+}
+
+void AudioCacheLRU::setPinned(std::string_view key, bool pinned)
+{
+    if (pinned)
+        _pinned.emplace(key);
+    else
+        _pinned.erase(key);
+}
+
+std::vector<std::string> AudioCacheLRU::trim(size_t budget, const std::function<bool(std::string_view)>& canEvict)
+{
+    std::vector<std::string> evicted;
+    if (budget == 0)
+        return evicted;
+
+    for (auto node = _order.end(); node != _order.begin() && _bytes > budget;)
+    {
+        auto it = _entries.find(*--node);
+        if (it->second.bytes == 0 || isPinned(it->first) || !canEvict(it->first))
+            continue;
+
+        _bytes -= it->second.bytes;
+        evicted.emplace_back(std::move(*node));
+        _entries.erase(it);
+        // continue from the successor of the removed node
+        node = _order.erase(node);
+    }
+    return evicted;
+}
+
+NS_AX_END
@@ -0,0 +1,89 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/hlookup.h"
+#include "platform/PlatformMacros.h"
+
+NS_AX_BEGIN
+
+/**
+ * The least recently used order and the byte budget of the decoded audio caches of AudioEngineImpl.
+ *
+ * Entries are keyed by file path and account the bytes of their cache once it's loaded. Pins are kept by key, so a
+ * file can be pinned before it's cached and stays pinned after it's uncached.
+ * @lua NA
+ */
+class AX_DLL AudioCacheLRU
+{
+public:
+    /** Adds an entry as the most recently used one, it holds no bytes until setSize. */
+    void add(std::string_view key);
+
+    /** Makes an entry the most recently used one. */
+    void touch(std::string_view key);
+
+    void setSize(std::string_view key, uint32_t bytes);
+
+    void remove(std::string_view key);
+
+    /** Removes all entries, the pins are kept. */
+    void clear();
+
+    void setPinned(std::string_view key, bool pinned);
+    bool isPinned(std::string_view key) const { return _pinned.find(key) != _pinned.end(); }
+
+    /**
+     * Removes the least recently used entries until the bytes fit in the budget.
+     * The pinned entries, the ones holding no bytes and the ones canEvict refuses are skipped.
+     * @param budget The budget in bytes, 0 means unlimited.
+     * @return The keys of the removed entries, the least recently used first.
+     */
+    std::vector<std::string> trim(size_t budget, const std::function<bool(std::string_view)>& canEvict);
+
+    size_t getBytes() const { return _bytes; }
+    size_t size() const { return _entries.size(); }
+
+private:
+    struct Entry
+    {
+        // node in _order, the most recently used entry is at the front
+        std::list<std::string>::iterator node;
+        uint32_t bytes = 0;
+    };
+
+    hlookup::string_map<Entry> _entries;
+    std::list<std::string> _order;
+    hlookup::string_set _pinned;
+    size_t _bytes = 0;
+};
+
+NS_AX_END
@@ -27,6 +27,7 @@
 #include "platform/PlatformConfig.h"
 
 #include "audio/AudioEngine.h"
+#include <algorithm>
 #include <condition_variable>
 #include <queue>
 #include "platform/FileUtils.h"
@@ -50,6 +51,8 @@ hlookup::string_map<std::list<AUDIO_ID>> AudioEngine::_audioPathIDMap;
 // profileName,ProfileHelper
 hlookup::string_map<AudioEngine::ProfileHelper> AudioEngine::_audioPathProfileHelperMap;
 unsigned int AudioEngine::_maxInstances                        = MAX_AUDIOINSTANCES;
+AudioStreamingConfig AudioEngine::_streamingConfig;
+size_t AudioEngine::_cacheBudget = AUDIO_CACHE_BUDGET_DEFAULT;
 AudioEngine::ProfileHelper* AudioEngine::_defaultProfileHelper = nullptr;
 std::unordered_map<AUDIO_ID, AudioEngine::AudioInfo> AudioEngine::_audioIDInfoMap;
 AudioEngineImpl* AudioEngine::_audioEngineImpl = nullptr;
@@ -408,6 +411,80 @@ bool AudioEngine::setMaxAudioInstance(int maxInstances)
     return false;
 }
 
+void AudioEngine::setStreamingConfig(const AudioStreamingConfig& config)
+{
+    _streamingConfig.bufferCount    = std::clamp(config.bufferCount, 2, QUEUEBUFFER_NUM_MAX);
+    _streamingConfig.bufferDuration = std::clamp(config.bufferDuration, 0.01f, 1.0f);
+    _streamingConfig.workerCount    = (std::max)(config.workerCount, 1);
+
+    if (_audioEngineImpl)
+    {
+        _audioEngineImpl->setStreamingConfig(_streamingConfig);
+    }
+}
+
+AudioMixer::VoiceId AudioEngine::playMixed(std::string_view filePath, const AudioMixer::VoiceSettings& settings)
+{
+    if (!isEnabled() || !lazyInit())
+    {
+        return AudioMixer::INVALID_VOICE;
+    }
+    return _audioEngineImpl->playMixed(filePath, settings);
+}
+
+AudioMixer* AudioEngine::getMixer()
+{
+    return lazyInit() ? _audioEngineImpl->getMixer() : nullptr;
+}
+
+void AudioEngine::setCacheBudget(size_t bytes)
+{
+    _cacheBudget = bytes;
+
+    if (_audioEngineImpl)
+    {
+        _audioEngineImpl->trimCaches();
+    }
+}
+
+void AudioEngine::setCachePinned(std::string_view filePath, bool pinned)
+{
+    if (lazyInit())
+    {
+        _audioEngineImpl->setCachePinned(filePath, pinned);
+    }
+}
+
+AudioCacheStats AudioEngine::getCacheStats()
+{
+    if (_audioEngineImpl)
+    {
+        return _audioEngineImpl->getCacheStats();
+    }
+
+    AudioCacheStats stats;
+    stats.budget = _cacheBudget;
+    return stats;
+}
+
+AudioStreamingStats AudioEngine::getStreamingStats()
+{
+    if (_audioEngineImpl)
+    {
+        return _audioEngineImpl->getStreamingStats();
+    }
+    return AudioStreamingStats{};
+}
+
+unsigned int AudioEngine::getUnderrunCount(AUDIO_ID audioID)
+{
+    if (_audioEngineImpl)
+    {
+        return _audioEngineImpl->getUnderrunCount(audioID);
+    }
+    return 0;
+}
+
 bool AudioEngine::isLoop(AUDIO_ID audioID)
 {
     auto tmpIterator = _audioIDInfoMap.find(audioID);
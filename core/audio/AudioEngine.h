@@ -29,6 +29,7 @@
 #include "platform/PlatformConfig.h"
 #include "platform/PlatformMacros.h"
 #include "audio/AudioMacros.h"
+#include "audio/AudioMixer.h"
 #include <functional>
 #include <list>
 #include <string>
@@ -58,6 +59,48 @@ struct AX_DLL AudioPlayerSettings
     float time = 0.0f; // The initial time offset when play audio
 };
 
+/**
+ * @struct AudioStreamingConfig
+ *
+ * @brief Tunables of the audio files which are too large to be cached and are streamed instead.
+ * @js NA
+ */
+struct AX_DLL AudioStreamingConfig
+{
+    int bufferCount = QUEUEBUFFER_NUM; // OpenAL buffers queued per source (range from 2 to QUEUEBUFFER_NUM_MAX).
+    float bufferDuration = QUEUEBUFFER_TIME_STEP; // Seconds of audio held by each buffer (range from 0.01 to 1.0).
+    int workerCount = 1; // Threads which refill the buffers of all streaming sources.
+};
+
+/**
+ * @struct AudioStreamingStats
+ *
+ * @brief Counters of the audio streaming service.
+ * @js NA
+ */
+struct AX_DLL AudioStreamingStats
+{
+    int activeStreams = 0; // Streaming sources currently serviced.
+    uint64_t underruns = 0; // Times a streaming source ran out of buffers and was restarted.
+    uint64_t streamedBuffers = 0; // Buffers refilled since the engine was initialized.
+};
+
+/**
+ * @struct AudioCacheStats
+ *
+ * @brief Counters of the decoded audio caches.
+ * @js NA
+ */
+struct AX_DLL AudioCacheStats
+{
+    size_t budget = 0; // The byte budget, 0 means unlimited.
+    size_t bytes = 0; // Decoded bytes held by all caches.
+    int entries = 0; // Cached audio files, including the ones still loading.
+    uint64_t hits = 0; // Plays and preloads served by an existing cache.
+    uint64_t misses = 0; // Plays and preloads which had to decode the file.
+    uint64_t evictions = 0; // Caches released to stay within the budget.
+};
+
 /**
  * @class AudioProfile
  *
@@ -271,6 +314,50 @@ public:
      */
     static bool setMaxAudioInstance(int maxInstances);
 
+    /**
+     * Play a sound effect through the software mixer.
+     *
+     * Mixed voices don't take an OpenAL source each, all of them are rendered into one stream, so hundreds of
+     * concurrent effects are cheap. Control the returned voice with getMixer().
+     *
+     * @param filePath The path of a 16-bit or float pcm audio file, it's decoded into memory on first use.
+     * @param settings The volume, pan, pitch, loop and priority of the voice.
+     * @return The voice id, AudioMixer::INVALID_VOICE on failure.
+     */
+    static AudioMixer::VoiceId playMixed(std::string_view filePath,
+                                         const AudioMixer::VoiceSettings& settings = AudioMixer::VoiceSettings{});
+
+    /**
+     * Gets the software mixer, it starts its output stream on first use.
+     */
+    static AudioMixer* getMixer();
+
+    /**
+     * Sets the streaming tunables.
+     *
+     * @note The buffer count and duration apply to the audio files loaded afterwards, call uncache first to
+     * reload a file with new settings. The worker count applies immediately.
+     * @param config The streaming tunables, out of range values are clamped.
+     */
+    static void setStreamingConfig(const AudioStreamingConfig& config);
+
+    /**
+     * Gets the streaming tunables.
+     */
+    static const AudioStreamingConfig& getStreamingConfig() { return _streamingConfig; }
+
+    /**
+     * Gets the counters of the streaming service.
+     */
+    static AudioStreamingStats getStreamingStats();
+
+    /**
+     * Gets how many times a streaming audio instance ran out of buffers, always 0 for cached audio.
+     *
+     * @param audioID An audioID returned by the play2d function.
+     */
+    static unsigned int getUnderrunCount(AUDIO_ID audioID);
+
     /**
      * Uncache the audio data from internal buffer.
      * AudioEngine cache audio data on ios,mac, and win32 platform.
@@ -287,6 +374,35 @@ public:
      */
     static void uncacheAll();
 
+    /**
+     * Sets the byte budget of the decoded audio caches.
+     *
+     * When the caches grow over the budget the least recently used ones are released, they are decoded again the
+     * next time they are played. Caches of playing or loading audio and pinned caches are never released.
+     *
+     * @param bytes The budget in bytes, 0 means unlimited. Default is 0.
+     */
+    static void setCacheBudget(size_t bytes);
+
+    /**
+     * Gets the byte budget of the decoded audio caches.
+     */
+    static size_t getCacheBudget() { return _cacheBudget; }
+
+    /**
+     * Pins the cache of an audio file, e.g. for UI sounds.
+     * A pinned cache is never released by the budget and its preload skips the prefetch queue.
+     *
+     * @param filePath Audio file path, it doesn't need to be loaded yet.
+     * @param pinned Whether to pin or unpin the cache.
+     */
+    static void setCachePinned(std::string_view filePath, bool pinned);
+
+    /**
+     * Gets the counters of the decoded audio caches.
+     */
+    static AudioCacheStats getCacheStats();
+
     /**
      * Gets the audio profile by id of audio instance.
      *
@@ -311,6 +427,8 @@ public:
 
     /**
      * Preload audio file.
+     * @note At most AUDIO_PREFETCH_TASKS_MAX preloads decode at once, the others are queued. Playing an audio file
+     * which is still queued loads it immediately.
      * @param filePath The file path of an audio.
      * @param callback A callback which will be called after loading is finished.
      */
@@ -378,6 +496,10 @@ protected:
 
     static unsigned int _maxInstances;
 
+    static AudioStreamingConfig _streamingConfig;
+
+    static size_t _cacheBudget;
+
     static ProfileHelper* _defaultProfileHelper;
 
     static AudioEngineImpl* _audioEngineImpl;
@@ -29,6 +29,9 @@
 
 #include "audio/AudioEngineImpl.h"
 #include "audio/AudioDecoderManager.h"
+#include "audio/AudioDecoder.h"
+
+#include <algorithm>
 
 #if AX_TARGET_PLATFORM == AX_PLATFORM_IOS || AX_TARGET_PLATFORM == AX_PLATFORM_MAC
 #    import <AVFoundation/AVFoundation.h>
@@ -315,7 +318,8 @@ ALvoid ax::AudioEngineImpl::myAlSourceNotificationCallback(ALuint sid, ALuint no
         player = e.second;
         if (player->_alSource == sid && player->_streamingSource)
         {
-            player->wakeupRotateThread();
+            s_instance->_streamer->wakeup();
+            break;
         }
     }
     s_instance->_threadMutex.unlock();
@@ -324,7 +328,14 @@ ALvoid ax::AudioEngineImpl::myAlSourceNotificationCallback(ALuint sid, ALuint no
 
 NS_AX_BEGIN
 
-AudioEngineImpl::AudioEngineImpl() : _scheduled(false), _currentAudioID(0), _scheduler(nullptr)
+AudioEngineImpl::AudioEngineImpl()
+    : _runningPrefetches(0)
+    , _cacheHits(0)
+    , _cacheMisses(0)
+    , _cacheEvictions(0)
+    , _scheduled(false)
+    , _currentAudioID(0)
+    , _scheduler(nullptr)
 {
     s_instance = this;
 }
@@ -336,11 +347,20 @@ AudioEngineImpl::~AudioEngineImpl()
         _scheduler->unschedule(AX_SCHEDULE_SELECTOR(AudioEngineImpl::update), this);
     }
 
+    if (_mixerStream)
+    {
+        _streamer->remove(_mixerStream.get());
+        _mixerStream.reset();
+    }
+
+    // all players were destroyed by AudioEngine::end already
+    _streamer.reset();
+
     if (s_ALContext)
     {
         alDeleteSources(MAX_AUDIOINSTANCES, _alSources);
 
-        _audioCaches.clear();
+        uncacheAll();
 
         alcMakeContextCurrent(nullptr);
         alcDestroyContext(s_ALContext);
@@ -457,6 +477,8 @@ bool AudioEngineImpl::init()
 
             _scheduler          = Director::getInstance()->getScheduler();
             ret                 = AudioDecoderManager::init();
+            _streamer           = std::make_unique<AudioStreamer>(AudioEngine::_streamingConfig.workerCount);
+            setStreamingConfig(AudioEngine::_streamingConfig);
             const char* vender  = alGetString(AL_VENDOR);
             const char* version = alGetString(AL_VERSION);
 
@@ -495,30 +517,56 @@ bool AudioEngineImpl::init()
 }
 
 AudioCache* AudioEngineImpl::preload(std::string_view filePath, std::function<void(bool)> callback)
+{
+    return _preload(filePath, std::move(callback), true);
+}
+
+AudioCache* AudioEngineImpl::_preload(std::string_view filePath, std::function<void(bool)> callback, bool prefetch)
 {
     AudioCache* audioCache = nullptr;
 
     auto it = _audioCaches.find(filePath);
     if (it == _audioCaches.end())
     {
+        ++_cacheMisses;
         audioCache = new AudioCache();  // hlookup_second(it);
-        _audioCaches.emplace(filePath, std::unique_ptr<AudioCache>(audioCache));
-        audioCache->_fileFullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
-        unsigned int cacheId      = audioCache->_id;
-        auto isCacheDestroyed     = audioCache->_isDestroyed;
-        AudioEngine::addTask([audioCache, cacheId, isCacheDestroyed]() {
-            if (*isCacheDestroyed)
-            {
-                AXLOGV("AudioCache (id={}) was destroyed, no need to launch readDataTask.", cacheId);
-                audioCache->setSkipReadDataTask(true);
-                return;
-            }
-            audioCache->readDataTask(cacheId);
-        });
+        audioCache->_queBufferNum      = AudioEngine::_streamingConfig.bufferCount;
+        audioCache->_queBufferDuration = AudioEngine::_streamingConfig.bufferDuration;
+        audioCache->_fileFullPath      = FileUtils::getInstance()->fullPathForFilename(filePath);
+
+        CacheEntry entry;
+        entry.cache = std::unique_ptr<AudioCache>(audioCache);
+        it          = _audioCaches.emplace(filePath, std::move(entry)).first;
+        _cacheLRU.add(filePath);
+
+        // registered first, so the budget is settled before the user callbacks run
+        audioCache->addLoadCallback(
+            [this, key = std::string{filePath}](bool isSuccess) { _onCacheLoaded(key, isSuccess); });
+
+        if (prefetch && !_cacheLRU.isPinned(filePath))
+        {
+            it.value().prefetch = PrefetchState::QUEUED;
+            _prefetchQueue.emplace_back(filePath);
+            _launchPrefetches();
+        }
+        else
+        {
+            _readCache(audioCache);
+        }
     }
     else
     {
-        audioCache = it->second.get();
+        ++_cacheHits;
+        auto& entry = it.value();
+        audioCache  = entry.cache.get();
+        _cacheLRU.touch(filePath);
+
+        // playing a queued preload can't wait for a prefetch slot
+        if (!prefetch && entry.prefetch == PrefetchState::QUEUED)
+        {
+            entry.prefetch = PrefetchState::NONE;
+            _readCache(audioCache);
+        }
     }
 
     if (audioCache && callback)
@@ -528,6 +576,259 @@ AudioCache* AudioEngineImpl::preload(std::string_view filePath, std::function<vo
     return audioCache;
 }
 
+void AudioEngineImpl::_readCache(AudioCache* audioCache)
+{
+    unsigned int cacheId  = audioCache->_id;
+    auto isCacheDestroyed = audioCache->_isDestroyed;
+    AudioEngine::addTask([audioCache, cacheId, isCacheDestroyed]() {
+        if (*isCacheDestroyed)
+        {
+            AXLOGV("AudioCache (id={}) was destroyed, no need to launch readDataTask.", cacheId);
+            audioCache->setSkipReadDataTask(true);
+            return;
+        }
+        audioCache->readDataTask(cacheId);
+    });
+}
+
+void AudioEngineImpl::_onCacheLoaded(std::string_view filePath, bool isSuccess)
+{
+    auto it = _audioCaches.find(filePath);
+    if (it == _audioCaches.end())
+        return;
+
+    auto& entry = it.value();
+    if (entry.prefetch == PrefetchState::RUNNING)
+    {
+        entry.prefetch = PrefetchState::NONE;
+        --_runningPrefetches;
+    }
+
+    if (isSuccess)
+    {
+        _cacheLRU.setSize(filePath, entry.cache->_sizeInBytes);
+    }
+    else
+    {
+        // erased once the other load callbacks ran, so a later preload tries again
+        _failedCaches.emplace_back(filePath);
+        _scheduler->runOnAxmolThread([this, isCacheDestroyed = entry.cache->_isDestroyed]() {
+            if (!*isCacheDestroyed)
+                trimCaches();
+        });
+    }
+
+    _launchPrefetches();
+    trimCaches();
+}
+
+void AudioEngineImpl::_launchPrefetches()
+{
+    while (_runningPrefetches < AUDIO_PREFETCH_TASKS_MAX && !_prefetchQueue.empty())
+    {
+        auto it = _audioCaches.find(_prefetchQueue.front());
+        _prefetchQueue.pop_front();
+
+        // uncached or promoted by play2d meanwhile
+        if (it == _audioCaches.end() || it->second.prefetch != PrefetchState::QUEUED)
+            continue;
+
+        it.value().prefetch = PrefetchState::RUNNING;
+        ++_runningPrefetches;
+        _readCache(it->second.cache.get());
+    }
+}
+
+void AudioEngineImpl::_eraseCache(hlookup::string_map<CacheEntry>::iterator it)
+{
+    auto& entry = it.value();
+    switch (entry.prefetch)
+    {
+    case PrefetchState::QUEUED:
+        // the read task was never launched, don't let ~AudioCache wait for it
+        entry.cache->setSkipReadDataTask(true);
+        break;
+    case PrefetchState::RUNNING:
+        --_runningPrefetches;
+        break;
+    default:
+        break;
+    }
+
+    _cacheLRU.remove(it->first);
+    _audioCaches.erase(it);
+}
+
+bool AudioEngineImpl::_isCacheInUse(AudioCache* cache) const
+{
+    // a cache whose load callbacks are running is in use by them
+    if (cache->_isInvokingLoadCallbacks)
+        return true;
+
+    for (auto&& player : _audioPlayers)
+    {
+        if (player.second->_audioCache == cache)
+            return true;
+    }
+    return false;
+}
+
+void AudioEngineImpl::_eraseFailedCaches()
+{
+    std::erase_if(_failedCaches, [this](const std::string& key) {
+        auto it = _audioCaches.find(key);
+        // uncached meanwhile, maybe cached again since
+        if (it == _audioCaches.end() || it->second.cache->_state != AudioCache::State::FAILED)
+            return true;
+        if (_isCacheInUse(it->second.cache.get()))
+            return false;
+
+        _eraseCache(it);
+        return true;
+    });
+}
+
+void AudioEngineImpl::trimCaches()
+{
+    const size_t budget = AudioEngine::_cacheBudget;
+    if (_failedCaches.empty() && (budget == 0 || _cacheLRU.getBytes() <= budget))
+        return;
+
+    std::lock_guard<std::recursive_mutex> lck(_threadMutex);
+
+    _eraseFailedCaches();
+
+    auto evicted = _cacheLRU.trim(budget, [this](std::string_view key) {
+        auto cache = _audioCaches.find(key)->second.cache.get();
+        return cache->_isLoadingFinished && !_isCacheInUse(cache);
+    });
+    for (auto&& key : evicted)
+    {
+        auto it    = _audioCaches.find(key);
+        auto cache = it->second.cache.get();
+        AXLOGV("AudioEngineImpl: evict {}, {} bytes", cache->_fileFullPath, cache->_sizeInBytes);
+        ++_cacheEvictions;
+        _eraseCache(it);
+    }
+}
+
+void AudioEngineImpl::setCachePinned(std::string_view filePath, bool pinned)
+{
+    _cacheLRU.setPinned(filePath, pinned);
+    if (!pinned)
+        trimCaches();
+}
+
+AudioCacheStats AudioEngineImpl::getCacheStats() const
+{
+    AudioCacheStats stats;
+    stats.budget    = AudioEngine::_cacheBudget;
+    stats.bytes     = _cacheLRU.getBytes();
+    stats.entries   = static_cast<int>(_audioCaches.size());
+    stats.hits      = _cacheHits;
+    stats.misses    = _cacheMisses;
+    stats.evictions = _cacheEvictions;
+    return stats;
+}
+
+AudioMixer* AudioEngineImpl::getMixer()
+{
+    if (!_mixer)
+    {
+        _mixer = std::make_unique<AudioMixer>();
+
+        ALuint alSource = findValidSource();
+        if (alSource == AL_INVALID)
+        {
+            AXLOGE("{}: no OpenAL source left for the mixer output", __FUNCTION__);
+            return _mixer.get();
+        }
+
+        auto& config   = AudioEngine::_streamingConfig;
+        auto frames    = static_cast<uint32_t>(_mixer->getSampleRate() * config.bufferDuration);
+        _mixerStream   = std::make_unique<AudioMixerStream>(_mixer.get(), alSource);
+        if (_mixerStream->open(config.bufferCount, frames))
+        {
+            _streamer->add(_mixerStream.get());
+        }
+        else
+        {
+            _mixerStream.reset();
+            _unusedSourcesPool.push(alSource);
+        }
+    }
+    return _mixer.get();
+}
+
+AudioMixer::VoiceId AudioEngineImpl::playMixed(std::string_view filePath, const AudioMixer::VoiceSettings& settings)
+{
+    if (s_ALDevice == nullptr)
+    {
+        return AudioMixer::INVALID_VOICE;
+    }
+
+    auto voice = getMixer()->play(_loadMixerSound(filePath), settings);
+    // restart the mixer output right away if it drained while idle
+    if (voice != AudioMixer::INVALID_VOICE && _mixerStream)
+        _streamer->wakeup();
+    return voice;
+}
+
+std::shared_ptr<AudioMixer::Sound> AudioEngineImpl::_loadMixerSound(std::string_view filePath)
+{
+    auto it = _mixerSounds.find(filePath);
+    if (it != _mixerSounds.end())
+        return it->second;
+
+    auto sound = std::make_shared<AudioMixer::Sound>();
+    _mixerSounds.emplace(filePath, sound);
+
+    AudioEngine::addTask([sound, fullPath = FileUtils::getInstance()->fullPathForFilename(filePath)]() {
+        AudioDecoder* decoder = AudioDecoderManager::createDecoder(fullPath);
+        do
+        {
+            BREAK_IF_ERR_LOG(decoder == nullptr || !decoder->open(fullPath), "{}", fullPath);
+
+            const auto sourceFormat = decoder->getSourceFormat();
+            const int channels      = static_cast<int>(decoder->getChannelCount());
+            BREAK_IF_ERR_LOG((sourceFormat != AUDIO_SOURCE_FORMAT::PCM_16 &&
+                              sourceFormat != AUDIO_SOURCE_FORMAT::PCM_FLT32) ||
+                                 channels > 2,
+                             "{} can't be mixed, only 16-bit or float pcm in mono or stereo", fullPath);
+
+            const uint32_t totalFrames = decoder->getTotalFrames();
+            std::vector<char> pcm(decoder->framesToBytes(totalFrames));
+            uint32_t framesRead = 0;
+            while (framesRead < totalFrames)
+            {
+                auto frames = decoder->read(totalFrames - framesRead, pcm.data() + decoder->framesToBytes(framesRead));
+                if (frames == 0)
+                    break;
+                framesRead += frames;
+            }
+
+            sound->samples.resize(static_cast<size_t>(framesRead) * channels);
+            if (sourceFormat == AUDIO_SOURCE_FORMAT::PCM_16)
+            {
+                memcpy(sound->samples.data(), pcm.data(), sound->samples.size() * sizeof(int16_t));
+            }
+            else
+            {
+                auto samples = reinterpret_cast<const float*>(pcm.data());
+                for (size_t i = 0; i < sound->samples.size(); ++i)
+                    sound->samples[i] = static_cast<int16_t>(std::clamp(samples[i], -1.0f, 1.0f) * 32767.0f);
+            }
+            sound->frames     = framesRead;
+            sound->channels   = channels;
+            sound->sampleRate = static_cast<int>(decoder->getSampleRate());
+        } while (false);
+
+        AudioDecoderManager::destroyDecoder(decoder);
+        sound->ready.store(true, std::memory_order_release);
+    });
+    return sound;
+}
+
 AUDIO_ID AudioEngineImpl::play2d(std::string_view filePath, bool loop, float volume, float time)
 {
     if (s_ALDevice == nullptr)
@@ -550,13 +851,14 @@ AUDIO_ID AudioEngineImpl::play2d(std::string_view filePath, bool loop, float vol
     player->_alSource = alSource;
     player->_loop     = loop;
     player->_volume   = volume;
+    player->_streamer = _streamer.get();
     if (time > 0.0f)
     {
         player->_currTime  = time;
         player->_timeDirty = true;
     }
 
-    auto audioCache = preload(filePath, nullptr);
+    auto audioCache = _preload(filePath, nullptr, false);
     if (audioCache == nullptr)
     {
         delete player;
@@ -749,6 +1051,11 @@ void AudioEngineImpl::stop(AUDIO_ID audioID)
 void AudioEngineImpl::stopAll()
 {
     std::lock_guard<std::recursive_mutex> lck(_threadMutex);
+    if (_mixer)
+    {
+        _mixer->stopAll();
+    }
+
     for (auto&& player : _audioPlayers)
     {
         player.second->destroy();
@@ -868,6 +1175,36 @@ void AudioEngineImpl::setFinishCallback(AUDIO_ID audioID,
     player->_finishCallbak = callback;
 }
 
+unsigned int AudioEngineImpl::getUnderrunCount(AUDIO_ID audioID)
+{
+    std::lock_guard<std::recursive_mutex> lck(_threadMutex);
+    auto iter = _audioPlayers.find(audioID);
+    if (iter == _audioPlayers.end())
+        return 0;
+
+    return iter->second->getUnderrunCount();
+}
+
+void AudioEngineImpl::setStreamingConfig(const AudioStreamingConfig& config)
+{
+    // the buffer count and duration are picked up by the caches loaded from now on
+    if (!_streamer)
+        return;
+    _streamer->setWorkerCount(config.workerCount);
+    _streamer->setIdleWait(std::chrono::milliseconds(static_cast<long long>(config.bufferDuration * 1000) / 2));
+}
+
+AudioStreamingStats AudioEngineImpl::getStreamingStats() const
+{
+    AudioStreamingStats stats;
+    if (!_streamer)
+        return stats;
+    stats.activeStreams   = _streamer->getActiveStreams();
+    stats.underruns       = _streamer->getUnderrunCount();
+    stats.streamedBuffers = _streamer->getStreamedBufferCount();
+    return stats;
+}
+
 void AudioEngineImpl::update(float /*dt*/)
 {
     std::unique_lock<std::recursive_mutex> lck(_threadMutex);
@@ -879,6 +1216,7 @@ void AudioEngineImpl::_updatePlayers(bool forStop)
     AUDIO_ID audioID;
     AudioPlayer* player;
     ALuint alSource;
+    const auto playerCount = _audioPlayers.size();
 
     //    AXLOGV("AudioPlayer count: {}", (int)_audioPlayers.size());
     for (auto it = _audioPlayers.begin(); it != _audioPlayers.end();)
@@ -929,6 +1267,10 @@ void AudioEngineImpl::_updatePlayers(bool forStop)
         }
     }
 
+    // the caches of the removed players may be released now
+    if (_audioPlayers.size() != playerCount)
+        trimCaches();
+
     // don't invoke finish callback when stop/stopAll to avoid stack overflow
     if (UTILS_LIKELY(!forStop))
     {
@@ -957,7 +1299,15 @@ void AudioEngineImpl::_unscheduleUpdate()
 
 void AudioEngineImpl::uncache(std::string_view filePath)
 {
-    _audioCaches.erase(filePath);
+    auto it = _audioCaches.find(filePath);
+    if (it != _audioCaches.end())
+    {
+        _eraseCache(it);
+        _launchPrefetches();
+    }
+
+    // the playing voices keep their sound alive
+    _mixerSounds.erase(filePath);
 }
 
 void AudioEngineImpl::uncacheAll()
@@ -966,7 +1316,18 @@ void AudioEngineImpl::uncacheAll()
     for (auto&& player : _audioPlayers)
         player.second->setCache(nullptr);
 
+    for (auto&& item : _audioCaches)
+    {
+        if (item.second.prefetch == PrefetchState::QUEUED)
+            item.second.cache->setSkipReadDataTask(true);
+    }
+
     _audioCaches.clear();
+    _mixerSounds.clear();
+    _cacheLRU.clear();
+    _failedCaches.clear();
+    _prefetchQueue.clear();
+    _runningPrefetches = 0;
 }
 NS_AX_END
 #undef LOG_TAG
@@ -31,11 +31,18 @@
 
 #    include <unordered_map>
 #    include <queue>
+#    include <deque>
+#    include <vector>
 
 #    include "base/Object.h"
 #    include "audio/AudioMacros.h"
+#    include "audio/AudioEngine.h"
 #    include "audio/AudioCache.h"
+#    include "audio/AudioCacheLRU.h"
 #    include "audio/AudioPlayer.h"
+#    include "audio/AudioStreamer.h"
+#    include "audio/AudioMixer.h"
+#    include "audio/AudioMixerStream.h"
 
 NS_AX_BEGIN
 
@@ -59,15 +66,49 @@ public:
     float getCurrentTime(AUDIO_ID audioID);
     bool setCurrentTime(AUDIO_ID audioID, float time);
     void setFinishCallback(AUDIO_ID audioID, const std::function<void(AUDIO_ID, std::string_view)>& callback);
+    unsigned int getUnderrunCount(AUDIO_ID audioID);
+
+    void setStreamingConfig(const AudioStreamingConfig& config);
+    AudioStreamingStats getStreamingStats() const;
 
     void uncache(std::string_view filePath);
     void uncacheAll();
     AudioCache* preload(std::string_view filePath, std::function<void(bool)> callback);
     void update(float dt);
 
+    void setCachePinned(std::string_view filePath, bool pinned);
+    // evicts the least recently used caches until the decoded bytes fit into AudioEngine::getCacheBudget()
+    void trimCaches();
+    AudioCacheStats getCacheStats() const;
+
+    // software mixed voices, all of them share one OpenAL source
+    AudioMixer* getMixer();
+    AudioMixer::VoiceId playMixed(std::string_view filePath, const AudioMixer::VoiceSettings& settings);
+
 private:
+    enum class PrefetchState
+    {
+        NONE,
+        QUEUED,
+        RUNNING
+    };
+
+    struct CacheEntry
+    {
+        std::unique_ptr<AudioCache> cache;
+        PrefetchState prefetch = PrefetchState::NONE;
+    };
+
     // query players state per frame and dispatch finish callback if possible
     void _updatePlayers(bool forStop);
+    AudioCache* _preload(std::string_view filePath, std::function<void(bool)> callback, bool prefetch);
+    void _readCache(AudioCache* audioCache);
+    void _onCacheLoaded(std::string_view filePath, bool isSuccess);
+    void _launchPrefetches();
+    void _eraseCache(hlookup::string_map<CacheEntry>::iterator it);
+    void _eraseFailedCaches();
+    bool _isCacheInUse(AudioCache* cache) const;
+    std::shared_ptr<AudioMixer::Sound> _loadMixerSound(std::string_view filePath);
     void _play2d(AudioCache* cache, AUDIO_ID audioID);
     void _unscheduleUpdate();
     ALuint findValidSource();
@@ -80,12 +121,29 @@ private:
     std::queue<ALuint> _unusedSourcesPool;
 
     // filePath,bufferInfo
-    hlookup::string_map<std::unique_ptr<AudioCache>> _audioCaches;
+    hlookup::string_map<CacheEntry> _audioCaches;
+    AudioCacheLRU _cacheLRU;
+    // keys of the caches which failed to load, erased once their load callbacks ran
+    std::vector<std::string> _failedCaches;
+    // keys of the preload requests waiting for a free prefetch slot
+    std::deque<std::string> _prefetchQueue;
+    int _runningPrefetches;
+    uint64_t _cacheHits;
+    uint64_t _cacheMisses;
+    uint64_t _cacheEvictions;
 
     // audioID,AudioInfo
     std::unordered_map<AUDIO_ID, AudioPlayer*> _audioPlayers;
     std::recursive_mutex _threadMutex;
 
+    // refills the buffer queues of all streaming players
+    std::unique_ptr<AudioStreamer> _streamer;
+
+    std::unique_ptr<AudioMixer> _mixer;
+    std::unique_ptr<AudioMixerStream> _mixerStream;
+    // filePath, decoded 16-bit pcm of the mixed voices
+    hlookup::string_map<std::shared_ptr<AudioMixer::Sound>> _mixerSounds;
+
     // finish callbacks
     std::vector<std::function<void()>> _finishCallbacks;
 
@@ -30,9 +30,16 @@
 
 #include <functional>
 
+// Defaults of AudioEngine::StreamingConfig, the streaming buffer count is clamped to QUEUEBUFFER_NUM_MAX
 #define QUEUEBUFFER_NUM (3)
+#define QUEUEBUFFER_NUM_MAX (8)
 #define QUEUEBUFFER_TIME_STEP (0.05f)
 
+// Default byte budget of the decoded audio caches, unlimited like before the budget, see AudioEngine::setCacheBudget
+#define AUDIO_CACHE_BUDGET_DEFAULT (0)
+// How many AudioEngine::preload requests decode at once, the others wait in a queue
+#define AUDIO_PREFETCH_TASKS_MAX (2)
+
 #define QUOTEME_(x) #x
 #define QUOTEME(x) QUOTEME_(x)
 
@@ -0,0 +1,392 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "audio/AudioMixer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(AX_USE_SSE)
+#    include <xmmintrin.h>
+#    define AX_MIXER_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#    include <arm_neon.h>
+#    define AX_MIXER_NEON 1
+#endif
+
+NS_AX_BEGIN
+
+namespace
+{
+constexpr uint64_t FIXED_ONE   = 1ull << 32;
+constexpr float FRACTION_SCALE = 1.0f / 4294967296.0f;
+constexpr float SAMPLE_SCALE   = 1.0f / 32768.0f;
+// the OpenAL Soft voices cap the pitch at 10 as well, the lower bound keeps the step positive
+constexpr float MIN_PITCH = 1.0f / 1024.0f;
+constexpr float MAX_PITCH = 10.0f;
+
+inline float clampPitch(float pitch)
+{
+    return std::isnan(pitch) ? 1.0f : std::clamp(pitch, MIN_PITCH, MAX_PITCH);
+}
+
+// out[0..1] += (lerp(left), lerp(right)) * gains, for one frame
+inline void mixFrame(float a0, float b0, float a1, float b1, float f, float gl, float gr, float* out)
+{
+    out[0] += (a0 + (b0 - a0) * f) * gl;
+    out[1] += (a1 + (b1 - a1) * f) * gr;
+}
+
+// out[0..7] += interleave(lerp(left), lerp(right)) * gains, for four frames
+inline void mixFrames4(const float* a0,
+                       const float* b0,
+                       const float* a1,
+                       const float* b1,
+                       const float* f,
+                       float gl,
+                       float gr,
+                       float* out)
+{
+#if defined(AX_MIXER_SSE)
+    const __m128 vf = _mm_load_ps(f);
+    __m128 va       = _mm_load_ps(a0);
+    const __m128 l  = _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(b0), va), vf));
+    va              = _mm_load_ps(a1);
+    const __m128 r  = _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(b1), va), vf));
+    const __m128 g  = _mm_setr_ps(gl, gr, gl, gr);
+    _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(_mm_unpacklo_ps(l, r), g)));
+    _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_mul_ps(_mm_unpackhi_ps(l, r), g)));
+#elif defined(AX_MIXER_NEON)
+    const float32x4_t vf = vld1q_f32(f);
+    float32x4_t va       = vld1q_f32(a0);
+    const float32x4_t l  = vaddq_f32(va, vmulq_f32(vsubq_f32(vld1q_f32(b0), va), vf));
+    va                   = vld1q_f32(a1);
+    const float32x4_t r  = vaddq_f32(va, vmulq_f32(vsubq_f32(vld1q_f32(b1), va), vf));
+    const float gains[4] = {gl, gr, gl, gr};
+    const float32x4_t g  = vld1q_f32(gains);
+    const float32x4x2_t lr = vzipq_f32(l, r);
+    vst1q_f32(out, vaddq_f32(vld1q_f32(out), vmulq_f32(lr.val[0], g)));
+    vst1q_f32(out + 4, vaddq_f32(vld1q_f32(out + 4), vmulq_f32(lr.val[1], g)));
+#else
+    for (int i = 0; i < 4; ++i)
+        mixFrame(a0[i], b0[i], a1[i], b1[i], f[i], gl, gr, out + i * 2);
+#endif
+}
+
+// linear balance, a centered voice plays at full volume on both sides
+inline void computeGains(float volume, float pan, float& gl, float& gr)
+{
+    gl = pan > 0.0f ? volume * (1.0f - pan) : volume;
+    gr = pan < 0.0f ? volume * (1.0f + pan) : volume;
+}
+}  // namespace
+
+AudioMixer::AudioMixer(int sampleRate)
+    : _sampleRate(sampleRate)
+    , _maxRealVoices(32)
+    , _audibilityThreshold(0.001f)
+    , _nextVoiceId(INVALID_VOICE + 1)
+    , _voiceCount(0)
+{}
+
+AudioMixer::VoiceId AudioMixer::play(std::shared_ptr<const Sound> sound, const VoiceSettings& settings)
+{
+    if (!sound || (sound->ready && sound->frames == 0))
+        return INVALID_VOICE;
+
+    std::lock_guard<std::mutex> lck(_mutex);
+    Voice voice;
+    voice.id       = _nextVoiceId++;
+    voice.sound    = std::move(sound);
+    voice.position = 0;
+    voice.step     = FIXED_ONE;
+    voice.volume   = std::clamp(settings.volume, 0.0f, 1.0f);
+    voice.pan      = std::clamp(settings.pan, -1.0f, 1.0f);
+    voice.pitch    = clampPitch(settings.pitch);
+    voice.loop     = settings.loop;
+    voice.priority = settings.priority;
+    voice.real     = false;
+    if (_nextVoiceId == INVALID_VOICE)
+        ++_nextVoiceId;
+
+    _voices.emplace_back(std::move(voice));
+    _voiceCount.store(static_cast<int>(_voices.size()), std::memory_order_release);
+    return _voices.back().id;
+}
+
+AudioMixer::VoiceId AudioMixer::play(std::shared_ptr<const Sound> sound)
+{
+    return play(std::move(sound), VoiceSettings{});
+}
+
+void AudioMixer::stop(VoiceId voice)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    auto it = std::find_if(_voices.begin(), _voices.end(), [voice](const Voice& v) { return v.id == voice; });
+    if (it != _voices.end())
+    {
+        _voices.erase(it);
+        _voiceCount.store(static_cast<int>(_voices.size()), std::memory_order_release);
+    }
+}
+
+void AudioMixer::stopAll()
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    _voices.clear();
+    _voiceCount.store(0, std::memory_order_release);
+}
+
+bool AudioMixer::isPlaying(VoiceId voice) const
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    return findVoice(voice) != nullptr;
+}
+
+void AudioMixer::setVolume(VoiceId voice, float volume)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    if (auto v = findVoice(voice))
+        v->volume = std::clamp(volume, 0.0f, 1.0f);
+}
+
+void AudioMixer::setPan(VoiceId voice, float pan)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    if (auto v = findVoice(voice))
+        v->pan = std::clamp(pan, -1.0f, 1.0f);
+}
+
+void AudioMixer::setPitch(VoiceId voice, float pitch)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    if (auto v = findVoice(voice))
+        v->pitch = clampPitch(pitch);
+}
+
+void AudioMixer::setMaxRealVoices(int maxRealVoices)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    _maxRealVoices = (std::max)(maxRealVoices, 0);
+}
+
+void AudioMixer::setAudibilityThreshold(float threshold)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    _audibilityThreshold = (std::max)(threshold, 0.0f);
+}
+
+AudioMixer::Stats AudioMixer::getStats() const
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    return _stats;
+}
+
+AudioMixer::Voice* AudioMixer::findVoice(VoiceId voice)
+{
+    auto it = std::find_if(_voices.begin(), _voices.end(), [voice](const Voice& v) { return v.id == voice; });
+    return it != _voices.end() ? &*it : nullptr;
+}
+
+const AudioMixer::Voice* AudioMixer::findVoice(VoiceId voice) const
+{
+    return const_cast<AudioMixer*>(this)->findVoice(voice);
+}
+
+void AudioMixer::updateStep(Voice& voice) const
+{
+    const double step = static_cast<double>(voice.pitch) * voice.sound->sampleRate / _sampleRate;
+    voice.step        = (std::max)(static_cast<uint64_t>(step * FIXED_ONE), uint64_t{1});
+}
+
+void AudioMixer::virtualize()
+{
+    _audible.clear();
+    for (auto&& voice : _voices)
+    {
+        voice.real = false;
+        // voices of a sound which isn't decoded yet or failed to decode don't take a real voice
+        if (!voice.sound->ready.load(std::memory_order_acquire) || voice.sound->frames == 0)
+            continue;
+        if (voice.volume > 0.0f && voice.volume >= _audibilityThreshold)
+            _audible.emplace_back(&voice);
+    }
+
+    // a total order, so the same voices are picked on every run
+    if (static_cast<int>(_audible.size()) > _maxRealVoices)
+    {
+        std::nth_element(_audible.begin(), _audible.begin() + _maxRealVoices, _audible.end(),
+                         [](const Voice* a, const Voice* b) {
+            if (a->priority != b->priority)
+                return a->priority > b->priority;
+            if (a->volume != b->volume)
+                return a->volume > b->volume;
+            return a->id < b->id;
+        });
+        _audible.resize(_maxRealVoices);
+    }
+
+    for (auto voice : _audible)
+        voice->real = true;
+}
+
+bool AudioMixer::mixVoice(Voice& voice, float* out, uint32_t frames) const
+{
+    const Sound& sound   = *voice.sound;
+    const int16_t* src   = sound.samples.data();
+    const int channels   = sound.channels;
+    const int right      = channels > 1 ? 1 : 0;
+    const uint64_t end   = static_cast<uint64_t>(sound.frames) << 32;
+    const uint64_t step  = voice.step;
+    // positions before it interpolate between two frames of the sound
+    const uint64_t inner = end - FIXED_ONE;
+
+    float gl, gr;
+    computeGains(voice.volume, voice.pan, gl, gr);
+
+    alignas(16) float a0[4], b0[4], a1[4], b1[4], f[4];
+    uint64_t pos = voice.position;
+    uint32_t i   = 0;
+    while (i < frames)
+    {
+        if (pos >= end)
+        {
+            if (!voice.loop)
+            {
+                voice.position = pos;
+                return false;
+            }
+            pos %= end;
+        }
+
+        uint32_t n = 0;
+        if (pos < inner)
+            n = static_cast<uint32_t>((std::min)(uint64_t{frames - i}, (inner - pos + step - 1) / step));
+
+        for (; n >= 4; n -= 4, i += 4)
+        {
+            for (int k = 0; k < 4; ++k, pos += step)
+            {
+                const int16_t* s = src + (pos >> 32) * channels;
+                f[k]             = static_cast<float>(pos & (FIXED_ONE - 1)) * FRACTION_SCALE;
+                a0[k]            = s[0] * SAMPLE_SCALE;
+                b0[k]            = s[channels] * SAMPLE_SCALE;
+                a1[k]            = s[right] * SAMPLE_SCALE;
+                b1[k]            = s[channels + right] * SAMPLE_SCALE;
+            }
+            mixFrames4(a0, b0, a1, b1, f, gl, gr, out + i * CHANNELS);
+        }
+
+        for (; n > 0; --n, ++i, pos += step)
+        {
+            const int16_t* s = src + (pos >> 32) * channels;
+            mixFrame(s[0] * SAMPLE_SCALE, s[channels] * SAMPLE_SCALE, s[right] * SAMPLE_SCALE,
+                     s[channels + right] * SAMPLE_SCALE, static_cast<float>(pos & (FIXED_ONE - 1)) * FRACTION_SCALE,
+                     gl, gr, out + i * CHANNELS);
+        }
+
+        // the last frame of the sound interpolates towards the first one when looping
+        if (i < frames && pos >= inner && pos < end)
+        {
+            const int16_t* s    = src + (pos >> 32) * channels;
+            const int16_t* next = voice.loop ? src : s;
+            mixFrame(s[0] * SAMPLE_SCALE, next[0] * SAMPLE_SCALE, s[right] * SAMPLE_SCALE, next[right] * SAMPLE_SCALE,
+                     static_cast<float>(pos & (FIXED_ONE - 1)) * FRACTION_SCALE, gl, gr, out + i * CHANNELS);
+            pos += step;
+            ++i;
+        }
+    }
+
+    voice.position = pos;
+    return voice.loop || pos < end;
+}
+
+bool AudioMixer::advanceVoice(Voice& voice, uint32_t frames) const
+{
+    const uint64_t end = static_cast<uint64_t>(voice.sound->frames) << 32;
+    voice.position += voice.step * frames;
+    if (voice.position >= end)
+    {
+        if (!voice.loop)
+            return false;
+        voice.position %= end;
+    }
+    return true;
+}
+
+void AudioMixer::renderVoices(float* out, uint32_t frames)
+{
+    std::fill(out, out + frames * CHANNELS, 0.0f);
+
+    virtualize();
+
+    _stats = Stats{};
+    for (auto&& voice : _voices)
+    {
+        // the sound is still being decoded
+        if (!voice.sound->ready.load(std::memory_order_acquire))
+            continue;
+
+        // the sound failed to decode
+        if (voice.sound->frames == 0)
+        {
+            voice.id = INVALID_VOICE;
+            continue;
+        }
+
+        updateStep(voice);
+        const bool playing = voice.real ? mixVoice(voice, out, frames) : advanceVoice(voice, frames);
+        if (!playing)
+        {
+            voice.id = INVALID_VOICE;
+            continue;
+        }
+
+        ++_stats.voices;
+        ++(voice.real ? _stats.realVoices : _stats.virtualVoices);
+    }
+
+    _voices.erase(
+        std::remove_if(_voices.begin(), _voices.end(), [](const Voice& v) { return v.id == INVALID_VOICE; }),
+        _voices.end());
+    _voiceCount.store(static_cast<int>(_voices.size()), std::memory_order_release);
+}
+
+void AudioMixer::render(float* out, uint32_t frames)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    renderVoices(out, frames);
+}
+
+void AudioMixer::render(int16_t* out, uint32_t frames)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    _scratch.resize(frames * CHANNELS);
+    renderVoices(_scratch.data(), frames);
+
+    for (size_t i = 0; i < _scratch.size(); ++i)
+        out[i] = static_cast<int16_t>(std::clamp(_scratch[i], -1.0f, 1.0f) * 32767.0f);
+}
+
+NS_AX_END
@@ -0,0 +1,153 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/PlatformConfig.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "platform/PlatformMacros.h"
+
+NS_AX_BEGIN
+
+/**
+ * A software mixer which renders many logical voices into one interleaved stereo stream.
+ *
+ * Voices are resampled with linear interpolation (SSE or NEON when available), scaled by their volume and pan and
+ * summed up. Only the most audible voices are mixed: voices quieter than the audibility threshold and the ones over
+ * the real voice limit are virtualized, they keep advancing but cost no mixing. Given the same commands the output
+ * is the same on every run, render() can be invoked offline to fill a plain buffer.
+ *
+ * The voice commands and render() may be invoked from different threads.
+ */
+class AX_DLL AudioMixer
+{
+public:
+    static constexpr int CHANNELS = 2;
+
+    using VoiceId = uint32_t;
+    static constexpr VoiceId INVALID_VOICE = 0;
+
+    /** 16-bit PCM data of a sound, mono or stereo interleaved. */
+    struct Sound
+    {
+        std::vector<int16_t> samples;
+        uint32_t frames = 0;
+        int channels    = 1;
+        int sampleRate  = 44100;
+        // set once the samples are filled, voices of a sound which isn't ready yet stay silent
+        std::atomic<bool> ready{false};
+    };
+
+    struct VoiceSettings
+    {
+        float volume = 1.0f;  // 0.0 to 1.0
+        float pan    = 0.0f;  // -1.0 (left) to 1.0 (right)
+        float pitch  = 1.0f;  // playback rate, clamped to (0.0, 10.0], NaN plays at 1.0
+        bool loop    = false;
+        int priority = 0;  // higher priority voices are kept real first
+    };
+
+    struct Stats
+    {
+        int voices        = 0;
+        int realVoices    = 0;
+        int virtualVoices = 0;
+    };
+
+    explicit AudioMixer(int sampleRate = 48000);
+
+    int getSampleRate() const { return _sampleRate; }
+
+    /** Starts a voice, returns INVALID_VOICE when the sound is empty. */
+    VoiceId play(std::shared_ptr<const Sound> sound, const VoiceSettings& settings);
+    VoiceId play(std::shared_ptr<const Sound> sound);
+    void stop(VoiceId voice);
+    void stopAll();
+    bool isPlaying(VoiceId voice) const;
+    /** Whether any voice is playing, including the ones of sounds still being decoded. Doesn't lock. */
+    bool hasVoices() const { return _voiceCount.load(std::memory_order_acquire) > 0; }
+
+    void setVolume(VoiceId voice, float volume);
+    void setPan(VoiceId voice, float pan);
+    void setPitch(VoiceId voice, float pitch);
+
+    /** The maximum number of voices mixed at once, the less audible ones are virtualized. */
+    void setMaxRealVoices(int maxRealVoices);
+    int getMaxRealVoices() const { return _maxRealVoices; }
+
+    /** Voices whose volume is below the threshold are virtualized. */
+    void setAudibilityThreshold(float threshold);
+    float getAudibilityThreshold() const { return _audibilityThreshold; }
+
+    /** Renders the next frames, 'out' receives frames * CHANNELS interleaved samples. */
+    void render(float* out, uint32_t frames);
+    void render(int16_t* out, uint32_t frames);
+
+    /** The voice counts of the last render. */
+    Stats getStats() const;
+
+private:
+    struct Voice
+    {
+        VoiceId id;
+        std::shared_ptr<const Sound> sound;
+        uint64_t position;  // 32.32 fixed point, in source frames
+        uint64_t step;      // 32.32 fixed point, source frames per output frame
+        float volume;
+        float pan;
+        float pitch;
+        bool loop;
+        int priority;
+        bool real;
+    };
+
+    Voice* findVoice(VoiceId voice);
+    const Voice* findVoice(VoiceId voice) const;
+    void updateStep(Voice& voice) const;
+    void virtualize();
+    void renderVoices(float* out, uint32_t frames);
+    // return false once a non looping voice reached its end
+    bool mixVoice(Voice& voice, float* out, uint32_t frames) const;
+    bool advanceVoice(Voice& voice, uint32_t frames) const;
+
+    int _sampleRate;
+    int _maxRealVoices;
+    float _audibilityThreshold;
+    VoiceId _nextVoiceId;
+    Stats _stats;
+
+    std::vector<Voice> _voices;
+    // _voices.size(), for the lock free hasVoices()
+    std::atomic<int> _voiceCount;
+    std::vector<Voice*> _audible;
+    std::vector<float> _scratch;
+    mutable std::mutex _mutex;
+};
+
+NS_AX_END
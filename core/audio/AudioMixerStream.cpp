@@ -0,0 +1,177 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#define LOG_TAG "AudioMixerStream"
+
+#include "audio/AudioMixerStream.h"
+
+NS_AX_BEGIN
+
+AudioMixerStream::AudioMixerStream(AudioMixer* mixer, ALuint alSource)
+    : _mixer(mixer), _alSource(alSource), _bufferCount(0), _framesPerBuffer(0), _idleBufferCount(0)
+{
+    memset(_bufferIds, 0, sizeof(_bufferIds));
+    memset(_idleBufferIds, 0, sizeof(_idleBufferIds));
+}
+
+AudioMixerStream::~AudioMixerStream()
+{
+    close();
+}
+
+bool AudioMixerStream::open(int bufferCount, uint32_t framesPerBuffer)
+{
+    _bufferCount     = bufferCount;
+    _framesPerBuffer = framesPerBuffer;
+    _pcm.resize(framesPerBuffer * AudioMixer::CHANNELS);
+
+    alGenBuffers(_bufferCount, _bufferIds);
+    auto alError = alGetError();
+    if (alError != AL_NO_ERROR)
+    {
+        AXLOGE("{}:alGenBuffers error code: {:#x}", __FUNCTION__, alError);
+        _bufferCount = 0;
+        return false;
+    }
+
+    for (int index = 0; index < _bufferCount; ++index)
+        renderBuffer(_bufferIds[index]);
+
+    alSourcei(_alSource, AL_BUFFER, 0);
+    alSourcef(_alSource, AL_PITCH, 1.0f);
+    alSourcef(_alSource, AL_GAIN, 1.0f);
+    alSourcei(_alSource, AL_LOOPING, AL_FALSE);
+    alSourceQueueBuffers(_alSource, _bufferCount, _bufferIds);
+    alSourcePlay(_alSource);
+
+    alError = alGetError();
+    if (alError != AL_NO_ERROR)
+    {
+        AXLOGE("{}:alSourcePlay error code: {:#x}", __FUNCTION__, alError);
+        return false;
+    }
+    return true;
+}
+
+void AudioMixerStream::close()
+{
+    if (_bufferCount == 0)
+        return;
+
+    alSourceStop(_alSource);
+    alSourcei(_alSource, AL_BUFFER, 0);
+    alDeleteBuffers(_bufferCount, _bufferIds);
+    CHECK_AL_ERROR_DEBUG();
+    _bufferCount     = 0;
+    _idleBufferCount = 0;
+}
+
+void AudioMixerStream::renderBuffer(ALuint bufferId)
+{
+    _mixer->render(_pcm.data(), _framesPerBuffer);
+    alBufferData(bufferId, AL_FORMAT_STEREO16, _pcm.data(), static_cast<ALsizei>(_pcm.size() * sizeof(int16_t)),
+                 _mixer->getSampleRate());
+}
+
+int AudioMixerStream::getStreamUrgency() const
+{
+    ALint sourceState;
+    alGetSourcei(_alSource, AL_SOURCE_STATE, &sourceState);
+    if (sourceState == AL_PAUSED)
+        return -1;
+    // a stopped source either ran dry or drained while the mixer had no voices, it's restarted once there are some
+    if (sourceState != AL_PLAYING)
+        return _mixer->hasVoices() ? QUEUEBUFFER_NUM_MAX + 1 : -1;
+
+    ALint queued = 0, processed = 0;
+    alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &processed);
+    if (processed <= 0)
+        return -1;
+    alGetSourcei(_alSource, AL_BUFFERS_QUEUED, &queued);
+    return QUEUEBUFFER_NUM_MAX - (queued - processed);
+}
+
+AudioStreamSource::StreamResult AudioMixerStream::stream()
+{
+    ALint sourceState;
+    alGetSourcei(_alSource, AL_SOURCE_STATE, &sourceState);
+    if (sourceState == AL_PLAYING)
+    {
+        ALint bufferProcessed = 0;
+        alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &bufferProcessed);
+        if (bufferProcessed <= 0)
+            return StreamResult::IDLE;
+
+        ALuint bid;
+        alSourceUnqueueBuffers(_alSource, 1, &bid);
+        // without voices the queue isn't refilled, the source stops once the tail of the last voice was played
+        if (!_mixer->hasVoices())
+        {
+            _idleBufferIds[_idleBufferCount++] = bid;
+            return StreamResult::IDLE;
+        }
+        renderBuffer(bid);
+        alSourceQueueBuffers(_alSource, 1, &bid);
+
+        // a voice started before the source drained, the buffers held back join the queue again
+        for (; _idleBufferCount > 0; --_idleBufferCount)
+        {
+            bid = _idleBufferIds[_idleBufferCount - 1];
+            renderBuffer(bid);
+            alSourceQueueBuffers(_alSource, 1, &bid);
+        }
+        return StreamResult::REFILLED;
+    }
+
+    if (sourceState == AL_PAUSED || !_mixer->hasVoices())
+        return StreamResult::IDLE;
+
+    // all the buffers left in the queue were played, refill them with the current mix instead of replaying them
+    ALint bufferProcessed = 0;
+    alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &bufferProcessed);
+    if (bufferProcessed > 0)
+    {
+        ALuint bids[QUEUEBUFFER_NUM_MAX];
+        alSourceUnqueueBuffers(_alSource, bufferProcessed, bids);
+    }
+    for (int index = 0; index < _bufferCount; ++index)
+        renderBuffer(_bufferIds[index]);
+    alSourceQueueBuffers(_alSource, _bufferCount, _bufferIds);
+
+    alSourcePlay(_alSource);
+    if (alGetError() != AL_NO_ERROR)
+    {
+        AXLOGE("{}", "Error restarting the mixer playback!");
+        return StreamResult::FINISHED;
+    }
+
+    // resuming after the idle drain isn't an underrun
+    const bool drained = _idleBufferCount > 0;
+    _idleBufferCount   = 0;
+    return drained ? StreamResult::REFILLED : StreamResult::UNDERRUN;
+}
+
+NS_AX_END
+
+#undef LOG_TAG
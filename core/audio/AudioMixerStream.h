@@ -0,0 +1,75 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/PlatformConfig.h"
+
+#include <vector>
+
+#include "audio/AudioMacros.h"
+#include "audio/AudioMixer.h"
+#include "audio/AudioStreamer.h"
+#include "audio/alconfig.h"
+
+NS_AX_BEGIN
+
+/**
+ * Plays the output of an AudioMixer on one OpenAL source, its buffer queue is refilled by the AudioStreamer.
+ *
+ * While the mixer has no voices the queue isn't refilled, the source drains and stops so neither the mixer nor
+ * OpenAL render silence. The source is restarted with a fresh mix once a voice is played.
+ */
+class AX_DLL AudioMixerStream : public AudioStreamSource
+{
+public:
+    AudioMixerStream(AudioMixer* mixer, ALuint alSource);
+    ~AudioMixerStream();
+
+    /** Renders and queues the first buffers and starts the source. */
+    bool open(int bufferCount, uint32_t framesPerBuffer);
+    /** Stops the source, the stream must have been removed from the AudioStreamer. */
+    void close();
+
+    ALuint getSource() const { return _alSource; }
+
+protected:
+    int getStreamUrgency() const override;
+    StreamResult stream() override;
+
+private:
+    void renderBuffer(ALuint bufferId);
+
+    AudioMixer* _mixer;
+    ALuint _alSource;
+    ALuint _bufferIds[QUEUEBUFFER_NUM_MAX];
+    int _bufferCount;
+    uint32_t _framesPerBuffer;
+    std::vector<int16_t> _pcm;
+    // the buffers unqueued without a refill while the mixer had no voices, only accessed by stream()
+    ALuint _idleBufferIds[QUEUEBUFFER_NUM_MAX];
+    int _idleBufferCount;
+};
+
+NS_AX_END
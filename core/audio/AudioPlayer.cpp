@@ -32,8 +32,7 @@
 #include "platform/FileUtils.h"
 #include "audio/AudioDecoder.h"
 #include "audio/AudioDecoderManager.h"
-
-#include "yasio/thread_name.hpp"
+#include "audio/AudioStreamer.h"
 
 NS_AX_BEGIN
 
@@ -50,12 +49,15 @@ AudioPlayer::AudioPlayer()
     , _ready(false)
     , _currTime(0.0f)
     , _streamingSource(false)
-    , _rotateBufferThread(nullptr)
+    , _bufferCount(0)
     , _timeDirty(false)
-    , _isRotateThreadExited(false)
-#if defined(__APPLE__)
-    , _needWakeupRotateThread(false)
-#endif
+    , _streamer(nullptr)
+    , _streamDecoder(nullptr)
+    , _streamBuffer(nullptr)
+    , _streamOffsetFrame(0)
+    , _streamEnded(false)
+    , _streamFinished(false)
+    , _underrunCount(0)
     , _id(++__playerIdIndex)
 {
     memset(_bufferIds, 0, sizeof(_bufferIds));
@@ -68,7 +70,7 @@ AudioPlayer::~AudioPlayer()
 
     if (_streamingSource)
     {
-        alDeleteBuffers(QUEUEBUFFER_NUM, _bufferIds);
+        alDeleteBuffers(_bufferCount, _bufferIds);
     }
 }
 
@@ -100,22 +102,12 @@ void AudioPlayer::destroy()
 
         if (_streamingSource)
         {
-            if (_rotateBufferThread != nullptr)
+            if (_streamer != nullptr)
             {
-                while (!_isRotateThreadExited)
-                {
-                    _sleepCondition.notify_one();
-                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
-                }
-
-                if (_rotateBufferThread->joinable())
-                {
-                    _rotateBufferThread->join();
-                }
-
-                delete _rotateBufferThread;
-                _rotateBufferThread = nullptr;
-                AXLOGV("{}", "rotateBufferThread exited!");
+                _streamer->remove(this);
+                _streamer = nullptr;
+                closeStream();
+                AXLOGV("{}", "stream removed from AudioStreamer!");
 
 #if AX_TARGET_PLATFORM == AX_PLATFORM_IOS
                 // some specific OpenAL implement defects existed on iOS platform
@@ -126,12 +118,12 @@ void AudioPlayer::destroy()
                 if (sourceState == AL_PLAYING)
                 {
                     alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &bufferProcessed);
-                    while (bufferProcessed < QUEUEBUFFER_NUM)
+                    while (bufferProcessed < _bufferCount)
                     {
                         std::this_thread::sleep_for(std::chrono::milliseconds(2));
                         alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &bufferProcessed);
                     }
-                    alSourceUnqueueBuffers(_alSource, QUEUEBUFFER_NUM, _bufferIds);
+                    alSourceUnqueueBuffers(_alSource, _bufferCount, _bufferIds);
                     CHECK_AL_ERROR_DEBUG();
                 }
                 AXLOGV("{}", "UnqueueBuffers Before alSourceStop");
@@ -197,12 +189,13 @@ bool AudioPlayer::play2d()
         }
         else
         {
-            alGenBuffers(QUEUEBUFFER_NUM, _bufferIds);
+            _bufferCount = _audioCache->_queBufferNum;
+            alGenBuffers(_bufferCount, _bufferIds);
 
             auto alError = alGetError();
             if (alError == AL_NO_ERROR)
             {
-                for (int index = 0; index < QUEUEBUFFER_NUM; ++index)
+                for (int index = 0; index < _bufferCount; ++index)
                 {
                     alBufferData(_bufferIds[index], _audioCache->_format, _audioCache->_queBuffers[index],
                                  _audioCache->_queBufferSize[index], _audioCache->_sampleRate);
@@ -217,28 +210,21 @@ bool AudioPlayer::play2d()
             _streamingSource = true;
         }
 
+        if (_streamingSource)
         {
-            std::unique_lock<std::mutex> lk(_sleepMutex);
-            if (_isDestroyed)
-                break;
-
-            if (_streamingSource)
-            {
-                // To continuously stream audio from a source without interruption, buffer queuing is required.
-                alSourceQueueBuffers(_alSource, QUEUEBUFFER_NUM, _bufferIds);
-                CHECK_AL_ERROR_DEBUG();
-                _rotateBufferThread = new std::thread(&AudioPlayer::rotateBufferThread, this,
-                                                      _audioCache->_queBufferFrames * QUEUEBUFFER_NUM + 1);
-            }
-            else
-            {
-                alSourcei(_alSource, AL_BUFFER, _audioCache->_alBufferId);
-                CHECK_AL_ERROR_DEBUG();
-            }
-
-            alSourcePlay(_alSource);
+            // To continuously stream audio from a source without interruption, buffer queuing is required.
+            alSourceQueueBuffers(_alSource, _bufferCount, _bufferIds);
+            CHECK_AL_ERROR_DEBUG();
+            _streamOffsetFrame = _audioCache->_queBufferFrames * _bufferCount + 1;
+        }
+        else
+        {
+            alSourcei(_alSource, AL_BUFFER, _audioCache->_alBufferId);
+            CHECK_AL_ERROR_DEBUG();
         }
 
+        alSourcePlay(_alSource);
+
         auto alError = alGetError();
         if (alError != AL_NO_ERROR)
         {
@@ -262,6 +248,10 @@ bool AudioPlayer::play2d()
             CHECK_AL_ERROR_DEBUG();
         }
 
+        // the decoder is opened lazily by the first worker which services the stream
+        if (_streamingSource && _streamer != nullptr)
+            _streamer->add(this);
+
         _ready = true;
         ret    = true;
     } while (false);
@@ -274,159 +264,167 @@ bool AudioPlayer::play2d()
     return ret;
 }
 
-// rotateBufferThread is used to rotate alBufferData for _alSource when playing big audio file
-void AudioPlayer::rotateBufferThread(int offsetFrame)
+bool AudioPlayer::openStream()
 {
-    yasio::set_thread_name("axmol-audio");
+    auto& fullPath = _audioCache->_fileFullPath;
+    _streamDecoder = AudioDecoderManager::createDecoder(fullPath);
+    if (_streamDecoder == nullptr || !_streamDecoder->open(fullPath))
+        return false;
 
-    char* tmpBuffer           = nullptr;
-    auto& fullPath            = _audioCache->_fileFullPath;
-    AudioDecoder* decoder     = AudioDecoderManager::createDecoder(fullPath);
-    long long rotateSleepTime = static_cast<long long>(QUEUEBUFFER_TIME_STEP * 1000) / 2;
-    do
+    const uint32_t bufferSize = _streamDecoder->framesToBytes(_audioCache->_queBufferFrames);
+    _streamBuffer             = (char*)calloc(1, bufferSize);
+
+    if (_streamOffsetFrame != 0)
     {
-        BREAK_IF(decoder == nullptr || !decoder->open(fullPath));
+        _streamDecoder->seek(_streamOffsetFrame);
+    }
+    return true;
+}
 
-        uint32_t framesRead         = 0;
-        const uint32_t framesToRead = _audioCache->_queBufferFrames;
-        const uint32_t bufferSize   = decoder->framesToBytes(framesToRead);
-#if AX_USE_ALSOFT
-        const auto sourceFormat = decoder->getSourceFormat();
-#endif
-        tmpBuffer = (char*)malloc(bufferSize);
-        memset(tmpBuffer, 0, bufferSize);
+void AudioPlayer::closeStream()
+{
+    AudioDecoderManager::destroyDecoder(_streamDecoder);
+    _streamDecoder = nullptr;
+    free(_streamBuffer);
+    _streamBuffer = nullptr;
+}
 
-        if (offsetFrame != 0)
-        {
-            decoder->seek(offsetFrame);
-        }
+int AudioPlayer::getStreamUrgency() const
+{
+    if (_isDestroyed)
+        return -1;
+
+    // not opened yet, or stopped: either underrun or finished
+    if (_streamDecoder == nullptr)
+        return QUEUEBUFFER_NUM_MAX + 1;
+
+    ALint sourceState;
+    alGetSourcei(_alSource, AL_SOURCE_STATE, &sourceState);
+    if (sourceState == AL_PAUSED)
+        return -1;
+    if (sourceState != AL_PLAYING)
+        return QUEUEBUFFER_NUM_MAX + 1;
+
+    // keep playing the already queued tail after the end of a non looping stream
+    if (_streamEnded && !_loop && !_timeDirty)
+        return -1;
+
+    ALint queued = 0, processed = 0;
+    alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &processed);
+    if (processed <= 0)
+        return -1;
+    alGetSourcei(_alSource, AL_BUFFERS_QUEUED, &queued);
+    return QUEUEBUFFER_NUM_MAX - (queued - processed);
+}
 
-        ALint sourceState;
-        ALint bufferProcessed = 0;
-        bool needToExitThread = false;
+AudioStreamSource::StreamResult AudioPlayer::stream()
+{
+    if (_isDestroyed)
+        return StreamResult::FINISHED;
 
-        while (!_isDestroyed)
-        {
-            alGetSourcei(_alSource, AL_SOURCE_STATE, &sourceState);
-            if (sourceState == AL_PLAYING)
-            {
-                alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &bufferProcessed);
-                while (bufferProcessed > 0)
-                {
-                    bufferProcessed--;
-                    if (_timeDirty)
-                    {
-                        _timeDirty  = false;
-                        offsetFrame = _currTime * decoder->getSampleRate() * decoder->getChannelCount();
-                        decoder->seek(offsetFrame);
-                    }
-                    else
-                    {
-                        _currTime += QUEUEBUFFER_TIME_STEP;
-                        if (_currTime > _audioCache->_duration)
-                        {
-                            if (_loop)
-                            {
-                                _currTime = 0.0f;
-                            }
-                            else
-                            {
-                                _currTime = _audioCache->_duration;
-                            }
-                        }
-                    }
+    if (_streamDecoder == nullptr && !openStream())
+        return StreamResult::FINISHED;
 
-                    framesRead = decoder->readFixedFrames(framesToRead, tmpBuffer);
+    ALint sourceState;
+    alGetSourcei(_alSource, AL_SOURCE_STATE, &sourceState);
+    if (sourceState == AL_PLAYING)
+    {
+        ALint bufferProcessed = 0;
+        alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &bufferProcessed);
+        if (bufferProcessed <= 0)
+            return StreamResult::IDLE;
 
-                    if (framesRead == 0)
-                    {
-                        if (_loop)
-                        {
-                            decoder->seek(0);
-                            framesRead = decoder->readFixedFrames(framesToRead, tmpBuffer);
-                        }
-                        else
-                        {
-                            needToExitThread = true;
-                            break;
-                        }
-                    }
-                    /*
-                     While the source is playing, alSourceUnqueueBuffers can be called to remove buffers which have
-                     already played. Those buffers can then be filled with new data or discarded. New or refilled
-                     buffers can then be attached to the playing source using alSourceQueueBuffers. As long as there is
-                     always a new buffer to play in the queue, the source will continue to play.
-                     */
-                    ALuint bid;
-                    alSourceUnqueueBuffers(_alSource, 1, &bid);
-#if AX_USE_ALSOFT
-                    if (sourceFormat == AUDIO_SOURCE_FORMAT::ADPCM || sourceFormat == AUDIO_SOURCE_FORMAT::IMA_ADPCM)
-                        alBufferi(bid, AL_UNPACK_BLOCK_ALIGNMENT_SOFT, decoder->getSamplesPerBlock());
-#endif
-                    alBufferData(bid, _audioCache->_format, tmpBuffer, decoder->framesToBytes(framesRead),
-                                 decoder->getSampleRate());
-                    alSourceQueueBuffers(_alSource, 1, &bid);
-                }
-            }
-            /* Make sure the source hasn't underrun */
-            else if (sourceState != AL_PAUSED)
+        auto decoder                = _streamDecoder;
+        const uint32_t framesToRead = _audioCache->_queBufferFrames;
+        if (_timeDirty)
+        {
+            _timeDirty         = false;
+            _streamEnded       = false;
+            _streamOffsetFrame = _currTime * decoder->getSampleRate() * decoder->getChannelCount();
+            decoder->seek(_streamOffsetFrame);
+        }
+        else if (_streamEnded && !_loop)
+        {
+            return StreamResult::IDLE;
+        }
+        else
+        {
+            _streamEnded = false;
+            _currTime += static_cast<float>(framesToRead) / decoder->getSampleRate();
+            if (_currTime > _audioCache->_duration)
             {
-                ALint queued;
-
-                /* If no buffers are queued, playback is finished */
-                alGetSourcei(_alSource, AL_BUFFERS_QUEUED, &queued);
-                if (queued == 0)
+                if (_loop)
                 {
-                    needToExitThread = true;
+                    _currTime = 0.0f;
                 }
                 else
                 {
-                    alSourcePlay(_alSource);
-                    if (alGetError() != AL_NO_ERROR)
-                    {
-                        AXLOGE("{}", "Error restarting playback!");
-                        needToExitThread = true;
-                    }
+                    _currTime = _audioCache->_duration;
                 }
             }
+        }
 
-            std::unique_lock<std::mutex> lk(_sleepMutex);
-            if (_isDestroyed || needToExitThread)
+        uint32_t framesRead = decoder->readFixedFrames(framesToRead, _streamBuffer);
+        if (framesRead == 0)
+        {
+            if (_loop)
             {
-                break;
+                decoder->seek(0);
+                framesRead = decoder->readFixedFrames(framesToRead, _streamBuffer);
             }
-#if defined(__APPLE__)
-            if (!_needWakeupRotateThread)
+            else
             {
-                _sleepCondition.wait_for(lk, std::chrono::milliseconds(rotateSleepTime));
+                _streamEnded = true;
+                return StreamResult::IDLE;
             }
-
-            _needWakeupRotateThread = false;
-#else
-            _sleepCondition.wait_for(lk, std::chrono::milliseconds(rotateSleepTime));
-#endif
         }
+        /*
+         While the source is playing, alSourceUnqueueBuffers can be called to remove buffers which have
+         already played. Those buffers can then be filled with new data or discarded. New or refilled
+         buffers can then be attached to the playing source using alSourceQueueBuffers. As long as there is
+         always a new buffer to play in the queue, the source will continue to play.
+         */
+        ALuint bid;
+        alSourceUnqueueBuffers(_alSource, 1, &bid);
+#if AX_USE_ALSOFT
+        const auto sourceFormat = decoder->getSourceFormat();
+        if (sourceFormat == AUDIO_SOURCE_FORMAT::ADPCM || sourceFormat == AUDIO_SOURCE_FORMAT::IMA_ADPCM)
+            alBufferi(bid, AL_UNPACK_BLOCK_ALIGNMENT_SOFT, decoder->getSamplesPerBlock());
+#endif
+        alBufferData(bid, _audioCache->_format, _streamBuffer, decoder->framesToBytes(framesRead),
+                     decoder->getSampleRate());
+        alSourceQueueBuffers(_alSource, 1, &bid);
+        return StreamResult::REFILLED;
+    }
+    /* Make sure the source hasn't underrun */
+    else if (sourceState != AL_PAUSED)
+    {
+        ALint queued;
 
-    } while (false);
+        /* If no buffers are queued or the last one was played, playback is finished */
+        alGetSourcei(_alSource, AL_BUFFERS_QUEUED, &queued);
+        if (queued == 0 || (_streamEnded && !_loop))
+            return StreamResult::FINISHED;
 
-    AXLOGV("{}", "Exit rotate buffer thread ...");
-    AudioDecoderManager::destroyDecoder(decoder);
-    free(tmpBuffer);
-    _isRotateThreadExited = true;
-}
+        ++_underrunCount;
+        AXLOGV("stream underrun, player id={}", _id);
 
-#if defined(__APPLE__)
-void AudioPlayer::wakeupRotateThread()
-{
-    _needWakeupRotateThread = true;
-    _sleepCondition.notify_all();
+        alSourcePlay(_alSource);
+        if (alGetError() != AL_NO_ERROR)
+        {
+            AXLOGE("{}", "Error restarting playback!");
+            return StreamResult::FINISHED;
+        }
+        return StreamResult::UNDERRUN;
+    }
+
+    return StreamResult::IDLE;
 }
-#endif
 
 bool AudioPlayer::isFinished() const
 {
     if (_streamingSource)
-        return _isRotateThreadExited;
+        return _streamFinished;
     else
     {
         ALint sourceState;
@@ -28,21 +28,24 @@
 
 #include "platform/PlatformConfig.h"
 
+#include <atomic>
 #include <string>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
 
 #include "audio/AudioMacros.h"
+#include "audio/AudioStreamer.h"
 #include "platform/PlatformMacros.h"
 #include "audio/alconfig.h"
 
 NS_AX_BEGIN
 
 class AudioCache;
+class AudioDecoder;
 class AudioEngineImpl;
 
-class AX_DLL AudioPlayer
+class AX_DLL AudioPlayer : public AudioStreamSource
 {
     friend class AudioEngineImpl;
 
@@ -59,13 +62,19 @@ public:
 
     bool isFinished() const;
 
+    // how many times the streaming source ran dry and had to be restarted
+    unsigned int getUnderrunCount() const { return _underrunCount.load(std::memory_order_relaxed); }
+
 protected:
     void setCache(AudioCache* cache);
-    void rotateBufferThread(int offsetFrame);
     bool play2d();
-#if defined(__APPLE__)
-    void wakeupRotateThread();
-#endif
+
+    // streaming, invoked by the AudioStreamer workers
+    int getStreamUrgency() const override;
+    StreamResult stream() override;
+    void onStreamFinished() override { _streamFinished = true; }
+    bool openStream();
+    void closeStream();
 
     AudioCache* _audioCache;
 
@@ -81,15 +90,16 @@ protected:
     // play by circular buffer
     float _currTime;
     bool _streamingSource;
-    ALuint _bufferIds[QUEUEBUFFER_NUM];
-    std::thread* _rotateBufferThread;
-    std::condition_variable _sleepCondition;
-    std::mutex _sleepMutex;
+    ALuint _bufferIds[QUEUEBUFFER_NUM_MAX];
+    int _bufferCount;
     bool _timeDirty;
-    bool _isRotateThreadExited;
-#if defined(__APPLE__)
-    std::atomic_bool _needWakeupRotateThread;
-#endif
+    AudioStreamer* _streamer;
+    AudioDecoder* _streamDecoder;
+    char* _streamBuffer;
+    uint32_t _streamOffsetFrame;
+    bool _streamEnded;
+    std::atomic_bool _streamFinished;
+    std::atomic<unsigned int> _underrunCount;
 
     std::mutex _play2dMutex;
 
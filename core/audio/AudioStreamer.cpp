@@ -0,0 +1,177 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#define LOG_TAG "AudioStreamer"
+
+#include "audio/AudioStreamer.h"
+#include "audio/AudioMacros.h"
+
+#include <algorithm>
+
+#include "yasio/thread_name.hpp"
+
+NS_AX_BEGIN
+
+AudioStreamer::AudioStreamer(int workerCount)
+    : _idleWait(static_cast<long long>(QUEUEBUFFER_TIME_STEP * 1000) / 2)
+    , _signaled(false)
+    , _quit(false)
+    , _underruns(0)
+    , _streamedBuffers(0)
+{
+    startWorkers(workerCount);
+}
+
+AudioStreamer::~AudioStreamer()
+{
+    stopWorkers();
+}
+
+void AudioStreamer::add(AudioStreamSource* source)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    source->_streamBusy = false;
+    _sources.emplace_back(source);
+    _signaled = true;
+    _wakeupCondition.notify_one();
+}
+
+void AudioStreamer::remove(AudioStreamSource* source)
+{
+    std::unique_lock<std::mutex> lck(_mutex);
+    _serviceCondition.wait(lck, [source] { return !source->_streamBusy; });
+    auto it = std::find(_sources.begin(), _sources.end(), source);
+    if (it != _sources.end())
+        _sources.erase(it);
+}
+
+void AudioStreamer::wakeup()
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    _signaled = true;
+    _wakeupCondition.notify_all();
+}
+
+void AudioStreamer::setWorkerCount(int workerCount)
+{
+    workerCount = (std::max)(workerCount, 1);
+    if (workerCount == getWorkerCount())
+        return;
+
+    stopWorkers();
+    startWorkers(workerCount);
+}
+
+void AudioStreamer::setIdleWait(std::chrono::milliseconds idleWait)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    _idleWait = (std::max)(idleWait, std::chrono::milliseconds(1));
+}
+
+int AudioStreamer::getActiveStreams() const
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    return static_cast<int>(_sources.size());
+}
+
+void AudioStreamer::startWorkers(int workerCount)
+{
+    _quit = false;
+    _workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i)
+        _workers.emplace_back(&AudioStreamer::run, this);
+}
+
+void AudioStreamer::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lck(_mutex);
+        _quit = true;
+        _wakeupCondition.notify_all();
+    }
+
+    for (auto&& worker : _workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+    _workers.clear();
+}
+
+void AudioStreamer::run()
+{
+    yasio::set_thread_name("axmol-audio");
+
+    std::unique_lock<std::mutex> lck(_mutex);
+    while (!_quit)
+    {
+        // pick the source closest to underrun, the OpenAL queries are cheap enough to do them under the lock
+        AudioStreamSource* next = nullptr;
+        int urgency             = -1;
+        for (auto source : _sources)
+        {
+            if (source->_streamBusy)
+                continue;
+
+            int value = source->getStreamUrgency();
+            if (value > urgency)
+            {
+                urgency = value;
+                next    = source;
+            }
+        }
+
+        if (next == nullptr)
+        {
+            if (!_signaled)
+                _wakeupCondition.wait_for(lck, _idleWait);
+            _signaled = false;
+            continue;
+        }
+
+        next->_streamBusy = true;
+        lck.unlock();
+
+        auto result = next->stream();
+        if (result == AudioStreamSource::StreamResult::REFILLED)
+            ++_streamedBuffers;
+        else if (result == AudioStreamSource::StreamResult::UNDERRUN)
+            ++_underruns;
+
+        lck.lock();
+        next->_streamBusy = false;
+        if (result == AudioStreamSource::StreamResult::FINISHED)
+        {
+            auto it = std::find(_sources.begin(), _sources.end(), next);
+            if (it != _sources.end())
+                _sources.erase(it);
+            next->onStreamFinished();
+        }
+        _serviceCondition.notify_all();
+    }
+}
+
+NS_AX_END
+
+#undef LOG_TAG
@@ -0,0 +1,129 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/PlatformConfig.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "platform/PlatformMacros.h"
+
+NS_AX_BEGIN
+
+class AudioStreamer;
+
+/**
+ * A source whose OpenAL buffer queue is refilled by the AudioStreamer workers.
+ */
+class AX_DLL AudioStreamSource
+{
+public:
+    enum class StreamResult
+    {
+        IDLE,      // nothing had to be refilled
+        REFILLED,  // one buffer was refilled
+        UNDERRUN,  // the source ran dry and was restarted
+        FINISHED   // the stream is done, it's removed from the streamer
+    };
+
+    virtual ~AudioStreamSource() {}
+
+protected:
+    friend class AudioStreamer;
+
+    // The higher the value the sooner the source runs out of queued data, a negative value means nothing to do.
+    virtual int getStreamUrgency() const = 0;
+    // Refills at most one buffer, invoked by one worker at a time.
+    virtual StreamResult stream() = 0;
+    // Invoked once stream() reported FINISHED, with the streamer mutex held.
+    virtual void onStreamFinished() {}
+
+    bool _streamBusy = false;  // guarded by the AudioStreamer mutex
+};
+
+/**
+ * Services the OpenAL buffer queues of all streaming audio players and the software mixer output.
+ *
+ * Sources register themselves once their first buffers are queued. The worker threads share one ready
+ * queue and always refill the source which has the fewest unplayed buffers left, one buffer at a time, so a long
+ * decode of one stream can't starve the others. When no source has a processed buffer the workers sleep for half a
+ * buffer duration or until they are woken up.
+ */
+class AX_DLL AudioStreamer
+{
+public:
+    explicit AudioStreamer(int workerCount = 1);
+    ~AudioStreamer();
+
+    /** Starts servicing a source, the source must have its buffers queued already. */
+    void add(AudioStreamSource* source);
+
+    /**
+     * Stops servicing a source, waits until a worker which is refilling it right now is done.
+     * Must not be called from a worker thread.
+     */
+    void remove(AudioStreamSource* source);
+
+    /** Wakes up the idle workers, e.g. when OpenAL notifies that a buffer was processed. */
+    void wakeup();
+
+    /** Restarts the workers, the registered players are kept. */
+    void setWorkerCount(int workerCount);
+    int getWorkerCount() const { return static_cast<int>(_workers.size()); }
+
+    /** How long idle workers sleep before polling the sources again. */
+    void setIdleWait(std::chrono::milliseconds idleWait);
+
+    int getActiveStreams() const;
+    uint64_t getUnderrunCount() const { return _underruns.load(std::memory_order_relaxed); }
+    uint64_t getStreamedBufferCount() const { return _streamedBuffers.load(std::memory_order_relaxed); }
+
+private:
+    void startWorkers(int workerCount);
+    void stopWorkers();
+    void run();
+
+    std::vector<std::thread> _workers;
+    std::vector<AudioStreamSource*> _sources;
+
+    mutable std::mutex _mutex;
+    // workers wait on it while idle
+    std::condition_variable _wakeupCondition;
+    // remove() waits on it while a worker services the player
+    std::condition_variable _serviceCondition;
+    std::chrono::milliseconds _idleWait;
+    bool _signaled;
+    bool _quit;
+
+    std::atomic<uint64_t> _underruns;
+    std::atomic<uint64_t> _streamedBuffers;
+};
+
+NS_AX_END
@@ -118,6 +118,7 @@ THE SOFTWARE.
 #include "2d/DrawNode.h"
 #include "2d/FontFNT.h"
 #include "2d/FontFreeType.h"
+#include "2d/FontPrebaked.h"
 #include "2d/Label.h"
 #include "2d/LabelAtlas.h"
 #include "2d/Layer.h"
@@ -163,6 +164,7 @@ THE SOFTWARE.
 #include "renderer/TextureCube.h"
 #include "renderer/TextureCache.h"
 #include "renderer/TrianglesCommand.h"
+#include "renderer/UploadQueue.h"
 #include "renderer/Shaders.h"
 
 // physics
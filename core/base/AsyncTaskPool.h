@@ -83,7 +83,8 @@ public:
     /**
      * Enqueue a asynchronous task.
      *
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others, tasks of one type run in order, one at a time, on the
+     * JobSystem workers.
      * @param callback callback when the task is finished. The callback is called in the main thread instead of task
      * thread.
      * @param callbackParam parameter used by the callback.
@@ -95,7 +96,8 @@ public:
     /**
      * Enqueue a asynchronous task.
      *
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others, tasks of one type run in order, one at a time, on the
+     * JobSystem workers.
      * @param task: task can be lambda function to be performed off thread.
      * @lua NA
      */
@@ -105,7 +107,7 @@ public:
     ~AsyncTaskPool();
 
 protected:
-    // thread tasks internally used
+    // serial queue of one task type, its tasks run one at a time on the JobSystem workers
     class ThreadTasks
     {
         struct AsyncTaskCallBack
@@ -114,52 +116,40 @@ protected:
             void* callbackParam;
         };
 
-    public:
-        ThreadTasks() : _stop(false)
+        struct Queue
         {
-            _thread = std::thread([this] {
-                for (;;)
-                {
-                    std::function<void()> task;
-                    AsyncTaskCallBack callback;
-                    {
-                        std::unique_lock<std::mutex> lock(this->_queueMutex);
-                        this->_condition.wait(lock, [this] { return this->_stop || !this->_tasks.empty(); });
-                        if (this->_stop && this->_tasks.empty())
-                            return;
-                        task     = std::move(this->_tasks.front());
-                        callback = std::move(this->_taskCallBacks.front());
-                        this->_tasks.pop();
-                        this->_taskCallBacks.pop();
-                    }
+            std::queue<std::function<void()>> tasks;
+            std::queue<AsyncTaskCallBack> taskCallBacks;
+
+            // synchronization
+            std::mutex mutex;
+            std::condition_variable idleCondition;
+            bool running = false;
+            bool stop    = false;
+        };
 
-                    task();
-                    Director::getInstance()->getScheduler()->runOnAxmolThread(
-                        std::bind(callback.callback, callback.callbackParam));
-                }
-            });
-        }
+    public:
+        ThreadTasks() : _queue(std::make_shared<Queue>()) {}
         ~ThreadTasks()
         {
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                _stop = true;
+            std::unique_lock<std::mutex> lock(_queue->mutex);
+            _queue->stop = true;
 
-                while (_tasks.size())
-                    _tasks.pop();
-                while (_taskCallBacks.size())
-                    _taskCallBacks.pop();
-            }
-            _condition.notify_all();
-            _thread.join();
+            while (_queue->tasks.size())
+                _queue->tasks.pop();
+            while (_queue->taskCallBacks.size())
+                _queue->taskCallBacks.pop();
+
+            // wait for the running task
+            _queue->idleCondition.wait(lock, [this] { return !_queue->running; });
         }
         void clear()
         {
-            std::unique_lock<std::mutex> lock(_queueMutex);
-            while (_tasks.size())
-                _tasks.pop();
-            while (_taskCallBacks.size())
-                _taskCallBacks.pop();
+            std::unique_lock<std::mutex> lock(_queue->mutex);
+            while (_queue->tasks.size())
+                _queue->tasks.pop();
+            while (_queue->taskCallBacks.size())
+                _queue->taskCallBacks.pop();
         }
 
         void enqueue(TaskCallBack callback, void* callbackParam, std::function<void()> task)
@@ -169,32 +159,56 @@ protected:
             taskCallBack.callbackParam = callbackParam;
 
             {
-                std::unique_lock<std::mutex> lock(_queueMutex);
+                std::unique_lock<std::mutex> lock(_queue->mutex);
 
                 // don't allow enqueueing after stopping the pool
-                if (_stop)
+                if (_queue->stop)
                 {
                     AX_ASSERT(0 && "already stop");
                     return;
                 }
 
-                _tasks.push(std::move(task));
-                _taskCallBacks.push(std::move(taskCallBack));
+                _queue->tasks.push(std::move(task));
+                _queue->taskCallBacks.push(std::move(taskCallBack));
+
+                if (_queue->running)
+                    return;
+                _queue->running = true;
             }
-            _condition.notify_one();
+            run(_queue);
         }
 
     private:
-        // need to keep track of thread so we can join them
-        std::thread _thread;
-        // the task queue
-        std::queue<std::function<void()>> _tasks;
-        std::queue<AsyncTaskCallBack> _taskCallBacks;
-
-        // synchronization
-        std::mutex _queueMutex;
-        std::condition_variable _condition;
-        bool _stop;
+        // drains the queue on one job, a task finishing while the JobSystem stops doesn't enqueue again
+        static void run(std::shared_ptr<Queue> queue)
+        {
+            Director::getInstance()->getJobSystem()->enqueue([queue] {
+                for (;;)
+                {
+                    std::function<void()> task;
+                    AsyncTaskCallBack callback;
+                    {
+                        std::unique_lock<std::mutex> lock(queue->mutex);
+                        if (queue->tasks.empty())
+                        {
+                            queue->running = false;
+                            queue->idleCondition.notify_all();
+                            return;
+                        }
+                        task     = std::move(queue->tasks.front());
+                        callback = std::move(queue->taskCallBacks.front());
+                        queue->tasks.pop();
+                        queue->taskCallBacks.pop();
+                    }
+
+                    task();
+                    Director::getInstance()->getScheduler()->runOnAxmolThread(
+                        std::bind(callback.callback, callback.callbackParam));
+                }
+            });
+        }
+
+        std::shared_ptr<Queue> _queue;
     };
 
     // tasks
@@ -39,6 +39,7 @@ THE SOFTWARE.
 #include "2d/ActionManager.h"
 #include "2d/FontFNT.h"
 #include "2d/FontAtlasCache.h"
+#include "2d/LabelLayoutCache.h"
 #include "2d/AnimationCache.h"
 #include "2d/Transition.h"
 #include "2d/FontFreeType.h"
@@ -46,6 +47,8 @@ THE SOFTWARE.
 #include "renderer/TextureCache.h"
 #include "renderer/Renderer.h"
 #include "renderer/RenderState.h"
+#include "renderer/UploadQueue.h"
+#include "2d/ParticleSystemManager.h"
 #include "2d/Camera.h"
 #include "base/UserDefault.h"
 #include "base/Utils.h"
@@ -119,6 +122,10 @@ bool Director::init()
     auto concurrency = Configuration::getInstance()->getValue("axmol.concurrency", Value{-1}).asInt();
     _jobSystem = new JobSystem(concurrency);
 
+    _uploadQueue = new UploadQueue();
+
+    _particleSystemManager = new ParticleSystemManager();
+
 #ifdef AX_ENABLE_CONSOLE
     _console = new Console();
 #endif
@@ -202,6 +209,8 @@ Director::~Director()
     /** clean auto release pool. */
     PoolManager::destroyInstance();
 
+    AX_SAFE_DELETE(_uploadQueue);
+    AX_SAFE_DELETE(_particleSystemManager);
     AX_SAFE_DELETE(_jobSystem);
 
     s_SharedDirector = nullptr;
@@ -286,9 +295,13 @@ void Director::drawScene()
     {
         _eventDispatcher->dispatchEvent(_eventBeforeUpdate);
         _scheduler->update(_deltaTime);
+        _particleSystemManager->update();
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
 
+    // streamed content, within the frame budget
+    _uploadQueue->update();
+
     _renderer->clear(ClearFlag::ALL, _clearColor, 1, 0, -10000.0);
 
     _eventDispatcher->dispatchEvent(_eventBeforeDraw);
@@ -1045,10 +1058,12 @@ void Director::reset()
     AX_SAFE_RELEASE_NULL(_FPSLabel);
     AX_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     AX_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+    AX_SAFE_RELEASE_NULL(_textLayoutsLabel);
 
     // purge bitmap cache
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
+    LabelLayoutCache::destroyInstance();
 
     FontFreeType::shutdownFreeType();
 
@@ -1075,6 +1090,7 @@ void Director::cleanupDirector()
     AX_SAFE_RELEASE(_FPSLabel);
     AX_SAFE_RELEASE(_drawnVerticesLabel);
     AX_SAFE_RELEASE(_drawnBatchesLabel);
+    AX_SAFE_RELEASE(_textLayoutsLabel);
 
     AX_SAFE_RELEASE(_runningScene);
     AX_SAFE_RELEASE(_notificationNode);
@@ -1230,13 +1246,14 @@ void Director::showStats()
         _isStatusLabelUpdated = false;
     }
 
-    static uint32_t prevCalls = 0;
-    static uint32_t prevVerts = 0;
+    static uint32_t prevCalls       = 0;
+    static uint32_t prevVerts       = 0;
+    static size_t prevLayoutLookups = 0;
 
     ++_frames;
     _accumDt += _deltaTime;
 
-    if (_statsDisplay && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel)
+    if (_statsDisplay && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel && _textLayoutsLabel)
     {
         char buffer[30] = {0};
 
@@ -1267,7 +1284,18 @@ void Director::showStats()
             prevVerts = currentVerts;
         }
 
+        // hits and misses of the Label layout cache
+        auto layoutStats = LabelLayoutCache::getInstance()->getStats();
+        if (layoutStats.hits + layoutStats.misses != prevLayoutLookups)
+        {
+            snprintf(buffer, sizeof(buffer), "Layouts:%6u/%u", static_cast<unsigned int>(layoutStats.hits),
+                     static_cast<unsigned int>(layoutStats.misses));
+            _textLayoutsLabel->setString(buffer);
+            prevLayoutLookups = layoutStats.hits + layoutStats.misses;
+        }
+
         const Mat4& identity = Mat4::IDENTITY;
+        _textLayoutsLabel->visit(_renderer, identity, 0);
         _drawnVerticesLabel->visit(_renderer, identity, 0);
         _drawnBatchesLabel->visit(_renderer, identity, 0);
         _FPSLabel->visit(_renderer, identity, 0);
@@ -1297,15 +1325,18 @@ void Director::createStatsLabel()
     std::string fpsString          = "00.0";
     std::string drawBatchString    = "000";
     std::string drawVerticesString = "00000";
+    std::string textLayoutsString  = "0/0";
     if (_FPSLabel)
     {
         fpsString          = _FPSLabel->getString();
         drawBatchString    = _drawnBatchesLabel->getString();
         drawVerticesString = _drawnVerticesLabel->getString();
+        textLayoutsString  = _textLayoutsLabel->getString();
 
         AX_SAFE_RELEASE_NULL(_FPSLabel);
         AX_SAFE_RELEASE_NULL(_drawnBatchesLabel);
         AX_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+        AX_SAFE_RELEASE_NULL(_textLayoutsLabel);
         _textureCache->removeTextureForKey("/cc_fps_images");
         FileUtils::getInstance()->purgeCachedEntries();
     }
@@ -1352,6 +1383,11 @@ void Director::createStatsLabel()
     _drawnVerticesLabel->setIgnoreContentScaleFactor(true);
     _drawnVerticesLabel->setScale(scaleFactor);
 
+    _textLayoutsLabel = LabelAtlas::create(textLayoutsString, texture, 12, 32, '.');
+    _textLayoutsLabel->retain();
+    _textLayoutsLabel->setIgnoreContentScaleFactor(true);
+    _textLayoutsLabel->setScale(scaleFactor);
+
     setStatsAnchor();
 }
 
@@ -1379,13 +1415,13 @@ void Director::setStatsAnchor(AnchorPreset anchor)
             _FPSLabel->setAnchorPoint({0, 0});
             break;
         case AnchorPreset::CENTER_LEFT:
-            _fpsPosition = Vec2(0, safeSize.height / 2 - height_spacing * 1.5);
+            _fpsPosition = Vec2(0, safeSize.height / 2 - height_spacing * 2);
             _drawnVerticesLabel->setAnchorPoint({0, 0.0});
             _drawnBatchesLabel->setAnchorPoint({0, 0.0});
             _FPSLabel->setAnchorPoint({0, 0});
             break;
         case AnchorPreset::TOP_LEFT:
-            _fpsPosition = Vec2(0, safeSize.height - height_spacing * 3);
+            _fpsPosition = Vec2(0, safeSize.height - height_spacing * 4);
             _drawnVerticesLabel->setAnchorPoint({0, 0});
             _drawnBatchesLabel->setAnchorPoint({0, 0});
             _FPSLabel->setAnchorPoint({0, 0});
@@ -1397,13 +1433,13 @@ void Director::setStatsAnchor(AnchorPreset anchor)
             _FPSLabel->setAnchorPoint({1, 0});
             break;
         case AnchorPreset::CENTER_RIGHT:
-            _fpsPosition = Vec2(safeSize.width, safeSize.height / 2 - height_spacing * 1.5);
+            _fpsPosition = Vec2(safeSize.width, safeSize.height / 2 - height_spacing * 2);
             _drawnVerticesLabel->setAnchorPoint({1, 0.0});
             _drawnBatchesLabel->setAnchorPoint({1, 0.0});
             _FPSLabel->setAnchorPoint({1, 0.0});
             break;
         case AnchorPreset::TOP_RIGHT:
-            _fpsPosition = Vec2(safeSize.width, safeSize.height - height_spacing * 3);
+            _fpsPosition = Vec2(safeSize.width, safeSize.height - height_spacing * 4);
             _drawnVerticesLabel->setAnchorPoint({1, 0});
             _drawnBatchesLabel->setAnchorPoint({1, 0});
             _FPSLabel->setAnchorPoint({1, 0});
@@ -1415,13 +1451,13 @@ void Director::setStatsAnchor(AnchorPreset anchor)
             _FPSLabel->setAnchorPoint({0.5, 0});
             break;
         case AnchorPreset::CENTER:
-            _fpsPosition = Vec2(safeSize.width / 2, safeSize.height / 2 - height_spacing * 1.5);
+            _fpsPosition = Vec2(safeSize.width / 2, safeSize.height / 2 - height_spacing * 2);
             _drawnVerticesLabel->setAnchorPoint({0.5, 0.0});
             _drawnBatchesLabel->setAnchorPoint({0.5, 0.0});
             _FPSLabel->setAnchorPoint({0.5, 0.0});
             break;
         case AnchorPreset::TOP_CENTER:
-            _fpsPosition = Vec2(safeSize.width / 2, safeSize.height - height_spacing * 3);
+            _fpsPosition = Vec2(safeSize.width / 2, safeSize.height - height_spacing * 4);
             _drawnVerticesLabel->setAnchorPoint({0.5, 0});
             _drawnBatchesLabel->setAnchorPoint({0.5, 0});
             _FPSLabel->setAnchorPoint({0.5, 0});
@@ -1434,6 +1470,8 @@ void Director::setStatsAnchor(AnchorPreset anchor)
             break;
         }
 
+        _textLayoutsLabel->setAnchorPoint(_FPSLabel->getAnchorPoint());
+        _textLayoutsLabel->setPosition(Vec2(0, height_spacing * 3.0f) + _fpsPosition + safeOrigin);
         _drawnVerticesLabel->setPosition(Vec2(0, height_spacing * 2.0f) + _fpsPosition + safeOrigin);
         _drawnBatchesLabel->setPosition(Vec2(0, height_spacing * 1.0f) + _fpsPosition + safeOrigin);
         _FPSLabel->setPosition(Vec2(0, height_spacing * 0.0f) + _fpsPosition + safeOrigin);
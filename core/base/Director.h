@@ -65,6 +65,8 @@ class EventDispatcher;
 class EventCustom;
 class EventListenerCustom;
 class TextureCache;
+class UploadQueue;
+class ParticleSystemManager;
 class Renderer;
 class Camera;
 
@@ -405,6 +407,14 @@ public:
      */
     JobSystem* getJobSystem() const { return _jobSystem; }
 
+    /** Gets the UploadQueue associated with this director, it spreads GPU uploads over frames.
+     */
+    UploadQueue* getUploadQueue() const { return _uploadQueue; }
+
+    /** Gets the ParticleSystemManager associated with this director, it simulates the particle systems in parallel.
+     */
+    ParticleSystemManager* getParticleSystemManager() const { return _particleSystemManager; }
+
     /** Gets the Scheduler associated with this director.
      * @since v2.0
      */
@@ -605,6 +615,10 @@ protected:
 
     JobSystem* _jobSystem = nullptr;
 
+    UploadQueue* _uploadQueue = nullptr;
+
+    ParticleSystemManager* _particleSystemManager = nullptr;
+
     // texture cache belongs to this director
     TextureCache* _textureCache = nullptr;
 
@@ -618,6 +632,7 @@ protected:
     LabelAtlas* _FPSLabel           = nullptr;
     LabelAtlas* _drawnBatchesLabel  = nullptr;
     LabelAtlas* _drawnVerticesLabel = nullptr;
+    LabelAtlas* _textLayoutsLabel   = nullptr;
 
     /** Whether or not the Director is paused */
     bool _paused = false;
@@ -0,0 +1,83 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/FixedTimestep.h"
+
+#include <algorithm>
+#include <cmath>
+
+NS_AX_BEGIN
+
+// frames as long as a step, give or take the float error, run exactly one step
+static constexpr float STEP_TOLERANCE = 1e-4f;
+
+FixedTimestep::FixedTimestep(int stepsPerSecond, int maxCatchUpSteps)
+    : _stepsPerSecond(0)
+    , _maxCatchUpSteps(1)
+    , _stepInterval(0.0f)
+    , _remainder(0.0f)
+    , _droppedSteps(0)
+    , _smoothing(Smoothing::NONE)
+{
+    setStepsPerSecond(stepsPerSecond);
+    setMaxCatchUpSteps(maxCatchUpSteps);
+}
+
+void FixedTimestep::setStepsPerSecond(int stepsPerSecond)
+{
+    _stepsPerSecond = (std::max)(stepsPerSecond, 0);
+    _stepInterval   = _stepsPerSecond > 0 ? 1.0f / _stepsPerSecond : 0.0f;
+    reset();
+}
+
+void FixedTimestep::setMaxCatchUpSteps(int steps)
+{
+    _maxCatchUpSteps = (std::max)(steps, 1);
+}
+
+int FixedTimestep::advance(float delta)
+{
+    if (_stepsPerSecond <= 0 || !(delta > 0.0f))
+        return 0;
+
+    _remainder += delta;
+    int steps = static_cast<int>(std::floor(_remainder / _stepInterval + STEP_TOLERANCE));
+    _remainder -= steps * _stepInterval;
+    if (steps > _maxCatchUpSteps)
+    {
+        // the phase between the steps is kept, only whole steps are dropped
+        _droppedSteps += static_cast<unsigned int>(steps - _maxCatchUpSteps);
+        steps = _maxCatchUpSteps;
+    }
+    _remainder = std::clamp(_remainder, 0.0f, _stepInterval * (1.0f - STEP_TOLERANCE));
+    return steps;
+}
+
+void FixedTimestep::reset()
+{
+    _remainder    = 0.0f;
+    _droppedSteps = 0;
+}
+
+NS_AX_END
@@ -0,0 +1,101 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/Config.h"
+#include "platform/PlatformDefine.h"
+
+NS_AX_BEGIN
+
+/**
+ * @brief A fixed step accumulator shared by the physics worlds.
+ *
+ * The frame time is accumulated and consumed in steps of a constant interval, so the simulation doesn't depend on
+ * the frame rate. The number of steps run in one frame is capped, the time beyond the cap is dropped instead of being
+ * carried over, which keeps a slow frame from making the next ones slower. The time left in the accumulator tells how
+ * far the frame is between two steps, the node transforms can be interpolated or extrapolated with it.
+ */
+class AX_DLL FixedTimestep
+{
+public:
+    /** How the node transforms are placed between two steps. */
+    enum class Smoothing
+    {
+        NONE,         // the transform of the last step
+        INTERPOLATE,  // blended between the last two steps, one step behind the simulation
+        EXTRAPOLATE,  // predicted from the last step and the velocities, may overshoot on collisions
+    };
+
+    /**
+     * @param stepsPerSecond The number of steps in a second, 0 disables the fixed step.
+     * @param maxCatchUpSteps The maximum number of steps in a frame.
+     */
+    explicit FixedTimestep(int stepsPerSecond = 0, int maxCatchUpSteps = 5);
+
+    /** Set the number of steps in a second, 0 disables the fixed step. The accumulated time is cleared. */
+    void setStepsPerSecond(int stepsPerSecond);
+    int getStepsPerSecond() const { return _stepsPerSecond; }
+
+    bool isEnabled() const { return _stepsPerSecond > 0; }
+
+    /** The duration of one step in seconds, 0 when disabled. */
+    float getStepInterval() const { return _stepInterval; }
+
+    /** Set the maximum number of steps run in a frame, at least 1. */
+    void setMaxCatchUpSteps(int steps);
+    int getMaxCatchUpSteps() const { return _maxCatchUpSteps; }
+
+    void setSmoothing(Smoothing smoothing) { _smoothing = smoothing; }
+    Smoothing getSmoothing() const { return _smoothing; }
+
+    /**
+     * Accumulate the frame time.
+     *
+     * @return The number of steps to run for this frame, no more than the maximum catch up steps.
+     */
+    int advance(float delta);
+
+    /** The accumulated time not consumed by a step, in [0, step interval). */
+    float getRemainder() const { return _remainder; }
+
+    /** The position of the frame between the last step and the next one, in [0, 1). */
+    float getAlpha() const { return _stepInterval > 0.0f ? _remainder / _stepInterval : 0.0f; }
+
+    /** The number of steps dropped because of the catch up limit since the last reset. */
+    unsigned int getDroppedSteps() const { return _droppedSteps; }
+
+    /** Clear the accumulated time and the dropped steps. */
+    void reset();
+
+private:
+    int _stepsPerSecond;
+    int _maxCatchUpSteps;
+    float _stepInterval;
+    float _remainder;
+    unsigned int _droppedSteps;
+    Smoothing _smoothing;
+};
+
+NS_AX_END
@@ -2,105 +2,280 @@
 #include "base/Director.h"
 #include "yasio/thread_name.hpp"
 
-#include <queue>
+#include <atomic>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <future>
 #include <functional>
 #include <stdexcept>
 
 NS_AX_BEGIN
 
+static constexpr int PRIORITY_LANES = 3;
+
+struct JobState
+{
+    std::function<void(JobThreadData*)> func;
+    std::shared_ptr<JobState> parent;
+    JobExecutor* executor        = nullptr;
+    JobSystem::Priority priority = JobSystem::Priority::NORMAL;
+
+    // the job itself plus its unfinished children
+    std::atomic<int> unfinished{1};
+    // dependencies not done yet, plus one while they are being registered
+    std::atomic<int> blockers{0};
+    std::atomic<bool> finished{false};
+
+    // guards done and dependents
+    std::mutex mutex;
+    bool done = false;
+    std::vector<std::shared_ptr<JobState>> dependents;
+};
+
 #pragma region JobExecutor
 class JobExecutor
 {
 public:
-    explicit JobExecutor(std::span<std::shared_ptr<JobThreadData>> tdds) : stop(false)
+    explicit JobExecutor(std::span<std::shared_ptr<JobThreadData>> tdds)
+        : _workerCount(static_cast<int>(tdds.size())), _queues(new WorkQueue[tdds.size() + 1])
     {
+        int index = 0;
         for (auto thread_data : tdds)
-            workers.emplace_back([this, thread_data] {
+        {
+            _workers.emplace_back([this, thread_data, index] {
+                t_executor   = this;
+                t_worker     = index;
+                t_threadData = thread_data.get();
+
                 thread_data->init();
                 yasio::set_thread_name(thread_data->name());
                 for (;;)
                 {
-                    std::function<void(JobThreadData*)> task;
+                    if (auto job = pop(index))
                     {
-                        std::unique_lock<std::mutex> lock(this->queue_mutex);
-                        this->condition.wait(lock, [this] { return this->stop || !this->tasks.empty(); });
-                        if (this->stop && this->tasks.empty())
-                            break;
-                        task = std::move(this->tasks.front());
-                        this->tasks.pop();
+                        execute(std::move(job), thread_data.get());
+                        continue;
                     }
 
-                    task(thread_data.get());
+                    std::unique_lock<std::mutex> lock(_sleepMutex);
+                    ++_sleepers;
+                    _sleepCondition.wait(lock, [this] { return _stop || _queued.load() > 0; });
+                    --_sleepers;
+                    if (_stop && _queued.load() == 0)
+                        break;
                 }
                 thread_data->finz();
             });
+            ++index;
+        }
     }
-    template <class F, class... Args>
-    auto enqueue(F&& f, Args&&... args) -> std::future<typename std::invoke_result<F(Args...)>::type>
+
+    ~JobExecutor()
     {
-        using return_type = typename std::invoke_result<F(Args...)>::type;
+        {
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _stop = true;
+        }
+        _sleepCondition.notify_all();
+        for (std::thread& worker : _workers)
+            worker.join();
+    }
 
-        auto task = std::make_shared<std::packaged_task<return_type(size_t)>>(
-            std::bind(std::forward<F>(f), std::placeholders::_1, std::forward<Args>(args)...));
+    int getWorkerCount() const { return _workerCount; }
+
+    // submits the job once all dependencies are done
+    void dispatch(std::shared_ptr<JobState> job, std::span<const JobHandle> dependencies)
+    {
+        // don't allow enqueueing after stopping the pool
+        if (_stop)
+            throw std::runtime_error("enqueue on stopped executor");
 
-        std::future<return_type> res = task->get_future();
+        job->blockers.store(1);
+        for (auto& dependency : dependencies)
         {
-            std::unique_lock<std::mutex> lock(queue_mutex);
+            auto& state = dependency._state;
+            if (!state)
+                continue;
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (!state->done)
+            {
+                state->dependents.emplace_back(job);
+                job->blockers.fetch_add(1);
+            }
+        }
 
-            // don't allow enqueueing after stopping the pool
-            if (stop)
-                throw std::runtime_error("enqueue on stopped executor");
+        if (job->blockers.fetch_sub(1) == 1)
+            submit(std::move(job));
+    }
 
-            tasks.emplace([task](JobThreadData* thread_data) { (*task)(thread_data); });
+    void submit(std::shared_ptr<JobState> job)
+    {
+        // workers keep their own jobs close, other threads go through the injection queue
+        auto& queue = _queues[t_executor == this ? t_worker : _workerCount];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.lanes[static_cast<int>(job->priority)].emplace_back(std::move(job));
+        }
+        _queued.fetch_add(1);
+
+        if (_sleepers.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _sleepCondition.notify_one();
         }
-        condition.notify_one();
-        return res;
     }
 
-    template <class F, class... Args>
-    void enqueue_v(F&& f, Args&&... args)
+    void wait(const std::shared_ptr<JobState>& job)
     {
-        auto task = std::bind(std::forward<F>(f), std::placeholders::_1, std::forward<Args>(args)...);
-
+        if (t_executor == this)
         {
-            std::unique_lock<std::mutex> lock(queue_mutex);
+            // help instead of blocking a worker, its jobs may be the ones waited on
+            while (!job->finished.load())
+            {
+                if (auto next = pop(t_worker))
+                    execute(std::move(next), t_threadData);
+                else
+                    std::this_thread::yield();
+            }
+            return;
+        }
 
-            // don't allow enqueueing after stopping the pool
-            if (stop)
-                throw std::runtime_error("enqueue on stopped executor");
+        ++_waiters;
+        {
+            std::unique_lock<std::mutex> lock(_doneMutex);
+            _doneCondition.wait(lock, [&job] { return job->finished.load(); });
+        }
+        --_waiters;
+    }
 
-            tasks.emplace(std::move(task));
+    void notifyDone()
+    {
+        if (_waiters.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(_doneMutex);
+            _doneCondition.notify_all();
         }
-        condition.notify_one();
     }
-    ~JobExecutor()
+
+    static void finish(std::shared_ptr<JobState> job)
     {
+        while (job && job->unfinished.fetch_sub(1) == 1)
         {
-            std::unique_lock<std::mutex> lock(queue_mutex);
-            stop = true;
+            std::vector<std::shared_ptr<JobState>> dependents;
+            {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->done = true;
+                dependents.swap(job->dependents);
+            }
+            job->finished.store(true);
+
+            auto executor = job->executor;
+            for (auto& dependent : dependents)
+            {
+                if (dependent->blockers.fetch_sub(1) == 1)
+                    executor->submit(std::move(dependent));
+            }
+            if (executor)
+                executor->notifyDone();
+
+            // the parent is done with its last child
+            job = std::move(job->parent);
         }
-        condition.notify_all();
-        for (std::thread& worker : workers)
-            worker.join();
+    }
+
+    static void execute(std::shared_ptr<JobState> job, JobThreadData* thread_data)
+    {
+        job->func(thread_data);
+        job->func = nullptr;
+        finish(std::move(job));
     }
 
 private:
-    // need to keep track of threads so we can join them
-    std::vector<std::thread> workers;
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<JobState>> lanes[PRIORITY_LANES];
+    };
+
+    // takes the next job by priority: own newest, injected oldest, then steals the oldest of another worker
+    std::shared_ptr<JobState> pop(int worker)
+    {
+        if (_queued.load() == 0)
+            return nullptr;
+
+        std::shared_ptr<JobState> job;
+        auto take = [&job](WorkQueue& queue, int lane, bool back) {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto& jobs = queue.lanes[lane];
+            if (jobs.empty())
+                return false;
+            if (back)
+            {
+                job = std::move(jobs.back());
+                jobs.pop_back();
+            }
+            else
+            {
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            return true;
+        };
+
+        for (int lane = 0; lane < PRIORITY_LANES; ++lane)
+        {
+            bool found = take(_queues[worker], lane, true) || take(_queues[_workerCount], lane, false);
+            for (int i = 1; !found && i < _workerCount; ++i)
+                found = take(_queues[(worker + i) % _workerCount], lane, false);
+            if (found)
+            {
+                _queued.fetch_sub(1);
+                return job;
+            }
+        }
+        return nullptr;
+    }
 
-    // the task queue
-    std::queue<std::function<void(JobThreadData*)>> tasks;
+    static thread_local JobExecutor* t_executor;
+    static thread_local int t_worker;
+    static thread_local JobThreadData* t_threadData;
 
-    // synchronization
-    std::mutex queue_mutex;
-    std::condition_variable condition;
-    bool stop;
+    std::vector<std::thread> _workers;
+    const int _workerCount;
+    // one queue per worker, the injection queue last
+    std::unique_ptr<WorkQueue[]> _queues;
+
+    std::atomic<int> _queued{0};
+    std::atomic<int> _sleepers{0};
+    std::atomic<bool> _stop{false};
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+
+    std::atomic<int> _waiters{0};
+    std::mutex _doneMutex;
+    std::condition_variable _doneCondition;
 };
 
+thread_local JobExecutor* JobExecutor::t_executor     = nullptr;
+thread_local int JobExecutor::t_worker                = -1;
+thread_local JobThreadData* JobExecutor::t_threadData = nullptr;
+
+#pragma endregion
+
+#pragma region JobHandle
+
+bool JobHandle::isDone() const
+{
+    return !_state || _state->finished.load();
+}
+
+void JobHandle::wait() const
+{
+    if (!isDone() && _state->executor)
+        _state->executor->wait(_state);
+}
+
 #pragma endregion
 
 #pragma region JobSystem
@@ -159,10 +334,20 @@ JobSystem::~JobSystem()
     delete _mainThreadData;
 }
 
+int JobSystem::getWorkerCount() const
+{
+    return _executor ? _executor->getWorkerCount() : 0;
+}
+
 void JobSystem::enqueue_v(std::function<void(JobThreadData*)> task)
 {
     if (_executor)
-        _executor->enqueue_v(std::move(task));
+    {
+        auto job      = std::make_shared<JobState>();
+        job->func     = std::move(task);
+        job->executor = _executor;
+        _executor->dispatch(std::move(job), {});
+    }
     else
         task(_mainThreadData);
 }
@@ -186,10 +371,7 @@ void JobSystem::enqueue(std::shared_ptr<JobThreadTask> task)
             task->setState(JobThreadTask::State::Idle);
         }
     };
-    if (_executor)
-        _executor->enqueue_v(std::move(taskw));
-    else
-        taskw(_mainThreadData);
+    enqueue_v(std::move(taskw));
 }
 
 void JobSystem::enqueue(std::function<void()> task, std::function<void()> done)
@@ -201,10 +383,111 @@ void JobSystem::enqueue(std::function<void()> task, std::function<void()> done)
         if (done_)
             Director::getInstance()->getScheduler()->runOnAxmolThread(done_);
     };
+    enqueue_v(std::move(taskw));
+}
+
+JobHandle JobSystem::schedule(std::function<void()> task, Priority priority)
+{
+    return schedule(std::move(task), {}, priority);
+}
+
+JobHandle JobSystem::schedule(std::function<void()> task, std::span<const JobHandle> dependencies, Priority priority)
+{
+    auto job      = std::make_shared<JobState>();
+    job->func     = [task_ = std::move(task)](JobThreadData*) { task_(); };
+    job->executor = _executor;
+    job->priority = priority;
+
     if (_executor)
-        _executor->enqueue_v(taskw);
+        _executor->dispatch(job, dependencies);
+    else  // no workers, dependencies already ran inline
+        JobExecutor::execute(job, _mainThreadData);
+
+    return JobHandle{std::move(job)};
+}
+
+JobHandle JobSystem::scheduleChild(const JobHandle& parent, std::function<void()> task, Priority priority)
+{
+    AXASSERT(parent.valid() && !parent.isDone(), "The parent job must be running");
+
+    auto job      = std::make_shared<JobState>();
+    job->func     = [task_ = std::move(task)](JobThreadData*) { task_(); };
+    job->executor = _executor;
+    job->priority = priority;
+    job->parent   = parent._state;
+    job->parent->unfinished.fetch_add(1);
+
+    if (_executor)
+        _executor->dispatch(job, {});
     else
-        taskw(_mainThreadData);
+        JobExecutor::execute(job, _mainThreadData);
+
+    return JobHandle{std::move(job)};
+}
+
+void JobSystem::parallel_for(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& fn)
+{
+    if (end <= begin)
+        return;
+
+    grain             = (std::max)(grain, size_t{1});
+    const auto chunks = (end - begin + grain - 1) / grain;
+    if (!_executor || chunks == 1)
+    {
+        fn(begin, end);
+        return;
+    }
+
+    struct ForState
+    {
+        const std::function<void(size_t, size_t)>* fn = nullptr;
+        size_t begin  = 0;
+        size_t end    = 0;
+        size_t grain  = 0;
+        size_t chunks = 0;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+
+        // processes the next unclaimed chunk, returns false if all chunks were claimed
+        bool runNext()
+        {
+            const auto index = next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= chunks)
+                return false;
+
+            const auto first = begin + index * grain;
+            (*fn)(first, (std::min)(first + grain, end));
+            done.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+    };
+
+    // the state is shared, helpers may only start after all chunks were claimed; fn is never
+    // touched then, so it can stay a reference
+    auto state    = std::make_shared<ForState>();
+    state->fn     = &fn;
+    state->begin  = begin;
+    state->end    = end;
+    state->grain  = grain;
+    state->chunks = chunks;
+
+    const auto helpers = (std::min)(chunks - 1, static_cast<size_t>(_executor->getWorkerCount()));
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        auto job      = std::make_shared<JobState>();
+        job->func     = [state](JobThreadData*) {
+            while (state->runNext())
+                ;
+        };
+        job->executor = _executor;
+        job->priority = Priority::HIGH;
+        _executor->dispatch(std::move(job), {});
+    }
+
+    while (state->runNext())
+        ;
+    while (state->done.load(std::memory_order_acquire) < chunks)
+        std::this_thread::yield();
 }
 
 #pragma endregion
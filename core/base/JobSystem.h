@@ -40,6 +40,7 @@
 #include <memory>
 #include <string>
 #include <span>
+#include <functional>
 #include "base/Config.h"
 #include "platform/PlatformDefine.h"
 
@@ -47,6 +48,8 @@ NS_AX_BEGIN
 
 class JobExecutor;
 class JobSystem;
+struct JobState;
+
 class JobThreadData
 {
 public:
@@ -89,9 +92,50 @@ protected:
     JobThreadData* _threadData{nullptr};
 };
 
+/**
+ * A handle to a scheduled job. A job is done once its function returned and all of its children are done.
+ */
+class AX_API JobHandle
+{
+public:
+    JobHandle() = default;
+
+    bool valid() const { return _state != nullptr; }
+
+    /** Whether the job and all of its children finished, an invalid handle is always done. */
+    bool isDone() const;
+
+    /**
+     * Blocks until the job is done. On a worker thread, other jobs are executed while waiting.
+     */
+    void wait() const;
+
+private:
+    friend class JobSystem;
+    friend class JobExecutor;
+
+    explicit JobHandle(std::shared_ptr<JobState> state) : _state(std::move(state)) {}
+
+    std::shared_ptr<JobState> _state;
+};
+
+/**
+ * The engine's thread pool, a work-stealing scheduler.
+ *
+ * Each worker owns a deque per priority lane. It pushes and pops its own jobs at the back, idle workers steal
+ * from the front. Jobs scheduled from other threads go to a shared injection queue. Higher priority lanes are
+ * always drained first.
+ */
 class AX_API JobSystem
 {
 public:
+    enum class Priority
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+    };
+
     JobSystem(int nThreads = -1);
     JobSystem(std::span<std::shared_ptr<JobThreadData>> tdds);
     ~JobSystem();
@@ -102,7 +146,36 @@ public:
     void enqueue(std::function<void()> task, std::function<void()> done);
     void enqueue(std::shared_ptr<JobThreadTask> task);
 
- protected:
+    /**
+     * Schedules a job.
+     * @return A handle to wait on, or to pass as a dependency or a parent.
+     */
+    JobHandle schedule(std::function<void()> task, Priority priority = Priority::NORMAL);
+
+    /**
+     * Schedules a job which only starts once all dependencies are done.
+     */
+    JobHandle schedule(std::function<void()> task,
+                       std::span<const JobHandle> dependencies,
+                       Priority priority = Priority::NORMAL);
+
+    /**
+     * Schedules a child job of a running parent, the parent isn't done until the child is done.
+     */
+    JobHandle scheduleChild(const JobHandle& parent,
+                            std::function<void()> task,
+                            Priority priority = Priority::NORMAL);
+
+    /**
+     * Calls fn(first, last) over [begin, end) split in chunks of grain items, and returns once all chunks were
+     * processed. The calling thread processes chunks too, so nesting parallel_for in jobs can't deadlock.
+     */
+    void parallel_for(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+    /** Gets the number of worker threads, 0 if jobs run inline on the calling thread. */
+    int getWorkerCount() const;
+
+protected:
     void init(const std::span<std::shared_ptr<JobThreadData>>& tdds);
 
 private:
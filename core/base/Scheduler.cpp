@@ -32,8 +32,45 @@ THE SOFTWARE.
 #include "base/Director.h"
 #include "base/ScriptSupport.h"
 
+#include <chrono>
+#include <iterator>
+#include <vector>
+
 NS_AX_BEGIN
 
+namespace
+{
+using PendingActionQueue = moodycamel::ConcurrentQueue<axstd::small_function<void()>>;
+
+// The explicit producer of a thread for a scheduler. The implicit producers of the bundled concurrentqueue are
+// never released on ARM and iOS, where it doesn't rely on thread_local, so each short lived thread queuing functions
+// leaked one. A token is released when its thread exits and the next threads reuse its producer, the producers are
+// bounded by the number of threads queuing functions at once. The token keeps the queue alive until then.
+struct PendingActionProducer
+{
+    explicit PendingActionProducer(std::shared_ptr<PendingActionQueue> q) : queue(std::move(q)), token(*queue) {}
+
+    std::shared_ptr<PendingActionQueue> queue;
+    moodycamel::ProducerToken token;
+};
+
+thread_local std::vector<std::unique_ptr<PendingActionProducer>> t_pendingActionProducers;
+
+moodycamel::ProducerToken& getPendingActionProducer(const std::shared_ptr<PendingActionQueue>& queue)
+{
+    auto& producers = t_pendingActionProducers;
+    for (auto&& producer : producers)
+    {
+        if (producer->queue == queue)
+            return producer->token;
+    }
+
+    // the thread is the last owner of the queues of the destroyed schedulers
+    std::erase_if(producers, [](const auto& producer) { return producer->queue.use_count() == 1; });
+    return producers.emplace_back(std::make_unique<PendingActionProducer>(queue))->token;
+}
+}  // namespace
+
 // implementation Timer
 
 Timer::Timer()
@@ -46,6 +83,12 @@ Timer::Timer()
     , _delay(0.0f)
     , _interval(0.0f)
     , _aborted(false)
+    , _deadline(0.0)
+    , _lastUpdate(0.0)
+    , _queueOrder(0)
+    , _queueIndex(SIZE_MAX)
+    , _due(false)
+    , _paused(false)
 {}
 
 void Timer::setupTimerWithInterval(float seconds, unsigned int repeat, float delay)
@@ -116,6 +159,17 @@ bool Timer::isExhausted() const
     return !_runForever && _timesExecuted > _repeat;
 }
 
+float Timer::getTimeToTrigger() const
+{
+    // the first update only starts the timer
+    if (_elapsed == -1)
+        return 0.0f;
+    if (_useDelay)
+        return _delay - _elapsed;
+    // if _interval == 0, update once every frame
+    return (_interval > 0) ? _interval - _elapsed : 0.0f;
+}
+
 // TimerTargetSelector
 
 TimerTargetSelector::TimerTargetSelector() : _target(nullptr), _selector(nullptr) {}
@@ -217,20 +271,19 @@ const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
 Scheduler::Scheduler()
     : _timeScale(1.0f)
-    , _currentTarget(nullptr)
-    , _currentTargetSalvaged(false)
     , _indexMapLocked(false)
 #if AX_ENABLE_SCRIPT_BINDING
     , _scriptHandlerEntries(20)
 #endif
-{
-    // I don't expect to have more than 30 functions to all per frame
-    _actionsToPerform.reserve(30);
-}
+    , _actionsToPerform(std::make_shared<PendingActionQueue>())
+    , _performToken(*_actionsToPerform)
+{}
 
 Scheduler::~Scheduler()
 {
     unscheduleAll();
+    // the queue may outlive the scheduler, until the threads which queued functions exit
+    removeAllPendingActions();
 }
 
 void Scheduler::schedule(const ccSchedulerFunc& callback,
@@ -282,13 +335,14 @@ void Scheduler::schedule(const ccSchedulerFunc& callback,
             AXLOG("Scheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat,
                   delay);
             (*timerIt)->setupTimerWithInterval(interval, repeat, delay);
+            restartTimer(*timerIt);
             return;
         }
     }
 
     TimerTargetCallback* timer = new TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    timers.pushBack(timer);
+    addTimer(timerIt->second, timer);
     timer->release();
 }
 
@@ -310,30 +364,12 @@ void Scheduler::unschedule(std::string_view key, void* target)
 
             if (timer && key == timer->getKey())
             {
-                if (timer == timerHandle.currentTimer && (!timer->isAborted()))
-                {
-                    timer->retain();
-                    timer->setAborted();
-                }
-
+                removeTimer(timer);
                 timerHandle.timers.erase(i);
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (timerHandle.timerIndex >= i)
-                {
-                    timerHandle.timerIndex--;
-                }
-
                 if (timerHandle.timers.empty())
                 {
-                    if (_currentTarget == &timerHandle)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        _timersMap.erase(timerIt);
-                    }
+                    _timersMap.erase(timerIt);
                 }
 
                 return;
@@ -556,22 +592,12 @@ void Scheduler::unscheduleAllForTarget(std::unordered_map<void*, TimerHandle>::i
 {
     auto const target = timerIt->first;
     auto& timerHandle = timerIt->second;
-    if (timerHandle.timers.contains(timerHandle.currentTimer) && (!timerHandle.currentTimer->isAborted()))
+    for (auto&& timer : timerHandle.timers)
     {
-        timerHandle.currentTimer->retain();
-        timerHandle.currentTimer->setAborted();
+        removeTimer(timer);
     }
     timerHandle.timers.clear();
-
-    if (_currentTarget == &timerHandle)
-    {
-        _currentTargetSalvaged = true;
-        ++timerIt;
-    }
-    else
-    {
-        timerIt = _timersMap.erase(timerIt);
-    }
+    timerIt = _timersMap.erase(timerIt);
 
     unscheduleUpdate(target);
 }
@@ -607,7 +633,7 @@ void Scheduler::resumeTarget(void* target)
     auto timerIt = _timersMap.find(target);
     if (timerIt != _timersMap.end())
     {
-        timerIt->second.paused = false;
+        resumeTimers(timerIt->second);
     }
 
     // update selector
@@ -626,7 +652,7 @@ void Scheduler::pauseTarget(void* target)
     auto timerIt = _timersMap.find(target);
     if (timerIt != _timersMap.end())
     {
-        timerIt->second.paused = true;
+        pauseTimers(timerIt->second);
     }
 
     // update selector
@@ -670,7 +696,7 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     // Custom Selectors
     for (auto& [target, timerHandle] : _timersMap)
     {
-        timerHandle.paused = true;
+        pauseTimers(timerHandle);
         idsWithSelectors.insert(target);
     }
 
@@ -716,16 +742,215 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
     }
 }
 
-void Scheduler::runOnAxmolThread(std::function<void()> action)
+void Scheduler::addTimer(TimerHandle& timerHandle, Timer* timer)
 {
-    std::lock_guard<std::mutex> lock(_performMutex);
-    _actionsToPerform.emplace_back(std::move(action));
+    timerHandle.timers.pushBack(timer);
+    timer->_paused     = timerHandle.paused;
+    timer->_lastUpdate = _timerClock;
+    if (!timer->_paused)
+        queueTimer(timer);
+}
+
+void Scheduler::removeTimer(Timer* timer)
+{
+    // a due timer is retained by updateTimers, which drops it once it's aborted
+    timer->setAborted();
+    dequeueTimer(timer);
+}
+
+void Scheduler::restartTimer(Timer* timer)
+{
+    timer->_lastUpdate = _timerClock;
+    if (timer->_queueIndex != SIZE_MAX)
+    {
+        dequeueTimer(timer);
+        queueTimer(timer);
+    }
+}
+
+void Scheduler::pauseTimers(TimerHandle& timerHandle)
+{
+    timerHandle.paused = true;
+    for (auto&& timer : timerHandle.timers)
+    {
+        if (timer->_paused)
+            continue;
+
+        // keep the time elapsed until now, the paused time isn't counted
+        if (timer->_elapsed != -1)
+            timer->_elapsed += static_cast<float>(_timerClock - timer->_lastUpdate);
+        timer->_lastUpdate = _timerClock;
+        timer->_paused     = true;
+        dequeueTimer(timer);
+    }
+}
+
+void Scheduler::resumeTimers(TimerHandle& timerHandle)
+{
+    timerHandle.paused = false;
+    for (auto&& timer : timerHandle.timers)
+    {
+        if (!timer->_paused)
+            continue;
+
+        timer->_paused     = false;
+        timer->_lastUpdate = _timerClock;
+        // a due timer is queued again by updateTimers
+        if (!timer->_due)
+            queueTimer(timer);
+    }
+}
+
+void Scheduler::queueTimer(Timer* timer)
+{
+    AXASSERT(timer->_queueIndex == SIZE_MAX, "The timer is already queued");
+    timer->_deadline   = timer->_lastUpdate + timer->getTimeToTrigger();
+    timer->_queueOrder = _timerOrder++;
+    timer->_queueIndex = _timerQueue.size();
+    _timerQueue.emplace_back(timer);
+    siftTimerUp(timer->_queueIndex);
+}
+
+void Scheduler::dequeueTimer(Timer* timer)
+{
+    const auto index = timer->_queueIndex;
+    if (index == SIZE_MAX)
+        return;
+
+    timer->_queueIndex = SIZE_MAX;
+    auto last          = _timerQueue.back();
+    _timerQueue.resize(_timerQueue.size() - 1);
+    if (last != timer)
+    {
+        _timerQueue[index] = last;
+        last->_queueIndex  = index;
+        siftTimerUp(index);
+        siftTimerDown(last->_queueIndex);
+    }
+}
+
+bool Scheduler::timerBefore(const Timer* lhs, const Timer* rhs)
+{
+    // timers with the same deadline are ordered by the time they were queued
+    return lhs->_deadline < rhs->_deadline || (lhs->_deadline == rhs->_deadline && lhs->_queueOrder < rhs->_queueOrder);
+}
+
+void Scheduler::siftTimerUp(size_t index)
+{
+    auto timer = _timerQueue[index];
+    while (index > 0)
+    {
+        auto parent = (index - 1) / 2;
+        if (!timerBefore(timer, _timerQueue[parent]))
+            break;
+        _timerQueue[index]              = _timerQueue[parent];
+        _timerQueue[index]->_queueIndex = index;
+        index                           = parent;
+    }
+    _timerQueue[index] = timer;
+    timer->_queueIndex = index;
+}
+
+void Scheduler::siftTimerDown(size_t index)
+{
+    auto timer       = _timerQueue[index];
+    const auto count = _timerQueue.size();
+    for (;;)
+    {
+        auto child = index * 2 + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && timerBefore(_timerQueue[child + 1], _timerQueue[child]))
+            ++child;
+        if (!timerBefore(_timerQueue[child], timer))
+            break;
+        _timerQueue[index]              = _timerQueue[child];
+        _timerQueue[index]->_queueIndex = index;
+        index                           = child;
+    }
+    _timerQueue[index] = timer;
+    timer->_queueIndex = index;
+}
+
+void Scheduler::updateTimers()
+{
+    // Take the due timers out first, the ones queued again or scheduled by the callbacks wait for the next frame.
+    // They're retained, so that a timer unscheduled by a callback outlives this loop.
+    while (!_timerQueue.empty() && _timerQueue.front()->_deadline <= _timerClock)
+    {
+        auto timer = _timerQueue.front();
+        dequeueTimer(timer);
+        timer->_due = true;
+        timer->retain();
+        _dueTimers.emplace_back(timer);
+    }
+
+    for (auto&& timer : _dueTimers)
+    {
+        // a target may be paused, or a timer unscheduled, by a previous callback
+        if (!timer->isAborted() && !timer->_paused)
+        {
+            auto dt            = static_cast<float>(_timerClock - timer->_lastUpdate);
+            timer->_lastUpdate = _timerClock;
+            timer->update(dt);
+        }
+
+        timer->_due = false;
+        if (!timer->isAborted() && !timer->_paused)
+            queueTimer(timer);
+        timer->release();
+    }
+    _dueTimers.clear();
+}
+
+void Scheduler::runOnAxmolThread(axstd::small_function<void()> action)
+{
+    if (action)
+        _actionsToPerform->enqueue(getPendingActionProducer(_actionsToPerform), std::move(action));
 }
 
 void Scheduler::removeAllPendingActions()
 {
-    std::unique_lock<std::mutex> lock(_performMutex);
-    _actionsToPerform.clear();
+    axstd::small_function<void()> discarded[32];
+    while (_actionsToPerform->try_dequeue_bulk(discarded, std::size(discarded)))
+        ;
+}
+
+void Scheduler::setPendingActionBudget(float milliseconds, size_t count)
+{
+    _pendingActionTimeBudget  = milliseconds;
+    _pendingActionCountBudget = count;
+}
+
+void Scheduler::runPendingActions()
+{
+    using namespace std::chrono;
+
+    // Only run what's queued now, functions queued by these ones wait for the next frame, like the ones that
+    // don't fit in the budget.
+    auto count = _actionsToPerform->size_approx();
+    if (count == 0)
+        return;
+    if (_pendingActionCountBudget)
+        count = (std::min)(count, _pendingActionCountBudget);
+
+    const auto start = steady_clock::now();
+    const auto timeBudget =
+        _pendingActionTimeBudget > 0
+            ? duration_cast<steady_clock::duration>(duration<float, std::milli>(_pendingActionTimeBudget))
+            : steady_clock::duration::max();
+
+    axstd::small_function<void()> action;
+    while (count-- && _actionsToPerform->try_dequeue(_performToken, action))
+    {
+        // fixed #4123: the function may queue new ones, it's run after it left the queue
+        action();
+        action = nullptr;
+
+        // at least one per frame, the rest waits for the next frames
+        if (steady_clock::now() - start >= timeBudget)
+            break;
+    }
 }
 
 // main loop
@@ -774,43 +999,9 @@ void Scheduler::update(float dt)
         }
     }
 
-    // Iterate over all the custom selectors
-    for (auto it = _timersMap.begin(); it != _timersMap.end();)
-    {
-        auto elt               = &it->second;
-        _currentTarget         = elt;
-        _currentTargetSalvaged = false;
-
-        if (!_currentTarget->paused)
-        {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers.size(); ++(elt->timerIndex))
-            {
-                elt->currentTimer = elt->timers[elt->timerIndex];
-                AXASSERT(!elt->currentTimer->isAborted(), "An aborted timer should not be updated");
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimer->isAborted())
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
-
-                elt->currentTimer = nullptr;
-            }
-        }
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers.empty())
-        {
-            it = _timersMap.erase(it);
-        }
-        else
-            ++it;
-    }
+    // Iterate over the custom selectors which are due
+    _timerClock += dt;
+    updateTimers();
 
     // delete all updates that are removed in update
     for (auto&& sched : _updateDeleteVector)
@@ -822,7 +1013,6 @@ void Scheduler::update(float dt)
     _updateDeleteVector.clear();
 
     _indexMapLocked = false;
-    _currentTarget  = nullptr;
 
 #if AX_ENABLE_SCRIPT_BINDING
     //
@@ -849,22 +1039,7 @@ void Scheduler::update(float dt)
     //
     // Functions allocated from another thread
     //
-
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if (!_actionsToPerform.empty())
-    {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if
-        // new functions are added in callback, it will cause thread deadlock.
-        auto temp = std::move(_actionsToPerform);
-        _performMutex.unlock();
-
-        for (const auto& function : temp)
-        {
-            function();
-        }
-    }
+    runPendingActions();
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector,
@@ -906,13 +1081,14 @@ void Scheduler::schedule(SEL_SCHEDULE selector,
             AXLOG("Scheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat,
                   delay);
             (*timerIt)->setupTimerWithInterval(interval, repeat, delay);
+            restartTimer(*timerIt);
             return;
         }
     }
 
     TimerTargetSelector* timer = new TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    timers.pushBack(timer);
+    addTimer(timerIt->second, timer);
     timer->release();
 }
 
@@ -961,30 +1137,12 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Object* target)
 
             if (timer && selector == timer->getSelector())
             {
-                if (timer == timerHandle.currentTimer && !timer->isAborted())
-                {
-                    timer->retain();
-                    timer->setAborted();
-                }
-
+                removeTimer(timer);
                 timers.erase(i);
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (timerHandle.timerIndex >= i)
-                {
-                    timerHandle.timerIndex--;
-                }
-
                 if (timers.empty())
                 {
-                    if (_currentTarget == &timerHandle)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        _timersMap.erase(timerIt);
-                    }
+                    _timersMap.erase(timerIt);
                 }
 
                 return;
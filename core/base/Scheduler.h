@@ -30,11 +30,13 @@ THE SOFTWARE.
 #define __CCSCHEDULER_H__
 
 #include <functional>
-#include <mutex>
+#include <memory>
 #include <set>
 #include "base/axstd.h"
+#include "base/small_function.h"
 #include "base/Object.h"
 #include "base/Vector.h"
+#include "concurrentqueue/concurrentqueue.h"
 
 NS_AX_BEGIN
 
@@ -47,6 +49,8 @@ typedef std::function<void(float)> ccSchedulerFunc;
  */
 class AX_DLL Timer : public Object
 {
+    friend class Scheduler;
+
 protected:
     Timer();
 
@@ -63,6 +67,9 @@ public:
     void update(float dt);
 
 protected:
+    /** The time until update() can trigger, 0 if it must be updated next frame. */
+    float getTimeToTrigger() const;
+
     Scheduler* _scheduler;  // weak ref
     float _elapsed;
     bool _runForever;
@@ -72,6 +79,14 @@ protected:
     float _delay;
     float _interval;
     bool _aborted;
+
+    // Scheduler timer queue state, the timer is only updated once its deadline is reached
+    double _deadline;
+    double _lastUpdate;
+    uint64_t _queueOrder;
+    size_t _queueIndex;
+    bool _due;
+    bool _paused;
 };
 
 class AX_DLL TimerTargetSelector : public Timer
@@ -171,8 +186,6 @@ struct SchedHandle
 struct TimerHandle
 {
     Vector<Timer*> timers;
-    int timerIndex;
-    Timer* currentTimer;
     bool paused;
 };
 
@@ -191,6 +204,9 @@ There are 2 different types of callbacks (selectors):
 The 'custom selectors' should be avoided when possible. It is faster, and consumes less memory to use the 'update
 selector'.
 
+Custom selectors are kept in a queue ordered by their next trigger time, so a frame only visits the ones which are
+due, and selectors with long intervals cost nothing until they trigger.
+
 */
 class AX_DLL Scheduler : public Object
 {
@@ -464,12 +480,14 @@ public:
     void resumeTargets(const std::set<void*>& targetsToResume);
 
     /** Calls a function on the cocos2d thread. Useful when you need to call a cocos2d function from another thread.
-     This function is thread safe.
+     This function is thread safe and lock free, small functions are queued without allocating.
+     Functions queued from the same thread run in order. The order between threads is unspecified, a function
+     queued after one from another thread may run first even when the two threads synchronized in between.
      @param function The function to be run in cocos2d thread.
      @since v3.0
      @js NA
      */
-    void runOnAxmolThread(std::function<void()> action);
+    void runOnAxmolThread(axstd::small_function<void()> action);
 
     AX_DEPRECATED_ATTRIBUTE void performFunctionInCocosThread(std::function<void()> action)
     {
@@ -486,6 +504,20 @@ public:
     void removeAllPendingActions();
     AX_DEPRECATED_ATTRIBUTE void removeAllFunctionsToBePerformedInCocosThread() { removeAllPendingActions(); }
 
+    /**
+     * Sets the per frame budget for running the pending functions, so that a burst of them is spread over frames.
+     * At least one pending function runs per frame, functions queued while they run wait for the next frame.
+     * @param milliseconds The time budget, 0 for unlimited. Default is 2.
+     * @param count The maximum number of functions run per frame, 0 for unlimited. Default is 0.
+     * @js NA
+     */
+    void setPendingActionBudget(float milliseconds, size_t count);
+    float getPendingActionTimeBudget() const { return _pendingActionTimeBudget; }
+    size_t getPendingActionCountBudget() const { return _pendingActionCountBudget; }
+
+    /** Gets the approximate number of pending functions, it may be stale by the time it returns. */
+    size_t getPendingActionCount() const { return _actionsToPerform->size_approx(); }
+
 protected:
     /** Schedules the 'callback' function for a given target with a given priority.
      The 'callback' selector will be called every frame.
@@ -511,6 +543,21 @@ protected:
 
     void unscheduleAllForTarget(std::unordered_map<void*, TimerHandle>::iterator& timerIt);
 
+    // timer queue, a binary min heap on the timer deadlines
+    void addTimer(TimerHandle& timerHandle, Timer* timer);
+    void removeTimer(Timer* timer);
+    void restartTimer(Timer* timer);
+    void pauseTimers(TimerHandle& timerHandle);
+    void resumeTimers(TimerHandle& timerHandle);
+    void queueTimer(Timer* timer);
+    void dequeueTimer(Timer* timer);
+    static bool timerBefore(const Timer* lhs, const Timer* rhs);
+    void siftTimerUp(size_t index);
+    void siftTimerDown(size_t index);
+    void updateTimers();
+
+    void runPendingActions();
+
     float _timeScale;
 
     axstd::pod_vector<SchedHandle*> _waitList; // list wait active
@@ -529,8 +576,11 @@ protected:
 
     // Used for "selectors with interval"
     std::unordered_map<void*, TimerHandle> _timersMap;
-    struct TimerHandle* _currentTarget;
-    bool _currentTargetSalvaged;
+    axstd::pod_vector<Timer*> _timerQueue;
+    axstd::pod_vector<Timer*> _dueTimers;
+    // scaled time of the timers, advanced by update
+    double _timerClock   = 0.0;
+    uint64_t _timerOrder = 0;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _indexMapLocked;
 
@@ -538,9 +588,12 @@ protected:
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
 #endif
 
-    // Used for "perform action"
-    std::vector<std::function<void()>> _actionsToPerform;
-    std::mutex _performMutex;
+    // Used for "perform action", multiple producers and the axmol thread as the consumer. The producing threads
+    // share its ownership until they exit, see runOnAxmolThread.
+    std::shared_ptr<moodycamel::ConcurrentQueue<axstd::small_function<void()>>> _actionsToPerform;
+    moodycamel::ConsumerToken _performToken;
+    float _pendingActionTimeBudget   = 2.0f;
+    size_t _pendingActionCountBudget = 0;
 };
 
 // end of base group
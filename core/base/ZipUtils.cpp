@@ -354,8 +354,8 @@ int ZipUtils::inflateGZipFile(const char* path, unsigned char** out)
 
 bool ZipUtils::isCCZFile(const char* path)
 {
-    // load file into memory
-    Data compressedData = FileUtils::getInstance()->getDataFromFile(path);
+    // map or load file into memory
+    auto compressedData = FileUtils::getInstance()->getFileView(path);
 
     if (compressedData.isNull())
     {
@@ -363,7 +363,7 @@ bool ZipUtils::isCCZFile(const char* path)
         return false;
     }
 
-    return isCCZBuffer(compressedData.getBytes(), compressedData.getSize());
+    return isCCZBuffer(compressedData.data(), compressedData.size());
 }
 
 bool ZipUtils::isCCZBuffer(const unsigned char* buffer, ssize_t len)
@@ -380,8 +380,8 @@ bool ZipUtils::isCCZBuffer(const unsigned char* buffer, ssize_t len)
 
 bool ZipUtils::isGZipFile(const char* path)
 {
-    // load file into memory
-    Data compressedData = FileUtils::getInstance()->getDataFromFile(path);
+    // map or load file into memory
+    auto compressedData = FileUtils::getInstance()->getFileView(path);
 
     if (compressedData.isNull())
     {
@@ -389,7 +389,7 @@ bool ZipUtils::isGZipFile(const char* path)
         return false;
     }
 
-    return isGZipBuffer(compressedData.getBytes(), compressedData.getSize());
+    return isGZipBuffer(compressedData.data(), compressedData.size());
 }
 
 bool ZipUtils::isGZipBuffer(const unsigned char* buffer, ssize_t len)
@@ -405,6 +405,7 @@ bool ZipUtils::isGZipBuffer(const unsigned char* buffer, ssize_t len)
 int ZipUtils::inflateCCZBuffer(const unsigned char* buffer, ssize_t bufferLen, unsigned char** out)
 {
     struct CCZHeader* header = (struct CCZHeader*)buffer;
+    axstd::byte_buffer decrypted;
 
     // verify header
     if (header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == '!')
@@ -426,7 +427,9 @@ int ZipUtils::inflateCCZBuffer(const unsigned char* buffer, ssize_t bufferLen, u
     }
     else if (header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == 'p')
     {
-        // encrypted ccz file
+        // encrypted ccz file, decrypt a copy since the buffer may be a read only file mapping
+        decrypted.assign(buffer, buffer + bufferLen);
+        buffer = decrypted.data();
         header = (struct CCZHeader*)buffer;
 
         // verify header version
@@ -494,8 +497,8 @@ int ZipUtils::inflateCCZFile(const char* path, unsigned char** out)
 {
     AXASSERT(out, "Invalid pointer for buffer!");
 
-    // load file into memory
-    Data compressedData = FileUtils::getInstance()->getDataFromFile(path);
+    // map or load file into memory
+    auto compressedData = FileUtils::getInstance()->getFileView(path);
 
     if (compressedData.isNull())
     {
@@ -503,7 +506,7 @@ int ZipUtils::inflateCCZFile(const char* path, unsigned char** out)
         return -1;
     }
 
-    return inflateCCZBuffer(compressedData.getBytes(), compressedData.getSize(), out);
+    return inflateCCZBuffer(compressedData.data(), compressedData.size(), out);
 }
 
 void ZipUtils::setPvrEncryptionKeyPart(int index, unsigned int value)
@@ -0,0 +1,172 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace axstd
+{
+template <typename _Sig, size_t _Capacity = 56>
+class small_function;
+
+/**
+ * A move only std::function which stores small callables inline instead of allocating them.
+ *
+ * Callables up to _Capacity bytes with a noexcept move constructor live in the object, larger ones fall back to
+ * the heap. The default capacity makes the whole object one cache line on 64-bit platforms, enough for lambdas
+ * capturing a few pointers and a std::string.
+ */
+template <typename _Ret, typename... _Args, size_t _Capacity>
+class small_function<_Ret(_Args...), _Capacity>
+{
+    template <typename _Ty>
+    struct is_std_function : std::false_type
+    {};
+    template <typename _Fty>
+    struct is_std_function<std::function<_Fty>> : std::true_type
+    {};
+
+    template <typename _Fn>
+    using enable_if_callable_t = std::enable_if_t<!std::is_same_v<std::decay_t<_Fn>, small_function> &&
+                                                      std::is_invocable_r_v<_Ret, std::decay_t<_Fn>&, _Args...>,
+                                                  int>;
+
+public:
+    /** Whether a callable of type _Fn is stored inline. */
+    template <typename _Fn>
+    static constexpr bool stores_inline = sizeof(_Fn) <= _Capacity && alignof(_Fn) <= alignof(std::max_align_t) &&
+                                          std::is_nothrow_move_constructible_v<_Fn>;
+
+    small_function() noexcept = default;
+    small_function(std::nullptr_t) noexcept {}
+
+    template <typename _Fn, enable_if_callable_t<_Fn> = 0>
+    small_function(_Fn&& fn)
+    {
+        using _Ty = std::decay_t<_Fn>;
+        if constexpr (std::is_pointer_v<_Ty> || std::is_member_pointer_v<_Ty> || is_std_function<_Ty>::value)
+        {
+            if (!fn)
+                return;
+        }
+
+        if constexpr (stores_inline<_Ty>)
+        {
+            ::new (static_cast<void*>(_storage)) _Ty(std::forward<_Fn>(fn));
+            _ops = &inline_ops<_Ty>;
+        }
+        else
+        {
+            *reinterpret_cast<_Ty**>(_storage) = new _Ty(std::forward<_Fn>(fn));
+            _ops                               = &heap_ops<_Ty>;
+        }
+    }
+
+    small_function(small_function&& o) noexcept { move_from(o); }
+
+    small_function& operator=(small_function&& o) noexcept
+    {
+        if (this != &o)
+        {
+            reset();
+            move_from(o);
+        }
+        return *this;
+    }
+
+    small_function& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    small_function(const small_function&)            = delete;
+    small_function& operator=(const small_function&) = delete;
+
+    ~small_function() { reset(); }
+
+    explicit operator bool() const noexcept { return _ops != nullptr; }
+
+    _Ret operator()(_Args... args) { return _ops->invoke(_storage, std::forward<_Args>(args)...); }
+
+    void reset() noexcept
+    {
+        if (_ops)
+        {
+            _ops->destroy(_storage);
+            _ops = nullptr;
+        }
+    }
+
+private:
+    struct ops
+    {
+        _Ret (*invoke)(void*, _Args&&...);
+        void (*move)(void* dst, void* src) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    template <typename _Ty>
+    static _Ret invoke(_Ty& fn, _Args&&... args)
+    {
+        if constexpr (std::is_void_v<_Ret>)
+            std::invoke(fn, std::forward<_Args>(args)...);
+        else
+            return std::invoke(fn, std::forward<_Args>(args)...);
+    }
+
+    template <typename _Ty>
+    static constexpr ops inline_ops = {
+        [](void* p, _Args&&... args) -> _Ret { return invoke(*static_cast<_Ty*>(p), std::forward<_Args>(args)...); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) _Ty(std::move(*static_cast<_Ty*>(src)));
+            static_cast<_Ty*>(src)->~_Ty();
+        },
+        [](void* p) noexcept { static_cast<_Ty*>(p)->~_Ty(); }};
+
+    template <typename _Ty>
+    static constexpr ops heap_ops = {
+        [](void* p, _Args&&... args) -> _Ret { return invoke(**static_cast<_Ty**>(p), std::forward<_Args>(args)...); },
+        [](void* dst, void* src) noexcept { *static_cast<_Ty**>(dst) = *static_cast<_Ty**>(src); },
+        [](void* p) noexcept { delete *static_cast<_Ty**>(p); }};
+
+    void move_from(small_function& o) noexcept
+    {
+        if (o._ops)
+        {
+            o._ops->move(_storage, o._storage);
+            _ops   = o._ops;
+            o._ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char _storage[_Capacity];
+    const ops* _ops = nullptr;
+};
+}  // namespace axstd
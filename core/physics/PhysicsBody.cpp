@@ -83,6 +83,9 @@ namespace
 {
 static const float MASS_DEFAULT   = 1.0;
 static const float MOMENT_DEFAULT = 200;
+// how far a smoothed node may be from where it was put before it counts as moved by the game
+static const float SMOOTHED_POSITION_TOLERANCE = 0.01f;
+static const float SMOOTHED_ROTATION_TOLERANCE = 0.01f;
 }  // namespace
 
 PhysicsBody::PhysicsBody()
@@ -111,6 +114,10 @@ PhysicsBody::PhysicsBody()
     , _recordScaleX(1.f)
     , _recordScaleY(1.f)
     , _fixedUpdate(false)
+    , _previousRotation(0.0f)
+    , _hasPreviousTransform(false)
+    , _smoothedRotation(0.0f)
+    , _smoothed(false)
 {
     _name = COMPONENT_NAME;
 }
@@ -929,16 +936,35 @@ void PhysicsBody::beforeSimulation(const Mat4& parentToWorldTransform,
         setScale(scaleX, scaleY);
     }
 
-    // set rotation
-    if (_recordedRotation != rotation)
+    auto worldPosition = _ownerCenterOffset;
+    nodeToWorldTransform.transformVector(worldPosition.x, worldPosition.y, worldPosition.z, 1.f, &worldPosition);
+
+    // a smoothed node isn't where its body is, the body only follows the node when the game moved it
+    if (_smoothed)
     {
-        setRotation(rotation);
+        if (std::abs(rotation - _smoothedRotation) > SMOOTHED_ROTATION_TOLERANCE)
+        {
+            setRotation(rotation);
+            _hasPreviousTransform = false;
+        }
+        if (Vec2(worldPosition.x, worldPosition.y).distanceSquared(_smoothedPosition) >
+            SMOOTHED_POSITION_TOLERANCE * SMOOTHED_POSITION_TOLERANCE)
+        {
+            setPosition(worldPosition.x, worldPosition.y);
+            _hasPreviousTransform = false;
+        }
     }
+    else
+    {
+        // set rotation
+        if (_recordedRotation != rotation)
+        {
+            setRotation(rotation);
+        }
 
-    // set position
-    auto worldPosition = _ownerCenterOffset;
-    nodeToWorldTransform.transformVector(worldPosition.x, worldPosition.y, worldPosition.z, 1.f, &worldPosition);
-    setPosition(worldPosition.x, worldPosition.y);
+        // set position
+        setPosition(worldPosition.x, worldPosition.y);
+    }
 
     _recordPosX = worldPosition.x;
     _recordPosY = worldPosition.y;
@@ -952,20 +978,64 @@ void PhysicsBody::beforeSimulation(const Mat4& parentToWorldTransform,
     }
 }
 
-void PhysicsBody::afterSimulation(const Mat4& parentToWorldTransform, float parentRotation)
+bool PhysicsBody::getSimulatedTransform(const Mat4& worldToParentTransform,
+                                        float parentRotation,
+                                        const FixedTimestep* smoothing,
+                                        Vec2& outPosition,
+                                        float& outRotation)
 {
-    // set Node position
-    auto tmp = getPosition();
-    Vec3 positionInParent(tmp.x, tmp.y, 0.f);
-    if (_recordPosX != positionInParent.x || _recordPosY != positionInParent.y)
+    auto position = getPosition();
+    auto rotation = getRotation();
+
+    if (smoothing)
     {
-        parentToWorldTransform.getInversed().transformVector(positionInParent.x, positionInParent.y, positionInParent.z,
-                                                             1.f, &positionInParent);
-        _owner->setPosition(positionInParent.x - _offset.x, positionInParent.y - _offset.y);
+        if (smoothing->getSmoothing() == FixedTimestep::Smoothing::INTERPOLATE)
+        {
+            if (_hasPreviousTransform)
+            {
+                const float alpha = smoothing->getAlpha();
+                position          = _previousPosition.lerp(position, alpha);
+                rotation          = _previousRotation + (rotation - _previousRotation) * alpha;
+            }
+        }
+        else if (!isResting())
+        {
+            const float time = smoothing->getRemainder() * (_world ? _world->getSpeed() : 1.0f);
+            position += getVelocity() * time;
+            rotation -= AX_RADIANS_TO_DEGREES(getAngularVelocity()) * time;
+        }
+        _smoothedPosition = position;
+        _smoothedRotation = rotation;
+        _smoothed         = true;
     }
+    else
+    {
+        const bool wasSmoothed = _smoothed;
+        _smoothed              = false;
+        _hasPreviousTransform  = false;
+        if (!wasSmoothed && _recordPosX == position.x && _recordPosY == position.y)
+        {
+            outRotation = rotation - parentRotation;
+            return false;
+        }
+    }
+
+    // Node rotation
+    outRotation = rotation - parentRotation;
 
-    // set Node rotation
-    _owner->setRotation(getRotation() - parentRotation);
+    // Node position
+    Vec3 positionInParent(position.x, position.y, 0.f);
+    worldToParentTransform.transformVector(positionInParent.x, positionInParent.y, positionInParent.z, 1.f,
+                                           &positionInParent);
+    outPosition.set(positionInParent.x - _offset.x, positionInParent.y - _offset.y);
+    return true;
+}
+
+void PhysicsBody::recordPreviousTransform()
+{
+    _previousPosition     = getPosition();
+    _previousRotation     = getRotation();
+    _hasPreviousTransform = true;
 }
 
 void PhysicsBody::onEnter()
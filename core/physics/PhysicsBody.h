@@ -42,6 +42,7 @@ NS_AX_BEGIN
 class Node;
 class PhysicsWorld;
 class PhysicsJoint;
+class FixedTimestep;
 
 const PhysicsMaterial PHYSICSBODY_MATERIAL_DEFAULT(0.1f, 0.5f, 0.5f);
 
@@ -567,7 +568,14 @@ protected:
                           float scaleX,
                           float scaleY,
                           float rotation);
-    void afterSimulation(const Mat4& parentToWorldTransform, float parentRotation);
+    // the node transform after a step, returns false when the position didn't change, one body per thread
+    bool getSimulatedTransform(const Mat4& worldToParentTransform,
+                               float parentRotation,
+                               const FixedTimestep* smoothing,
+                               Vec2& outPosition,
+                               float& outRotation);
+    // the state the interpolation starts from, before the last step of a frame
+    void recordPreviousTransform();
 
 protected:
     std::vector<PhysicsJoint*> _joints;
@@ -615,6 +623,15 @@ protected:
     // fixed update state
     bool _fixedUpdate;
 
+    // the transform before the last fixed update
+    Vec2 _previousPosition;
+    float _previousRotation;
+    bool _hasPreviousTransform;
+    // the world transform given to the node when smoothed
+    Vec2 _smoothedPosition;
+    float _smoothedRotation;
+    bool _smoothed;
+
     friend class PhysicsWorld;
     friend class PhysicsShape;
     friend class PhysicsJoint;
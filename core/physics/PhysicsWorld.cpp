@@ -27,6 +27,7 @@
 #include "physics/PhysicsWorld.h"
 #if defined(AX_ENABLE_PHYSICS)
 #    include <algorithm>
+#    include <atomic>
 #    include <climits>
 
 #    include "chipmunk/chipmunk_private.h"
@@ -41,6 +42,7 @@
 #    include "base/Director.h"
 #    include "base/EventDispatcher.h"
 #    include "base/EventCustom.h"
+#    include "base/JobSystem.h"
 
 NS_AX_BEGIN
 const float PHYSICS_INFINITY = FLT_MAX;
@@ -54,6 +56,11 @@ const int PhysicsWorld::DEBUGDRAW_ALL     = DEBUGDRAW_SHAPE | DEBUGDRAW_JOINT |
 
 const float _debugDrawThickness = 0.5f;  // thickness of the DebugDraw lines, circles, dots, polygons
 
+// bodies synced by a worker per chunk
+static const size_t SYNC_BODIES_PER_CHUNK = 64;
+// batched queries run by a worker per chunk
+static const size_t QUERIES_PER_CHUNK = 32;
+
 namespace
 {
 typedef struct RayCastCallbackInfo
@@ -78,6 +85,25 @@ typedef struct PointQueryCallbackInfo
     PhysicsQueryPointCallbackFunc func;
     void* data;
 } PointQueryCallbackInfo;
+
+// the state of one query of a batch, the batched queries run without the space lock so they can share the space
+struct BatchRayCastInfo
+{
+    cpVect start;
+    cpVect end;
+    int categoryBitmask;
+    cpSegmentQueryInfo closest;
+};
+
+struct BatchQueryInfo
+{
+    cpBB bb;
+    cpVect point;
+    int categoryBitmask;
+    PhysicsShape** shapes;
+    int capacity;
+    int count;
+};
 }  // namespace
 
 class PhysicsWorldCallback
@@ -103,6 +129,9 @@ public:
                                      cpFloat distance,
                                      cpVect gradient,
                                      Vector<PhysicsShape*>* arr);
+    static cpFloat batchRayCastFunc(BatchRayCastInfo* info, cpShape* shape, void* data);
+    static cpCollisionID batchQueryRectFunc(BatchQueryInfo* info, cpShape* shape, cpCollisionID id, void* data);
+    static cpCollisionID batchQueryPointFunc(BatchQueryInfo* info, cpShape* shape, cpCollisionID id, void* data);
 
 public:
     static bool continues;
@@ -205,6 +234,49 @@ void PhysicsWorldCallback::queryPointFunc(cpShape* shape,
     PhysicsWorldCallback::continues = info->func(*info->world, *physicsShape, info->data);
 }
 
+cpFloat PhysicsWorldCallback::batchRayCastFunc(BatchRayCastInfo* info, cpShape* shape, void* /*data*/)
+{
+    auto physicsShape = static_cast<PhysicsShape*>(cpShapeGetUserData(shape));
+    cpSegmentQueryInfo hit;
+    if (!cpShapeGetSensor(shape) && (physicsShape->getCategoryBitmask() & info->categoryBitmask) &&
+        cpShapeSegmentQuery(shape, info->start, info->end, 0.0f, &hit) && hit.alpha < info->closest.alpha)
+    {
+        info->closest = hit;
+    }
+
+    return info->closest.alpha;
+}
+
+cpCollisionID PhysicsWorldCallback::batchQueryRectFunc(BatchQueryInfo* info,
+                                                       cpShape* shape,
+                                                       cpCollisionID id,
+                                                       void* /*data*/)
+{
+    auto physicsShape = static_cast<PhysicsShape*>(cpShapeGetUserData(shape));
+    if (info->count < info->capacity && (physicsShape->getCategoryBitmask() & info->categoryBitmask) &&
+        cpBBIntersects(info->bb, cpShapeGetBB(shape)))
+    {
+        info->shapes[info->count++] = physicsShape;
+    }
+    return id;
+}
+
+cpCollisionID PhysicsWorldCallback::batchQueryPointFunc(BatchQueryInfo* info,
+                                                        cpShape* shape,
+                                                        cpCollisionID id,
+                                                        void* /*data*/)
+{
+    auto physicsShape = static_cast<PhysicsShape*>(cpShapeGetUserData(shape));
+    if (info->count < info->capacity && (physicsShape->getCategoryBitmask() & info->categoryBitmask))
+    {
+        cpPointQueryInfo hit;
+        cpShapePointQuery(shape, info->point, &hit);
+        if (hit.distance < 0.0f)
+            info->shapes[info->count++] = physicsShape;
+    }
+    return id;
+}
+
 static inline cpSpaceDebugColor RGBAColor(float r, float g, float b, float a)
 {
     cpSpaceDebugColor color = {r, g, b, a};
@@ -499,6 +571,140 @@ void PhysicsWorld::queryPoint(PhysicsQueryPointCallbackFunc func, const Vec2& po
     }
 }
 
+int PhysicsWorld::rayCastBatch(std::span<const PhysicsRaySegment> rays,
+                               std::span<PhysicsRayCastInfo> outHits,
+                               int categoryBitmask,
+                               bool parallel)
+{
+    AXASSERT(outHits.size() >= rays.size(), "outHits must be as large as rays");
+    // in release builds, the rays without a slot in outHits are skipped
+    rays = rays.first((std::min)(rays.size(), outHits.size()));
+
+    if (!_delayAddBodies.empty() || !_delayRemoveBodies.empty())
+    {
+        updateBodies();
+    }
+
+    std::atomic<int> hits{0};
+    runQueryBatch(rays.size(), parallel, [&](size_t first, size_t last) {
+        int chunkHits = 0;
+        for (auto i = first; i < last; ++i)
+        {
+            auto& ray  = rays[i];
+            auto start = PhysicsHelper::vec22cpv(ray.start);
+            auto end   = PhysicsHelper::vec22cpv(ray.end);
+            BatchRayCastInfo info{start, end, categoryBitmask, {nullptr, end, cpvzero, 1.0f}};
+
+            // the static shapes first, the closest of their hits shortens the search of the dynamic ones
+            cpSpatialIndexSegmentQuery(_cpSpace->staticShapes, &info, start, end, 1.0f,
+                                       (cpSpatialIndexSegmentQueryFunc)PhysicsWorldCallback::batchRayCastFunc,
+                                       nullptr);
+            cpSpatialIndexSegmentQuery(_cpSpace->dynamicShapes, &info, start, end, info.closest.alpha,
+                                       (cpSpatialIndexSegmentQueryFunc)PhysicsWorldCallback::batchRayCastFunc,
+                                       nullptr);
+
+            auto shape = info.closest.shape ? static_cast<PhysicsShape*>(cpShapeGetUserData(info.closest.shape))
+                                            : nullptr;
+            outHits[i] = {shape,
+                          ray.start,
+                          ray.end,
+                          PhysicsHelper::cpv2vec2(info.closest.point),
+                          PhysicsHelper::cpv2vec2(info.closest.normal),
+                          static_cast<float>(info.closest.alpha),
+                          nullptr};
+            if (shape)
+                ++chunkHits;
+        }
+        hits += chunkHits;
+    });
+
+    return hits;
+}
+
+int PhysicsWorld::queryRectBatch(std::span<const Rect> rects,
+                                 std::span<PhysicsShape*> outShapes,
+                                 std::span<int> outCounts,
+                                 int categoryBitmask,
+                                 bool parallel)
+{
+    AXASSERT(outCounts.size() >= rects.size(), "outCounts must be as large as rects");
+    rects = rects.first((std::min)(rects.size(), outCounts.size()));
+    if (rects.empty())
+        return 0;
+
+    if (!_delayAddBodies.empty() || !_delayRemoveBodies.empty())
+    {
+        updateBodies();
+    }
+
+    const int capacity = static_cast<int>(outShapes.size() / rects.size());
+    std::atomic<int> found{0};
+    runQueryBatch(rects.size(), parallel, [&](size_t first, size_t last) {
+        int chunkFound = 0;
+        for (auto i = first; i < last; ++i)
+        {
+            auto bb = PhysicsHelper::rect2cpbb(rects[i]);
+            BatchQueryInfo info{bb, cpvzero, categoryBitmask, outShapes.data() + i * capacity, capacity, 0};
+            cpSpatialIndexQuery(_cpSpace->dynamicShapes, &info, bb,
+                                (cpSpatialIndexQueryFunc)PhysicsWorldCallback::batchQueryRectFunc, nullptr);
+            cpSpatialIndexQuery(_cpSpace->staticShapes, &info, bb,
+                                (cpSpatialIndexQueryFunc)PhysicsWorldCallback::batchQueryRectFunc, nullptr);
+            outCounts[i] = info.count;
+            chunkFound += info.count;
+        }
+        found += chunkFound;
+    });
+
+    return found;
+}
+
+int PhysicsWorld::queryPointBatch(std::span<const Vec2> points,
+                                  std::span<PhysicsShape*> outShapes,
+                                  std::span<int> outCounts,
+                                  int categoryBitmask,
+                                  bool parallel)
+{
+    AXASSERT(outCounts.size() >= points.size(), "outCounts must be as large as points");
+    points = points.first((std::min)(points.size(), outCounts.size()));
+    if (points.empty())
+        return 0;
+
+    if (!_delayAddBodies.empty() || !_delayRemoveBodies.empty())
+    {
+        updateBodies();
+    }
+
+    const int capacity = static_cast<int>(outShapes.size() / points.size());
+    std::atomic<int> found{0};
+    runQueryBatch(points.size(), parallel, [&](size_t first, size_t last) {
+        int chunkFound = 0;
+        for (auto i = first; i < last; ++i)
+        {
+            auto point = PhysicsHelper::vec22cpv(points[i]);
+            auto bb    = cpBBNewForCircle(point, 0.0f);
+            BatchQueryInfo info{bb, point, categoryBitmask, outShapes.data() + i * capacity, capacity, 0};
+            cpSpatialIndexQuery(_cpSpace->dynamicShapes, &info, bb,
+                                (cpSpatialIndexQueryFunc)PhysicsWorldCallback::batchQueryPointFunc, nullptr);
+            cpSpatialIndexQuery(_cpSpace->staticShapes, &info, bb,
+                                (cpSpatialIndexQueryFunc)PhysicsWorldCallback::batchQueryPointFunc, nullptr);
+            outCounts[i] = info.count;
+            chunkFound += info.count;
+        }
+        found += chunkFound;
+    });
+
+    return found;
+}
+
+void PhysicsWorld::runQueryBatch(size_t count, bool parallel, const std::function<void(size_t, size_t)>& fn)
+{
+    auto jobSystem = Director::getInstance()->getJobSystem();
+    if (parallel && count > QUERIES_PER_CHUNK && jobSystem->getWorkerCount() > 0)
+        jobSystem->parallel_for(0, count, QUERIES_PER_CHUNK, fn);
+    else
+        fn(0, count);
+}
+
 Vector<PhysicsShape*> PhysicsWorld::getShapes(const Vec2& point) const
 {
     Vector<PhysicsShape*> arr;
@@ -559,7 +765,7 @@ void PhysicsWorld::addBody(PhysicsBody* body)
     addBodyOrDelay(body);
     _bodies.pushBack(body);
     body->_world = this;
-    body->setFixedUpdate(_fixedRate > 0);
+    body->setFixedUpdate(_fixedTimestep.isEnabled());
 }
 
 void PhysicsWorld::doAddBody(PhysicsBody* body)
@@ -905,6 +1111,15 @@ void PhysicsWorld::setSubsteps(int steps)
     }
 }
 
+void PhysicsWorld::setFixedUpdateRate(int updatesPerSecond)
+{
+    _fixedTimestep.setStepsPerSecond(updatesPerSecond);
+    for (auto&& body : _bodies)
+    {
+        body->setFixedUpdate(_fixedTimestep.isEnabled());
+    }
+}
+
 void PhysicsWorld::step(float delta)
 {
     if (_autoStep)
@@ -955,14 +1170,19 @@ void PhysicsWorld::update(float delta, bool userCall /* = false*/)
     }
     else
     {
-        _updateTime += delta;
-        if (_fixedRate)
+        if (_fixedTimestep.isEnabled())
         {
-            const float step = 1.0f / _fixedRate;
-            const float dt   = step * _speed;
-            while (_updateTime > step)
+            const int steps = _fixedTimestep.advance(delta);
+            const float dt  = _fixedTimestep.getStepInterval() * _speed;
+            for (int i = 0; i < steps; ++i)
             {
-                _updateTime -= step;
+                // the state the interpolation starts from
+                if (i == steps - 1 && _fixedTimestep.getSmoothing() == FixedTimestep::Smoothing::INTERPOLATE)
+                {
+                    for (auto&& body : _bodies)
+                        body->recordPreviousTransform();
+                }
+
                 for (auto&& body : _bodies)
                 {
                     body->fixedUpdate(dt);
@@ -973,11 +1193,12 @@ void PhysicsWorld::update(float delta, bool userCall /* = false*/)
                 cpSpaceStep(_cpSpace, dt);
 #    else
                 cpHastySpaceStep(_cpSpace, dt);
-#    endif                
+#    endif
             }
         }
         else
         {
+            _updateTime += delta;
             if (++_updateRateCount >= _updateRate)
             {
                 const float dt = _updateTime * _speed / _substeps;
@@ -1000,9 +1221,10 @@ void PhysicsWorld::update(float delta, bool userCall /* = false*/)
         debugDraw();
     }
 
-    // Update physics position, should loop as the same sequence as node tree.
-    // PhysicsWorld::afterSimulation() will depend on the sequence.
-    afterSimulation(_scene, sceneToWorldTransform, 0.f);
+    // Update physics position, in the sequence of the node tree.
+    const bool smoothing = !userCall && _fixedTimestep.isEnabled() &&
+                           _fixedTimestep.getSmoothing() != FixedTimestep::Smoothing::NONE;
+    afterSimulation(_scene, sceneToWorldTransform, 0.f, smoothing ? &_fixedTimestep : nullptr);
 
     if (_postUpdateCallback)
         _postUpdateCallback();  // fix #11154
@@ -1029,7 +1251,6 @@ PhysicsWorld::PhysicsWorld()
     , _updateRateCount(0)
     , _updateTime(0.0f)
     , _substeps(1)
-    , _fixedRate(0)
     , _cpSpace(nullptr)
     , _updateBodyTransform(false)
     , _scene(nullptr)
@@ -1037,6 +1258,7 @@ PhysicsWorld::PhysicsWorld()
     , _debugDraw(nullptr)
     , _debugDrawMask(DEBUGDRAW_NONE)
     , _eventDispatcher(nullptr)
+    , _parallelSyncThreshold(256)
 {}
 
 PhysicsWorld::~PhysicsWorld()
@@ -1076,7 +1298,47 @@ void PhysicsWorld::beforeSimulation(Node* node,
         beforeSimulation(child, nodeToWorldTransform, scaleX, scaleY, rotation);
 }
 
-void PhysicsWorld::afterSimulation(Node* node, const Mat4& parentToWorldTransform, float parentRotation)
+void PhysicsWorld::afterSimulation(Node* node,
+                                   const Mat4& parentToWorldTransform,
+                                   float parentRotation,
+                                   const FixedTimestep* smoothing)
+{
+    // every transform is read before a node moves, so the bodies don't depend on each other
+    _bodySyncs.clear();
+    _syncParentTransforms.clear();
+    int parentIndex = -1;
+    gatherBodySyncs(node, parentToWorldTransform, parentRotation, parentIndex);
+
+    auto computeSyncs = [this, smoothing](size_t first, size_t last) {
+        for (auto i = first; i < last; ++i)
+        {
+            auto& sync = _bodySyncs[i];
+            sync.moved = sync.body->getSimulatedTransform(_syncParentTransforms[sync.parent], sync.parentRotation,
+                                                          smoothing, sync.position, sync.rotation);
+        }
+    };
+
+    auto jobSystem = Director::getInstance()->getJobSystem();
+    if (_parallelSyncThreshold > 0 && _bodySyncs.size() >= static_cast<size_t>(_parallelSyncThreshold) &&
+        jobSystem->getWorkerCount() > 0)
+        jobSystem->parallel_for(0, _bodySyncs.size(), SYNC_BODIES_PER_CHUNK, computeSyncs);
+    else
+        computeSyncs(0, _bodySyncs.size());
+
+    // the node setters stay on this thread, a Sprite marks its descendants dirty for instance
+    for (auto&& sync : _bodySyncs)
+    {
+        auto owner = sync.body->getNode();
+        if (sync.moved)
+            owner->setPosition(sync.position.x, sync.position.y);
+        owner->setRotation(sync.rotation);
+    }
+}
+
+void PhysicsWorld::gatherBodySyncs(Node* node,
+                                   const Mat4& parentToWorldTransform,
+                                   float parentRotation,
+                                   int& parentIndex)
 {
     auto nodeToWorldTransform = parentToWorldTransform * node->getNodeToParentTransform();
     auto nodeRotation         = parentRotation + node->getRotation();
@@ -1084,11 +1346,34 @@ void PhysicsWorld::afterSimulation(Node* node, const Mat4& parentToWorldTransfor
     auto physicsBody = node->getPhysicsBody();
     if (physicsBody)
     {
-        physicsBody->afterSimulation(parentToWorldTransform, parentRotation);
+        // inversed once for all the siblings
+        if (parentIndex < 0)
+        {
+            parentIndex = static_cast<int>(_syncParentTransforms.size());
+            _syncParentTransforms.emplace_back(parentToWorldTransform.getInversed());
+        }
+        _bodySyncs.emplace_back(BodySync{physicsBody, parentIndex, parentRotation, Vec2::ZERO, 0.0f, false});
     }
 
+    int childParentIndex = -1;
     for (auto&& child : node->getChildren())
-        afterSimulation(child, nodeToWorldTransform, nodeRotation);
+        gatherBodySyncs(child, nodeToWorldTransform, nodeRotation, childParentIndex);
+}
+
+void PhysicsWorld::setSolverThreads(int threads)
+{
+#    if AX_TARGET_PLATFORM != AX_PLATFORM_WIN32
+    cpHastySpaceSetThreads(_cpSpace, static_cast<unsigned long>((std::max)(threads, 0)));
+#    endif
+}
+
+int PhysicsWorld::getSolverThreads() const
+{
+#    if AX_TARGET_PLATFORM == AX_PLATFORM_WIN32
+    return 1;
+#    else
+    return static_cast<int>(cpHastySpaceGetThreads(_cpSpace));
+#    endif
 }
 
 void PhysicsWorld::setPostUpdateCallback(const std::function<void()>& callback)
@@ -31,7 +31,9 @@
 #if defined(AX_ENABLE_PHYSICS)
 
 #    include <list>
+#    include <span>
 #    include "base/Vector.h"
+#    include "base/FixedTimestep.h"
 #    include "math/Math.h"
 #    include "physics/PhysicsBody.h"
 
@@ -86,6 +88,13 @@ typedef std::function<bool(PhysicsWorld& world, const PhysicsRayCastInfo& info,
 typedef std::function<bool(PhysicsWorld&, PhysicsShape&, void*)> PhysicsQueryRectCallbackFunc;
 typedef PhysicsQueryRectCallbackFunc PhysicsQueryPointCallbackFunc;
 
+/** A line segment of a batched ray cast. */
+struct PhysicsRaySegment
+{
+    Vec2 start;
+    Vec2 end;
+};
+
 /**
  * @addtogroup physics
  * @{
@@ -192,6 +201,63 @@ public:
      */
     void queryPoint(PhysicsQueryPointCallbackFunc func, const Vec2& point, void* data);
 
+    /**
+     * Find the closest shape hit by each ray of a batch.
+     *
+     * The queries only read the broadphase, the bodies added or removed since the last step are flushed once for
+     * the batch. Sensors are ignored. With parallel set, the rays are spread over the JobSystem workers, the call
+     * returning once they are all done.
+     * @param   rays   The line segments to cast.
+     * @param   outHits   Receives the closest hit of each ray, its shape is nullptr when the ray hits nothing. Must
+     * be as large as rays, the rays beyond its size are not cast.
+     * @param   categoryBitmask   Only the shapes whose category bitmask matches it are hit.
+     * @param   parallel   Whether to cast the rays on the worker threads.
+     * @return The number of rays which hit a shape.
+     */
+    int rayCastBatch(std::span<const PhysicsRaySegment> rays,
+                     std::span<PhysicsRayCastInfo> outHits,
+                     int categoryBitmask = -1,
+                     bool parallel      = false);
+
+    /**
+     * Find the shapes whose bounding box overlaps each rect of a batch.
+     *
+     * outShapes is divided in as many slices as there are rects, the shapes found for a rect beyond the size of its
+     * slice are dropped.
+     * @param   rects   The rects to query.
+     * @param   outShapes   Receives the shapes found, the ones of rect i starting at i * outShapes.size() /
+     * rects.size().
+     * @param   outCounts   Receives the number of shapes written for each rect. Must be as large as rects, the rects
+     * beyond its size are not queried.
+     * @param   categoryBitmask   Only the shapes whose category bitmask matches it are found.
+     * @param   parallel   Whether to run the queries on the worker threads.
+     * @return The number of shapes written.
+     */
+    int queryRectBatch(std::span<const Rect> rects,
+                       std::span<PhysicsShape*> outShapes,
+                       std::span<int> outCounts,
+                       int categoryBitmask = -1,
+                       bool parallel      = false);
+
+    /**
+     * Find the shapes containing each point of a batch.
+     *
+     * outShapes is sliced the way queryRectBatch does.
+     * @param   points   The points to query.
+     * @param   outShapes   Receives the shapes found, the ones of point i starting at i * outShapes.size() /
+     * points.size().
+     * @param   outCounts   Receives the number of shapes written for each point. Must be as large as points, the
+     * points beyond its size are not queried.
+     * @param   categoryBitmask   Only the shapes whose category bitmask matches it are found.
+     * @param   parallel   Whether to run the queries on the worker threads.
+     * @return The number of shapes written.
+     */
+    int queryPointBatch(std::span<const Vec2> points,
+                        std::span<PhysicsShape*> outShapes,
+                        std::span<int> outCounts,
+                        int categoryBitmask = -1,
+                        bool parallel      = false);
+
     /**
      * Get physics shapes that contains the point.
      *
@@ -320,26 +386,66 @@ public:
      * 0 - disable fixed step system
      * default value is 0
      */
-    void setFixedUpdateRate(int updatesPerSecond)
-    {
-        if (updatesPerSecond > 0)
-        {
-            _fixedRate = updatesPerSecond;
-            for (auto body : _bodies)
-            {
-                body->setFixedUpdate(true);
-            }
-        }
-        else
-        {
-            for (auto body : _bodies)
-            {
-                body->setFixedUpdate(false);
-            }
-        }
-    }
-    /** get the number of substeps */
-    int getFixedUpdateRate() const { return _fixedRate; }
+    void setFixedUpdateRate(int updatesPerSecond);
+    /** get the number of fixed updates in a second */
+    int getFixedUpdateRate() const { return _fixedTimestep.getStepsPerSecond(); }
+
+    /**
+     * Set the maximum number of fixed updates run in a frame.
+     *
+     * A frame longer than this number of updates only runs that many, the rest of its time is dropped, so one slow
+     * frame doesn't make the next ones slower.
+     * @param steps An integer number, at least 1, default value is 5.
+     */
+    void setMaxFixedUpdateSteps(int steps) { _fixedTimestep.setMaxCatchUpSteps(steps); }
+    int getMaxFixedUpdateSteps() const { return _fixedTimestep.getMaxCatchUpSteps(); }
+
+    /**
+     * Set how the nodes are placed between two fixed updates.
+     *
+     * With a fixed update rate lower than the frame rate, the nodes move once every few frames. INTERPOLATE blends
+     * the last two updates, the nodes being one update behind the simulation, EXTRAPOLATE moves them along the body
+     * velocities. A node moved by the game while its body is smoothed is teleported, its body following it.
+     * @param smoothing The smoothing mode, default value is NONE.
+     */
+    void setFixedUpdateSmoothing(FixedTimestep::Smoothing smoothing) { _fixedTimestep.setSmoothing(smoothing); }
+    FixedTimestep::Smoothing getFixedUpdateSmoothing() const { return _fixedTimestep.getSmoothing(); }
+
+    /** The fixed step accumulator, to read the time left before the next update for instance. */
+    const FixedTimestep& getFixedTimestep() const { return _fixedTimestep; }
+
+    /**
+     * Set the number of threads running the constraint solver, the calling thread included.
+     *
+     * The solver iterations are shared among the threads of the Chipmunk cpHastySpace once a step has more than 50
+     * contacts and joints, which pays off with piles of bodies. Chipmunk caps the number at 2, and the result of a
+     * multithreaded step isn't deterministic. Windows builds always solve on the calling thread.
+     * @param threads An integer number, 0 picks the number of cores on Apple platforms and 1 elsewhere, default
+     * value is 0.
+     */
+    void setSolverThreads(int threads);
+
+    /**
+     * Get the number of threads running the constraint solver.
+     *
+     * @return An integer number.
+     */
+    int getSolverThreads() const;
+
+    /**
+     * Set the number of bodies from which their nodes get the simulated transforms on the JobSystem workers.
+     *
+     * The nodes are updated on the calling thread anyway, the workers compute their positions and rotations.
+     * @param bodies An integer number, 0 never uses the workers, default value is 256.
+     */
+    void setParallelSyncThreshold(int bodies) { _parallelSyncThreshold = bodies; }
+
+    /**
+     * Get the number of bodies from which the transforms sync uses the JobSystem workers.
+     *
+     * @return An integer number.
+     */
+    int getParallelSyncThreshold() const { return _parallelSyncThreshold; }
 
     /**
      * Set the debug draw mask of this physics world.
@@ -425,7 +531,7 @@ protected:
     int _updateRateCount;
     float _updateTime;
     int _substeps;
-    int _fixedRate;
+    FixedTimestep _fixedTimestep;
     cpSpace* _cpSpace;
 
     bool _updateBodyTransform;
@@ -447,6 +553,21 @@ protected:
     std::function<void()> _preUpdateCallback;
     std::function<void()> _postUpdateCallback;
 
+    // the nodes getting the transforms of their bodies after a step, gathered along the node tree
+    struct BodySync
+    {
+        PhysicsBody* body;
+        int parent;  // index in _syncParentTransforms
+        float parentRotation;
+        Vec2 position;
+        float rotation;
+        bool moved;
+    };
+    std::vector<BodySync> _bodySyncs;
+    // the world to parent transforms, shared by the sibling bodies
+    std::vector<Mat4> _syncParentTransforms;
+    int _parallelSyncThreshold;
+
 protected:
     PhysicsWorld();
     virtual ~PhysicsWorld();
@@ -456,7 +577,13 @@ protected:
                           float nodeParentScaleX,
                           float nodeParentScaleY,
                           float parentRotation);
-    void afterSimulation(Node* node, const Mat4& parentToWorldTransform, float parentRotation);
+    void afterSimulation(Node* node,
+                         const Mat4& parentToWorldTransform,
+                         float parentRotation,
+                         const FixedTimestep* smoothing);
+    void gatherBodySyncs(Node* node, const Mat4& parentToWorldTransform, float parentRotation, int& parentIndex);
+    // runs fn over [0, count), on the workers when parallel
+    void runQueryBatch(size_t count, bool parallel, const std::function<void(size_t, size_t)>& fn);
 
     friend class Node;
     friend class Sprite;
@@ -28,6 +28,8 @@ THE SOFTWARE.
 #include "2d/Node.h"
 #include "2d/Scene.h"
 
+#include <algorithm>
+
 #if defined(AX_ENABLE_3D_PHYSICS)
 
 #    if (AX_ENABLE_BULLET_INTEGRATION)
@@ -75,7 +77,10 @@ void Physics3DComponent::setPhysics3DObject(Physics3DObject* physicsObj)
 }
 
 Physics3DComponent::Physics3DComponent()
-    : _physics3DObj(nullptr), _syncFlag(Physics3DComponent::PhysicsSyncFlag::NODE_AND_NODE)
+    : _physics3DObj(nullptr)
+    , _syncFlag(Physics3DComponent::PhysicsSyncFlag::NODE_AND_NODE)
+    , _hasPreviousTransform(false)
+    , _smoothed(false)
 {}
 
 void Physics3DComponent::setEnabled(bool b)
@@ -151,16 +156,75 @@ void Physics3DComponent::preSimulate()
 {
     if (((int)_syncFlag & (int)Physics3DComponent::PhysicsSyncFlag::NODE_TO_PHYSICS) && _physics3DObj && _owner)
     {
-        syncNodeToPhysics();
+        // a smoothed node isn't where its body is, the body only follows the node when the game moved it
+        auto nodeToWorld = _owner->getNodeToWorldTransform();
+        if (!_smoothed || !std::equal(std::begin(nodeToWorld.m), std::end(nodeToWorld.m), _smoothedNodeToWorld.m))
+        {
+            syncNodeToPhysics();
+            _hasPreviousTransform = false;
+        }
     }
 }
 
-void Physics3DComponent::postSimulate()
+void Physics3DComponent::postSimulate(const FixedTimestep* smoothing)
 {
     if (((int)_syncFlag & (int)Physics3DComponent::PhysicsSyncFlag::PHYSICS_TO_NODE) && _physics3DObj && _owner)
     {
-        syncPhysicsToNode();
+        if (smoothing && _physics3DObj->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY)
+        {
+            syncPhysicsToNode(getSmoothedTransform(*smoothing));
+            _smoothedNodeToWorld = _owner->getNodeToWorldTransform();
+            _smoothed            = true;
+        }
+        else
+        {
+            syncPhysicsToNode();
+            _smoothed             = false;
+            _hasPreviousTransform = false;
+        }
+    }
+}
+
+void Physics3DComponent::recordPreviousTransform()
+{
+    if (_physics3DObj && _physics3DObj->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY)
+    {
+        const auto& transform = static_cast<Physics3DRigidBody*>(_physics3DObj)->getRigidBody()->getWorldTransform();
+        _previousPosition     = convertbtVector3ToVec3(transform.getOrigin());
+        _previousRotation     = convertbtQuatToQuat(transform.getRotation());
+        _hasPreviousTransform = true;
+    }
+}
+
+Mat4 Physics3DComponent::getSmoothedTransform(const FixedTimestep& smoothing) const
+{
+    auto body             = static_cast<Physics3DRigidBody*>(_physics3DObj)->getRigidBody();
+    const auto& transform = body->getWorldTransform();
+    if (smoothing.getSmoothing() == FixedTimestep::Smoothing::INTERPOLATE)
+    {
+        if (!_hasPreviousTransform)
+            return convertbtTransformToMat4(transform);
+
+        const float alpha = smoothing.getAlpha();
+        Quaternion rotation;
+        Quaternion::slerp(_previousRotation, convertbtQuatToQuat(transform.getRotation()), alpha, &rotation);
+        auto position = _previousPosition.lerp(convertbtVector3ToVec3(transform.getOrigin()), alpha);
+
+        Mat4 mat;
+        Mat4::createRotation(rotation, &mat);
+        mat.m[12] = position.x;
+        mat.m[13] = position.y;
+        mat.m[14] = position.z;
+        return mat;
     }
+
+    if (!body->isActive() || body->isStaticOrKinematicObject())
+        return convertbtTransformToMat4(transform);
+
+    btTransform predicted;
+    btTransformUtil::integrateTransform(transform, body->getLinearVelocity(), body->getAngularVelocity(),
+                                        smoothing.getRemainder(), predicted);
+    return convertbtTransformToMat4(predicted);
 }
 
 void Physics3DComponent::setTransformInPhysics(const ax::Vec3& translateInPhysics,
@@ -180,6 +244,15 @@ void Physics3DComponent::setSyncFlag(PhysicsSyncFlag syncFlag)
 }
 
 void Physics3DComponent::syncPhysicsToNode()
+{
+    if (_physics3DObj->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY ||
+        _physics3DObj->getObjType() == Physics3DObject::PhysicsObjType::COLLIDER)
+    {
+        syncPhysicsToNode(_physics3DObj->getWorldTransform());
+    }
+}
+
+void Physics3DComponent::syncPhysicsToNode(const Mat4& physicsTransform)
 {
     if (_physics3DObj->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY ||
         _physics3DObj->getObjType() == Physics3DObject::PhysicsObjType::COLLIDER)
@@ -188,7 +261,7 @@ void Physics3DComponent::syncPhysicsToNode()
         if (_owner->getParent())
             parentMat = _owner->getParent()->getNodeToWorldTransform();
 
-        auto mat = parentMat.getInversed() * _physics3DObj->getWorldTransform();
+        auto mat = parentMat.getInversed() * physicsTransform;
         // remove scale, no scale support for physics
         float oneOverLen = 1.f / sqrtf(mat.m[0] * mat.m[0] + mat.m[1] * mat.m[1] + mat.m[2] * mat.m[2]);
         mat.m[0] *= oneOverLen;
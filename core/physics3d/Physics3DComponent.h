@@ -45,6 +45,7 @@ NS_AX_BEGIN
 
 class Physics3DObject;
 class Physics3DWorld;
+class FixedTimestep;
 
 /** @brief Physics3DComponent: A component with 3D physics, you can add a rigid body to it, and then add this component
  * to a node, the node will move and rotate with this rigid body */
@@ -131,13 +132,28 @@ public:
 protected:
     void preSimulate();
 
-    void postSimulate();
+    void postSimulate(const FixedTimestep* smoothing);
+
+    // the state the interpolation starts from, before the last step of a frame
+    void recordPreviousTransform();
+
+    void syncPhysicsToNode(const ax::Mat4& physicsTransform);
+
+    ax::Mat4 getSmoothedTransform(const FixedTimestep& smoothing) const;
 
     ax::Mat4 _transformInPhysics;  // transform in physics space
     ax::Mat4 _invTransformInPhysics;
 
     Physics3DObject* _physics3DObj;
     PhysicsSyncFlag _syncFlag;
+
+    // the rigid body transform before the last fixed step
+    ax::Vec3 _previousPosition;
+    ax::Quaternion _previousRotation;
+    bool _hasPreviousTransform;
+    // the node to world transform when the node was smoothed
+    ax::Mat4 _smoothedNodeToWorld;
+    bool _smoothed;
 };
 
 // end of 3d group
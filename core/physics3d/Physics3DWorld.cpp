@@ -26,6 +26,10 @@
 
 #include "physics3d/Physics3D.h"
 #include "renderer/Renderer.h"
+#include "base/Director.h"
+#include "base/JobSystem.h"
+
+#include <atomic>
 
 #if defined(AX_ENABLE_3D_PHYSICS)
 
@@ -33,10 +37,117 @@
 
 NS_AX_BEGIN
 
+namespace
+{
+// rays or boxes queried by a worker per chunk
+const size_t QUERIES_PER_CHUNK = 32;
+
+// the sub-stepping of btDiscreteDynamicsWorld::stepSimulation with the steps run by the caller, so the state before
+// the last one can be recorded. Like there, the kinematic velocities and the forces span all the steps of a frame.
+class FixedStepDynamicsWorld : public btDiscreteDynamicsWorld
+{
+public:
+    using btDiscreteDynamicsWorld::btDiscreteDynamicsWorld;
+
+    void beginSteps(btScalar duration)
+    {
+        saveKinematicState(duration);
+        applyGravity();
+    }
+
+    void step(btScalar interval)
+    {
+        internalSingleStepSimulation(interval);
+        synchronizeMotionStates();
+    }
+
+    void endSteps() { clearForces(); }
+};
+
+// the broadphase tree traversal stack of a thread, the one of btDbvtBroadphase is shared by all the ray tests
+thread_local btAlignedObjectArray<const btDbvtNode*> t_queryStack;
+
+// btSingleRayCallback of btCollisionWorld, which only reads the world
+struct BatchRayCallback : public btBroadphaseRayCallback
+{
+    btTransform rayFromTrans;
+    btTransform rayToTrans;
+    btCollisionWorld::RayResultCallback& resultCallback;
+
+    BatchRayCallback(const btVector3& rayFrom, const btVector3& rayTo, btCollisionWorld::RayResultCallback& result)
+        : resultCallback(result)
+    {
+        rayFromTrans.setIdentity();
+        rayFromTrans.setOrigin(rayFrom);
+        rayToTrans.setIdentity();
+        rayToTrans.setOrigin(rayTo);
+
+        btVector3 rayDir = (rayTo - rayFrom).normalized();
+        for (int i = 0; i < 3; ++i)
+        {
+            m_rayDirectionInverse[i] =
+                rayDir[i] == btScalar(0.0) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0) / rayDir[i];
+            m_signs[i]               = m_rayDirectionInverse[i] < 0.0;
+        }
+        m_lambda_max = rayDir.dot(rayTo - rayFrom);
+    }
+
+    bool process(const btBroadphaseProxy* proxy) override
+    {
+        if (resultCallback.m_closestHitFraction == btScalar(0.f))
+            return false;
+
+        auto collisionObject = static_cast<btCollisionObject*>(proxy->m_clientObject);
+        if (resultCallback.needsCollision(collisionObject->getBroadphaseHandle()))
+        {
+            btCollisionWorld::rayTestSingle(rayFromTrans, rayToTrans, collisionObject,
+                                            collisionObject->getCollisionShape(),
+                                            collisionObject->getWorldTransform(), resultCallback);
+        }
+        return true;
+    }
+};
+
+struct BatchRayTester : public btDbvt::ICollide
+{
+    btBroadphaseRayCallback& rayCallback;
+
+    explicit BatchRayTester(btBroadphaseRayCallback& callback) : rayCallback(callback) {}
+    void Process(const btDbvtNode* leaf) override { rayCallback.process(static_cast<btBroadphaseProxy*>(leaf->data)); }
+};
+
+struct BatchAABBTester : public btDbvt::ICollide
+{
+    Physics3DObject** objects;
+    int capacity;
+    int count;
+
+    BatchAABBTester(Physics3DObject** out, int size) : objects(out), capacity(size), count(0) {}
+    void Process(const btDbvtNode* leaf) override
+    {
+        auto proxy           = static_cast<btBroadphaseProxy*>(leaf->data);
+        auto collisionObject = static_cast<btCollisionObject*>(proxy->m_clientObject);
+        auto obj             = static_cast<Physics3DObject*>(collisionObject->getUserPointer());
+        if (obj && count < capacity)
+            objects[count++] = obj;
+    }
+};
+
+void runQueryBatch(size_t count, bool parallel, const std::function<void(size_t, size_t)>& fn)
+{
+    auto jobSystem = Director::getInstance()->getJobSystem();
+    if (parallel && count > QUERIES_PER_CHUNK && jobSystem->getWorkerCount() > 0)
+        jobSystem->parallel_for(0, count, QUERIES_PER_CHUNK, fn);
+    else
+        fn(0, count);
+}
+}  // namespace
+
 Physics3DWorld::Physics3DWorld()
     : _needCollisionChecking(false)
     , _collisionCheckingFlag(false)
     , _needGhostPairCallbackChecking(false)
+    , _fixedTimestep(60, 3)
     , _btPhyiscsWorld(nullptr)
     , _collisionConfiguration(nullptr)
     , _dispatcher(nullptr)
@@ -100,7 +211,7 @@ bool Physics3DWorld::init(Physics3DWorldDes* info)
     btGhostPairCallback* ghostCallback = new btGhostPairCallback();
     _ghostCallback                     = ghostCallback;
 
-    _btPhyiscsWorld = new btDiscreteDynamicsWorld(_dispatcher, _broadphase, _solver, _collisionConfiguration);
+    _btPhyiscsWorld = new FixedStepDynamicsWorld(_dispatcher, _broadphase, _solver, _collisionConfiguration);
     _btPhyiscsWorld->setGravity(convertVec3TobtVector3(info->gravity));
     if (info->isDebugDrawEnabled)
     {
@@ -265,11 +376,37 @@ void Physics3DWorld::stepSimulate(float dt)
         {
             it->preSimulate();
         }
-        _btPhyiscsWorld->stepSimulation(dt, 3);
+        if (_fixedTimestep.isEnabled())
+        {
+            // the steps are counted here rather than by bullet, to know the state before the last one
+            auto world      = static_cast<FixedStepDynamicsWorld*>(_btPhyiscsWorld);
+            const int steps = _fixedTimestep.advance(dt);
+            if (steps > 0)
+                world->beginSteps(_fixedTimestep.getStepInterval() * steps);
+            for (int i = 0; i < steps; ++i)
+            {
+                if (i == steps - 1 && _fixedTimestep.getSmoothing() == FixedTimestep::Smoothing::INTERPOLATE)
+                {
+                    for (auto&& it : _physicsComponents)
+                    {
+                        it->recordPreviousTransform();
+                    }
+                }
+                world->step(_fixedTimestep.getStepInterval());
+            }
+            world->endSteps();
+        }
+        else
+        {
+            // bullet's own 60 Hz sub-stepping, as before the fixed step accumulator
+            _btPhyiscsWorld->stepSimulation(dt, _fixedTimestep.getMaxCatchUpSteps());
+        }
         // sync dynamic node after simulation
+        const bool smoothing = _fixedTimestep.isEnabled() &&
+                               _fixedTimestep.getSmoothing() != FixedTimestep::Smoothing::NONE;
         for (auto&& it : _physicsComponents)
         {
-            it->postSimulate();
+            it->postSimulate(smoothing ? &_fixedTimestep : nullptr);
         }
         if (needCollisionChecking())
             collisionChecking();
@@ -305,6 +442,79 @@ bool Physics3DWorld::rayCast(const ax::Vec3& startPos,
     return false;
 }
 
+int Physics3DWorld::rayCastBatch(std::span<const RaySegment> rays, std::span<HitResult> outHits, bool parallel)
+{
+    AXASSERT(outHits.size() >= rays.size(), "outHits must be as large as rays");
+    // in release builds, the rays without a slot in outHits are skipped
+    rays = rays.first((std::min)(rays.size(), outHits.size()));
+
+    std::atomic<int> hits{0};
+    runQueryBatch(rays.size(), parallel, [&](size_t first, size_t last) {
+        int chunkHits = 0;
+        for (auto i = first; i < last; ++i)
+        {
+            auto btStart = convertVec3TobtVector3(rays[i].startPos);
+            auto btEnd   = convertVec3TobtVector3(rays[i].endPos);
+            btCollisionWorld::ClosestRayResultCallback btResult(btStart, btEnd);
+            BatchRayCallback rayCallback(btStart, btEnd, btResult);
+            BatchRayTester tester(rayCallback);
+            for (auto&& set : _broadphase->m_sets)
+            {
+                set.rayTestInternal(set.m_root, btStart, btEnd, rayCallback.m_rayDirectionInverse, rayCallback.m_signs,
+                                    rayCallback.m_lambda_max, btVector3(0, 0, 0), btVector3(0, 0, 0), t_queryStack,
+                                    tester);
+            }
+
+            auto& result = outHits[i];
+            if (btResult.hasHit())
+            {
+                result.hitObj      = getPhysicsObject(btResult.m_collisionObject);
+                result.hitPosition = convertbtVector3ToVec3(btResult.m_hitPointWorld);
+                result.hitNormal   = convertbtVector3ToVec3(btResult.m_hitNormalWorld);
+                ++chunkHits;
+            }
+            else
+            {
+                result.hitObj = nullptr;
+            }
+        }
+        hits += chunkHits;
+    });
+
+    return hits;
+}
+
+int Physics3DWorld::queryAABBBatch(std::span<const AABB> boxes,
+                                   std::span<Physics3DObject*> outObjects,
+                                   std::span<int> outCounts,
+                                   bool parallel)
+{
+    AXASSERT(outCounts.size() >= boxes.size(), "outCounts must be as large as boxes");
+    boxes = boxes.first((std::min)(boxes.size(), outCounts.size()));
+    if (boxes.empty())
+        return 0;
+
+    const int capacity = static_cast<int>(outObjects.size() / boxes.size());
+    std::atomic<int> found{0};
+    runQueryBatch(boxes.size(), parallel, [&](size_t first, size_t last) {
+        int chunkFound = 0;
+        for (auto i = first; i < last; ++i)
+        {
+            auto volume = btDbvtVolume::FromMM(convertVec3TobtVector3(boxes[i]._min),
+                                               convertVec3TobtVector3(boxes[i]._max));
+            BatchAABBTester tester(outObjects.data() + i * capacity, capacity);
+            for (auto&& set : _broadphase->m_sets)
+                set.collideTVNoStackAlloc(set.m_root, volume, t_queryStack, tester);
+
+            outCounts[i] = tester.count;
+            chunkFound += tester.count;
+        }
+        found += chunkFound;
+    });
+
+    return found;
+}
+
 bool Physics3DWorld::sweepShape(Physics3DShape* shape,
                                 const ax::Mat4& startTransform,
                                 const ax::Mat4& endTransform,
@@ -329,6 +539,10 @@ bool Physics3DWorld::sweepShape(Physics3DShape* shape,
 
 Physics3DObject* Physics3DWorld::getPhysicsObject(const btCollisionObject* btObj)
 {
+    // set by the rigid bodies and colliders
+    if (btObj->getUserPointer())
+        return static_cast<Physics3DObject*>(btObj->getUserPointer());
+
     for (auto&& it : _objects)
     {
         if (it->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY)
@@ -30,6 +30,10 @@
 #include "math/Math.h"
 #include "base/Object.h"
 #include "base/Config.h"
+#include "base/FixedTimestep.h"
+#include "3d/AABB.h"
+
+#include <span>
 
 #if defined(AX_ENABLE_3D_PHYSICS)
 
@@ -87,6 +91,13 @@ public:
         Physics3DObject* hitObj;
     };
 
+    /** A line segment of a batched ray cast. */
+    struct RaySegment
+    {
+        ax::Vec3 startPos;
+        ax::Vec3 endPos;
+    };
+
     /**
      * Creates a Physics3DWorld with Physics3DWorldDes.
      *
@@ -121,6 +132,33 @@ public:
     /** Simulate one frame. */
     void stepSimulate(float dt);
 
+    /**
+     * Set the number of fixed steps in a second, default value is 60.
+     * 0 leaves the stepping to bullet, at 60 Hz like before the fixed step settings, the nodes aren't smoothed.
+     */
+    void setFixedUpdateRate(int updatesPerSecond) { _fixedTimestep.setStepsPerSecond(updatesPerSecond); }
+
+    /** Get the number of fixed steps in a second. */
+    int getFixedUpdateRate() const { return _fixedTimestep.getStepsPerSecond(); }
+
+    /** Set the maximum number of fixed steps in a frame, the rest of a longer frame is dropped. Default value is 3. */
+    void setMaxFixedUpdateSteps(int steps) { _fixedTimestep.setMaxCatchUpSteps(steps); }
+
+    /** Get the maximum number of fixed steps in a frame. */
+    int getMaxFixedUpdateSteps() const { return _fixedTimestep.getMaxCatchUpSteps(); }
+
+    /**
+     * Set how the nodes following a rigid body are placed between two fixed steps, default value is NONE.
+     * A smoothed node moved by the game teleports its rigid body.
+     */
+    void setFixedUpdateSmoothing(FixedTimestep::Smoothing smoothing) { _fixedTimestep.setSmoothing(smoothing); }
+
+    /** Get how the nodes are placed between two fixed steps. */
+    FixedTimestep::Smoothing getFixedUpdateSmoothing() const { return _fixedTimestep.getSmoothing(); }
+
+    /** Get the fixed step accumulator. */
+    const FixedTimestep& getFixedTimestep() const { return _fixedTimestep; }
+
     /** Enable or disable debug drawing. */
     void setDebugDrawEnable(bool enableDebugDraw);
 
@@ -141,6 +179,33 @@ public:
      */
     bool rayCast(const ax::Vec3& startPos, const ax::Vec3& endPos, HitResult* result);
 
+    /**
+     * Ray cast a batch of segments, without going through the shared ray stack of the broadphase so the rays can be
+     * spread over the JobSystem workers. The world must not be stepped or changed while the batch runs.
+     * @param rays The line segments to cast.
+     * @param outHits Receives the closest hit of each ray, its hitObj is nullptr when the ray hits nothing. Must be
+     * as large as rays, the rays beyond its size are not cast.
+     * @param parallel Whether to cast the rays on the worker threads.
+     * @return The number of rays which hit an object.
+     */
+    int rayCastBatch(std::span<const RaySegment> rays, std::span<HitResult> outHits, bool parallel = false);
+
+    /**
+     * Find the objects whose bounding box overlaps each box of a batch.
+     * outObjects is divided in as many slices as there are boxes, the objects found for a box beyond the size of its
+     * slice are dropped.
+     * @param boxes The boxes to query.
+     * @param outObjects Receives the objects found, the ones of box i starting at i * outObjects.size() / boxes.size().
+     * @param outCounts Receives the number of objects written for each box. Must be as large as boxes, the boxes
+     * beyond its size are not queried.
+     * @param parallel Whether to run the queries on the worker threads.
+     * @return The number of objects written.
+     */
+    int queryAABBBatch(std::span<const AABB> boxes,
+                       std::span<Physics3DObject*> outObjects,
+                       std::span<int> outCounts,
+                       bool parallel = false);
+
     /** Performs a swept shape cast on all objects in the Physics3DWorld. */
     bool sweepShape(Physics3DShape* shape,
                     const ax::Mat4& startTransform,
@@ -167,6 +232,7 @@ protected:
     bool _needCollisionChecking;
     bool _collisionCheckingFlag;
     bool _needGhostPairCallbackChecking;
+    FixedTimestep _fixedTimestep;
 
 #        if (AX_ENABLE_BULLET_INTEGRATION)
     btDynamicsWorld* _btPhyiscsWorld;
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "base/Director.h"
 #include "platform/SAXParser.h"
 #include "platform/FileStream.h"
+#include "mio/mio.hpp"
 
 #ifdef MINIZIP_FROM_SYSTEM
 #    include <minizip/unzip.h>
@@ -536,6 +537,7 @@ bool FileUtils::init()
 {
     DECLARE_GUARD;
     _searchPathArray.emplace_back(_defaultResRootPath);
+    updateSearchPathIndex();
     return true;
 }
 
@@ -578,6 +580,48 @@ void FileUtils::getDataFromFile(std::string_view filename, std::function<void(Da
         std::move(callback));
 }
 
+FileView FileUtils::getFileView(std::string_view filename) const
+{
+    // below this size, reading is cheaper than setting up a mapping
+    constexpr int64_t MAPPING_THRESHOLD = 64 * 1024;
+
+    if (filename.empty())
+        return {};
+
+    const auto fullPath = fullPathForFilename(filename);
+
+    FileStream fileStream;
+    fileStream.open(fullPath, IFileStream::Mode::READ);
+    if (!fileStream)
+        return {};
+
+    const auto size = fileStream.size();
+    if (size <= 0 || size > ULONG_MAX)
+        return {};
+
+    // only plain files have a native handle, the files inside the apk or an obb are read
+    if (size >= MAPPING_THRESHOLD && fileStream.nativeHandle() != (osfhnd_t)-1)
+    {
+        std::error_code error;
+        auto mapping = std::make_shared<mio::mmap_source>();
+        mapping->map(fileStream.nativeHandle(), 0, mio::map_entire_file, error);
+        if (!error)
+        {
+            auto bytes = reinterpret_cast<const uint8_t*>(mapping->data());
+            return FileView{std::move(mapping), bytes, static_cast<size_t>(size), true};
+        }
+    }
+
+    auto buffer = std::make_shared<axstd::byte_buffer>();
+    buffer->resize(static_cast<size_t>(size));
+    const auto sizeRead = fileStream.read(buffer->data(), (unsigned)size);
+    if (sizeRead < size)
+        return {};
+
+    auto bytes = buffer->data();
+    return FileView{std::move(buffer), bytes, static_cast<size_t>(size), false};
+}
+
 FileUtils::Status FileUtils::getContents(std::string_view filename, ResizableBuffer* buffer) const
 {
     if (filename.empty())
@@ -671,10 +715,8 @@ std::string FileUtils::fullPathForFilename(std::string_view filename) const
     }
 
     /*
-     * As we know, this function 'fullPathForFilename' will be calling when load any file, how to ensure this thread
-     * safe Step: a. call this function at main-thread always b. use the really fullPath to call
-     * getStringFromFile/getDataFromFile at sub-thread c. then this function will call again with really fullPath d.
-     * then isAbsolutePath avoid to access _fullPathCache _fullPathCache concurrent
+     * This function is called when loading any file, from any thread: the cache and the search path index are
+     * thread safe, and cache hits take no lock. Absolute paths skip the cache.
      */
     if (isAbsolutePath(filename))
     {
@@ -682,22 +724,22 @@ std::string FileUtils::fullPathForFilename(std::string_view filename) const
     }
 
     // Already Cached ?
-    auto cacheIter = _fullPathCache.find(filename);
-    if (cacheIter != _fullPathCache.end())
+    std::string fullpath;
+    auto generation = _fullPathCache.generation();
+    if (_fullPathCache.find(filename, fullpath))
     {
-        return cacheIter->second;
+        return fullpath;
     }
 
-    std::string fullpath;
-
-    for (const auto& searchIt : _searchPathArray)
+    auto searchPaths = getSearchPathIndex();
+    for (const auto& searchIt : *searchPaths)
     {
         fullpath = this->getPathForFilename(filename, searchIt);
 
         if (!fullpath.empty())
         {
             // Using the filename passed in as key.
-            _fullPathCache.emplace(filename, fullpath);
+            _fullPathCache.emplace(filename, fullpath, generation);
             return fullpath;
         }
     }
@@ -728,12 +770,8 @@ std::string FileUtils::fullPathForDirectory(std::string_view dir) const
     else
     {
         // Already Cached ?
-        auto cacheIter = _fullPathCacheDir.find(dir);
-        if (cacheIter != _fullPathCacheDir.end())
-        {
-            result = cacheIter->second;
-        }
-        else
+        auto generation = _fullPathCacheDir.generation();
+        if (!_fullPathCacheDir.find(dir, result))
         {
             std::string longdir{dir};
 
@@ -742,13 +780,14 @@ std::string FileUtils::fullPathForDirectory(std::string_view dir) const
                 longdir += "/";
             }
 
-            for (const auto& searchIt : _searchPathArray)
+            auto searchPaths = getSearchPathIndex();
+            for (const auto& searchIt : *searchPaths)
             {
                 auto fullpath = this->getPathForDirectory(longdir, searchIt);
                 if (!fullpath.empty() && isDirectoryExistInternal(fullpath))
                 {
                     // Using the filename passed in as key.
-                    _fullPathCacheDir.emplace(dir, fullpath);
+                    _fullPathCacheDir.emplace(dir, fullpath, generation);
                     result = fullpath;
                     break;
                 }
@@ -822,8 +861,6 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
     bool existDefaultRootPath = false;
     _originalSearchPaths      = searchPaths;
 
-    _fullPathCache.clear();
-    _fullPathCacheDir.clear();
     _searchPathArray.clear();
 
     for (const auto& path : _originalSearchPaths)
@@ -852,6 +889,11 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
         // AXLOG("Default root path doesn't exist, adding it.");
         _searchPathArray.emplace_back(_defaultResRootPath);
     }
+
+    // the index is published before the cache is cleared, lookups of the new cache generation see the new paths
+    updateSearchPathIndex();
+    _fullPathCache.clear();
+    _fullPathCacheDir.clear();
 }
 
 void FileUtils::addSearchPath(std::string_view searchpath, const bool front)
@@ -891,6 +933,29 @@ void FileUtils::addSearchPath(std::string_view searchpath, const bool front)
         _originalSearchPaths.emplace_back(std::string{searchpath});
         _searchPathArray.emplace_back(std::move(path));
     }
+
+    updateSearchPathIndex();
+}
+
+void FileUtils::updateSearchPathIndex()
+{
+    auto index = std::make_shared<std::vector<std::string>>();
+    index->reserve(_searchPathArray.size());
+    for (auto&& path : _searchPathArray)
+    {
+        // a path listed twice can't match on its second probe
+        if (std::find(index->begin(), index->end(), path) == index->end())
+            index->emplace_back(path);
+    }
+
+    std::lock_guard<std::mutex> lock(_searchPathIndexMutex);
+    _searchPathIndex = std::move(index);
+}
+
+std::shared_ptr<const std::vector<std::string>> FileUtils::getSearchPathIndex() const
+{
+    std::lock_guard<std::mutex> lock(_searchPathIndexMutex);
+    return _searchPathIndex;
 }
 
 std::string FileUtils::getFullPathForFilenameWithinDirectory(std::string_view directory,
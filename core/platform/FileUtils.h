@@ -35,6 +35,8 @@ THE SOFTWARE.
 #include <memory>
 
 #include "platform/IFileStream.h"
+#include "platform/FileView.h"
+#include "platform/FullPathCache.h"
 #include "platform/PlatformMacros.h"
 #include "base/Types.h"
 #include "base/Value.h"
@@ -167,6 +169,13 @@ public:
      */
     virtual void getDataFromFile(std::string_view filename, std::function<void(Data)> callback) const;
 
+    /**
+     *  Gets a read only view of a file, without the copy of getDataFromFile when the file can be memory-mapped.
+     *  Use it when the content is only parsed or decoded.
+     *  @return A view sharing the file content, null if the file can't be read.
+     */
+    virtual FileView getFileView(std::string_view filename) const;
+
     enum class Status
     {
         OK                 = 0,
@@ -758,10 +767,16 @@ public:
                                            std::function<void(std::vector<std::string>)> callback) const;
 
     /** Returns the full path cache. */
-    const hlookup::string_map<std::string> getFullPathCache() const { return _fullPathCache; }
+    const hlookup::string_map<std::string> getFullPathCache() const { return _fullPathCache.snapshot(); }
 
     /** Returns the full path cache. */
-    const hlookup::string_map<std::string> getFullPathCacheDir() const { return _fullPathCacheDir; }
+    const hlookup::string_map<std::string> getFullPathCacheDir() const { return _fullPathCacheDir.snapshot(); }
+
+    /** Returns the lookup and lock contention counters of the full path cache of files. */
+    FullPathCache::Stats getFullPathCacheStats() const { return _fullPathCache.getStats(); }
+
+    /** Returns the lookup and lock contention counters of the full path cache of directories. */
+    FullPathCache::Stats getFullPathCacheDirStats() const { return _fullPathCacheDir.getStats(); }
 
     /**
      *  Checks whether a file exists without considering search paths and resolution orders.
@@ -827,6 +842,16 @@ protected:
     virtual std::string getFullPathForFilenameWithinDirectory(std::string_view directory,
                                                               std::string_view filename) const;
 
+    /**
+     *  Rebuilds the search path index from _searchPathArray, call it after _searchPathArray changed.
+     */
+    void updateSearchPathIndex();
+
+    /**
+     *  Gets the search paths to probe, safe to use from any thread.
+     */
+    std::shared_ptr<const std::vector<std::string>> getSearchPathIndex() const;
+
     /**
      * mutex used to protect fields.
      */
@@ -838,6 +863,13 @@ protected:
      */
     std::vector<std::string> _searchPathArray;
 
+    /**
+     * The search paths probed by full path lookups: _searchPathArray without duplicates.
+     * It's replaced as a whole, lookups of other threads keep the one they started with.
+     */
+    std::shared_ptr<const std::vector<std::string>> _searchPathIndex = std::make_shared<std::vector<std::string>>();
+    mutable std::mutex _searchPathIndexMutex;
+
     /**
      * The search paths which was set by 'setSearchPaths' / 'addSearchPath'.
      */
@@ -856,13 +888,13 @@ protected:
      *  The full path cache for normal files. When a file is found, it will be added into this cache.
      *  This variable is used for improving the performance of file search.
      */
-    mutable hlookup::string_map<std::string> _fullPathCache;
+    mutable FullPathCache _fullPathCache;
 
     /**
      *  The full path cache for directories. When a diretory is found, it will be added into this cache.
      *  This variable is used for improving the performance of file search.
      */
-    mutable hlookup::string_map<std::string> _fullPathCacheDir;
+    mutable FullPathCache _fullPathCacheDir;
 
     /**
      * Writable path.
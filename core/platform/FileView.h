@@ -0,0 +1,67 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <span>
+#include "platform/PlatformMacros.h"
+
+NS_AX_BEGIN
+
+/**
+ * An immutable view of a file content, see FileUtils::getFileView.
+ *
+ * Large files are memory-mapped, the other files and the files inside packages are read to memory.
+ * Copies share the content, which is released with the last copy.
+ */
+class AX_DLL FileView
+{
+public:
+    FileView() = default;
+    FileView(std::shared_ptr<const void> holder, const uint8_t* data, size_t size, bool mapped)
+        : _holder(std::move(holder)), _data(data), _size(size), _mapped(mapped)
+    {}
+
+    const uint8_t* data() const { return _data; }
+    size_t size() const { return _size; }
+    std::span<const uint8_t> span() const { return {_data, _size}; }
+
+    /** Whether the view is empty, the file couldn't be read or has no content. */
+    bool isNull() const { return _size == 0; }
+
+    /** Whether the content is memory-mapped, pages are then loaded on first access. */
+    bool isMapped() const { return _mapped; }
+
+    void clear() { *this = FileView{}; }
+
+private:
+    std::shared_ptr<const void> _holder;
+    const uint8_t* _data = nullptr;
+    size_t _size         = 0;
+    bool _mapped         = false;
+};
+
+NS_AX_END
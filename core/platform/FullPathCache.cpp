@@ -0,0 +1,147 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/FullPathCache.h"
+
+NS_AX_BEGIN
+
+namespace
+{
+// generations are unique in the process, so a thread local map can't be mistaken for another cache's
+std::atomic<uint64_t> s_generations{0};
+
+struct LocalCache
+{
+    uint64_t generation = 0;
+    hlookup::string_map<std::string> map;
+};
+
+// the files and the directories caches, and room for a FileUtils being replaced
+constexpr size_t LOCAL_CACHE_SLOTS   = 4;
+constexpr size_t LOCAL_CACHE_ENTRIES = 4096;
+
+thread_local LocalCache t_localCaches[LOCAL_CACHE_SLOTS];
+thread_local size_t t_nextLocalCache = 0;
+
+LocalCache& localCacheFor(uint64_t generation)
+{
+    for (auto& cache : t_localCaches)
+    {
+        if (cache.generation == generation)
+            return cache;
+    }
+
+    auto& cache = t_localCaches[t_nextLocalCache];
+    t_nextLocalCache = (t_nextLocalCache + 1) % LOCAL_CACHE_SLOTS;
+    cache.generation = generation;
+    cache.map.clear();
+    return cache;
+}
+}  // namespace
+
+FullPathCache::FullPathCache() : _generation(++s_generations) {}
+
+bool FullPathCache::find(std::string_view key, std::string& value) const
+{
+    _lookups.fetch_add(1, std::memory_order_relaxed);
+
+    auto& local = localCacheFor(generation());
+    auto localIt = local.map.find(key);
+    if (localIt != local.map.end())
+    {
+        _localHits.fetch_add(1, std::memory_order_relaxed);
+        value = localIt->second;
+        return true;
+    }
+
+    auto& shard = shardFor(key);
+    if (!shard.mutex.try_lock_shared())
+    {
+        _contentions.fetch_add(1, std::memory_order_relaxed);
+        shard.mutex.lock_shared();
+    }
+    auto it    = shard.map.find(key);
+    bool found = it != shard.map.end();
+    if (found)
+        value = it->second;
+    shard.mutex.unlock_shared();
+
+    if (!found)
+        return false;
+
+    _sharedHits.fetch_add(1, std::memory_order_relaxed);
+    if (local.map.size() >= LOCAL_CACHE_ENTRIES)
+        local.map.clear();
+    local.map.emplace(key, value);
+    return true;
+}
+
+void FullPathCache::emplace(std::string_view key, std::string_view value, uint64_t generation)
+{
+    auto& shard = shardFor(key);
+    if (!shard.mutex.try_lock())
+    {
+        _contentions.fetch_add(1, std::memory_order_relaxed);
+        shard.mutex.lock();
+    }
+    // resolved before a clear, the search paths may have changed
+    if (_generation.load(std::memory_order_acquire) == generation)
+        shard.map.emplace(key, value);
+    shard.mutex.unlock();
+}
+
+void FullPathCache::clear()
+{
+    // the new generation is published while all shards are locked, so a reader of the new generation can't see
+    // entries of the old one
+    for (auto& shard : _shards)
+        shard.mutex.lock();
+
+    for (auto& shard : _shards)
+        shard.map.clear();
+    _generation.store(++s_generations, std::memory_order_release);
+
+    for (auto& shard : _shards)
+        shard.mutex.unlock();
+}
+
+hlookup::string_map<std::string> FullPathCache::snapshot() const
+{
+    hlookup::string_map<std::string> entries;
+    for (auto& shard : _shards)
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (auto&& entry : shard.map)
+            entries.emplace(entry.first, entry.second);
+    }
+    return entries;
+}
+
+FullPathCache::Stats FullPathCache::getStats() const
+{
+    return Stats{_lookups.load(std::memory_order_relaxed), _localHits.load(std::memory_order_relaxed),
+                 _sharedHits.load(std::memory_order_relaxed), _contentions.load(std::memory_order_relaxed)};
+}
+
+NS_AX_END
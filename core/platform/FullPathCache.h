@@ -0,0 +1,95 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <shared_mutex>
+#include <string>
+#include "base/hlookup.h"
+#include "platform/PlatformMacros.h"
+
+NS_AX_BEGIN
+
+/**
+ * The full path cache of FileUtils, safe to use from any thread.
+ *
+ * Entries are spread over shards, each guarded by a reader/writer lock. Every thread also keeps the entries it
+ * found in a thread local map, so repeated lookups of a thread take no lock at all.
+ * clear() starts a new generation: the thread local maps of older generations are dropped on their next lookup,
+ * and entries resolved against older search paths are not inserted.
+ */
+class AX_DLL FullPathCache
+{
+public:
+    struct Stats
+    {
+        uint64_t lookups;
+        uint64_t localHits;   // found in the thread local map, without lock
+        uint64_t sharedHits;  // found in a shard
+        uint64_t contentions; // a shard lock was busy
+    };
+
+    FullPathCache();
+
+    /** Gets the current generation, to pass to emplace when the value was resolved after this call. */
+    uint64_t generation() const { return _generation.load(std::memory_order_acquire); }
+
+    bool find(std::string_view key, std::string& value) const;
+
+    /** Inserts the entry unless the cache was cleared since generation. */
+    void emplace(std::string_view key, std::string_view value, uint64_t generation);
+
+    void clear();
+
+    /** Gets a copy of all entries. */
+    hlookup::string_map<std::string> snapshot() const;
+
+    Stats getStats() const;
+
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        hlookup::string_map<std::string> map;
+    };
+
+    Shard& shardFor(std::string_view key) const
+    {
+        return _shards[hlookup::string_hash{}(key) % SHARD_COUNT];
+    }
+
+    mutable std::array<Shard, SHARD_COUNT> _shards;
+    std::atomic<uint64_t> _generation;
+
+    mutable std::atomic<uint64_t> _lookups{0};
+    mutable std::atomic<uint64_t> _localHits{0};
+    mutable std::atomic<uint64_t> _sharedHits{0};
+    mutable std::atomic<uint64_t> _contentions{0};
+};
+
+NS_AX_END
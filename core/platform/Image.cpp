@@ -589,31 +589,28 @@ bool Image::initWithImageFile(std::string_view path)
     bool ret  = false;
     _filePath = FileUtils::getInstance()->fullPathForFilename(path);
 
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    // decoded straight from the file mapping, the data isn't owned so it's never modified
+    auto data = FileUtils::getInstance()->getFileView(_filePath);
 
     if (!data.isNull())
-    {
-        ssize_t n = 0;
-        auto buf  = data.takeBuffer(&n);
-        ret       = initWithImageData(buf, n, true);
-    }
+        ret = initWithImageData(const_cast<uint8_t*>(data.data()), static_cast<ssize_t>(data.size()), false);
 
     return ret;
 }
 
 bool Image::initWithImageFileThreadSafe(std::string_view fullpath)
+{
+    auto data = FileUtils::getInstance()->getFileView(fullpath);
+    return initWithImageDataThreadSafe(fullpath, data);
+}
+
+bool Image::initWithImageDataThreadSafe(std::string_view fullpath, const FileView& data)
 {
     bool ret  = false;
     _filePath = fullpath;
 
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
-
     if (!data.isNull())
-    {
-        ssize_t n = 0;
-        auto buf  = data.takeBuffer(&n);
-        ret       = initWithImageData(buf, n, true);
-    }
+        ret = initWithImageData(const_cast<uint8_t*>(data.data()), static_cast<ssize_t>(data.size()), false);
 
     return ret;
 }
@@ -2302,6 +2299,14 @@ void Image::forwardPixels(uint8_t* data, ssize_t dataLen, int offset, bool ownDa
         _dataLen = dataLen - offset;
         _data    = (uint8_t*)malloc(_dataLen);
         memcpy(_data, data + offset, _dataLen);
+
+        // the compressed mipmaps point into the caller's data, i.e. a file view released after decoding
+        for (int i = 0; i < _numberOfMipmaps; ++i)
+        {
+            auto& address = _mipmaps[i].address;
+            if (address >= data + offset && address < data + dataLen)
+                address = _data + (address - (data + offset));
+        }
     }
 }
 
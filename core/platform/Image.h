@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/Object.h"
 #include "renderer/Texture2D.h"
 #include "base/Data.h"
+#include "platform/FileView.h"
 
 #if AX_TARGET_PLATFORM == AX_PLATFORM_WINRT
 #    define AX_USE_WIC 1
@@ -260,6 +261,14 @@ protected:
      */
     bool initWithImageFileThreadSafe(std::string_view fullpath);
 
+    /*
+     @brief Decodes file content read by another thread, the decode stage of TextureCache::addImageAsync.
+     @param fullpath  full path of the file the data was read from.
+     @param data  the file content, it's only read.
+     @return  true if loaded correctly.
+     */
+    bool initWithImageDataThreadSafe(std::string_view fullpath, const FileView& data);
+
     Format detectFormat(const uint8_t* data, ssize_t dataLen);
     bool isPng(const uint8_t* data, ssize_t dataLen);
     bool isJpg(const uint8_t* data, ssize_t dataLen);
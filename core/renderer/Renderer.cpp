@@ -36,6 +36,7 @@
 #include "renderer/Technique.h"
 #include "renderer/Pass.h"
 #include "renderer/Texture2D.h"
+#include "renderer/UploadQueue.h"
 
 #include "base/Configuration.h"
 #include "base/Director.h"
@@ -107,15 +108,100 @@ ssize_t RenderQueue::size() const
     return result;
 }
 
+// maps a float to an unsigned key with the same ordering
+static inline uint32_t floatToSortKey(float value)
+{
+    // -0.0 compares equal to +0.0, it keeps its submit order like in the comparison sort
+    if (value == 0.0f)
+        value = 0.0f;
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits ^ ((bits & 0x80000000u) ? 0xffffffffu : 0x80000000u);
+}
+
+// below this size a comparison sort beats the radix histograms
+static const size_t RADIX_SORT_THRESHOLD = 64;
+
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]),
-                     std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]),
-                     compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]),
-                     compareRenderCommand);
+    sortByKey(_commands[QUEUE_GROUP::TRANSPARENT_3D], true);
+    sortByKey(_commands[QUEUE_GROUP::GLOBALZ_NEG], false);
+    sortByKey(_commands[QUEUE_GROUP::GLOBALZ_POS], false);
+}
+
+void RenderQueue::sortByKey(std::vector<RenderCommand*>& commands, bool byDepth)
+{
+    const auto count = commands.size();
+    if (count < 2)
+        return;
+
+    // build the keys, the transparent 3D queue is drawn back to front so its key is the inverted depth
+    _sortEntries.resize(count);
+    auto entries = _sortEntries.data();
+    bool ordered = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto command = commands[i];
+        auto key     = byDepth ? ~floatToSortKey(command->getDepth()) : floatToSortKey(command->getGlobalOrder());
+        entries[i] = {key, command};
+        if (i && key < entries[i - 1].key)
+            ordered = false;
+    }
+
+    // most frames submit commands already in order
+    if (ordered)
+        return;
+
+    if (count < RADIX_SORT_THRESHOLD)
+    {
+        if (byDepth)
+            std::stable_sort(commands.begin(), commands.end(), compare3DCommand);
+        else
+            std::stable_sort(commands.begin(), commands.end(), compareRenderCommand);
+        return;
+    }
+
+    // stable LSD radix sort, 4 passes of 8 bits, all histograms are built in one sweep
+    uint32_t histograms[4][256] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto key = entries[i].key;
+        ++histograms[0][key & 0xff];
+        ++histograms[1][(key >> 8) & 0xff];
+        ++histograms[2][(key >> 16) & 0xff];
+        ++histograms[3][key >> 24];
+    }
+
+    _sortScratch.resize(count);
+    auto src = entries;
+    auto dst = _sortScratch.data();
+    for (int pass = 0; pass < 4; ++pass)
+    {
+        auto histogram   = histograms[pass];
+        const auto shift = pass * 8;
+
+        // skip the pass when every key has the same digit, i.e. the high bytes of small z orders
+        if (histogram[(src[0].key >> shift) & 0xff] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (int digit = 0; digit < 256; ++digit)
+        {
+            auto n           = histogram[digit];
+            histogram[digit] = offset;
+            offset += n;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+            dst[histogram[(src[i].key >> shift) & 0xff]++] = src[i];
+
+        std::swap(src, dst);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        commands[i] = src[i].command;
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -151,11 +237,23 @@ void RenderQueue::realloc(size_t reserveSize)
     }
 }
 
+void RenderQueue::append(const RenderQueue& other)
+{
+    for (int i = 0; i < QUEUE_GROUP::QUEUE_COUNT; ++i)
+    {
+        auto& src = other._commands[i];
+        if (!src.empty())
+            _commands[i].insert(_commands[i].end(), src.begin(), src.end());
+    }
+}
+
 //
 //
 //
 static const int DEFAULT_RENDER_QUEUE = 0;
 
+static thread_local RenderQueue* s_threadRecordingQueue = nullptr;
+
 //
 // constructors, destructor, init
 //
@@ -202,6 +300,12 @@ void Renderer::init()
     _vertexBuffer = _triangleCommandBufferManager.getVertexBuffer();
     _indexBuffer  = _triangleCommandBufferManager.getIndexBuffer();
 
+    // write batched triangles straight into GPU-visible memory when the backend can map it
+    _streamTriangles = _vertexBuffer->mapStreaming() && _indexBuffer->mapStreaming();
+#ifdef AX_USE_METAL
+    AXASSERT(_streamTriangles, "Metal dynamic buffers should always be mappable");
+#endif
+
     auto driver    = backend::DriverBase::getInstance();
     _commandBuffer = driver->newCommandBuffer();
     // @MTL: the depth stencil flags must same render target and _dsDesc
@@ -231,6 +335,13 @@ void Renderer::addCallbackCommand(std::function<void()> func, float globalZOrder
 
 void Renderer::addCommand(RenderCommand* command)
 {
+    if (auto recordingQueue = s_threadRecordingQueue)
+    {
+        AXASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
+        recordingQueue->emplace_back(command);
+        return;
+    }
+
     int renderQueueID = _commandGroupStack.top();
     addCommand(command, renderQueueID);
 }
@@ -246,6 +357,7 @@ void Renderer::addCommand(RenderCommand* command, int renderQueueID)
 
 GroupCommand* Renderer::getNextGroupCommand()
 {
+    AXASSERT(!s_threadRecordingQueue, "Group commands pool isn't thread safe");
     if (_groupCommandPool.empty())
     {
         return new GroupCommand();
@@ -261,6 +373,7 @@ GroupCommand* Renderer::getNextGroupCommand()
 void Renderer::pushGroup(int renderQueueID)
 {
     AXASSERT(!_isRendering, "Cannot change render queue while rendering");
+    AXASSERT(!s_threadRecordingQueue, "Cannot push render group while recording concurrently");
     _commandGroupStack.push(renderQueueID);
 }
 
@@ -272,11 +385,44 @@ void Renderer::popGroup()
 
 int Renderer::createRenderQueue()
 {
+    AXASSERT(!s_threadRecordingQueue, "Cannot create render queue while recording concurrently");
     RenderQueue newRenderQueue;
     _renderGroups.emplace_back(newRenderQueue);
     return (int)_renderGroups.size() - 1;
 }
 
+std::span<RenderQueue> Renderer::beginConcurrentRecording(size_t count)
+{
+    AXASSERT(!_isRendering, "Cannot record commands while rendering");
+    AXASSERT(_recordingQueueCount == 0, "Concurrent recording can't be nested");
+
+    if (_recordingQueues.size() < count)
+        _recordingQueues.resize(count);
+    for (size_t i = 0; i < count; ++i)
+        _recordingQueues[i].clear();
+    _recordingQueueCount = count;
+
+    return std::span<RenderQueue>{_recordingQueues.data(), count};
+}
+
+void Renderer::endConcurrentRecording()
+{
+    auto& currentQueue = _renderGroups[_commandGroupStack.top()];
+    for (size_t i = 0; i < _recordingQueueCount; ++i)
+        currentQueue.append(_recordingQueues[i]);
+    _recordingQueueCount = 0;
+}
+
+void Renderer::setThreadRecordingQueue(RenderQueue* queue)
+{
+    s_threadRecordingQueue = queue;
+}
+
+RenderQueue* Renderer::getThreadRecordingQueue()
+{
+    return s_threadRecordingQueue;
+}
+
 void Renderer::processGroupCommand(GroupCommand* command)
 {
     flush();
@@ -315,20 +461,19 @@ void Renderer::processRenderCommand(RenderCommand* command)
             drawBatchedTriangles();
 
             _queuedTotalIndexCount = _queuedTotalVertexCount = 0;
-#ifdef AX_USE_METAL
-            _queuedIndexCount = _queuedVertexCount = 0;
-            _triangleCommandBufferManager.prepareNextBuffer();
-            _vertexBuffer = _triangleCommandBufferManager.getVertexBuffer();
-            _indexBuffer  = _triangleCommandBufferManager.getIndexBuffer();
-#endif
+            if (_streamTriangles)
+            {
+                _queuedIndexCount = _queuedVertexCount = 0;
+                _triangleCommandBufferManager.prepareNextBuffer();
+                _vertexBuffer = _triangleCommandBufferManager.getVertexBuffer();
+                _indexBuffer  = _triangleCommandBufferManager.getIndexBuffer();
+            }
         }
 
         // queue it
         _queuedTriangleCommands.emplace_back(cmd);
-#ifdef AX_USE_METAL
         _queuedIndexCount += cmd->getIndexCount();
         _queuedVertexCount += cmd->getVertexCount();
-#endif
         _queuedTotalVertexCount += cmd->getVertexCount();
         _queuedTotalIndexCount += cmd->getIndexCount();
     }
@@ -403,6 +548,9 @@ void Renderer::render()
 {
     // TODO: setup camera or MVP
     _isRendering = true;
+
+    // uploads the content this frame draws with
+    Director::getInstance()->getUploadQueue()->updateFrame();
     //    if (_glViewAssigned)
     {
         // Process render commands
@@ -426,11 +574,12 @@ void Renderer::endFrame()
 {
     _commandBuffer->endFrame();
 
-#ifdef AX_USE_METAL
-    _triangleCommandBufferManager.putbackAllBuffers();
-    _vertexBuffer = _triangleCommandBufferManager.getVertexBuffer();
-    _indexBuffer  = _triangleCommandBufferManager.getIndexBuffer();
-#endif
+    if (_streamTriangles)
+    {
+        _triangleCommandBufferManager.putbackAllBuffers();
+        _vertexBuffer = _triangleCommandBufferManager.getVertexBuffer();
+        _indexBuffer  = _triangleCommandBufferManager.getIndexBuffer();
+    }
     _queuedTotalIndexCount  = 0;
     _queuedTotalVertexCount = 0;
 }
@@ -598,42 +747,182 @@ void Renderer::setViewPort(int x, int y, unsigned int w, unsigned int h)
 }
 
 void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset)
+{
+    const auto vertexStart = _filledVertex;
+    // fill vertex, and convert them to world coordinates
+    fillVertices(cmd);
+    fillIndices(cmd, vertexBufferOffset, vertexStart);
+}
+
+void Renderer::fillVertices(const TrianglesCommand* cmd)
 {
     size_t vertexCount = cmd->getVertexCount();
-    memcpy(&_verts[_filledVertex], cmd->getVertices(), sizeof(V3F_C4B_T2F) * vertexCount);
+    auto out           = _vertexOut + _filledVertex;
 
-    // fill vertex, and convert them to world coordinates
-    const Mat4& modelView = cmd->getModelView();
-    for (size_t i = 0; i < vertexCount; ++i)
+    if (auto writer = cmd->getVertexWriter())
+    {
+        writer(*cmd, out);
+    }
+    else
     {
-        modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
+        // transform on a local copy, the output may be write-combined memory
+        const V3F_C4B_T2F* vertices = cmd->getVertices();
+        const Mat4& modelView       = cmd->getModelView();
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            V3F_C4B_T2F vertex = vertices[i];
+            modelView.transformPoint(&vertex.vertices);
+            out[i] = vertex;
+        }
     }
 
-    // fill index
+    _filledVertex += vertexCount;
+}
+
+void Renderer::fillIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset, unsigned int vertexStart)
+{
     const unsigned short* indices = cmd->getIndices();
     size_t indexCount             = cmd->getIndexCount();
     for (size_t i = 0; i < indexCount; ++i)
     {
-        _indices[_filledIndex + i] = vertexBufferOffset + _filledVertex + indices[i];
+        _indexOut[_filledIndex + i] = vertexBufferOffset + vertexStart + indices[i];
     }
 
-    _filledVertex += vertexCount;
     _filledIndex += indexCount;
 }
 
+size_t Renderer::reorderQueuedTriangles()
+{
+    // How many batches back a command may travel, keeps the pass linear
+    static const int MAX_LOOKBACK = 16;
+
+    _reorderItems.clear();
+    _reorderBatches.clear();
+
+    size_t batchesBefore    = 0;
+    uint32_t prevMaterialID = 0;
+
+    for (auto cmd : _queuedTriangleCommands)
+    {
+        const auto vertexStart = _filledVertex;
+        fillVertices(cmd);
+
+        const auto materialID = cmd->getMaterialID();
+        const bool batchable  = !cmd->isSkipBatching();
+        if (!batchable || batchesBefore == 0 || materialID != prevMaterialID)
+            ++batchesBefore;
+        prevMaterialID = batchable ? materialID : 0;
+
+        // world bounds, only planar commands can prove they don't overlap after projection
+        bool planar = batchable && _filledVertex > vertexStart;
+        Vec2 min, max;
+        float z = 0.0f;
+        if (planar)
+        {
+            const auto& first = _verts[vertexStart].vertices;
+            min = max = Vec2(first.x, first.y);
+            z         = first.z;
+            for (auto i = vertexStart + 1; i < _filledVertex; ++i)
+            {
+                const auto& v = _verts[i].vertices;
+                if (v.z != z)
+                {
+                    planar = false;
+                    break;
+                }
+                min.x = std::min(min.x, v.x);
+                min.y = std::min(min.y, v.y);
+                max.x = std::max(max.x, v.x);
+                max.y = std::max(max.y, v.y);
+            }
+        }
+
+        const int itemIndex = (int)_reorderItems.size();
+        _reorderItems.push_back({cmd, vertexStart, -1});
+
+        // Walk back over the batches of this run. Joining a batch draws the command before every batch walked
+        // past, which is safe when they share its z plane and none of them overlaps it: the projection of a
+        // plane is injective, so disjoint world bounds can't cover the same pixel.
+        ReorderBatch* target = nullptr;
+        if (planar)
+        {
+            const float globalOrder = cmd->getGlobalOrder();
+            const int last          = (int)_reorderBatches.size() - 1;
+            for (int j = last; j >= 0 && last - j < MAX_LOOKBACK; --j)
+            {
+                auto& batch = _reorderBatches[j];
+                if (batch.barrier || batch.globalOrder != globalOrder || batch.z != z)
+                    break;
+                if (batch.materialID == materialID)
+                {
+                    target = &batch;
+                    break;
+                }
+                if (min.x < batch.max.x && batch.min.x < max.x && min.y < batch.max.y && batch.min.y < max.y)
+                    break;
+            }
+        }
+
+        if (target)
+        {
+            _reorderItems[target->tail].next = itemIndex;
+            target->tail                     = itemIndex;
+            target->min.x                    = std::min(target->min.x, min.x);
+            target->min.y                    = std::min(target->min.y, min.y);
+            target->max.x                    = std::max(target->max.x, max.x);
+            target->max.y                    = std::max(target->max.y, max.y);
+        }
+        else
+        {
+            _reorderBatches.push_back(
+                {materialID, cmd->getGlobalOrder(), z, min, max, itemIndex, itemIndex, !planar});
+        }
+    }
+
+    // write back the new order, remembering where each command's vertices were filled
+    _reorderVertexStarts.clear();
+    size_t count        = 0;
+    size_t batchesAfter = 0;
+    prevMaterialID      = 0;
+    for (const auto& batch : _reorderBatches)
+    {
+        for (int i = batch.head; i != -1; i = _reorderItems[i].next)
+        {
+            auto cmd = _reorderItems[i].cmd;
+            _queuedTriangleCommands[count++] = cmd;
+            _reorderVertexStarts.push_back(_reorderItems[i].vertexStart);
+
+            const bool batchable = !cmd->isSkipBatching();
+            if (!batchable || batchesAfter == 0 || cmd->getMaterialID() != prevMaterialID)
+                ++batchesAfter;
+            prevMaterialID = batchable ? cmd->getMaterialID() : 0;
+        }
+    }
+    AXASSERT(count == _queuedTriangleCommands.size(), "reordered command count mismatch");
+
+    return batchesBefore > batchesAfter ? batchesBefore - batchesAfter : 0;
+}
+
 void Renderer::drawBatchedTriangles()
 {
     if (_queuedTriangleCommands.empty())
         return;
 
-        /************** 1: Setup up vertices/indices *************/
-#ifdef AX_USE_METAL
-    unsigned int vertexBufferFillOffset = _queuedTotalVertexCount - _queuedVertexCount;
-    unsigned int indexBufferFillOffset  = _queuedTotalIndexCount - _queuedIndexCount;
-#else
+    /************** 1: Setup up vertices/indices *************/
+    // when streaming, batches of the frame are appended after each other and written in place
     unsigned int vertexBufferFillOffset = 0;
     unsigned int indexBufferFillOffset  = 0;
-#endif
+    V3F_C4B_T2F* streamVertices         = nullptr;
+    unsigned short* streamIndices       = nullptr;
+    if (_streamTriangles)
+    {
+        vertexBufferFillOffset = _queuedTotalVertexCount - _queuedVertexCount;
+        indexBufferFillOffset  = _queuedTotalIndexCount - _queuedIndexCount;
+        streamVertices = static_cast<V3F_C4B_T2F*>(_vertexBuffer->mapStreaming()) + vertexBufferFillOffset;
+        streamIndices  = static_cast<unsigned short*>(_indexBuffer->mapStreaming()) + indexBufferFillOffset;
+    }
+    _vertexOut = streamVertices ? streamVertices : _verts;
+    _indexOut  = streamIndices ? streamIndices : _indices;
 
     _triBatchesToDraw[0].offset        = indexBufferFillOffset;
     _triBatchesToDraw[0].indicesToDraw = 0;
@@ -646,12 +935,26 @@ void Renderer::drawBatchedTriangles()
     _filledVertex = 0;
     _filledIndex  = 0;
 
-    for (const auto& cmd : _queuedTriangleCommands)
+    const bool reordered = _batchReorderEnabled && _queuedTriangleCommands.size() > 2;
+    if (reordered)
     {
+        // bounds are read back from the filled vertices, stage them in system memory
+        _vertexOut = _verts;
+        _savedBatches += reorderQueuedTriangles();
+        if (streamVertices)
+            memcpy(streamVertices, _verts, _filledVertex * sizeof(_verts[0]));
+    }
+
+    for (size_t cmdIndex = 0, cmdCount = _queuedTriangleCommands.size(); cmdIndex < cmdCount; ++cmdIndex)
+    {
+        auto cmd               = _queuedTriangleCommands[cmdIndex];
         auto currentMaterialID = cmd->getMaterialID();
         const bool batchable   = !cmd->isSkipBatching();
 
-        fillVerticesAndIndices(cmd, vertexBufferFillOffset);
+        if (reordered)
+            fillIndices(cmd, vertexBufferFillOffset, _reorderVertexStarts[cmdIndex]);
+        else
+            fillVerticesAndIndices(cmd, vertexBufferFillOffset);
 
         // in the same batch ?
         if (batchable && (prevMaterialID == currentMaterialID || firstCommand))
@@ -691,14 +994,17 @@ void Renderer::drawBatchedTriangles()
         firstCommand   = false;
     }
     batchesTotal++;
-#ifdef AX_USE_METAL
-    _vertexBuffer->updateSubData(_verts, vertexBufferFillOffset * sizeof(_verts[0]), _filledVertex * sizeof(_verts[0]));
-    _indexBuffer->updateSubData(_indices, indexBufferFillOffset * sizeof(_indices[0]),
-                                _filledIndex * sizeof(_indices[0]));
-#else
-    _vertexBuffer->updateData(_verts, _filledVertex * sizeof(_verts[0]));
-    _indexBuffer->updateData(_indices, _filledIndex * sizeof(_indices[0]));
-#endif
+    if (_streamTriangles)
+    {
+        _vertexBuffer->flushMappedRange(vertexBufferFillOffset * sizeof(_verts[0]), _filledVertex * sizeof(_verts[0]));
+        _indexBuffer->flushMappedRange(indexBufferFillOffset * sizeof(_indices[0]),
+                                       _filledIndex * sizeof(_indices[0]));
+    }
+    else
+    {
+        _vertexBuffer->updateData(_verts, _filledVertex * sizeof(_verts[0]));
+        _indexBuffer->updateData(_indices, _filledIndex * sizeof(_indices[0]));
+    }
 
     /************** 2: Draw *************/
     beginRenderPass();
@@ -724,10 +1030,8 @@ void Renderer::drawBatchedTriangles()
     /************** 3: Cleanup *************/
     _queuedTriangleCommands.clear();
 
-#ifdef AX_USE_METAL
     _queuedIndexCount  = 0;
     _queuedVertexCount = 0;
-#endif
 }
 
 void Renderer::drawCustomCommand(RenderCommand* command)
@@ -897,6 +1201,7 @@ void Renderer::clear(ClearFlag flags, const Color4F& color, float depth, unsigne
 
 CallbackCommand* Renderer::nextCallbackCommand()
 {
+    AXASSERT(!s_threadRecordingQueue, "Callback commands pool isn't thread safe");
     CallbackCommand* cmd = nullptr;
     if (!_callbackCommandsPool.empty())
     {
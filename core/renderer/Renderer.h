@@ -30,6 +30,7 @@
 #include <array>
 #include <deque>
 #include <optional>
+#include <span>
 
 #include "platform/PlatformMacros.h"
 #include "renderer/RenderCommand.h"
@@ -98,7 +99,8 @@ public:
     void emplace_back(RenderCommand* command);
     /**Return the number of render commands.*/
     ssize_t size() const;
-    /**Sort the render commands.*/
+    /**Sort the render commands, the globalZ queues by globalZOrder and the transparent 3D queue by depth.
+    Uses a stable radix sort on packed keys, queues which are already ordered are left untouched.*/
     void sort();
     /**Treat sorted commands as an array, access them one by one.*/
     RenderCommand* operator[](ssize_t index) const;
@@ -106,14 +108,27 @@ public:
     void clear();
     /**Realloc command queues and reserve with given size. Note: this clears any existing commands.*/
     void realloc(size_t reserveSize);
+    /**Append all commands of another queue, keeping their order in each sub group.*/
+    void append(const RenderQueue& other);
     /**Get a sub group of the render queue.*/
     std::vector<RenderCommand*>& getSubQueue(QUEUE_GROUP group) { return _commands[group]; }
     /**Get the number of render commands contained in a subqueue.*/
     ssize_t getSubQueueSize(QUEUE_GROUP group) const { return _commands[group].size(); }
 
 protected:
+    struct SortEntry
+    {
+        uint32_t key;
+        RenderCommand* command;
+    };
+
+    void sortByKey(std::vector<RenderCommand*>& commands, bool byDepth);
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+    /**Scratch buffers for the radix sort, reused across frames.*/
+    std::vector<SortEntry> _sortEntries;
+    std::vector<SortEntry> _sortScratch;
 
     /**Cull state.*/
     bool _isCullEnabled;
@@ -182,8 +197,20 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) TrianglesCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of draw calls saved by batch reordering in the last frame */
+    ssize_t getSavedBatches() const { return _savedBatches; }
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats() { _drawnBatches = _drawnVertices = _savedBatches = 0; }
+
+    /**
+     * Enable/disable material-aware reordering of queued TrianglesCommands.
+     * Within a run of equal global z order, a command may be moved back to join an earlier batch with the same
+     * material, but only past commands whose world bounds, lying in the same z plane, don't overlap its own.
+     * The rendered result is unchanged; the draw calls saved are reported by getSavedBatches().
+     * Disabled by default.
+     */
+    void setBatchReorderEnabled(bool enabled) { _batchReorderEnabled = enabled; }
+    bool isBatchReorderEnabled() const { return _batchReorderEnabled; }
 
     /**
      Set render targets. If not set, will use default render targets. It will effect all commands.
@@ -425,6 +452,30 @@ public:
 
     CallbackCommand* nextCallbackCommand();
 
+    /**
+     * Prepares private render queues for recording commands from several threads at once.
+     * The queues are cleared, bind one to each recording thread with `setThreadRecordingQueue`.
+     * @param count The number of queues needed.
+     * @see `Node::setConcurrentVisitEnabled`
+     */
+    std::span<RenderQueue> beginConcurrentRecording(size_t count);
+
+    /**
+     * Appends the private queues in index order into the current render queue.
+     * Since each queue holds the commands of a contiguous part of the scene graph, the merged
+     * result is identical to a serial visit once the render queue is sorted by globalZOrder.
+     */
+    void endConcurrentRecording();
+
+    /**
+     * Binds the calling thread to a private render queue, `addCommand` records into it
+     * instead of the current render group. Pass nullptr to unbind.
+     */
+    static void setThreadRecordingQueue(RenderQueue* queue);
+
+    /** Gets the private render queue bound to the calling thread, nullptr if not recording concurrently. */
+    static RenderQueue* getThreadRecordingQueue();
+
 protected:
     friend class Director;
     friend class GroupCommand;
@@ -432,6 +483,7 @@ protected:
     /**
      * Create and reuse vertex and index buffer for triangleCommand.
      * When queued vertex or index count exceed the limited value, a new vertex or index buffer will be created.
+     * Only used when streaming, the backend triple buffers each of them across frames.
      */
     class TriangleCommandBufferManager
     {
@@ -491,6 +543,11 @@ protected:
     void doVisitRenderQueue(const std::vector<RenderCommand*>&);
 
     void fillVerticesAndIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset);
+    void fillVertices(const TrianglesCommand* cmd);
+    void fillIndices(const TrianglesCommand* cmd, unsigned int vertexBufferOffset, unsigned int vertexStart);
+
+    /// Fills the vertices of all queued triangles and reorders them by material, returns the saved batches
+    size_t reorderQueuedTriangles();
 
     void pushStateBlock();
 
@@ -506,6 +563,10 @@ protected:
 
     std::vector<RenderQueue> _renderGroups;
 
+    // private queues for concurrent scene graph visit
+    std::vector<RenderQueue> _recordingQueues;
+    size_t _recordingQueueCount = 0;
+
     std::vector<TrianglesCommand*> _queuedTriangleCommands;
 
     // the pool for callback commands
@@ -516,6 +577,10 @@ protected:
     // for TrianglesCommand
     V3F_C4B_T2F _verts[VBO_SIZE];
     unsigned short _indices[INDEX_VBO_SIZE];
+    // where the current batch is written, the staging arrays above or the mapped buffers when streaming
+    V3F_C4B_T2F* _vertexOut   = _verts;
+    unsigned short* _indexOut = _indices;
+    bool _streamTriangles     = false;
     backend::Buffer* _vertexBuffer = nullptr;
     backend::Buffer* _indexBuffer  = nullptr;
     TriangleCommandBufferManager _triangleCommandBufferManager;
@@ -545,9 +610,33 @@ protected:
     unsigned int _filledIndex            = 0;
     unsigned int _filledVertex           = 0;
 
+    // for batch reordering
+    struct ReorderItem
+    {
+        TrianglesCommand* cmd;
+        unsigned int vertexStart;
+        int next;  // next item in the same batch, -1 for the tail
+    };
+    struct ReorderBatch
+    {
+        uint32_t materialID;
+        float globalOrder;
+        float z;
+        Vec2 min;
+        Vec2 max;
+        int head;
+        int tail;
+        bool barrier;  // unbatchable or non-planar, nothing may be moved past it
+    };
+    std::vector<ReorderItem> _reorderItems;
+    std::vector<ReorderBatch> _reorderBatches;
+    std::vector<unsigned int> _reorderVertexStarts;
+    bool _batchReorderEnabled = false;
+
     // stats
     size_t _drawnBatches  = 0;
     size_t _drawnVertices = 0;
+    size_t _savedBatches  = 0;
     // the flag for checking whether renderer is rendering
     bool _isRendering      = false;
     bool _isDepthTestFor2D = false;
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
 
 #include "renderer/Texture2D.h"
 #include "base/Macros.h"
@@ -42,6 +43,8 @@ THE SOFTWARE.
 #include "platform/FileUtils.h"
 #include "base/Utils.h"
 #include "base/NinePatchImageParser.h"
+#include "base/JobSystem.h"
+#include "renderer/UploadQueue.h"
 #include "renderer/backend/DriverBase.h"
 
 using namespace std;
@@ -82,41 +85,62 @@ std::string TextureCache::getDescription() const
 struct TextureCache::AsyncStruct
 {
 public:
-    AsyncStruct(std::string_view fn, const std::function<void(Texture2D*)>& f, std::string_view key)
+    AsyncStruct(std::string_view fn, const std::function<void(Texture2D*)>& f, std::string_view key, int prio)
         : filename(fn)
         , callback(f)
         , callbackKey(key)
         , pixelFormat(Texture2D::getDefaultAlphaPixelFormat())
         , loadSuccess(false)
+        , priority(prio)
+        , cancelled(false)
     {}
 
     std::string filename;
     std::function<void(Texture2D*)> callback;
     std::string callbackKey;
+    FileView data;
     Image image;
     Image imageAlpha;
     backend::PixelFormat pixelFormat;
     bool loadSuccess;
+    int priority;
+    std::atomic<bool> cancelled;
 };
 
+// keeps the queue sorted by decreasing priority, requests of the same priority stay in order
+template <typename _Ty>
+static void insertByPriority(std::deque<_Ty*>& queue, _Ty* asyncStruct)
+{
+    auto it = std::find_if(queue.begin(), queue.end(),
+                           [asyncStruct](const auto* other) { return other->priority < asyncStruct->priority; });
+    queue.insert(it, asyncStruct);
+}
+
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to
- _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL
- thread)
+ - get AsyncStruct from _requestQueue, read or map the file to AsyncStruct.data, then add AsyncStruct to _decodeQueue
+ (Load thread)
+ - get AsyncStruct from _decodeQueue, decode AsyncStruct.data to AsyncStruct.image, then add AsyncStruct to
+ _responseQueue (JobSystem workers)
+ - on schedule callback, move _responseQueue to the Director's UploadQueue, which converts images to textures
+ within the frame budget, then delete AsyncStruct (GL thread)
 
  the Critical Area include these members:
  - _requestQueue: locked by _requestMutex
+ - _decodeQueue, _decodeRunning: locked by _decodeMutex
  - _responseQueue: locked by _responseMutex
 
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - file data: new in Load thread, released in decode job
+ - image data: new in decode job, delete in GL thread(by Image instance)
 
  Note:
  - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - images are decoded in parallel and by priority, the callbacks may be invoked out of request order.
+ - the Load thread stops reading while the _decodeQueue holds twice the decode concurrency, so no more
+ than a few files are held in memory.
 
  How to deal add image many times?
  - At first, this situation is abnormal, we only ensure the logic is correct.
@@ -124,47 +148,15 @@ public:
  - If the image request is in queue already, there will be more than one request in queue,
  - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
 
- Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
-
  Call unbindImageAsync(path) to prevent the call to the callback when the
  texture is loaded.
  */
 void TextureCache::addImageAsync(std::string_view path, const std::function<void(Texture2D*)>& callback)
 {
-    addImageAsync(path, callback, path);
+    addImageAsync(path, callback, path, 0);
 }
 
 /**
- The addImageAsync logic follow the steps:
- - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to
- _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL
- thread)
-
- the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
- - _responseQueue: locked by _responseMutex
-
- the object's life time:
- - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
-
- Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
-
- How to deal add image many times?
- - At first, this situation is abnormal, we only ensure the logic is correct.
- - If the image has been loaded, the after load image call will return immediately.
- - If the image request is in queue already, there will be more than one request in queue,
- - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
-
- Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
-
  The callbackKey allows to unbind the callback in cases where the loading of
  path is requested by several sources simultaneously. Each source can then
  unbind the callback independently as needed whilst a call to
@@ -173,6 +165,14 @@ void TextureCache::addImageAsync(std::string_view path, const std::function<void
 void TextureCache::addImageAsync(std::string_view path,
                                  const std::function<void(Texture2D*)>& callback,
                                  std::string_view callbackKey)
+{
+    addImageAsync(path, callback, callbackKey, 0);
+}
+
+void TextureCache::addImageAsync(std::string_view path,
+                                 const std::function<void(Texture2D*)>& callback,
+                                 std::string_view callbackKey,
+                                 int priority)
 {
     Texture2D* texture = nullptr;
 
@@ -214,12 +214,12 @@ void TextureCache::addImageAsync(std::string_view path,
     ++_asyncRefCount;
 
     // generate async struct
-    AsyncStruct* data = new AsyncStruct(fullpath, callback, callbackKey);
+    AsyncStruct* data = new AsyncStruct(fullpath, callback, callbackKey, priority);
 
     // add async struct into queue
     _asyncStructQueue.emplace_back(data);
     std::unique_lock<std::mutex> ul(_requestMutex);
-    _requestQueue.emplace_back(data);
+    insertByPriority(_requestQueue, data);
     _sleepCondition.notify_one();
 }
 
@@ -234,7 +234,8 @@ void TextureCache::unbindImageAsync(std::string_view callbackKey)
     {
         if (asyncStruct->callbackKey == callbackKey)
         {
-            asyncStruct->callback = nullptr;
+            asyncStruct->callback  = nullptr;
+            asyncStruct->cancelled = true;
         }
     }
 }
@@ -247,10 +248,26 @@ void TextureCache::unbindAllImageAsync()
     }
     for (auto&& asyncStruct : _asyncStructQueue)
     {
-        asyncStruct->callback = nullptr;
+        asyncStruct->callback  = nullptr;
+        asyncStruct->cancelled = true;
     }
 }
 
+void TextureCache::setAsyncDecodeConcurrency(int concurrency)
+{
+    std::unique_lock<std::mutex> ul(_decodeMutex);
+    _asyncDecodeConcurrency.store(concurrency, std::memory_order_relaxed);
+}
+
+int TextureCache::getAsyncDecodeConcurrency() const
+{
+    const int concurrency = _asyncDecodeConcurrency.load(std::memory_order_relaxed);
+    if (concurrency > 0)
+        return concurrency;
+    // leave a worker to the other engine jobs
+    return (std::max)(1, Director::getInstance()->getJobSystem()->getWorkerCount() - 1);
+}
+
 void TextureCache::loadImage()
 {
     AsyncStruct* asyncStruct = nullptr;
@@ -279,104 +296,155 @@ void TextureCache::loadImage()
         }
         ul.unlock();
 
-        // load image
-        asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
+        // read file, the decoding is left to the JobSystem
+        if (!asyncStruct->cancelled)
+            asyncStruct->data = FileUtils::getInstance()->getFileView(asyncStruct->filename);
+
+        // push the asyncStruct to decode queue, waiting while the decoders are behind
+        std::unique_lock<std::mutex> dl(_decodeMutex);
+        const size_t maxPending = static_cast<size_t>(getAsyncDecodeConcurrency()) * 2;
+        _decodeCondition.wait(dl, [this, maxPending] { return _needQuit || _decodeQueue.size() < maxPending; });
+        if (_needQuit)
+            break;
+        insertByPriority(_decodeQueue, asyncStruct);
+        int launches = dispatchDecodes();
+        dl.unlock();
 
-        // ETC1 ALPHA supports.
-        if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC1 &&
-            !s_etc1AlphaFileSuffix.empty())
-        {  // check whether alpha texture exists & load it
-            auto alphaFile = asyncStruct->filename + s_etc1AlphaFileSuffix;
-            if (FileUtils::getInstance()->isFileExist(alphaFile))
-                asyncStruct->imageAlpha.initWithImageFileThreadSafe(alphaFile);
+        auto jobSystem = Director::getInstance()->getJobSystem();
+        for (; launches > 0; --launches)
+            jobSystem->enqueue([this] { decodeImage(); });
+    }
+}
+
+int TextureCache::dispatchDecodes()
+{
+    // called with _decodeMutex locked, returns how many decode jobs to enqueue
+    int launches = (std::min)(static_cast<int>(_decodeQueue.size()), getAsyncDecodeConcurrency() - _decodeRunning);
+    if (launches <= 0)
+        return 0;
+    _decodeRunning += launches;
+    return launches;
+}
+
+void TextureCache::decodeImage()
+{
+    std::unique_lock<std::mutex> dl(_decodeMutex);
+    while (!_decodeQueue.empty() && !_needQuit)
+    {
+        AsyncStruct* asyncStruct = _decodeQueue.front();
+        _decodeQueue.pop_front();
+        _decodeCondition.notify_all();
+        dl.unlock();
+
+        if (!asyncStruct->cancelled && !asyncStruct->data.isNull())
+        {
+            // decode image
+            asyncStruct->loadSuccess =
+                asyncStruct->image.initWithImageDataThreadSafe(asyncStruct->filename, asyncStruct->data);
+
+            // ETC1 ALPHA supports.
+            if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC1 &&
+                !s_etc1AlphaFileSuffix.empty())
+            {  // check whether alpha texture exists & load it
+                auto alphaFile = asyncStruct->filename + s_etc1AlphaFileSuffix;
+                if (FileUtils::getInstance()->isFileExist(alphaFile))
+                    asyncStruct->imageAlpha.initWithImageFileThreadSafe(alphaFile);
+            }
         }
+        asyncStruct->data.clear();
+
         // push the asyncStruct to response queue
         _responseMutex.lock();
         _responseQueue.emplace_back(asyncStruct);
         _responseMutex.unlock();
+
+        dl.lock();
     }
+    --_decodeRunning;
+    _decodeCondition.notify_all();
 }
 
 void TextureCache::addImageAsyncCallBack(float /*dt*/)
 {
-    Texture2D* texture       = nullptr;
-    AsyncStruct* asyncStruct = nullptr;
-    while (true)
+    // hand the decoded images to the upload queue, which creates the textures within the frame budget
+    _responseMutex.lock();
+    auto responses = std::move(_responseQueue);
+    _responseQueue.clear();
+    _responseMutex.unlock();
+
+    auto uploadQueue = Director::getInstance()->getUploadQueue();
+    for (auto asyncStruct : responses)
     {
-        // pop an AsyncStruct from response queue
-        _responseMutex.lock();
-        if (_responseQueue.empty())
-        {
-            asyncStruct = nullptr;
-        }
-        else
-        {
-            asyncStruct = _responseQueue.front();
-            _responseQueue.pop_front();
+        auto bytes = asyncStruct->loadSuccess && !asyncStruct->cancelled ? asyncStruct->image.getDataLen() : 0;
+        uploadQueue->enqueue(this, static_cast<size_t>(bytes),
+                             [this, asyncStruct] { completeImageAsync(asyncStruct); });
+    }
+}
 
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            AX_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
-        }
-        _responseMutex.unlock();
+void TextureCache::completeImageAsync(AsyncStruct* asyncStruct)
+{
+    Texture2D* texture = nullptr;
 
-        if (nullptr == asyncStruct)
-        {
-            break;
-        }
+    // decoded out of request order, so find it in _asyncStructQueue
+    auto found = std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct);
+    AX_ASSERT(found != _asyncStructQueue.end());
+    _asyncStructQueue.erase(found);
 
-        // check the image has been convert to texture or not
-        auto it = _textures.find(asyncStruct->filename);
-        if (it != _textures.end())
-        {
-            texture = it->second;
-        }
-        else
+    // check the image has been convert to texture or not
+    auto it = _textures.find(asyncStruct->filename);
+    if (it != _textures.end())
+    {
+        texture = it->second;
+    }
+    else if (asyncStruct->cancelled)
+    {
+        texture = nullptr;
+    }
+    else
+    {
+        // convert image to texture
+        if (asyncStruct->loadSuccess)
         {
-            // convert image to texture
-            if (asyncStruct->loadSuccess)
-            {
-                Image* image = &(asyncStruct->image);
-                // generate texture in render thread
-                texture = new Texture2D();
+            Image* image = &(asyncStruct->image);
+            // generate texture in render thread
+            texture = new Texture2D();
 
-                texture->initWithImage(image, asyncStruct->pixelFormat);
-                // parse 9-patch info
-                this->parseNinePatchImage(image, texture, asyncStruct->filename);
+            texture->initWithImage(image, asyncStruct->pixelFormat);
+            // parse 9-patch info
+            this->parseNinePatchImage(image, texture, asyncStruct->filename);
 #if AX_ENABLE_CACHE_TEXTURE_DATA
-                // cache the texture file name
-                VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
+            // cache the texture file name
+            VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
 #endif
-                // cache the texture. retain it, since it is added in the map
-                _textures.emplace(asyncStruct->filename, texture);
-                texture->retain();
+            // cache the texture. retain it, since it is added in the map
+            _textures.emplace(asyncStruct->filename, texture);
+            texture->retain();
 
-                texture->autorelease();
-                // ETC1 ALPHA supports.
-                if (asyncStruct->imageAlpha.getFileType() == Image::Format::ETC1)
-                {
-                    texture->updateWithImage(&asyncStruct->imageAlpha, asyncStruct->pixelFormat, 1);
-                }
-            }
-            else
+            texture->autorelease();
+            // ETC1 ALPHA supports.
+            if (asyncStruct->imageAlpha.getFileType() == Image::Format::ETC1)
             {
-                texture = nullptr;
-                AXLOG("axmol: failed to call TextureCache::addImageAsync(%s)", asyncStruct->filename.c_str());
+                texture->updateWithImage(&asyncStruct->imageAlpha, asyncStruct->pixelFormat, 1);
             }
         }
-
-        // call callback function
-        if (asyncStruct->callback)
+        else
         {
-            (asyncStruct->callback)(texture);
+            texture = nullptr;
+            AXLOG("axmol: failed to call TextureCache::addImageAsync(%s)", asyncStruct->filename.c_str());
         }
+    }
 
-        // release the asyncStruct
-        delete asyncStruct;
-        --_asyncRefCount;
+    // call callback function
+    if (asyncStruct->callback)
+    {
+        (asyncStruct->callback)(texture);
     }
 
-    if (0 == _asyncRefCount)
+    // release the asyncStruct
+    delete asyncStruct;
+
+    // the last pending image is uploaded, stop polling the responses
+    if (0 == --_asyncRefCount)
     {
         Director::getInstance()->getScheduler()->unschedule(AX_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack),
                                                             this);
@@ -747,8 +815,34 @@ void TextureCache::waitForQuit()
     _needQuit = true;
     _sleepCondition.notify_one();
     ul.unlock();
+
+    std::unique_lock<std::mutex> dl(_decodeMutex);
+    _decodeCondition.notify_all();
+    dl.unlock();
+
     if (_loadingThread)
         _loadingThread->join();
+
+    // wait for the decode jobs, they stop after their current image
+    dl.lock();
+    _decodeCondition.wait(dl, [this] { return _decodeRunning == 0; });
+    dl.unlock();
+
+    // drop the pending uploads, then the requests wherever they are, their callbacks aren't run while quitting
+    Director::getInstance()->getUploadQueue()->cancel(this);
+    for (auto asyncStruct : _asyncStructQueue)
+        delete asyncStruct;
+    _asyncStructQueue.clear();
+    _requestQueue.clear();
+    _decodeQueue.clear();
+    _responseQueue.clear();
+
+    if (_asyncRefCount > 0)
+    {
+        _asyncRefCount = 0;
+        Director::getInstance()->getScheduler()->unschedule(AX_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack),
+                                                            this);
+    }
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #ifndef __CCTEXTURE_CACHE_H__
 #define __CCTEXTURE_CACHE_H__
 
+#include <atomic>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
@@ -123,19 +124,34 @@ public:
                        const std::function<void(Texture2D*)>& callback,
                        std::string_view callbackKey);
 
+    /** Same as addImageAsync(path, callback, callbackKey), requests with a higher priority are read and decoded
+     * first. Requests of the same priority keep their order. The default priority is 0.
+     */
+    void addImageAsync(std::string_view path,
+                       const std::function<void(Texture2D*)>& callback,
+                       std::string_view callbackKey,
+                       int priority);
+
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is
      * invoked, the object always need to unbind this callback manually.
+     * The request is cancelled too: it is skipped if it wasn't read or decoded yet, and no texture is created.
      * @param filename It's the related/absolute path of the file image.
      * @since v3.1
      */
     virtual void unbindImageAsync(std::string_view filename);
 
-    /** Unbind all bound image asynchronous load callbacks.
+    /** Unbind all bound image asynchronous load callbacks, and cancel their requests.
      * @since v3.1
      */
     virtual void unbindAllImageAsync();
 
+    /** Sets how many images addImageAsync decodes in parallel on the JobSystem workers.
+     * @param concurrency The number of decoding jobs, 0 uses the worker count minus one, at least 1.
+     */
+    void setAsyncDecodeConcurrency(int concurrency);
+    int getAsyncDecodeConcurrency() const;
+
     /** Returns a Texture2D object given an Image.
      * If the image was not previously loaded, it will create a new Texture2D object and it will return it.
      * Otherwise it will return a reference of a previously loaded image.
@@ -226,26 +242,37 @@ public:
 private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
+    void decodeImage();
+    int dispatchDecodes();
     void parseNinePatchImage(Image* image, Texture2D* texture, std::string_view path);
 
 public:
 protected:
     struct AsyncStruct;
 
+    void completeImageAsync(AsyncStruct* asyncStruct);
+
+    // the I/O stage, decoding runs on the JobSystem
     std::thread* _loadingThread;
 
     std::deque<AsyncStruct*> _asyncStructQueue;
-    std::deque<AsyncStruct*> _requestQueue;
-    std::deque<AsyncStruct*> _responseQueue;
+    std::deque<AsyncStruct*> _requestQueue;     // waiting to be read, by priority
+    std::deque<AsyncStruct*> _decodeQueue;      // read, waiting to be decoded, by priority
+    std::deque<AsyncStruct*> _responseQueue;    // decoded, waiting for the main thread
 
     std::mutex _requestMutex;
+    std::mutex _decodeMutex;
     std::mutex _responseMutex;
 
     std::condition_variable _sleepCondition;
+    std::condition_variable _decodeCondition;
 
-    bool _needQuit;
+    std::atomic<bool> _needQuit;
 
     int _asyncRefCount;
+    // written under _decodeMutex, read without it by the callers of getAsyncDecodeConcurrency
+    std::atomic<int> _asyncDecodeConcurrency{0};
+    int _decodeRunning = 0;
 
     hlookup::string_map<Texture2D*> _textures;
 
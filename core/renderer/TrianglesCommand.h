@@ -102,6 +102,16 @@ public:
     /**Get the model view matrix.*/
     const Mat4& getModelView() const { return _mv; }
 
+    /**
+     * Writes getVertexCount() vertices of the command, transformed to world space, into the renderer's vertex
+     * stream. The output may be GPU-visible write-combined memory: write each vertex once and never read it back.
+     */
+    using VertexWriter = void (*)(const TrianglesCommand& command, V3F_C4B_T2F* out);
+    /**Set a writer filling the vertices in place of the default copy and transform of getVertices().*/
+    void setVertexWriter(VertexWriter writer) { _vertexWriter = writer; }
+    /**Get the vertex writer, nullptr if the vertices are copied and transformed by the renderer.*/
+    VertexWriter getVertexWriter() const { return _vertexWriter; }
+
     /** update material ID */
     void updateMaterialID();
 
@@ -119,6 +129,8 @@ protected:
     BlendFunc _blendType              = BlendFunc::DISABLE;
     uint64_t _batchId                 = 0;
     backend::TextureBackend* _texture = nullptr;
+
+    VertexWriter _vertexWriter = nullptr;
 };
 
 NS_AX_END
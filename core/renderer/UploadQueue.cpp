@@ -0,0 +1,126 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/UploadQueue.h"
+
+#include <algorithm>
+#include <chrono>
+
+NS_AX_BEGIN
+
+void UploadQueue::enqueue(const void* owner, size_t bytes, std::function<void()> upload)
+{
+    _pendingBytes += bytes;
+    _deferred.emplace_back(Upload{owner, bytes, std::move(upload)});
+}
+
+void UploadQueue::enqueueForFrame(const void* owner, size_t bytes, std::function<void()> upload)
+{
+    _pendingBytes += bytes;
+    _frame.emplace_back(Upload{owner, bytes, std::move(upload)});
+}
+
+void UploadQueue::cancel(const void* owner)
+{
+    auto cancelIn = [this, owner](std::deque<Upload>& queue) {
+        auto it = std::remove_if(queue.begin(), queue.end(), [this, owner](const Upload& upload) {
+            if (upload.owner != owner)
+                return false;
+            _pendingBytes -= upload.bytes;
+            return true;
+        });
+        queue.erase(it, queue.end());
+    };
+    cancelIn(_frame);
+    cancelIn(_deferred);
+}
+
+void UploadQueue::flush(const void* owner)
+{
+    // the uploads may queue or cancel other uploads, so take them out first
+    std::deque<Upload> owned;
+    auto takeFrom = [&owned, owner](std::deque<Upload>& queue) {
+        auto it = std::stable_partition(queue.begin(), queue.end(),
+                                        [owner](const Upload& upload) { return upload.owner != owner; });
+        std::move(it, queue.end(), std::back_inserter(owned));
+        queue.erase(it, queue.end());
+    };
+    takeFrom(_frame);
+    takeFrom(_deferred);
+
+    for (auto&& upload : owned)
+        run(upload);
+}
+
+void UploadQueue::run(Upload& upload)
+{
+    _pendingBytes -= upload.bytes;
+    _frameBytes += upload.bytes;
+    upload.upload();
+}
+
+void UploadQueue::update()
+{
+    using namespace std::chrono;
+
+    const auto start = steady_clock::now();
+    const auto timeBudget =
+        _timeBudget > 0 ? duration_cast<steady_clock::duration>(duration<float, std::milli>(_timeBudget))
+                        : steady_clock::duration::max();
+    size_t bytes = 0;
+
+    while (!_deferred.empty())
+    {
+        auto upload = std::move(_deferred.front());
+        _deferred.pop_front();
+        bytes += upload.bytes;
+        run(upload);
+
+        // at least one per frame, the rest waits for the next frames
+        if ((_byteBudget && bytes >= _byteBudget) || steady_clock::now() - start >= timeBudget)
+            break;
+    }
+
+    // report the uploads since the previous update
+    _uploadedBytes = _frameBytes;
+    _frameBytes    = 0;
+}
+
+void UploadQueue::updateFrame()
+{
+    while (!_frame.empty())
+    {
+        auto upload = std::move(_frame.front());
+        _frame.pop_front();
+        run(upload);
+    }
+}
+
+void UploadQueue::setBudget(float milliseconds, size_t bytes)
+{
+    _timeBudget = milliseconds;
+    _byteBudget = bytes;
+}
+
+NS_AX_END
@@ -0,0 +1,108 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include "base/Config.h"
+#include "platform/PlatformDefine.h"
+
+NS_AX_BEGIN
+
+/**
+ * Queues GPU uploads on the main thread so that streamed content doesn't stall a frame.
+ *
+ * Deferred uploads are drained by the Director once per frame, until the time or the byte budget is spent.
+ * At least one upload runs per frame, so the queue always progresses.
+ * Frame uploads are always run before the renderer draws the frame, they let several updates of the same
+ * resource be coalesced into one upload.
+ *
+ * Uploads are keyed by an owner, which must cancel them before it's destroyed.
+ */
+class AX_DLL UploadQueue
+{
+public:
+    /**
+     * Queues an upload, run in a later frame within the budget.
+     * @param owner The object the upload belongs to, used to cancel or flush it.
+     * @param bytes The uploaded size, counted against the byte budget.
+     */
+    void enqueue(const void* owner, size_t bytes, std::function<void()> upload);
+
+    /** Queues an upload run before the current frame is rendered, not subject to the budget. */
+    void enqueueForFrame(const void* owner, size_t bytes, std::function<void()> upload);
+
+    /** Removes the pending uploads of owner without running them. */
+    void cancel(const void* owner);
+
+    /** Runs the pending uploads of owner now. */
+    void flush(const void* owner);
+
+    /** Runs the deferred uploads within the budget, called by the Director once per frame. */
+    void update();
+
+    /** Runs the frame uploads, called by the Renderer before it draws. */
+    void updateFrame();
+
+    /**
+     * Sets the budget of update().
+     * @param milliseconds The time budget, 0 for unlimited. Default is 4.
+     * @param bytes The byte budget, 0 for unlimited. Default is 8 MiB.
+     */
+    void setBudget(float milliseconds, size_t bytes);
+    float getTimeBudget() const { return _timeBudget; }
+    size_t getByteBudget() const { return _byteBudget; }
+
+    /** Gets the number of pending uploads. */
+    size_t getQueueDepth() const { return _deferred.size() + _frame.size(); }
+
+    /** Gets the size of pending uploads. */
+    size_t getPendingBytes() const { return _pendingBytes; }
+
+    /** Gets the size uploaded in the last frame. */
+    size_t getUploadedBytes() const { return _uploadedBytes; }
+
+private:
+    struct Upload
+    {
+        const void* owner;
+        size_t bytes;
+        std::function<void()> upload;
+    };
+
+    void run(Upload& upload);
+
+    std::deque<Upload> _deferred;
+    std::deque<Upload> _frame;
+
+    float _timeBudget     = 4.0f;
+    size_t _byteBudget    = 8 * 1024 * 1024;
+    size_t _pendingBytes  = 0;
+    size_t _uploadedBytes = 0;
+    // counts the bytes of the frame being prepared, reported by update()
+    size_t _frameBytes = 0;
+};
+
+NS_AX_END
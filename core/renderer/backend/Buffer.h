@@ -73,6 +73,22 @@ public:
      */
     virtual void usingDefaultStoredData(bool needDefaultStoredData) = 0;
 
+    /**
+     * Get a write pointer straight into the GPU-visible storage of a dynamic buffer for the current frame.
+     * The storage is triple buffered by the backend, so ranges written in this frame are never in use by the GPU.
+     * The pointer may change between frames, query it again before writing. Memory may be write-combined,
+     * never read through it.
+     * @return nullptr if the backend can't map the buffer, use `updateData` or `updateSubData` instead.
+     */
+    virtual void* mapStreaming() { return nullptr; }
+
+    /**
+     * Make writes through the pointer returned by `mapStreaming` visible to the GPU.
+     * @param offset The offset in bytes of the written range.
+     * @param size The size in bytes of the written range.
+     */
+    virtual void flushMappedRange(std::size_t /*offset*/, std::size_t /*size*/) {}
+
     /**
      * Get buffer size in bytes.
      * @return The buffer size in bytes.
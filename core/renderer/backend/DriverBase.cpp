@@ -29,4 +29,13 @@ NS_AX_BACKEND_BEGIN
 
 DriverBase* DriverBase::_instance = nullptr;
 
+void DriverBase::setInstance(DriverBase* instance)
+{
+    if (_instance != instance)
+    {
+        delete _instance;
+        _instance = instance;
+    }
+}
+
 NS_AX_BACKEND_END
@@ -61,7 +61,8 @@ enum class FeatureType : uint32_t
     VAO,
     MAPBUFFER,
     DEPTH24,
-    ASTC
+    ASTC,
+    PERSISTENT_MAPPING
 };
 
 /**
@@ -84,6 +85,12 @@ public:
     static DriverBase* getInstance();
     static void destroyInstance();
 
+    /**
+     * Replace the shared instance, i.e. with the headless DriverNull.
+     * Must be called before any backend resource is created, the previous instance is destroyed.
+     */
+    static void setInstance(DriverBase* instance);
+
     virtual ~DriverBase() = default;
 
     /**
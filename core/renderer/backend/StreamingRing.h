@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#pragma once
+
+#include "Macros.h"
+
+#include <cstdint>
+
+NS_AX_BACKEND_BEGIN
+
+/**
+ * @addtogroup _backend
+ * @{
+ */
+
+/**
+ * The rotation of a triple buffered streaming buffer. The buffer has one region per frame in flight, it moves to
+ * the next region once per frame and fences the one just used. A region is only handed out again once its fence
+ * was waited on, so the GPU is done reading it.
+ *
+ * The backends supply the fences, see BufferGL and BufferNull.
+ */
+template <typename Fence>
+class StreamingRing
+{
+public:
+    static constexpr int REGIONS = 3;
+
+    /** Starts over at the first region, in the given frame. */
+    void reset(uint64_t frame)
+    {
+        _index = 0;
+        _frame = frame;
+    }
+
+    /**
+     * Gets the region to write in this frame, moving to the next one in a new frame.
+     * @param createFence Returns a fence signaled once the GPU is done with the commands issued so far.
+     * @param waitFence Waits on a fence, then destroys it.
+     */
+    template <typename CreateFence, typename WaitFence>
+    int acquire(uint64_t frame, CreateFence&& createFence, WaitFence&& waitFence)
+    {
+        if (frame != _frame)
+        {
+            _frame          = frame;
+            _fences[_index] = createFence();
+            _index          = (_index + 1) % REGIONS;
+
+            if (auto fence = _fences[_index])
+            {
+                waitFence(fence);
+                _fences[_index] = Fence{};
+            }
+        }
+        return _index;
+    }
+
+    /** Destroys the fences still pending, the buffer is going away. */
+    template <typename DeleteFence>
+    void clear(DeleteFence&& deleteFence)
+    {
+        for (auto& fence : _fences)
+        {
+            if (fence)
+                deleteFence(fence);
+            fence = Fence{};
+        }
+    }
+
+    int getIndex() const { return _index; }
+
+private:
+    Fence _fences[REGIONS] = {};
+    int _index             = 0;
+    uint64_t _frame        = 0;
+};
+
+// end of _backend group
+/// @}
+NS_AX_BACKEND_END
@@ -80,6 +80,11 @@ public:
      */
     virtual void usingDefaultStoredData(bool needDefaultStoredData) override{};
 
+    /**
+     * Dynamic buffers live in shared storage, return the contents of this frame's buffer.
+     */
+    virtual void* mapStreaming() override;
+
     /// @name Setters & Getters
     id<MTLBuffer> getMTLBuffer() const;
 
@@ -82,6 +82,15 @@ void BufferMTL::updateSubData(const void* data, std::size_t offset, std::size_t
     memcpy((uint8_t*)_mtlBuffer.contents + offset, data, size);
 }
 
+void* BufferMTL::mapStreaming()
+{
+    if (BufferUsage::DYNAMIC != _usage)
+        return nullptr;
+
+    updateIndex();
+    return _mtlBuffer.contents;
+}
+
 id<MTLBuffer> BufferMTL::getMTLBuffer() const
 {
     return _mtlBuffer;
@@ -567,6 +567,9 @@ bool DriverMTL::checkForFeatureSupported(FeatureType feature)
     case FeatureType::ASTC:
         featureSupported = supportASTC(_featureSet);
         break;
+    case FeatureType::PERSISTENT_MAPPING:
+        featureSupported = true;
+        break;
     default:
         break;
     }
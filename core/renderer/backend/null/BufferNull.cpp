@@ -0,0 +1,86 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "BufferNull.h"
+#include "DriverNull.h"
+#include "base/Macros.h"
+
+#include <cassert>
+
+NS_AX_BACKEND_BEGIN
+
+BufferNull::BufferNull(DriverNull* driver, std::size_t size, BufferType type, BufferUsage usage)
+    : Buffer(size, type, usage), _driver(driver), _data(size)
+{}
+
+void BufferNull::updateData(const void* data, std::size_t size)
+{
+    assert(size && size <= _size);
+
+    if (data)
+        memcpy(_data.data() + getRegionOffset(), data, size);
+
+    auto& frameLog = _driver->getCurrentFrameLog();
+    ++frameLog.bufferUploads;
+    frameLog.bufferUploadSize += size;
+}
+
+void BufferNull::updateSubData(const void* data, std::size_t offset, std::size_t size)
+{
+    AXASSERT(offset + size <= _size, "buffer size overflow");
+    memcpy(_data.data() + getRegionOffset() + offset, data, size);
+
+    auto& frameLog = _driver->getCurrentFrameLog();
+    ++frameLog.bufferUploads;
+    frameLog.bufferUploadSize += size;
+}
+
+void* BufferNull::mapStreaming()
+{
+    if (BufferUsage::DYNAMIC != _usage)
+        return nullptr;
+
+    const auto frame = _driver->getCurrentFrameLog().frameIndex;
+    if (_streamingIndex < 0)
+    {
+        _data.resize(_size * StreamingRing<uint64_t>::REGIONS);
+        _streamingRing.reset(frame);
+    }
+
+    // a fence is the frame it completes with, nothing is in flight once a frame ended
+    _streamingIndex = _streamingRing.acquire(
+        frame, [frame] { return frame + 1; }, [this](uint64_t) { ++_driver->getCurrentFrameLog().fenceWaits; });
+    return _data.data() + getRegionOffset();
+}
+
+void BufferNull::flushMappedRange(std::size_t offset, std::size_t size)
+{
+    AXASSERT(offset + size <= _size, "buffer size overflow");
+
+    auto& frameLog = _driver->getCurrentFrameLog();
+    ++frameLog.bufferUploads;
+    frameLog.bufferUploadSize += size;
+}
+
+NS_AX_BACKEND_END
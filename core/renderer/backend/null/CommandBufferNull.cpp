@@ -0,0 +1,211 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CommandBufferNull.h"
+#include "DriverNull.h"
+#include "RenderPipelineNull.h"
+#include "DepthStencilStateNull.h"
+#include "../Buffer.h"
+#include "../Program.h"
+#include "../RenderTarget.h"
+
+NS_AX_BACKEND_BEGIN
+
+CommandBufferNull::CommandBufferNull(DriverNull* driver) : _driver(driver) {}
+
+CommandBufferNull::~CommandBufferNull()
+{
+    AX_SAFE_RELEASE_NULL(_renderPipeline);
+    AX_SAFE_RELEASE_NULL(_vertexBuffer);
+    AX_SAFE_RELEASE_NULL(_indexBuffer);
+    AX_SAFE_RELEASE_NULL(_instanceBuffer);
+    AX_SAFE_RELEASE_NULL(_programState);
+}
+
+void CommandBufferNull::setDepthStencilState(DepthStencilState* depthStencilState)
+{
+    _depthStencilStateNull = static_cast<DepthStencilStateNull*>(depthStencilState);
+}
+
+void CommandBufferNull::setRenderPipeline(RenderPipeline* renderPipeline)
+{
+    AX_SAFE_RETAIN(renderPipeline);
+    AX_SAFE_RELEASE(_renderPipeline);
+    _renderPipeline = static_cast<RenderPipelineNull*>(renderPipeline);
+}
+
+bool CommandBufferNull::beginFrame()
+{
+    _driver->beginFrameLog();
+    return true;
+}
+
+void CommandBufferNull::beginRenderPass(const RenderTarget* /*renderTarget*/, const RenderPassDescriptor& /*descriptor*/)
+{
+    ++_driver->getCurrentFrameLog().renderPasses;
+}
+
+void CommandBufferNull::updateDepthStencilState(const DepthStencilDescriptor& descriptor)
+{
+    if (_depthStencilStateNull)
+        _depthStencilStateNull->update(descriptor);
+    ++_driver->getCurrentFrameLog().depthStencilChanges;
+}
+
+void CommandBufferNull::updatePipelineState(const RenderTarget* rt, const PipelineDescriptor& descriptor)
+{
+    if (_renderPipeline)
+        _renderPipeline->update(rt, descriptor);
+    ++_driver->getCurrentFrameLog().pipelineStateChanges;
+}
+
+void CommandBufferNull::setViewport(int x, int y, unsigned int w, unsigned int h)
+{
+    _viewport = {x, y, w, h};
+    ++_driver->getCurrentFrameLog().viewportChanges;
+}
+
+void CommandBufferNull::setCullMode(CullMode /*mode*/) {}
+
+void CommandBufferNull::setWinding(Winding /*winding*/) {}
+
+void CommandBufferNull::setVertexBuffer(Buffer* buffer)
+{
+    AX_SAFE_RETAIN(buffer);
+    AX_SAFE_RELEASE(_vertexBuffer);
+    _vertexBuffer = buffer;
+}
+
+void CommandBufferNull::setProgramState(ProgramState* programState)
+{
+    AX_SAFE_RETAIN(programState);
+    AX_SAFE_RELEASE(_programState);
+    _programState = programState;
+    ++_driver->getCurrentFrameLog().programStateChanges;
+}
+
+void CommandBufferNull::setIndexBuffer(Buffer* buffer)
+{
+    AX_SAFE_RETAIN(buffer);
+    AX_SAFE_RELEASE(_indexBuffer);
+    _indexBuffer = buffer;
+}
+
+void CommandBufferNull::setInstanceBuffer(Buffer* buffer)
+{
+    AX_SAFE_RETAIN(buffer);
+    AX_SAFE_RELEASE(_instanceBuffer);
+    _instanceBuffer = buffer;
+}
+
+void CommandBufferNull::drawArrays(PrimitiveType primitiveType, std::size_t start, std::size_t count, bool /*wireframe*/)
+{
+    recordDraw(primitiveType, start, count, 1, false);
+}
+
+void CommandBufferNull::drawElements(PrimitiveType primitiveType,
+                                     IndexFormat /*indexType*/,
+                                     std::size_t count,
+                                     std::size_t offset,
+                                     bool /*wireframe*/)
+{
+    recordDraw(primitiveType, offset, count, 1, true);
+}
+
+void CommandBufferNull::drawElementsInstanced(PrimitiveType primitiveType,
+                                              IndexFormat /*indexType*/,
+                                              std::size_t count,
+                                              std::size_t offset,
+                                              int instanceCount,
+                                              bool /*wireframe*/)
+{
+    recordDraw(primitiveType, offset, count, instanceCount, true);
+}
+
+void CommandBufferNull::recordDraw(PrimitiveType primitiveType,
+                                   std::size_t start,
+                                   std::size_t count,
+                                   int instanceCount,
+                                   bool indexed)
+{
+    FrameLog::DrawCall dc;
+    dc.primitiveType = primitiveType;
+    dc.start         = start;
+    dc.count         = count;
+    dc.instanceCount = instanceCount;
+    dc.indexed       = indexed;
+    if (_programState)
+    {
+        dc.batchId = _programState->getBatchId();
+        if (auto program = _programState->getProgram())
+        {
+            dc.programType = program->getProgramType();
+            dc.programId   = program->getProgramId();
+        }
+    }
+    _driver->getCurrentFrameLog().drawCalls.emplace_back(dc);
+}
+
+void CommandBufferNull::endRenderPass()
+{
+    AX_SAFE_RELEASE_NULL(_programState);
+}
+
+void CommandBufferNull::endFrame()
+{
+    _driver->endFrameLog();
+}
+
+void CommandBufferNull::setScissorRect(bool /*isEnabled*/, float /*x*/, float /*y*/, float /*width*/, float /*height*/)
+{
+    ++_driver->getCurrentFrameLog().scissorChanges;
+}
+
+void CommandBufferNull::readPixels(RenderTarget* rt, std::function<void(const PixelBufferDescriptor&)> callback)
+{
+    PixelBufferDescriptor pbd;
+    uint32_t width = 0, height = 0;
+    if (rt->isDefaultRenderTarget())
+    {
+        width  = _viewport.w;
+        height = _viewport.h;
+    }
+    else if (auto colorAttachment = rt->_color[0].texture)
+    {
+        width  = colorAttachment->getWidth();
+        height = colorAttachment->getHeight();
+    }
+
+    const auto bufferSize = static_cast<std::size_t>(width) * height * 4;
+    if (bufferSize)
+    {
+        auto wptr = pbd._data.resize(bufferSize);
+        memset(wptr, 0, bufferSize);
+        pbd._width  = width;
+        pbd._height = height;
+    }
+    callback(pbd);
+}
+
+NS_AX_BACKEND_END
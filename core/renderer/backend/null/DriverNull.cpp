@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "DriverNull.h"
+#include "CommandBufferNull.h"
+#include "BufferNull.h"
+#include "TextureNull.h"
+#include "ProgramNull.h"
+#include "RenderPipelineNull.h"
+#include "RenderTargetNull.h"
+#include "DepthStencilStateNull.h"
+#include "../ProgramManager.h"
+
+NS_AX_BACKEND_BEGIN
+
+DriverNull::DriverNull()
+{
+    _maxAttributes     = 16;
+    _maxTextureSize    = 16384;
+    _maxTextureUnits   = 32;
+    _maxSamplesAllowed = 1;
+}
+
+DriverNull::~DriverNull()
+{
+    ProgramManager::destroyInstance();
+}
+
+CommandBuffer* DriverNull::newCommandBuffer()
+{
+    return new CommandBufferNull(this);
+}
+
+Buffer* DriverNull::newBuffer(std::size_t size, BufferType type, BufferUsage usage)
+{
+    return new BufferNull(this, size, type, usage);
+}
+
+TextureBackend* DriverNull::newTexture(const TextureDescriptor& descriptor)
+{
+    switch (descriptor.textureType)
+    {
+    case TextureType::TEXTURE_2D:
+        return new Texture2DNull(this, descriptor);
+    case TextureType::TEXTURE_CUBE:
+        return new TextureCubeNull(this, descriptor);
+    default:
+        return nullptr;
+    }
+}
+
+RenderTarget* DriverNull::newDefaultRenderTarget(TargetBufferFlags rtf)
+{
+    auto rt = new RenderTargetNull(true);
+    rt->setTargetFlags(rtf);
+    return rt;
+}
+
+RenderTarget* DriverNull::newRenderTarget(TargetBufferFlags rtf,
+                                          TextureBackend* colorAttachment,
+                                          TextureBackend* depthAttachment,
+                                          TextureBackend* stencilAttachhment)
+{
+    auto rt = new RenderTargetNull(false);
+    rt->setTargetFlags(rtf);
+    RenderTarget::ColorAttachment colors{{colorAttachment, 0}};
+    rt->setColorAttachment(colors);
+    rt->setDepthAttachment(depthAttachment);
+    rt->setStencilAttachment(stencilAttachhment);
+    return rt;
+}
+
+DepthStencilState* DriverNull::newDepthStencilState()
+{
+    return new DepthStencilStateNull();
+}
+
+RenderPipeline* DriverNull::newRenderPipeline()
+{
+    return new RenderPipelineNull();
+}
+
+Program* DriverNull::newProgram(std::string_view vertexShader, std::string_view fragmentShader)
+{
+    return new ProgramNull(vertexShader, fragmentShader);
+}
+
+ShaderModule* DriverNull::newShaderModule(ShaderStage stage, std::string_view source)
+{
+    return new ShaderModuleNull(stage);
+}
+
+void DriverNull::beginFrameLog()
+{
+    _currentFrame.frameIndex = _frameIndex;
+}
+
+void DriverNull::endFrameLog()
+{
+    std::swap(_lastFrame, _currentFrame);
+    ++_frameIndex;
+
+    if (_frameLogCallback)
+        _frameLogCallback(_lastFrame);
+
+    // uploads issued between frames, i.e. by asset loading, are accounted to the next frame
+    _currentFrame.reset();
+    _currentFrame.frameIndex = _frameIndex;
+}
+
+NS_AX_BACKEND_END
@@ -0,0 +1,101 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../DriverBase.h"
+#include "FrameLog.h"
+
+#include <functional>
+
+NS_AX_BACKEND_BEGIN
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * A GPU-less driver, all resources live in system memory and every command is recorded
+ * into a FrameLog instead of being executed.
+ * Install it with DriverBase::setInstance before the Renderer is initialized.
+ */
+class AX_DLL DriverNull : public DriverBase
+{
+public:
+    DriverNull();
+    ~DriverNull();
+
+    CommandBuffer* newCommandBuffer() override;
+    Buffer* newBuffer(std::size_t size, BufferType type, BufferUsage usage) override;
+    TextureBackend* newTexture(const TextureDescriptor& descriptor) override;
+    RenderTarget* newDefaultRenderTarget(TargetBufferFlags rtf) override;
+    RenderTarget* newRenderTarget(TargetBufferFlags rtf,
+                                  TextureBackend* colorAttachment,
+                                  TextureBackend* depthAttachment,
+                                  TextureBackend* stencilAttachhment) override;
+    DepthStencilState* newDepthStencilState() override;
+    RenderPipeline* newRenderPipeline() override;
+    void setFrameBufferOnly(bool frameBufferOnly) override {}
+    Program* newProgram(std::string_view vertexShader, std::string_view fragmentShader) override;
+
+    const char* getVendor() const override { return "axmol"; }
+    const char* getRenderer() const override { return "null"; }
+    const char* getVersion() const override { return "1.0"; }
+
+    /** The null backend accepts every texture format, the data is only kept in memory. */
+    bool checkForFeatureSupported(FeatureType feature) override { return true; }
+
+    /**
+     * Get the log of the frame being recorded.
+     */
+    FrameLog& getCurrentFrameLog() { return _currentFrame; }
+
+    /**
+     * Get the log of the last completed frame, valid after CommandBuffer::endFrame.
+     */
+    const FrameLog& getLastFrameLog() const { return _lastFrame; }
+
+    /**
+     * Set a callback invoked with the log of every completed frame.
+     */
+    void setFrameLogCallback(std::function<void(const FrameLog&)> callback) { _frameLogCallback = std::move(callback); }
+
+    /// @cond DO_NOT_SHOW
+    void beginFrameLog();
+    void endFrameLog();
+    /// @endcond
+
+protected:
+    ShaderModule* newShaderModule(ShaderStage stage, std::string_view source) override;
+
+private:
+    FrameLog _currentFrame;
+    FrameLog _lastFrame;
+    uint64_t _frameIndex = 0;
+    std::function<void(const FrameLog&)> _frameLogCallback;
+};
+
+// end of _null group
+/// @}
+NS_AX_BACKEND_END
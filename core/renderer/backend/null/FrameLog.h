@@ -0,0 +1,99 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Macros.h"
+#include "../Types.h"
+
+#include <cstdint>
+#include <vector>
+
+NS_AX_BACKEND_BEGIN
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * The commands recorded by the null backend during one frame.
+ * Everything submitted between CommandBuffer::beginFrame and CommandBuffer::endFrame is
+ * logged here, so headless tests can assert draw call counts and upload volume without a GPU.
+ */
+struct FrameLog
+{
+    struct DrawCall
+    {
+        PrimitiveType primitiveType = PrimitiveType::TRIANGLE;
+        std::size_t start           = 0;  ///< first vertex for drawArrays, byte offset for drawElements
+        std::size_t count           = 0;  ///< vertex or index count
+        int instanceCount           = 1;
+        bool indexed                = false;
+        uint32_t programType        = 0;
+        uint64_t programId          = 0;
+        uint64_t batchId            = 0;  ///< ProgramState batch id at the time of the draw
+    };
+
+    uint64_t frameIndex = 0;
+
+    std::vector<DrawCall> drawCalls;
+
+    uint32_t renderPasses         = 0;
+    uint32_t pipelineStateChanges = 0;
+    uint32_t programStateChanges  = 0;
+    uint32_t depthStencilChanges  = 0;
+    uint32_t viewportChanges      = 0;
+    uint32_t scissorChanges       = 0;
+
+    uint32_t bufferUploads       = 0;
+    std::size_t bufferUploadSize = 0;  ///< bytes
+    uint32_t textureUploads       = 0;
+    std::size_t textureUploadSize = 0;  ///< bytes
+    uint32_t fenceWaits           = 0;  ///< streaming buffer regions waited on before they were written again
+
+    std::size_t getDrawCallCount() const { return drawCalls.size(); }
+
+    /** Total vertices or indices submitted by all draw calls. */
+    std::size_t getElementCount() const
+    {
+        std::size_t total = 0;
+        for (auto& dc : drawCalls)
+            total += dc.count * dc.instanceCount;
+        return total;
+    }
+
+    void reset()
+    {
+        drawCalls.clear();
+        renderPasses = pipelineStateChanges = programStateChanges = 0;
+        depthStencilChanges = viewportChanges = scissorChanges = 0;
+        bufferUploads = textureUploads = 0;
+        bufferUploadSize = textureUploadSize = 0;
+        fenceWaits                            = 0;
+    }
+};
+
+// end of _null group
+/// @}
+NS_AX_BACKEND_END
@@ -0,0 +1,50 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ProgramNull.h"
+
+NS_AX_BACKEND_BEGIN
+
+static const std::string_view s_builtinAttributeNames[] = {
+    ATTRIBUTE_NAME_POSITION,  ATTRIBUTE_NAME_COLOR,     ATTRIBUTE_NAME_TEXCOORD, ATTRIBUTE_NAME_TEXCOORD1,
+    ATTRIBUTE_NAME_TEXCOORD2, ATTRIBUTE_NAME_TEXCOORD3, ATTRIBUTE_NAME_NORMAL,   ATTRIBUTE_NAME_INSTANCE,
+};
+
+ProgramNull::ProgramNull(std::string_view vertexShader, std::string_view fragmentShader)
+    : Program(vertexShader, fragmentShader)
+{
+    for (int location = 0; location < static_cast<int>(Attribute::ATTRIBUTE_MAX); ++location)
+    {
+        auto& attrib    = _activeAttribs[std::string{s_builtinAttributeNames[location]}];
+        attrib.location = location;
+    }
+}
+
+int ProgramNull::getAttributeLocation(std::string_view name) const
+{
+    auto it = _activeAttribs.find(name);
+    return it != _activeAttribs.end() ? it->second.location : -1;
+}
+
+NS_AX_BACKEND_END
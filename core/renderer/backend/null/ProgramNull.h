@@ -0,0 +1,82 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Program.h"
+#include "../ShaderModule.h"
+
+NS_AX_BACKEND_BEGIN
+
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * A shader module which is never compiled.
+ */
+class ShaderModuleNull : public ShaderModule
+{
+public:
+    explicit ShaderModuleNull(ShaderStage stage) : ShaderModule(stage) {}
+};
+
+/**
+ * A program which exposes the engine built-in vertex attributes only, there are no active uniforms,
+ * so uniform updates through ProgramState are silently ignored.
+ */
+class ProgramNull : public Program
+{
+public:
+    ProgramNull(std::string_view vertexShader, std::string_view fragmentShader);
+
+    UniformLocation getUniformLocation(std::string_view /*uniform*/) const override { return {}; }
+    UniformLocation getUniformLocation(backend::Uniform /*name*/) const override { return {}; }
+    int getAttributeLocation(std::string_view name) const override;
+    int getAttributeLocation(backend::Attribute name) const override { return static_cast<int>(name); }
+    int getMaxVertexLocation() const override { return 0; }
+    int getMaxFragmentLocation() const override { return 0; }
+    const hlookup::string_map<AttributeBindInfo>& getActiveAttributes() const override { return _activeAttribs; }
+    std::size_t getUniformBufferSize(ShaderStage /*stage*/) const override { return 0; }
+    const hlookup::string_map<UniformInfo>& getAllActiveUniformInfo(ShaderStage /*stage*/) const override
+    {
+        return _activeUniformInfos;
+    }
+
+protected:
+#if AX_ENABLE_CACHE_TEXTURE_DATA
+    int getMappedLocation(int location) const override { return location; }
+    int getOriginalLocation(int location) const override { return location; }
+    const std::unordered_map<std::string, int> getAllUniformsLocation() const override { return {}; }
+#endif
+
+private:
+    hlookup::string_map<AttributeBindInfo> _activeAttribs;
+    hlookup::string_map<UniformInfo> _activeUniformInfos;
+};
+
+// end of _null group
+/// @}
+NS_AX_BACKEND_END
@@ -0,0 +1,60 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../RenderPipeline.h"
+
+NS_AX_BACKEND_BEGIN
+
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * Keeps the last program and blend state, nothing is compiled.
+ */
+class RenderPipelineNull : public RenderPipeline
+{
+public:
+    RenderPipelineNull() = default;
+
+    void update(const RenderTarget*, const PipelineDescriptor& pipelineDescriptor) override
+    {
+        _programState    = pipelineDescriptor.programState;
+        _blendDescriptor = pipelineDescriptor.blendDescriptor;
+    }
+
+    ProgramState* getProgramState() const { return _programState; }
+    const BlendDescriptor& getBlendDescriptor() const { return _blendDescriptor; }
+
+private:
+    ProgramState* _programState = nullptr;
+    BlendDescriptor _blendDescriptor;
+};
+
+// end of _null group
+/// @}
+NS_AX_BACKEND_END
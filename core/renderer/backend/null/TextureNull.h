@@ -0,0 +1,96 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Texture.h"
+
+NS_AX_BACKEND_BEGIN
+
+class DriverNull;
+
+/**
+ * @addtogroup _null
+ * @{
+ */
+
+/**
+ * A 2D texture without storage, uploads are only accounted in the FrameLog.
+ */
+class Texture2DNull : public backend::Texture2DBackend
+{
+public:
+    Texture2DNull(DriverNull* driver, const TextureDescriptor& descriptor);
+
+    void updateData(uint8_t* data, std::size_t width, std::size_t height, std::size_t level, int index = 0) override;
+    void updateCompressedData(uint8_t* data,
+                              std::size_t width,
+                              std::size_t height,
+                              std::size_t dataLen,
+                              std::size_t level,
+                              int index = 0) override;
+    void updateSubData(std::size_t xoffset,
+                       std::size_t yoffset,
+                       std::size_t width,
+                       std::size_t height,
+                       std::size_t level,
+                       uint8_t* data,
+                       int index = 0) override;
+    void updateCompressedSubData(std::size_t xoffset,
+                                 std::size_t yoffset,
+                                 std::size_t width,
+                                 std::size_t height,
+                                 std::size_t dataLen,
+                                 std::size_t level,
+                                 uint8_t* data,
+                                 int index = 0) override;
+
+    void updateSamplerDescriptor(const SamplerDescriptor& /*sampler*/) override {}
+    void generateMipmaps() override { _hasMipmaps = true; }
+
+private:
+    void recordUpload(std::size_t size);
+
+    DriverNull* _driver = nullptr;
+};
+
+/**
+ * A cubemap texture without storage, uploads are only accounted in the FrameLog.
+ */
+class TextureCubeNull : public backend::TextureCubemapBackend
+{
+public:
+    TextureCubeNull(DriverNull* driver, const TextureDescriptor& descriptor);
+
+    void updateFaceData(TextureCubeFace side, void* data, int index = 0) override;
+    void updateSamplerDescriptor(const SamplerDescriptor& /*sampler*/) override {}
+    void generateMipmaps() override { _hasMipmaps = true; }
+
+private:
+    DriverNull* _driver = nullptr;
+};
+
+// end of _null group
+/// @}
+NS_AX_BACKEND_END
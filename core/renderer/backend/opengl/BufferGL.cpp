@@ -29,6 +29,7 @@
 #include "base/EventDispatcher.h"
 #include "renderer/backend/opengl/MacrosGL.h"
 #include "OpenGLState.h"
+#include "renderer/backend/DriverBase.h"
 
 NS_AX_BACKEND_BEGIN
 
@@ -61,6 +62,15 @@ BufferGL::BufferGL(std::size_t size, BufferType type, BufferUsage usage) : Buffe
 
 BufferGL::~BufferGL()
 {
+#if !AX_GLES_PROFILE
+    if (_streamingIndex >= 0)
+    {
+        _streamingRing.clear([](GLsync fence) { glDeleteSync(fence); });
+        for (int i = 0; i < STREAMING_BUFFERS; ++i)
+            __gl->deleteBuffer(_type, _streamingBuffers[i]);
+        _buffer = 0;
+    }
+#endif
     if (_buffer)
         __gl->deleteBuffer(_type, _buffer);
 #if AX_ENABLE_CACHE_TEXTURE_DATA
@@ -106,6 +116,16 @@ void BufferGL::updateData(const void* data, std::size_t size)
 {
     assert(size && size <= _size);
 
+#if !AX_GLES_PROFILE
+    // immutable storage, write through the mapping
+    if (_streamingIndex >= 0)
+    {
+        if (data)
+            memcpy(_streamingData[_streamingIndex], data, size);
+        return;
+    }
+#endif
+
     if (_buffer)
     {
         glBufferData(__gl->bindBuffer(_type, _buffer), size, data, toGLUsage(_usage));
@@ -125,6 +145,14 @@ void BufferGL::updateSubData(const void* data, std::size_t offset, std::size_t s
     AXASSERT(_bufferAllocated != 0, "updateData should be invoke before updateSubData");
     AXASSERT(offset + size <= _bufferAllocated, "buffer size overflow");
 
+#if !AX_GLES_PROFILE
+    if (_streamingIndex >= 0)
+    {
+        memcpy(static_cast<char*>(_streamingData[_streamingIndex]) + offset, data, size);
+        return;
+    }
+#endif
+
     if (_buffer)
     {
         CHECK_GL_ERROR_DEBUG();
@@ -138,4 +166,66 @@ void BufferGL::updateSubData(const void* data, std::size_t offset, std::size_t s
     }
 }
 
+void* BufferGL::mapStreaming()
+{
+#if !AX_GLES_PROFILE
+    if (BufferUsage::DYNAMIC != _usage || _streamingUnsupported)
+        return nullptr;
+
+    if (_streamingIndex < 0 && !createStreamingStorage())
+    {
+        _streamingUnsupported = true;
+        return nullptr;
+    }
+
+    // move to the next buffer once per frame, fencing the one just used
+    _streamingIndex = _streamingRing.acquire(
+        Director::getInstance()->getTotalFrames(), [] { return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); },
+        [](GLsync fence) {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(fence);
+        });
+    _buffer = _streamingBuffers[_streamingIndex];
+    return _streamingData[_streamingIndex];
+#else
+    return nullptr;
+#endif
+}
+
+#if !AX_GLES_PROFILE
+bool BufferGL::createStreamingStorage()
+{
+    if (!DriverBase::getInstance()->checkForFeatureSupported(FeatureType::PERSISTENT_MAPPING))
+        return false;
+
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(STREAMING_BUFFERS, _streamingBuffers);
+    for (int i = 0; i < STREAMING_BUFFERS; ++i)
+    {
+        auto target = __gl->bindBuffer(_type, _streamingBuffers[i]);
+        glBufferStorage(target, _size, nullptr, flags);
+        _streamingData[i] = glMapBufferRange(target, 0, _size, flags);
+        if (!_streamingData[i])
+        {
+            for (int j = 0; j < STREAMING_BUFFERS; ++j)
+                __gl->deleteBuffer(_type, _streamingBuffers[j]);
+            memset(_streamingBuffers, 0, sizeof(_streamingBuffers));
+            memset(_streamingData, 0, sizeof(_streamingData));
+            return false;
+        }
+    }
+    CHECK_GL_ERROR_DEBUG();
+
+    if (_buffer)
+        __gl->deleteBuffer(_type, _buffer);
+
+    _streamingRing.reset(Director::getInstance()->getTotalFrames());
+    _streamingIndex  = 0;
+    _buffer          = _streamingBuffers[0];
+    _bufferAllocated = _size;
+    return true;
+}
+#endif
+
 NS_AX_BACKEND_END
@@ -25,6 +25,7 @@
 #pragma once
 
 #include "../Buffer.h"
+#include "../StreamingRing.h"
 #include "platform/GL.h"
 #include "base/EventListenerCustom.h"
 
@@ -78,6 +79,12 @@ public:
      */
     virtual void usingDefaultStoredData(bool needDefaultStoredData) override;
 
+    /**
+     * On desktop GL with buffer storage support, a dynamic buffer is backed by three persistently mapped, coherent
+     * buffers rotated per frame. A fence guards each of them so it is only written again once the GPU is done.
+     */
+    virtual void* mapStreaming() override;
+
     /**
      * Get buffer object.
      * @return Buffer object.
@@ -96,6 +103,17 @@ private:
     std::size_t _bufferAllocated = 0;
     char* _data                  = nullptr;
     bool _needDefaultStoredData  = true;
+#if !AX_GLES_PROFILE
+    bool createStreamingStorage();
+
+    static constexpr int STREAMING_BUFFERS = StreamingRing<GLsync>::REGIONS;
+
+    GLuint _streamingBuffers[STREAMING_BUFFERS] = {};
+    void* _streamingData[STREAMING_BUFFERS]     = {};
+    StreamingRing<GLsync> _streamingRing;
+    int _streamingIndex        = -1;
+    bool _streamingUnsupported = false;
+#endif
 };
 // end of _opengl group
 ///> @}
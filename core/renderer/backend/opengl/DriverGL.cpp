@@ -542,6 +542,11 @@ bool DriverGL::checkForFeatureSupported(FeatureType feature)
     case FeatureType::ASTC:
         featureSupported = checkASTCRenderability();
         break;
+    case FeatureType::PERSISTENT_MAPPING:
+#if !AX_GLES_PROFILE
+        featureSupported = hasExtension("GL_ARB_buffer_storage"sv);
+#endif
+        break;
     default:
         break;
     }
@@ -10,15 +10,17 @@
 #include <imgui/misc/cpp/imgui_stdlib.h>
 #include <zlib.h>
 #include "base/JsonWriter.h"
+#include "2d/FontPrebaked.h"
 #include "yasio/utils.hpp"
 
 NS_AX_EXT_BEGIN
 
 struct FontAtlasGenParams
 {
-    std::string sourceFont;  // font relative path? choose from developer machine?
-    std::string fontAsset;   // fontAsset .xasset
-    std::string glyphs;      // utf-8
+    std::string sourceFont;     // font relative path? choose from developer machine?
+    std::string fontAsset;      // fontAsset .xasset
+    std::string prebakedAsset;  // .axfa, memory-mapped at runtime, see FontPrebaked
+    std::string glyphs;         // utf-8
     int faceSize    = 32;
     int atlasDim[2] = {512, 512};  // w,h
     bool useAscii   = true;
@@ -138,8 +140,17 @@ public:
         }
         xasset.writeEndArray();
 
-        xasset.writeNumber("pageX", _currentPageOrigX);
-        xasset.writeNumber("pageY", _currentPageOrigY);
+        // pageX, pageY for the loaders of the row packed atlases, the skyline of the last page is exact
+        xasset.writeNumber("pageX", 0);
+        xasset.writeNumber("pageY", _pagePacker.getMaxHeight());
+        xasset.writeStartArray("skyline"sv);
+        for (auto& segment : _pagePacker.getSkyline())
+        {
+            xasset.writeNumberValue(segment.x);
+            xasset.writeNumberValue(segment.y);
+            xasset.writeNumberValue(segment.width);
+        }
+        xasset.writeEndArray();
 
         xasset.writeEndObject();
 
@@ -215,8 +226,9 @@ void SDFGen::open(ax::Scene* scene)
     auto defaultFontFile = FileUtils::getInstance()->fullPathForFilename(R"(fonts/arial.ttf)");
 
     _atlasParams             = new FontAtlasGenParams();
-    _atlasParams->sourceFont = "fonts/arial.ttf";
-    _atlasParams->fontAsset  = "fonts/arial-SDF.xasset";
+    _atlasParams->sourceFont    = "fonts/arial.ttf";
+    _atlasParams->fontAsset     = "fonts/arial-SDF.xasset";
+    _atlasParams->prebakedAsset = "fonts/arial-SDF.axfa";
 
     ImGuiPresenter::getInstance()->addFont(defaultFontFile);
     /* For Simplified Chinese support, please use:
@@ -329,6 +341,29 @@ void SDFGen::onImGuiDraw()
             _atlasParams->saved = true;
         }
 
+        ImGui::InputText("Prebaked Asset", &_atlasParams->prebakedAsset);
+        if (ImGui::Button("Save Prebaked"))
+        {
+            auto start = yasio::highp_clock();
+
+            TTFConfig ttfConfig(_atlasParams->sourceFont, static_cast<float>(_atlasParams->faceSize),
+                                _atlasParams->useAscii ? GlyphCollection::ASCII : GlyphCollection::CUSTOM,
+                                _atlasParams->glyphs.c_str(), true);
+            ttfConfig.faceSize = _atlasParams->faceSize;
+
+            auto fu        = FileUtils::getInstance();
+            auto storePath = fu->isAbsolutePath(_atlasParams->prebakedAsset)
+                                 ? _atlasParams->prebakedAsset
+                                 : fu->getDefaultResourceRootPath() + _atlasParams->prebakedAsset;
+            if (FontPrebaked::bake(ttfConfig, storePath, _atlasParams->atlasDim[0], _atlasParams->atlasDim[1]))
+                _atlasParams->error.clear();
+            else
+                _atlasParams->error = "Bake prebaked font atlas fail!";
+
+            _atlasParams->cost  = (yasio::highp_clock() - start) / 1000.0;
+            _atlasParams->saved = true;
+        }
+
         if (_atlasParams->saved)
         {
             ImGui::SameLine();
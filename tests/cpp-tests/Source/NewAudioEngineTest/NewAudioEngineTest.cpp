@@ -46,6 +46,7 @@ AudioEngineTests::AudioEngineTests()
     ADD_TEST_CASE(AudioSmallFile3Test);
     ADD_TEST_CASE(AudioPauseResumeAfterPlay);
     ADD_TEST_CASE(AudioPreloadSameFileMultipleTimes);
+    ADD_TEST_CASE(AudioPreloadOverCacheBudget);
     ADD_TEST_CASE(AudioPlayFileInWritablePath);
     ADD_TEST_CASE(AudioIssue16938Test);
     ADD_TEST_CASE(AudioPlayInFinishedCB);
@@ -1113,6 +1114,42 @@ std::string AudioPreloadSameFileMultipleTimes::subtitle() const
     return "Should not crash";
 }
 
+void AudioPreloadOverCacheBudget::onEnter()
+{
+    AudioEngineTestDemo::onEnter();
+
+    // every decoded file exceeds the budget, so each load tries to evict the cache whose callbacks are running
+    _oldCacheBudget = AudioEngine::getCacheBudget();
+    AudioEngine::uncacheAll();
+    AudioEngine::setCacheBudget(1);
+
+    AudioEngine::preload("audio/SoundEffectsFX009/FX082.mp3", [](bool isSucceed) {
+        ax::print("preload FX082.mp3 %s", isSucceed ? "succeed" : "failed");
+        AudioEngine::preload("background.mp3", [](bool isSucceed) {
+            auto stats = AudioEngine::getCacheStats();
+            ax::print("preload background.mp3 %s, %zu bytes cached, %d evictions", isSucceed ? "succeed" : "failed",
+                      stats.bytes, static_cast<int>(stats.evictions));
+        });
+    });
+}
+
+void AudioPreloadOverCacheBudget::onExit()
+{
+    AudioEngine::setCacheBudget(_oldCacheBudget);
+
+    AudioEngineTestDemo::onExit();
+}
+
+std::string AudioPreloadOverCacheBudget::title() const
+{
+    return "Preload files over the cache budget";
+}
+
+std::string AudioPreloadOverCacheBudget::subtitle() const
+{
+    return "Should not crash, both preloads succeed";
+}
+
 void AudioPlayFileInWritablePath::onEnter()
 {
     AudioEngineTestDemo::onEnter();
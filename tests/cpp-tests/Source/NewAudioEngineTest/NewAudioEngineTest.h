@@ -294,6 +294,21 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class AudioPreloadOverCacheBudget : public AudioEngineTestDemo
+{
+public:
+    CREATE_FUNC(AudioPreloadOverCacheBudget);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    size_t _oldCacheBudget = 0;
+};
+
 class AudioPlayFileInWritablePath : public AudioEngineTestDemo
 {
 public:
@@ -0,0 +1,276 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "2d/ActionBatch.h"
+#include "2d/ActionEase.h"
+#include "2d/ActionInstant.h"
+#include "2d/ActionInterval.h"
+#include "2d/ActionManager.h"
+#include "2d/Node.h"
+
+USING_NS_AX;
+
+namespace
+{
+class TestMoveBy : public MoveBy
+{
+public:
+    static TestMoveBy* create(float duration, const Vec2& deltaPosition)
+    {
+        auto action = new TestMoveBy();
+        action->initWithDuration(duration, deltaPosition);
+        action->autorelease();
+        return action;
+    }
+};
+
+Action* tagged(Action* action)
+{
+    action->setTag(1);
+    return action;
+}
+
+// runs the same actions on two sets of nodes, with and without batching
+struct BatchFixture
+{
+    BatchFixture()
+    {
+        batched   = new ActionManager();
+        unbatched = new ActionManager();
+        unbatched->setBatchingEnabled(false);
+    }
+
+    ~BatchFixture()
+    {
+        batched->release();
+        unbatched->release();
+    }
+
+    template <typename _MakeAction>
+    void run(int index, _MakeAction&& makeAction)
+    {
+        for (auto pair : {std::make_pair(batched, &batchedNodes), std::make_pair(unbatched, &unbatchedNodes)})
+        {
+            while (pair.second->size() <= index)
+            {
+                auto node = Node::create();
+                node->setPosition(Vec2(10.0f * pair.second->size(), 20));
+                pair.second->pushBack(node);
+            }
+            pair.first->addAction(makeAction(), pair.second->at(index), false);
+        }
+    }
+
+    void update(float dt)
+    {
+        batched->update(dt);
+        unbatched->update(dt);
+    }
+
+    void checkNodes()
+    {
+        REQUIRE(batchedNodes.size() == unbatchedNodes.size());
+        for (ssize_t i = 0; i < batchedNodes.size(); ++i)
+        {
+            auto node     = batchedNodes.at(i);
+            auto expected = unbatchedNodes.at(i);
+            INFO("node ", i);
+            // the stacked moves are summed in another order when some are batched
+            CHECK(node->getPositionX() == doctest::Approx(expected->getPositionX()));
+            CHECK(node->getPositionY() == doctest::Approx(expected->getPositionY()));
+            CHECK(node->getPositionZ() == doctest::Approx(expected->getPositionZ()));
+            CHECK(node->getScaleX() == expected->getScaleX());
+            CHECK(node->getScaleY() == expected->getScaleY());
+            CHECK(node->getScaleZ() == expected->getScaleZ());
+            CHECK(node->getOpacity() == expected->getOpacity());
+            CHECK(batched->getNumberOfRunningActionsInTarget(node) ==
+                  unbatched->getNumberOfRunningActionsInTarget(expected));
+        }
+    }
+
+    ActionManager* batched;
+    ActionManager* unbatched;
+    Vector<Node*> batchedNodes;
+    Vector<Node*> unbatchedNodes;
+};
+}  // namespace
+
+TEST_SUITE("2d/ActionBatch") {
+    TEST_CASE("batchable") {
+        CHECK(ActionBatch::isBatchable(MoveBy::create(1, Vec2(1, 1))));
+        CHECK(ActionBatch::isBatchable(MoveTo::create(1, Vec3(1, 1, 1))));
+        CHECK(ActionBatch::isBatchable(ScaleBy::create(1, 2)));
+        CHECK(ActionBatch::isBatchable(ScaleTo::create(1, 2, 3)));
+        CHECK(ActionBatch::isBatchable(FadeTo::create(1, 100)));
+        CHECK(ActionBatch::isBatchable(FadeIn::create(1)));
+        CHECK(ActionBatch::isBatchable(FadeOut::create(1)));
+        CHECK(ActionBatch::isBatchable(EaseSineOut::create(MoveBy::create(1, Vec2(1, 1)))));
+        CHECK(ActionBatch::isBatchable(EaseIn::create(ScaleTo::create(1, 2), 3)));
+        CHECK(ActionBatch::isBatchable(EaseElasticInOut::create(FadeIn::create(1))));
+
+        CHECK_FALSE(ActionBatch::isBatchable(RotateBy::create(1, 90)));
+        CHECK_FALSE(ActionBatch::isBatchable(TestMoveBy::create(1, Vec2(1, 1))));
+        CHECK_FALSE(ActionBatch::isBatchable(EaseSineOut::create(RotateBy::create(1, 90))));
+        CHECK_FALSE(ActionBatch::isBatchable(EaseSineOut::create(EaseSineIn::create(MoveBy::create(1, Vec2(1, 1))))));
+        CHECK_FALSE(ActionBatch::isBatchable(
+            Sequence::create(MoveBy::create(1, Vec2(1, 1)), MoveBy::create(1, Vec2(1, 1)), nullptr)));
+    }
+
+    TEST_CASE("matches_unbatched") {
+        BatchFixture fixture;
+        fixture.run(0, [] { return MoveBy::create(0.5f, Vec2(100, -40)); });
+        fixture.run(1, [] { return MoveTo::create(1.2f, Vec3(5, 6, 7)); });
+        fixture.run(2, [] { return ScaleBy::create(0.3f, 2.0f, 0.5f); });
+        fixture.run(3, [] { return ScaleTo::create(0.7f, 3.0f); });
+        fixture.run(4, [] { return FadeOut::create(0.4f); });
+        fixture.run(5, [] { return FadeTo::create(0.9f, 77); });
+        fixture.run(6, [] { return EaseIn::create(MoveBy::create(0.8f, Vec2(30, 60)), 2.5f); });
+        fixture.run(7, [] { return EaseElasticOut::create(ScaleTo::create(1.0f, 1.5f), 0.4f); });
+        fixture.run(8, [] { return EaseBounceInOut::create(FadeTo::create(0.6f, 200)); });
+        fixture.run(9, [] { return EaseBackOut::create(MoveTo::create(0.25f, Vec2(-10, -10))); });
+        // moves stacked on the same node, with an unbatched one in between
+        fixture.run(10, [] { return MoveBy::create(0.5f, Vec2(100, 0)); });
+        fixture.run(10, [] { return TestMoveBy::create(0.7f, Vec2(0, 100)); });
+        fixture.run(10, [] { return EaseSineInOut::create(MoveBy::create(0.9f, Vec2(-50, 50))); });
+        fixture.run(11, [] {
+            return Sequence::create(MoveBy::create(0.2f, Vec2(10, 10)), ScaleTo::create(0.2f, 2.0f), nullptr);
+        });
+        fixture.run(11, [] { return FadeOut::create(0.3f); });
+        CHECK(fixture.batched->getNumberOfRunningActions() == fixture.unbatched->getNumberOfRunningActions());
+
+        for (int frame = 0; frame < 90; ++frame)
+        {
+            fixture.update(1.0f / 60);
+            fixture.checkNodes();
+        }
+        CHECK(fixture.batched->getNumberOfRunningActions() == 0);
+    }
+
+    TEST_CASE("paused") {
+        BatchFixture fixture;
+        fixture.run(0, [] { return tagged(MoveBy::create(1, Vec2(60, 0))); });
+        fixture.run(1, [] { return FadeOut::create(1); });
+
+        for (int frame = 0; frame < 30; ++frame)
+        {
+            if (frame == 10)
+            {
+                fixture.batched->pauseTarget(fixture.batchedNodes.at(0));
+                fixture.unbatched->pauseTarget(fixture.unbatchedNodes.at(0));
+            }
+            if (frame == 15)
+            {
+                auto targets = fixture.batched->pauseAllRunningActions();
+                CHECK(targets.size() == 2);
+                fixture.unbatched->pauseAllRunningActions();
+            }
+            if (frame == 20)
+            {
+                fixture.batched->resumeTargets(fixture.batchedNodes);
+                fixture.unbatched->resumeTargets(fixture.unbatchedNodes);
+            }
+            fixture.update(1.0f / 30);
+            fixture.checkNodes();
+        }
+
+        auto action = static_cast<ActionInterval*>(fixture.batched->getActionByTag(1, fixture.batchedNodes.at(0)));
+        CHECK(action->getElapsed() == doctest::Approx(19.0f / 30));
+    }
+
+    TEST_CASE("removed") {
+        BatchFixture fixture;
+        fixture.run(0, [] { return tagged(MoveBy::create(1, Vec2(60, 0))); });
+        fixture.run(1, [] { return ScaleTo::create(1, 2); });
+
+        for (int frame = 0; frame < 10; ++frame)
+            fixture.update(0.05f);
+
+        auto node   = fixture.batchedNodes.at(0);
+        auto action = static_cast<MoveBy*>(fixture.batched->getActionByTag(1, node));
+        action->retain();
+        fixture.batched->removeAction(action);
+        fixture.unbatched->removeAllActionsFromTarget(fixture.unbatchedNodes.at(0));
+        CHECK(action->getElapsed() == doctest::Approx(0.45f));
+        CHECK(node->getPosition().x == doctest::Approx(27.0f));
+
+        // the moves stacked on the removed one are kept
+        node->setPositionY(40);
+        action->startWithTarget(node);
+        action->step(0);
+        action->step(0.5f);
+        CHECK(node->getPosition().x == doctest::Approx(57.0f));
+        CHECK(node->getPosition().y == doctest::Approx(40.0f));
+        action->release();
+
+        fixture.batched->setBatchingEnabled(false);
+        CHECK(fixture.batched->getNumberOfRunningActions() == 1);
+        fixture.update(0.05f);
+        CHECK(fixture.batchedNodes.at(1)->getScale() == fixture.unbatchedNodes.at(1)->getScale());
+        fixture.batched->removeAllActionsFromTarget(fixture.batchedNodes.at(1));
+        CHECK(fixture.batched->getNumberOfRunningActions() == 0);
+    }
+
+    TEST_CASE("removed_by_node") {
+        // a node which stops its actions once it's set to half its opacity
+        class FadingNode : public Node
+        {
+        public:
+            void setOpacity(uint8_t opacity) override
+            {
+                Node::setOpacity(opacity);
+                if (opacity <= 128)
+                    getActionManager()->removeAllActionsFromTarget(this);
+            }
+
+        };
+
+        auto manager = new ActionManager();
+        Vector<Node*> nodes;
+        int references = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            auto node = new FadingNode();
+            node->init();
+            node->autorelease();
+            node->setActionManager(manager);
+            nodes.pushBack(node);
+            references = node->getReferenceCount();
+            manager->addAction(FadeOut::create(0.5f + i * 0.1f), node, false);
+            manager->addAction(MoveBy::create(2, Vec2(10, 10)), node, false);
+        }
+
+        for (int frame = 0; frame < 60; ++frame)
+            manager->update(1.0f / 60);
+
+        for (auto node : nodes)
+        {
+            CHECK(node->getOpacity() <= 128);
+            CHECK(node->getOpacity() > 100);
+            CHECK(manager->getNumberOfRunningActionsInTarget(node) == 0);
+            CHECK(node->getReferenceCount() == references);
+        }
+        manager->release();
+    }
+}
@@ -0,0 +1,398 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "2d/FontAtlas.h"
+#include "2d/FontFreeType.h"
+#include "2d/FontPrebaked.h"
+#include "base/Director.h"
+#include "base/JobSystem.h"
+#include "base/Utils.h"
+#include "base/ZipUtils.h"
+#include "platform/FileUtils.h"
+#include "renderer/UploadQueue.h"
+
+#include <atomic>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+USING_NS_AX;
+using namespace std::string_view_literals;
+
+namespace
+{
+// "Boxes" has the letters A to L only, each a 400 units wide box 40 units taller than the previous letter, with an
+// advance of 600 units. Built with the FontBuilder of fontTools.
+const uint8_t BOXES_TTF[] = {
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x80, 0x00, 0x03, 0x00, 0x20, 0x4f, 0x53, 0x2f, 0x32,
+    0x45, 0x21, 0x44, 0x40, 0x00, 0x00, 0x01, 0x28, 0x00, 0x00, 0x00, 0x60, 0x63, 0x6d, 0x61, 0x70,
+    0x00, 0x0c, 0x00, 0x9f, 0x00, 0x00, 0x01, 0xa4, 0x00, 0x00, 0x00, 0x34, 0x67, 0x6c, 0x79, 0x66,
+    0xc1, 0xa8, 0xe2, 0x8e, 0x00, 0x00, 0x01, 0xf4, 0x00, 0x00, 0x01, 0x38, 0x68, 0x65, 0x61, 0x64,
+    0x2f, 0x62, 0xcb, 0x60, 0x00, 0x00, 0x00, 0xac, 0x00, 0x00, 0x00, 0x36, 0x68, 0x68, 0x65, 0x61,
+    0x05, 0x7a, 0x01, 0xf6, 0x00, 0x00, 0x00, 0xe4, 0x00, 0x00, 0x00, 0x24, 0x68, 0x6d, 0x74, 0x78,
+    0x04, 0xb0, 0x02, 0x58, 0x00, 0x00, 0x01, 0x88, 0x00, 0x00, 0x00, 0x1c, 0x6c, 0x6f, 0x63, 0x61,
+    0x01, 0xd4, 0x02, 0x22, 0x00, 0x00, 0x01, 0xd8, 0x00, 0x00, 0x00, 0x1c, 0x6d, 0x61, 0x78, 0x70,
+    0x00, 0x0f, 0x00, 0x06, 0x00, 0x00, 0x01, 0x08, 0x00, 0x00, 0x00, 0x20, 0x6e, 0x61, 0x6d, 0x65,
+    0x42, 0x0f, 0x35, 0xd7, 0x00, 0x00, 0x03, 0x2c, 0x00, 0x00, 0x00, 0x5a, 0x70, 0x6f, 0x73, 0x74,
+    0x01, 0x05, 0x00, 0xfc, 0x00, 0x00, 0x03, 0x88, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x01, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x9a, 0xe4, 0x38, 0x7f, 0x5f, 0x0f, 0x3c, 0xf5, 0x00, 0x03, 0x03, 0xe8,
+    0x00, 0x00, 0x00, 0x00, 0xe6, 0xfa, 0x43, 0xba, 0x00, 0x00, 0x00, 0x00, 0xe6, 0xfa, 0x43, 0xba,
+    0x00, 0x64, 0x00, 0x00, 0x01, 0xf4, 0x03, 0x0c, 0x00, 0x00, 0x00, 0x03, 0x00, 0x02, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x03, 0x20, 0xff, 0x38, 0x00, 0x00, 0x02, 0x58,
+    0x00, 0x64, 0x00, 0x64, 0x01, 0xf4, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x04,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x02, 0x58, 0x01, 0x90, 0x00, 0x05,
+    0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x3f, 0x3f, 0x3f, 0x3f, 0x00, 0x00, 0x00, 0x41, 0x00, 0x4c, 0x03, 0x20, 0xff, 0x38,
+    0x00, 0x00, 0x03, 0x20, 0x00, 0xc8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x02, 0x58, 0x00, 0x00, 0x00, 0x64, 0x00, 0x64,
+    0x00, 0x64, 0x00, 0x64, 0x00, 0x64, 0x00, 0x64, 0x00, 0x64, 0x00, 0x64, 0x00, 0x64, 0x00, 0x64,
+    0x00, 0x64, 0x00, 0x64, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x14,
+    0x00, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x14, 0x00, 0x04, 0x00, 0x20, 0x00, 0x00, 0x00, 0x04,
+    0x00, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x4c, 0xff, 0xff, 0x00, 0x00, 0x00, 0x41, 0xff, 0xff,
+    0xff, 0xc0, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x1a,
+    0x00, 0x27, 0x00, 0x34, 0x00, 0x41, 0x00, 0x4e, 0x00, 0x5b, 0x00, 0x68, 0x00, 0x75, 0x00, 0x82,
+    0x00, 0x8f, 0x00, 0x9c, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xf4, 0x01, 0x54, 0x00, 0x03,
+    0x00, 0x00, 0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x01, 0x54, 0xfe, 0xac, 0x00, 0x00, 0x01,
+    0x00, 0x64, 0x00, 0x00, 0x01, 0xf4, 0x01, 0x7c, 0x00, 0x03, 0x00, 0x00, 0x33, 0x11, 0x21, 0x11,
+    0x64, 0x01, 0x90, 0x01, 0x7c, 0xfe, 0x84, 0x00, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xf4,
+    0x01, 0xa4, 0x00, 0x03, 0x00, 0x00, 0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x01, 0xa4, 0xfe,
+    0x5c, 0x00, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xf4, 0x01, 0xcc, 0x00, 0x03, 0x00, 0x00,
+    0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x01, 0xcc, 0xfe, 0x34, 0x00, 0x00, 0x01, 0x00, 0x64,
+    0x00, 0x00, 0x01, 0xf4, 0x01, 0xf4, 0x00, 0x03, 0x00, 0x00, 0x33, 0x11, 0x21, 0x11, 0x64, 0x01,
+    0x90, 0x01, 0xf4, 0xfe, 0x0c, 0x00, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xf4, 0x02, 0x1c,
+    0x00, 0x03, 0x00, 0x00, 0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x02, 0x1c, 0xfd, 0xe4, 0x00,
+    0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xf4, 0x02, 0x44, 0x00, 0x03, 0x00, 0x00, 0x33, 0x11,
+    0x21, 0x11, 0x64, 0x01, 0x90, 0x02, 0x44, 0xfd, 0xbc, 0x00, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00,
+    0x01, 0xf4, 0x02, 0x6c, 0x00, 0x03, 0x00, 0x00, 0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x02,
+    0x6c, 0xfd, 0x94, 0x00, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xf4, 0x02, 0x94, 0x00, 0x03,
+    0x00, 0x00, 0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x02, 0x94, 0xfd, 0x6c, 0x00, 0x00, 0x01,
+    0x00, 0x64, 0x00, 0x00, 0x01, 0xf4, 0x02, 0xbc, 0x00, 0x03, 0x00, 0x00, 0x33, 0x11, 0x21, 0x11,
+    0x64, 0x01, 0x90, 0x02, 0xbc, 0xfd, 0x44, 0x00, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xf4,
+    0x02, 0xe4, 0x00, 0x03, 0x00, 0x00, 0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x02, 0xe4, 0xfd,
+    0x1c, 0x00, 0x00, 0x01, 0x00, 0x64, 0x00, 0x00, 0x01, 0xf4, 0x03, 0x0c, 0x00, 0x03, 0x00, 0x00,
+    0x33, 0x11, 0x21, 0x11, 0x64, 0x01, 0x90, 0x03, 0x0c, 0xfc, 0xf4, 0x00, 0x00, 0x00, 0x00, 0x04,
+    0x00, 0x36, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x05, 0x00, 0x00, 0x00, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x07, 0x00, 0x05, 0x00, 0x03, 0x00, 0x01, 0x04, 0x09,
+    0x00, 0x01, 0x00, 0x0a, 0x00, 0x0c, 0x00, 0x03, 0x00, 0x01, 0x04, 0x09, 0x00, 0x02, 0x00, 0x0e,
+    0x00, 0x16, 0x42, 0x6f, 0x78, 0x65, 0x73, 0x52, 0x65, 0x67, 0x75, 0x6c, 0x61, 0x72, 0x00, 0x42,
+    0x00, 0x6f, 0x00, 0x78, 0x00, 0x65, 0x00, 0x73, 0x00, 0x52, 0x00, 0x65, 0x00, 0x67, 0x00, 0x75,
+    0x00, 0x6c, 0x00, 0x61, 0x00, 0x72, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x24, 0x00, 0x25,
+    0x00, 0x26, 0x00, 0x27, 0x00, 0x28, 0x00, 0x29, 0x00, 0x2a, 0x00, 0x2b, 0x00, 0x2c, 0x00, 0x2d,
+    0x00, 0x2e, 0x00, 0x2f,
+};
+
+FontFreeType* createFont(float outline = 0.0f)
+{
+    auto fu   = FileUtils::getInstance();
+    auto path = fu->getWritablePath() + "font_atlas_test.ttf";
+    if (!fu->isFileExist(path))
+    {
+        Data data;
+        data.copy(BOXES_TTF, sizeof(BOXES_TTF));
+        fu->writeDataToFile(data, path);
+    }
+    return FontFreeType::create(path, 24, GlyphCollection::DYNAMIC, ""sv, false, outline);
+}
+
+std::vector<unsigned int> getGlyphIndices(FontFreeType* font, std::u32string_view text)
+{
+    std::vector<unsigned int> glyphIndices;
+    for (auto charCode : text)
+        glyphIndices.emplace_back(font->getCharIndex(charCode));
+    return glyphIndices;
+}
+
+// keeps the pages in memory only, there is no render device for their textures
+class TestAtlas : public FontAtlas
+{
+public:
+    explicit TestAtlas(Font* font, int size = 256) : FontAtlas(font, size, size, 1.0f) { reinit(); }
+
+    using FontAtlas::insertRasterizedLetters;
+    using FontAtlas::_currentPageData;
+    using FontAtlas::_width;
+    using FontAtlas::_dirtyStartX;
+    using FontAtlas::_dirtyStartY;
+    using FontAtlas::_dirtyEndX;
+    using FontAtlas::_dirtyEndY;
+    using FontAtlas::_uploadQueued;
+
+    void addNewPage() override
+    {
+        flushTextureContent();
+        memset(_currentPageData, 0, _currentPageDataSize);
+        ++_currentPage;
+        _pagePacker.reset(_width, _height);
+    }
+
+    // the quad of the letter is within the rect waiting for the upload and has its pixels on the page
+    void checkUploaded(char32_t charCode)
+    {
+        INFO("char ", static_cast<uint32_t>(charCode));
+        FontLetterDefinition letterDefinition;
+        REQUIRE(getLetterDefinitionForChar(charCode, letterDefinition));
+        REQUIRE_GT(letterDefinition.width, 0.0f);
+
+        const int x      = static_cast<int>(letterDefinition.U);
+        const int y      = static_cast<int>(letterDefinition.V);
+        const int width  = static_cast<int>(letterDefinition.width);
+        const int height = static_cast<int>(letterDefinition.height);
+        CHECK_LE(_dirtyStartX, x);
+        CHECK_LE(_dirtyStartY, y);
+        CHECK_LE(x + width, _dirtyEndX);
+        CHECK_LE(y + height, _dirtyEndY);
+
+        bool covered = false;
+        for (int row = y; row < y + height && !covered; ++row)
+            for (int column = x; column < x + width && !covered; ++column)
+                covered = _currentPageData[row * _width + column] != 0;
+        CHECK(covered);
+    }
+};
+}  // namespace
+
+TEST_SUITE("2d/FontAtlas") {
+    TEST_CASE("worker_pool") {
+        for (float outline : {0.0f, 1.0f}) {
+            INFO("outline ", outline);
+            auto font = createFont(outline);
+            REQUIRE(font != nullptr);
+            REQUIRE(font->isConcurrentRasterizationSupported());
+
+            // the workers render on faces of their own, the result must match the main face
+            auto glyphIndices = getGlyphIndices(font, U"ABCDEFGHIJKL");
+            std::vector<FontFreeType::GlyphBitmap> glyphs(glyphIndices.size());
+            std::atomic<int> failures{0};
+            JobSystem jobSystem(4);
+            jobSystem.parallel_for(0, glyphIndices.size(), 1, [&](size_t first, size_t last) {
+                for (auto i = first; i < last; ++i)
+                    if (!font->rasterizeGlyph(glyphIndices[i], glyphs[i]))
+                        ++failures;
+            });
+            CHECK_EQ(failures.load(), 0);
+
+            const size_t bytesPerPixel = outline > 0 ? 2 : 1;
+            for (size_t i = 0; i < glyphs.size(); ++i) {
+                FontFreeType::GlyphBitmap expected;
+                font->renderGlyphBitmap(glyphIndices[i], expected);
+                CHECK(glyphs[i].rendered);
+                CHECK_GT(glyphs[i].width, 0);
+                CHECK_EQ(glyphs[i].width, expected.width);
+                CHECK_EQ(glyphs[i].height, expected.height);
+                CHECK_EQ(glyphs[i].xAdvance, expected.xAdvance);
+                CHECK_EQ(glyphs[i].pixels.size(), glyphs[i].width * glyphs[i].height * bytesPerPixel);
+                CHECK(glyphs[i].pixels == expected.pixels);
+                if (i > 0)
+                    CHECK_GE(glyphs[i].height, glyphs[i - 1].height);
+            }
+        }
+    }
+
+    TEST_CASE("unrendered_glyphs") {
+        auto font = createFont();
+        REQUIRE(font != nullptr);
+        TestAtlas atlas(font);
+
+        // as left by workers which couldn't open a face, they're rendered with the main face
+        std::vector<char32_t> charCodes{U'A', U'B'};
+        auto glyphIndices = getGlyphIndices(font, U"AB");
+        std::vector<FontFreeType::GlyphBitmap> glyphs(charCodes.size());
+        atlas.insertRasterizedLetters(charCodes, glyphIndices, glyphs);
+
+        for (size_t i = 0; i < charCodes.size(); ++i) {
+            FontFreeType::GlyphBitmap expected;
+            font->renderGlyphBitmap(glyphIndices[i], expected);
+            CHECK(glyphs[i].rendered);
+            atlas.checkUploaded(charCodes[i]);
+
+            FontLetterDefinition letterDefinition;
+            REQUIRE(atlas.getLetterDefinitionForChar(charCodes[i], letterDefinition));
+            CHECK_EQ(letterDefinition.xAdvance, expected.xAdvance);
+        }
+    }
+
+    TEST_CASE("glyph_bigger_than_the_page") {
+        for (float outline : {0.0f, 1.0f}) {
+            INFO("outline ", outline);
+            auto font = createFont(outline);
+            REQUIRE(font != nullptr);
+            TestAtlas atlas(font, 16);
+
+            // laid out as a space, the bitmap of a plain glyph belongs to FreeType and must not be freed
+            atlas.prepareLetterDefinitions(U"L");
+            FontLetterDefinition letterDefinition;
+            REQUIRE(atlas.getLetterDefinitionForChar(U'L', letterDefinition));
+            CHECK_EQ(letterDefinition.width, 0.0f);
+            CHECK_GT(letterDefinition.xAdvance, 0);
+        }
+    }
+
+    TEST_CASE("restored_atlas") {
+        auto font = createFont();
+        REQUIRE(font != nullptr);
+
+        // two empty 64x64 pages, the top 20 rows of the last one are used
+        std::vector<uint8_t> page(64 * 64, 0);
+        auto compressed = ZipUtils::compressGZ(std::span{page});
+        auto pageData   = utils::base64Encode(std::span{compressed});
+        auto fu         = FileUtils::getInstance();
+        std::string settings = R"({"type": "fontatlas", "atlasName": "restored", "sourceFont": ")" +
+                               fu->getWritablePath() + R"(font_atlas_test.ttf", "faceSize": 24, "atlasDim": [64, 64],
+            "pages": [")" + pageData + R"(", ")" + pageData + R"("], "skyline": [0, 20, 64], "letters": {}})";
+        auto path = fu->getWritablePath() + "font_atlas_test.fontatlas";
+        REQUIRE(fu->writeStringToFile(settings, path));
+
+        hlookup::string_map<FontAtlas*> atlases;
+        FontAtlas::loadFontAtlas(path, atlases);
+        REQUIRE(atlases.size() == 1);
+        auto atlas = atlases.begin()->second;
+        CHECK(atlas->getPagePacker().getWidth() == 64);
+        CHECK(atlas->getPagePacker().getHeight() == 64);
+
+        // the next letter goes under the restored skyline, not on a new page
+        atlas->prepareLetterDefinitions(U"A");
+        FontLetterDefinition letterDefinition;
+        REQUIRE(atlas->getLetterDefinitionForChar(U'A', letterDefinition));
+        CHECK_GT(letterDefinition.width, 0.0f);
+        CHECK_EQ(letterDefinition.textureID, 1);
+        CHECK_EQ(atlas->getTextures().size(), 2);
+        CHECK_GT(atlas->getPagePacker().getMaxHeight(), 20);
+        atlas->release();
+    }
+
+    TEST_CASE("prebaked_atlas") {
+        REQUIRE(createFont() != nullptr);
+
+        // two empty 64x64 pages, the top 20 rows of the last one are used, the letters not baked come from the ttf
+        FontPrebaked::Contents contents;
+        contents.atlasName        = "prebaked";
+        contents.sourceFont       = FileUtils::getInstance()->getWritablePath() + "font_atlas_test.ttf";
+        contents.atlasWidth       = 64;
+        contents.atlasHeight      = 64;
+        contents.faceSize         = 24;
+        contents.lineHeight       = 27.0f;
+        contents.fontMaxHeight    = 27;
+        contents.fontAscender     = 22;
+        contents.letterEdgeExtend = 2;
+        contents.letters.push_back({U'B', 0, 0, 9, 12, 0, 3, 1, 11, 1});
+        contents.skyline.push_back({0, 20, 64});
+        for (int page = 0; page < 2; ++page)
+            contents.pages.emplace_back(64 * 64, 0);
+        auto data = std::make_shared<std::vector<uint8_t>>(FontPrebaked::encode(contents));
+        auto font = FontPrebaked::createWithFileView(FileView(data, data->data(), data->size(), false));
+        REQUIRE(font != nullptr);
+
+        auto atlas = font->newFontAtlas();
+        CHECK(atlas->getPagePacker().getWidth() == 64);
+        CHECK(atlas->getPagePacker().getHeight() == 64);
+
+        atlas->prepareLetterDefinitions(U"A");
+        FontLetterDefinition letterDefinition;
+        REQUIRE(atlas->getLetterDefinitionForChar(U'A', letterDefinition));
+        CHECK_GT(letterDefinition.width, 0.0f);
+        CHECK_EQ(letterDefinition.textureID, 1);
+        CHECK_EQ(atlas->getTextures().size(), 2);
+        CHECK_GT(atlas->getPagePacker().getMaxHeight(), 20);
+        atlas->release();
+    }
+
+    TEST_CASE("placeholders") {
+        auto jobSystem = Director::getInstance()->getJobSystem();
+        if (jobSystem->getWorkerCount() == 0) {
+            MESSAGE("the JobSystem has no workers, glyphs are never rasterized asynchronously");
+            return;
+        }
+
+        auto font = createFont();
+        REQUIRE(font != nullptr);
+        TestAtlas atlas(font);
+
+        FontAtlas::setAsyncGlyphRasterizationEnabled(true);
+        atlas.prepareLetterDefinitions(U"ABC");
+        FontAtlas::setAsyncGlyphRasterizationEnabled(false);
+        auto generation = atlas.getGlyphGeneration();
+
+        // laid out with the final advance, nothing to draw yet
+        CHECK(atlas.hasPendingGlyphs());
+        auto glyphIndices = getGlyphIndices(font, U"ABC");
+        for (size_t i = 0; i < glyphIndices.size(); ++i) {
+            FontLetterDefinition letterDefinition;
+            REQUIRE(atlas.getLetterDefinitionForChar(static_cast<char32_t>(U'A' + i), letterDefinition));
+            CHECK_EQ(letterDefinition.width, 0.0f);
+            CHECK_EQ(letterDefinition.xAdvance, font->getGlyphAdvance(glyphIndices[i]));
+        }
+
+        atlas.waitForPendingGlyphs();
+        CHECK_FALSE(atlas.hasPendingGlyphs());
+        CHECK_NE(atlas.getGlyphGeneration(), generation);
+        for (size_t i = 0; i < glyphIndices.size(); ++i) {
+            atlas.checkUploaded(static_cast<char32_t>(U'A' + i));
+
+            FontLetterDefinition letterDefinition;
+            REQUIRE(atlas.getLetterDefinitionForChar(static_cast<char32_t>(U'A' + i), letterDefinition));
+            CHECK_EQ(letterDefinition.xAdvance, font->getGlyphAdvance(glyphIndices[i]));
+        }
+    }
+
+    TEST_CASE("dirty_rect_upload") {
+        auto uploadQueue = Director::getInstance()->getUploadQueue();
+        auto font        = createFont();
+        REQUIRE(font != nullptr);
+        TestAtlas atlas(font);
+
+        const auto queueDepth   = uploadQueue->getQueueDepth();
+        const auto pendingBytes = uploadQueue->getPendingBytes();
+        atlas.prepareLetterDefinitions(U"AB");
+        REQUIRE(atlas._uploadQueued);
+        CHECK_EQ(uploadQueue->getQueueDepth(), queueDepth + 1);
+
+        // only the rect around the new glyphs is uploaded, its rows start 4 pixels aligned
+        const int width  = atlas._dirtyEndX - atlas._dirtyStartX;
+        const int height = atlas._dirtyEndY - atlas._dirtyStartY;
+        CHECK_LT(width, atlas._width);
+        CHECK_EQ(uploadQueue->getPendingBytes() - pendingBytes, static_cast<size_t>(width * height));
+        CHECK_EQ(atlas._dirtyStartX % 4, 0);
+        CHECK((atlas._dirtyEndX % 4 == 0 || atlas._dirtyEndX == atlas._width));
+        atlas.checkUploaded(U'A');
+        atlas.checkUploaded(U'B');
+
+        // the glyphs of the same frame join the queued upload
+        atlas.prepareLetterDefinitions(U"CD");
+        CHECK_EQ(uploadQueue->getQueueDepth(), queueDepth + 1);
+        for (char32_t charCode : U"ABCD"sv)
+            atlas.checkUploaded(charCode);
+
+        uploadQueue->flush(&atlas);
+        CHECK_FALSE(atlas._uploadQueued);
+        CHECK_EQ(uploadQueue->getQueueDepth(), queueDepth);
+        CHECK_GE(atlas._dirtyStartY, atlas._dirtyEndY);
+    }
+}
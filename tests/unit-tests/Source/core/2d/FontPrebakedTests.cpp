@@ -0,0 +1,156 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "2d/FontPrebaked.h"
+
+#include <memory>
+#include <vector>
+
+USING_NS_AX;
+
+namespace
+{
+FontPrebaked::Contents makeContents()
+{
+    FontPrebaked::Contents contents;
+    contents.atlasName        = "24 0 fonts/arial.ttf";
+    contents.sourceFont       = "fonts/arial.ttf";
+    contents.atlasWidth       = 32;
+    contents.atlasHeight      = 16;
+    contents.bytesPerPixel    = 1;
+    contents.faceSize         = 24;
+    contents.lineHeight       = 27.0f;
+    contents.fontMaxHeight    = 27;
+    contents.fontAscender     = 22;
+    contents.letterEdgeExtend = 2;
+    // unsorted on purpose
+    contents.letters.push_back({U'B', 10, 0, 9, 12, 1, 3, 1, 11, 1});
+    contents.letters.push_back({U'A', 0, 0, 9, 12, 0, 3, 0, 10, 1});
+    contents.letters.push_back({U' ', 0, 0, 0, 0, 0, 0, 0, 6, 1});
+    contents.kernings.push_back({U'V', U'A', -2});
+    contents.kernings.push_back({U'A', U'V', -3});
+    contents.skyline.push_back({0, 13, 20});
+    contents.skyline.push_back({20, 0, 12});
+    for (int page = 0; page < 2; ++page)
+        contents.pages.emplace_back(32 * 16, static_cast<uint8_t>(page + 1));
+    return contents;
+}
+
+FileView makeView(std::vector<uint8_t> data)
+{
+    auto holder = std::make_shared<std::vector<uint8_t>>(std::move(data));
+    return FileView(holder, holder->data(), holder->size(), false);
+}
+}  // namespace
+
+TEST_SUITE("2d/FontPrebaked") {
+    TEST_CASE("round_trip") {
+        auto font = FontPrebaked::createWithFileView(makeView(FontPrebaked::encode(makeContents())));
+        REQUIRE(font != nullptr);
+
+        auto& header = font->getHeader();
+        CHECK(header.atlasWidth == 32);
+        CHECK(header.atlasHeight == 16);
+        CHECK(header.pagesOffset % 16 == 0);
+        CHECK(font->getAtlasName() == "24 0 fonts/arial.ttf");
+        CHECK(font->getSourceFontName() == "fonts/arial.ttf");
+        CHECK(font->getFontMaxHeight() == 27);
+        CHECK_FALSE(font->isSourceFontOpen());
+
+        REQUIRE(font->getLetters().size() == 3);
+        CHECK(font->getLetters()[0].charCode == U' ');
+        CHECK(font->getLetters()[2].charCode == U'B');
+        auto letter = font->findLetter(U'B');
+        REQUIRE(letter != nullptr);
+        CHECK(letter->U == 10.0f);
+        CHECK(letter->page == 1);
+        CHECK(letter->xAdvance == 11);
+        CHECK(font->findLetter(U'C') == nullptr);
+
+        CHECK(font->getSkyline().size() == 2);
+        CHECK(font->getSkyline()[1].x == 20);
+
+        REQUIRE(font->getPageCount() == 2);
+        CHECK(font->getPageSize() == 32 * 16);
+        CHECK(font->getPageData(0)[0] == 1);
+        CHECK(font->getPageData(1)[32 * 16 - 1] == 2);
+    }
+
+    TEST_CASE("kerning") {
+        auto font = FontPrebaked::createWithFileView(makeView(FontPrebaked::encode(makeContents())));
+        REQUIRE(font != nullptr);
+
+        CHECK(font->getKerning(U'A', U'V') == -3);
+        CHECK(font->getKerning(U'V', U'A') == -2);
+        CHECK(font->getKerning(U'A', U'A') == 0);
+
+        int count = 0;
+        std::unique_ptr<int[]> sizes(font->getHorizontalKerningForTextUTF32(U"AVA", count));
+        REQUIRE(count == 3);
+        CHECK(sizes[0] == 0);
+        CHECK(sizes[1] == -3);
+        CHECK(sizes[2] == -2);
+    }
+
+    TEST_CASE("rejects_corrupted_files") {
+        auto data = FontPrebaked::encode(makeContents());
+
+        auto truncated = data;
+        truncated.resize(truncated.size() - 1);
+        CHECK(FontPrebaked::createWithFileView(makeView(truncated)) == nullptr);
+
+        auto badMagic = data;
+        badMagic[0]   = 'X';
+        CHECK(FontPrebaked::createWithFileView(makeView(badMagic)) == nullptr);
+
+        CHECK(FontPrebaked::createWithFileView(makeView({})) == nullptr);
+    }
+
+    TEST_CASE("rejects_letters_and_skyline_outside_the_pages") {
+        auto contents = makeContents();
+        contents.letters[0].page = 2;
+        CHECK(FontPrebaked::createWithFileView(makeView(FontPrebaked::encode(contents))) == nullptr);
+
+        contents = makeContents();
+        contents.letters[0].page = -1;
+        CHECK(FontPrebaked::createWithFileView(makeView(FontPrebaked::encode(contents))) == nullptr);
+
+        contents = makeContents();
+        contents.skyline[1].width = 13;
+        CHECK(FontPrebaked::createWithFileView(makeView(FontPrebaked::encode(contents))) == nullptr);
+
+        contents = makeContents();
+        contents.skyline[1].x = 21;
+        CHECK(FontPrebaked::createWithFileView(makeView(FontPrebaked::encode(contents))) == nullptr);
+
+        contents = makeContents();
+        contents.skyline[0].y = 17;
+        CHECK(FontPrebaked::createWithFileView(makeView(FontPrebaked::encode(contents))) == nullptr);
+
+        contents = makeContents();
+        contents.skyline.clear();
+        CHECK(FontPrebaked::createWithFileView(makeView(FontPrebaked::encode(contents))) == nullptr);
+    }
+}
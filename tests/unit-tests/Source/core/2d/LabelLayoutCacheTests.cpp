@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "2d/LabelLayoutCache.h"
+
+USING_NS_AX;
+
+namespace
+{
+LabelLayoutCache::Layout makeLayout(int lines)
+{
+    LabelLayoutCache::Layout layout;
+    layout.numberOfLines = lines;
+    layout.linesWidth.assign(lines, 10.0f);
+    return layout;
+}
+}  // namespace
+
+TEST_SUITE("2d/LabelLayoutCache") {
+    TEST_CASE("hit_and_miss") {
+        LabelLayoutCache cache;
+        std::u32string text = U"Score: 100";
+
+        LabelLayoutCache::Key key;
+        key.text       = text;
+        key.lineHeight = 20.0f;
+        CHECK(cache.find(key) == nullptr);
+        cache.insert(key, makeLayout(1));
+
+        // the key's text is copied, a different buffer with the same text hits
+        std::u32string sameText = U"Score: 100";
+        key.text                = sameText;
+        auto layout             = cache.find(key);
+        REQUIRE(layout != nullptr);
+        CHECK(layout->numberOfLines == 1);
+
+        // every field is a part of the key
+        key.maxLineWidth = 50.0f;
+        CHECK(cache.find(key) == nullptr);
+        key.maxLineWidth    = 0.0f;
+        key.glyphGeneration = 1;
+        CHECK(cache.find(key) == nullptr);
+        key.glyphGeneration = 0;
+        key.text            = U"Score: 101";
+        CHECK(cache.find(key) == nullptr);
+
+        auto stats = cache.getStats();
+        CHECK(stats.hits == 1);
+        CHECK(stats.misses == 4);
+        CHECK(stats.entries == 1);
+    }
+
+    TEST_CASE("lru_eviction") {
+        LabelLayoutCache cache;
+        cache.setCapacity(2);
+
+        std::u32string texts[] = {U"a", U"b", U"c"};
+        LabelLayoutCache::Key keys[3];
+        for (int i = 0; i < 3; ++i)
+            keys[i].text = texts[i];
+
+        cache.insert(keys[0], makeLayout(1));
+        cache.insert(keys[1], makeLayout(2));
+        CHECK(cache.find(keys[0]) != nullptr);  // b is the least recently used now
+        cache.insert(keys[2], makeLayout(3));
+
+        CHECK(cache.find(keys[0]) != nullptr);
+        CHECK(cache.find(keys[1]) == nullptr);
+        CHECK(cache.find(keys[2])->numberOfLines == 3);
+        CHECK(cache.getStats().evictions == 1);
+
+        // an insert of a cached key replaces its layout
+        cache.insert(keys[0], makeLayout(4));
+        CHECK(cache.find(keys[0])->numberOfLines == 4);
+        CHECK(cache.getStats().entries == 2);
+
+        cache.setCapacity(0);
+        CHECK(cache.getStats().entries == 0);
+        cache.insert(keys[0], makeLayout(1));
+        CHECK(cache.find(keys[0]) == nullptr);
+    }
+}
@@ -0,0 +1,128 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include <doctest.h>
+#include "2d/Node.h"
+#include "base/Director.h"
+#include "base/JobSystem.h"
+#include "renderer/Renderer.h"
+#include "renderer/CustomCommand.h"
+
+#include <vector>
+
+USING_NS_AX;
+
+namespace
+{
+class TestRenderer : public Renderer
+{
+public:
+    // takes the commands of the default render queue, sorted or in the order they were added
+    std::vector<RenderCommand*> takeCommands(bool sorted)
+    {
+        auto& queue = _renderGroups[0];
+        if (sorted)
+            queue.sort();
+
+        std::vector<RenderCommand*> commands;
+        for (ssize_t i = 0; i < queue.size(); ++i)
+            commands.push_back(queue[i]);
+        queue.clear();
+        return commands;
+    }
+};
+
+// draws one command, each node owns its command so the commands identify the nodes
+class CommandNode : public Node
+{
+public:
+    static CommandNode* create(int localZOrder, float globalZOrder)
+    {
+        auto node = new CommandNode();
+        node->init();
+        node->autorelease();
+        node->setLocalZOrder(localZOrder);
+        node->setGlobalZOrder(globalZOrder);
+        return node;
+    }
+
+    void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override
+    {
+        _command.init(_globalZOrder, transform, flags);
+        renderer->addCommand(&_command);
+    }
+
+private:
+    CustomCommand _command;
+};
+
+// a parent drawing between its children, some of them with children of their own
+Node* createTree(int childCount)
+{
+    auto root = CommandNode::create(0, 0.0f);
+    for (int i = 0; i < childCount; ++i)
+    {
+        auto child = CommandNode::create(i % 7 - 3, static_cast<float>(i % 5 - 2));
+        for (int j = 0; j < i % 3; ++j)
+            child->addChild(CommandNode::create(j - 1, 0.0f));
+        root->addChild(child);
+    }
+    return root;
+}
+
+std::vector<RenderCommand*> visit(Node* root, TestRenderer& renderer, bool concurrent, bool sorted)
+{
+    root->setConcurrentVisitEnabled(concurrent);
+    root->visit(&renderer, Mat4::IDENTITY, 0);
+    return renderer.takeCommands(sorted);
+}
+}  // namespace
+
+TEST_SUITE("2d/Node") {
+    TEST_CASE("concurrent_visit") {
+        if (Director::getInstance()->getJobSystem()->getWorkerCount() == 0)
+        {
+            MESSAGE("no JobSystem workers, the children are visited on this thread only");
+        }
+
+        TestRenderer renderer;
+        for (int childCount : {2, 5, 64, 300})
+        {
+            CAPTURE(childCount);
+            auto root = createTree(childCount);
+            root->retain();
+
+            auto serial = visit(root, renderer, false, false);
+            CHECK(serial.size() > static_cast<size_t>(childCount));
+
+            // the same commands in the same order, both as recorded and once sorted
+            for (int frame = 0; frame < 4; ++frame)
+                CHECK_EQ(visit(root, renderer, true, false), serial);
+            CHECK_EQ(visit(root, renderer, true, true), visit(root, renderer, false, true));
+
+            root->release();
+        }
+    }
+}
@@ -0,0 +1,370 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "2d/ParticleKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+USING_NS_AX;
+
+namespace
+{
+// not a multiple of four, so both the vectorized kernels and the plain loops run
+constexpr int COUNT = 37;
+
+std::vector<float> randomFloats(std::mt19937& rng, int count, float low, float high)
+{
+    std::uniform_real_distribution<float> dist(low, high);
+    std::vector<float> values(count);
+    for (auto& v : values)
+        v = dist(rng);
+    return values;
+}
+
+// the corners of a particle as ParticleSystemQuad computed them before the kernels
+void referenceQuad(V3F_C4B_T2F_Quad& quad, float x, float y, float size, float scale, float rotation)
+{
+    float half = size / 2 * scale;
+    float r    = -AX_DEGREES_TO_RADIANS(rotation);
+    float cr   = cosf(r);
+    float sr   = sinf(r);
+
+    quad.bl.vertices.x = -half * cr + half * sr + x;
+    quad.bl.vertices.y = -half * sr - half * cr + y;
+    quad.br.vertices.x = half * cr + half * sr + x;
+    quad.br.vertices.y = half * sr - half * cr + y;
+    quad.tr.vertices.x = half * cr - half * sr + x;
+    quad.tr.vertices.y = half * sr + half * cr + y;
+    quad.tl.vertices.x = -half * cr - half * sr + x;
+    quad.tl.vertices.y = -half * sr + half * cr + y;
+}
+
+uint8_t referenceByte(float value)
+{
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 255.0f));
+}
+
+struct Particles
+{
+    std::vector<float> posx, posy, startX, startY, dirX, dirY, radial, tangential;
+    std::vector<float> r, g, b, a, dr, dg, db, da, size, deltaSize, rotation, deltaRotation, staticRotation;
+    std::vector<V3F_C4B_T2F_Quad> quads;
+
+    Particles(int count)
+    {
+        std::mt19937 rng(7);
+        posx           = randomFloats(rng, count, -100, 100);
+        posy           = randomFloats(rng, count, -100, 100);
+        startX         = randomFloats(rng, count, -10, 10);
+        startY         = randomFloats(rng, count, -10, 10);
+        dirX           = randomFloats(rng, count, -50, 50);
+        dirY           = randomFloats(rng, count, -50, 50);
+        radial         = randomFloats(rng, count, -20, 20);
+        tangential     = randomFloats(rng, count, -20, 20);
+        r              = randomFloats(rng, count, 0, 1);
+        g              = randomFloats(rng, count, 0, 1);
+        b              = randomFloats(rng, count, 0, 1);
+        a              = randomFloats(rng, count, 0, 1);
+        dr             = randomFloats(rng, count, -0.1f, 0.1f);
+        dg             = randomFloats(rng, count, -0.1f, 0.1f);
+        db             = randomFloats(rng, count, -0.1f, 0.1f);
+        da             = randomFloats(rng, count, -0.1f, 0.1f);
+        size           = randomFloats(rng, count, 1, 64);
+        deltaSize      = randomFloats(rng, count, -10, 10);
+        rotation       = randomFloats(rng, count, -360, 360);
+        deltaRotation  = randomFloats(rng, count, -90, 90);
+        staticRotation = randomFloats(rng, count, -180, 180);
+        quads.resize(count);
+    }
+};
+
+// one update of the gravity mode particles with the plain loops the kernels replace
+void referenceUpdate(Particles& p, float dt)
+{
+    const int count = static_cast<int>(p.posx.size());
+    for (int i = 0; i < count; ++i)
+    {
+        float n = std::sqrt(p.posx[i] * p.posx[i] + p.posy[i] * p.posy[i]);
+        float nx = n > 0 ? p.posx[i] / n : 0;
+        float ny = n > 0 ? p.posy[i] / n : 0;
+        p.dirX[i] += (nx * p.radial[i] - ny * p.tangential[i]) * dt;
+        p.dirY[i] += (ny * p.radial[i] + nx * p.tangential[i] - 98) * dt;
+        p.posx[i] += p.dirX[i] * dt;
+        p.posy[i] += p.dirY[i] * dt;
+    }
+    for (int i = 0; i < count; ++i)
+        p.r[i] += p.dr[i] * dt;
+    for (int i = 0; i < count; ++i)
+        p.g[i] += p.dg[i] * dt;
+    for (int i = 0; i < count; ++i)
+        p.b[i] += p.db[i] * dt;
+    for (int i = 0; i < count; ++i)
+        p.a[i] += p.da[i] * dt;
+    for (int i = 0; i < count; ++i)
+        p.size[i] = std::max(0.0f, p.size[i] + p.deltaSize[i] * dt);
+    for (int i = 0; i < count; ++i)
+        p.rotation[i] += p.deltaRotation[i] * dt;
+    for (int i = 0; i < count; ++i)
+        referenceQuad(p.quads[i], p.posx[i] + p.startX[i], p.posy[i] + p.startY[i], p.size[i], 1.0f,
+                      p.rotation[i] + p.staticRotation[i]);
+    for (int i = 0; i < count; ++i)
+    {
+        Color4B color(referenceByte(p.r[i] * 255), referenceByte(p.g[i] * 255), referenceByte(p.b[i] * 255),
+                      referenceByte(p.a[i] * 255));
+        p.quads[i].bl.colors = p.quads[i].br.colors = p.quads[i].tl.colors = p.quads[i].tr.colors = color;
+    }
+}
+
+void kernelUpdate(Particles& p, float dt)
+{
+    const int count = static_cast<int>(p.posx.size());
+    ParticleKernels::integrateGravity(p.posx.data(), p.posy.data(), p.dirX.data(), p.dirY.data(), p.radial.data(),
+                                      p.tangential.data(), 0, -98, dt, 1, count);
+    ParticleKernels::addScaled(p.r.data(), p.dr.data(), dt, count);
+    ParticleKernels::addScaled(p.g.data(), p.dg.data(), dt, count);
+    ParticleKernels::addScaled(p.b.data(), p.db.data(), dt, count);
+    ParticleKernels::addScaled(p.a.data(), p.da.data(), dt, count);
+    ParticleKernels::addScaledNonNegative(p.size.data(), p.deltaSize.data(), dt, count);
+    ParticleKernels::addScaled(p.rotation.data(), p.deltaRotation.data(), dt, count);
+    ParticleKernels::updateQuadVertices(p.quads.data(), p.posx.data(), p.posy.data(), p.startX.data(),
+                                        p.startY.data(), {1, 0, 0, 1, 0, 0}, p.size.data(), nullptr,
+                                        p.rotation.data(), p.staticRotation.data(), count);
+    ParticleKernels::updateQuadColors(p.quads.data(), p.r.data(), p.g.data(), p.b.data(), p.a.data(), nullptr,
+                                      nullptr, false, count);
+}
+}  // namespace
+
+TEST_SUITE("2d/ParticleKernels") {
+    TEST_CASE("add") {
+        std::mt19937 rng(1);
+        auto base  = randomFloats(rng, COUNT, -5, 5);
+        auto delta = randomFloats(rng, COUNT, -5, 5);
+        auto limit = randomFloats(rng, COUNT, -5, 5);
+
+        auto values = base;
+        ParticleKernels::addScalar(values.data(), 0.25f, COUNT);
+        for (int i = 0; i < COUNT; ++i)
+            CHECK(values[i] == base[i] + 0.25f);
+
+        values = base;
+        ParticleKernels::addScalarClamped(values.data(), 0.25f, limit.data(), COUNT);
+        for (int i = 0; i < COUNT; ++i)
+            CHECK(values[i] == std::min(base[i] + 0.25f, limit[i]));
+
+        values = base;
+        ParticleKernels::addScaled(values.data(), delta.data(), 0.5f, COUNT);
+        for (int i = 0; i < COUNT; ++i)
+            CHECK(values[i] == base[i] + delta[i] * 0.5f);
+
+        values = base;
+        ParticleKernels::addScaledNonNegative(values.data(), delta.data(), 0.5f, COUNT);
+        for (int i = 0; i < COUNT; ++i)
+            CHECK(values[i] == std::max(base[i] + delta[i] * 0.5f, 0.0f));
+
+        // nothing to do is fine
+        ParticleKernels::addScalar(values.data(), 1.0f, 0);
+    }
+
+    TEST_CASE("find_dead") {
+        std::mt19937 rng(2);
+        std::vector<float> timeToLive(COUNT, 1.0f);
+        CHECK(ParticleKernels::findDead(timeToLive.data(), 0, COUNT) == COUNT);
+        CHECK(ParticleKernels::findDead(timeToLive.data(), COUNT, COUNT) == COUNT);
+
+        for (int round = 0; round < 50; ++round)
+        {
+            auto values = randomFloats(rng, COUNT, -0.2f, 1.0f);
+            values[rng() % COUNT] = 0.0f;
+            for (int start = 0; start <= COUNT; ++start)
+            {
+                int expected = start;
+                while (expected < COUNT && values[expected] > 0.0f)
+                    ++expected;
+                CHECK(ParticleKernels::findDead(values.data(), start, COUNT) == expected);
+            }
+        }
+    }
+
+    TEST_CASE("gravity") {
+        std::mt19937 rng(3);
+        auto posx       = randomFloats(rng, COUNT, -100, 100);
+        auto posy       = randomFloats(rng, COUNT, -100, 100);
+        auto dirX       = randomFloats(rng, COUNT, -50, 50);
+        auto dirY       = randomFloats(rng, COUNT, -50, 50);
+        auto radial     = randomFloats(rng, COUNT, -20, 20);
+        auto tangential = randomFloats(rng, COUNT, -20, 20);
+        // on the emitter there is no direction to accelerate along, at one unit away there is
+        posx[0] = posy[0] = 0.0f;
+        posx[1] = 1.0f;
+        posy[1] = 0.0f;
+
+        const float dt = 1.0f / 60, gravityX = 3, gravityY = -98, flipped = -1;
+        auto x = posx, y = posy, dx = dirX, dy = dirY;
+        ParticleKernels::integrateGravity(x.data(), y.data(), dx.data(), dy.data(), radial.data(), tangential.data(),
+                                          gravityX, gravityY, dt, flipped, COUNT);
+
+        for (int i = 0; i < COUNT; ++i)
+        {
+            float n  = std::sqrt(posx[i] * posx[i] + posy[i] * posy[i]);
+            float nx = n > 0 ? posx[i] / n : 0;
+            float ny = n > 0 ? posy[i] / n : 0;
+            float ex = dirX[i] + (nx * radial[i] - ny * tangential[i] + gravityX) * dt;
+            float ey = dirY[i] + (ny * radial[i] + nx * tangential[i] + gravityY) * dt;
+            CHECK(dx[i] == doctest::Approx(ex).epsilon(1e-5));
+            CHECK(dy[i] == doctest::Approx(ey).epsilon(1e-5));
+            CHECK(x[i] == doctest::Approx(posx[i] + ex * dt * flipped).epsilon(1e-5));
+            CHECK(y[i] == doctest::Approx(posy[i] + ey * dt * flipped).epsilon(1e-5));
+        }
+        CHECK(dx[1] == doctest::Approx(dirX[1] + (radial[1] + gravityX) * dt));
+    }
+
+    TEST_CASE("radius") {
+        std::mt19937 rng(4);
+        auto angle  = randomFloats(rng, COUNT, -20, 20);
+        auto radius = randomFloats(rng, COUNT, 0, 200);
+        auto speed  = randomFloats(rng, COUNT, -6, 6);
+        auto grow   = randomFloats(rng, COUNT, -30, 30);
+        std::vector<float> posx(COUNT), posy(COUNT);
+
+        const float dt = 1.0f / 30;
+        auto a = angle, r = radius;
+        ParticleKernels::integrateRadius(posx.data(), posy.data(), a.data(), r.data(), speed.data(), grow.data(), dt,
+                                         1, COUNT);
+
+        for (int i = 0; i < COUNT; ++i)
+        {
+            float ea = angle[i] + speed[i] * dt;
+            float er = radius[i] + grow[i] * dt;
+            CHECK(a[i] == ea);
+            CHECK(r[i] == er);
+            CHECK(posx[i] == doctest::Approx(-cosf(ea) * er).epsilon(1e-4).scale(er));
+            CHECK(posy[i] == doctest::Approx(-sinf(ea) * er).epsilon(1e-4).scale(er));
+        }
+    }
+
+    TEST_CASE("quad_vertices") {
+        std::mt19937 rng(5);
+        auto posx     = randomFloats(rng, COUNT, -100, 100);
+        auto posy     = randomFloats(rng, COUNT, -100, 100);
+        auto startX   = randomFloats(rng, COUNT, -100, 100);
+        auto startY   = randomFloats(rng, COUNT, -100, 100);
+        auto size     = randomFloats(rng, COUNT, 0, 64);
+        auto scale    = randomFloats(rng, COUNT, 0, 1);
+        auto rotation = randomFloats(rng, COUNT, -720, 720);
+        auto fixed    = randomFloats(rng, COUNT, -180, 180);
+
+        const AffineTransform transforms[] = {
+            {0, 0, 0, 0, 5, -7},          // free of the emitter
+            {1, 0, 0, 1, -12, 30},        // relative to the emitter
+            {0.5f, 0.8f, -0.8f, 0.5f, 3, 9},  // into a turned and scaled node
+        };
+        const float* scalings[] = {nullptr, scale.data()};
+        for (const auto& t : transforms)
+        {
+            for (const float* scaling : scalings)
+            {
+                std::vector<V3F_C4B_T2F_Quad> quads(COUNT), expected(COUNT);
+                ParticleKernels::updateQuadVertices(quads.data(), posx.data(), posy.data(), startX.data(),
+                                                    startY.data(), t, size.data(), scaling, rotation.data(),
+                                                    fixed.data(), COUNT);
+                for (int i = 0; i < COUNT; ++i)
+                {
+                    float x = posx[i] + t.a * startX[i] + t.c * startY[i] + t.tx;
+                    float y = posy[i] + t.b * startX[i] + t.d * startY[i] + t.ty;
+                    referenceQuad(expected[i], x, y, size[i], scaling ? scaling[i] : 1.0f, rotation[i] + fixed[i]);
+
+                    for (auto corner : {&V3F_C4B_T2F_Quad::bl, &V3F_C4B_T2F_Quad::br, &V3F_C4B_T2F_Quad::tl,
+                                        &V3F_C4B_T2F_Quad::tr})
+                    {
+                        CHECK((quads[i].*corner).vertices.x ==
+                              doctest::Approx((expected[i].*corner).vertices.x).scale(100).epsilon(1e-5));
+                        CHECK((quads[i].*corner).vertices.y ==
+                              doctest::Approx((expected[i].*corner).vertices.y).scale(100).epsilon(1e-5));
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_CASE("quad_colors") {
+        std::mt19937 rng(6);
+        // past both ends of 0..1 too, the bytes saturate
+        auto r       = randomFloats(rng, COUNT, -0.5f, 1.5f);
+        auto g       = randomFloats(rng, COUNT, -0.5f, 1.5f);
+        auto b       = randomFloats(rng, COUNT, -0.5f, 1.5f);
+        auto a       = randomFloats(rng, COUNT, 0, 1);
+        auto fadeIn  = randomFloats(rng, COUNT, 0, 1);
+        auto fadeLen = randomFloats(rng, COUNT, 1, 2);
+
+        for (bool premultiply : {false, true})
+        {
+            for (bool fade : {false, true})
+            {
+                std::vector<V3F_C4B_T2F_Quad> quads(COUNT);
+                ParticleKernels::updateQuadColors(quads.data(), r.data(), g.data(), b.data(), a.data(),
+                                                  fade ? fadeIn.data() : nullptr, fade ? fadeLen.data() : nullptr,
+                                                  premultiply, COUNT);
+                for (int i = 0; i < COUNT; ++i)
+                {
+                    float rgbScale = premultiply ? a[i] * 255.0f : 255.0f;
+                    float alpha    = fade ? a[i] * (fadeIn[i] / fadeLen[i]) : a[i];
+                    Color4B expected(referenceByte(r[i] * rgbScale), referenceByte(g[i] * rgbScale),
+                                     referenceByte(b[i] * rgbScale), referenceByte(alpha * 255.0f));
+                    CHECK(quads[i].bl.colors == expected);
+                    CHECK(quads[i].br.colors == expected);
+                    CHECK(quads[i].tl.colors == expected);
+                    CHECK(quads[i].tr.colors == expected);
+                }
+            }
+        }
+    }
+
+    // run with --no-skip to compare the kernels with the plain loops they replace
+    TEST_CASE("benchmark" * doctest::skip()) {
+        using Clock = std::chrono::steady_clock;
+        for (int count : {10000, 100000})
+        {
+            Particles reference(count), kernels(count);
+            double referenceMs = 0, kernelsMs = 0;
+            for (int frame = 0; frame < 100; ++frame)
+            {
+                auto start = Clock::now();
+                referenceUpdate(reference, 1.0f / 60);
+                auto middle = Clock::now();
+                kernelUpdate(kernels, 1.0f / 60);
+                auto end = Clock::now();
+                referenceMs += std::chrono::duration<double, std::milli>(middle - start).count();
+                kernelsMs += std::chrono::duration<double, std::milli>(end - middle).count();
+            }
+            MESSAGE(count << " particles, plain loops " << referenceMs / 100 << " ms, kernels " << kernelsMs / 100
+                          << " ms a frame");
+            CHECK(kernels.posx[count / 2] == doctest::Approx(reference.posx[count / 2]).epsilon(1e-3));
+        }
+    }
+}
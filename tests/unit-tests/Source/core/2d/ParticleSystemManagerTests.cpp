@@ -0,0 +1,177 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "2d/ParticleSystemManager.h"
+#include "2d/ParticleSystemQuad.h"
+#include "base/Director.h"
+#include "platform/Image.h"
+
+#include <string.h>
+
+USING_NS_AX;
+
+namespace
+{
+class TestParticles : public ParticleSystemQuad
+{
+public:
+    static TestParticles* create(uint32_t seed)
+    {
+        auto particles = new TestParticles();
+        particles->initWithTotalParticles(300);
+        particles->autorelease();
+
+        particles->setDuration(DURATION_INFINITY);
+        particles->setEmissionRate(200);
+        particles->setLife(1.0f);
+        particles->setLifeVar(0.5f);
+        particles->setSpeed(60);
+        particles->setSpeedVar(30);
+        particles->setAngle(90);
+        particles->setAngleVar(180);
+        particles->setGravity(Vec2(0, -50));
+        particles->setRadialAccel(10);
+        particles->setTangentialAccelVar(20);
+        particles->setStartSize(8);
+        particles->setStartSizeVar(4);
+        particles->setEndSize(START_SIZE_EQUAL_TO_END_SIZE);
+        particles->setStartColor(Color4F(1, 0.5f, 0.25f, 1));
+        particles->setStartColorVar(Color4F(0, 0.5f, 0.5f, 0));
+        particles->setEndColor(Color4F(0, 0, 1, 0));
+        particles->setPosition(Vec2(100, 200));
+        particles->setRandomSeed(seed);
+        return particles;
+    }
+
+    const V3F_C4B_T2F_Quad* getQuads() const { return _quads; }
+};
+}  // namespace
+
+TEST_SUITE("2d/ParticleSystemManager") {
+    TEST_CASE("matches_serial_updates") {
+        auto manager = Director::getInstance()->getParticleSystemManager();
+        manager->setParallelThreshold(1);
+
+        Vector<TestParticles*> serial, parallel;
+        for (uint32_t seed = 1; seed <= 8; ++seed)
+        {
+            serial.pushBack(TestParticles::create(seed));
+            parallel.pushBack(TestParticles::create(seed));
+        }
+
+        for (int frame = 0; frame < 60; ++frame)
+        {
+            manager->setEnabled(false);
+            for (auto particles : serial)
+                particles->update(1.0f / 60);
+
+            manager->setEnabled(true);
+            for (auto particles : parallel)
+                particles->update(1.0f / 60);
+            CHECK(manager->getQueueDepth() == static_cast<size_t>(parallel.size()));
+
+            manager->update();
+            CHECK(manager->getQueueDepth() == 0);
+        }
+        manager->setEnabled(false);
+        manager->setParallelThreshold(4);
+
+        for (ssize_t i = 0; i < serial.size(); ++i)
+        {
+            auto expected = serial.at(i);
+            auto actual   = parallel.at(i);
+            REQUIRE(expected->getParticleCount() == actual->getParticleCount());
+            CHECK(expected->getParticleCount() > 0);
+            CHECK(memcmp(expected->getQuads(), actual->getQuads(),
+                         sizeof(V3F_C4B_T2F_Quad) * expected->getParticleCount()) == 0);
+        }
+    }
+
+    TEST_CASE("second_update_in_a_frame") {
+        auto manager = Director::getInstance()->getParticleSystemManager();
+
+        auto reference = TestParticles::create(3);
+        auto particles = TestParticles::create(3);
+        reference->update(1.0f / 60);
+        reference->update(1.0f / 60);
+
+        // the queued update runs before the second one, and simulate never queues
+        manager->setEnabled(true);
+        particles->update(1.0f / 60);
+        CHECK(manager->getQueueDepth() == 1);
+        particles->update(1.0f / 60);
+        CHECK(manager->getQueueDepth() == 1);
+        manager->update();
+
+        reference->simulate(0.5f, 30);
+        particles->simulate(0.5f, 30);
+        CHECK(manager->getQueueDepth() == 0);
+        manager->setEnabled(false);
+
+        REQUIRE(reference->getParticleCount() == particles->getParticleCount());
+        CHECK(memcmp(reference->getQuads(), particles->getQuads(),
+                     sizeof(V3F_C4B_T2F_Quad) * reference->getParticleCount()) == 0);
+    }
+
+    TEST_CASE("emission_masks") {
+        auto manager = Director::getInstance()->getParticleSystemManager();
+        manager->setParallelThreshold(1);
+
+        // an opaque diagonal in a 4x4 mask
+        uint8_t pixels[4 * 4 * 4] = {};
+        for (int i = 0; i < 4; ++i)
+            pixels[(i * 4 + i) * 4 + 3] = 255;
+        auto image = new Image();
+        image->initWithRawData(pixels, sizeof(pixels), 4, 4, 8);
+        ParticleEmissionMaskCache::getInstance()->bakeEmissionMask("#tpsm", image);
+        image->release();
+
+        auto reference = TestParticles::create(5);
+        auto particles = TestParticles::create(5);
+        for (auto system : {reference, particles})
+        {
+            system->setEmissionShapes(true);
+            system->addEmissionShape(ParticleSystem::createMaskShape("#tpsm", Vec2::ZERO, Vec2(40, 40)));
+        }
+
+        for (int frame = 0; frame < 30; ++frame)
+        {
+            manager->setEnabled(false);
+            reference->update(1.0f / 60);
+
+            manager->setEnabled(true);
+            particles->update(1.0f / 60);
+            manager->update();
+        }
+        manager->setEnabled(false);
+        manager->setParallelThreshold(4);
+        ParticleEmissionMaskCache::getInstance()->removeMask("#tpsm");
+
+        REQUIRE(reference->getParticleCount() == particles->getParticleCount());
+        CHECK(reference->getParticleCount() > 0);
+        CHECK(memcmp(reference->getQuads(), particles->getQuads(),
+                     sizeof(V3F_C4B_T2F_Quad) * reference->getParticleCount()) == 0);
+    }
+}
@@ -0,0 +1,136 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "2d/SkylinePacker.h"
+
+#include <random>
+#include <vector>
+
+USING_NS_AX;
+
+namespace
+{
+struct PackedRect
+{
+    int x, y, width, height;
+};
+
+bool overlaps(const PackedRect& a, const PackedRect& b)
+{
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+}  // namespace
+
+TEST_SUITE("2d/SkylinePacker") {
+    TEST_CASE("fills_exactly") {
+        SkylinePacker packer(64, 64);
+        int x = 0, y = 0;
+        for (int i = 0; i < 16; ++i)
+            REQUIRE(packer.pack(16, 16, x, y));
+        CHECK_FALSE(packer.pack(1, 1, x, y));
+        CHECK(packer.getUsedArea() == 64 * 64);
+        CHECK(packer.getSkyline().size() == 1);
+        CHECK(packer.getMaxHeight() == 64);
+
+        packer.reset(64, 64);
+        CHECK(packer.pack(64, 64, x, y));
+        CHECK(x == 0);
+        CHECK(y == 0);
+    }
+
+    TEST_CASE("rejects") {
+        SkylinePacker packer(32, 32);
+        int x = -1, y = -1;
+        CHECK_FALSE(packer.pack(33, 1, x, y));
+        CHECK_FALSE(packer.pack(1, 33, x, y));
+        CHECK_FALSE(packer.pack(0, 4, x, y));
+        CHECK(packer.getUsedArea() == 0);
+        CHECK(packer.getSkyline().size() == 1);
+    }
+
+    TEST_CASE("fills_gaps") {
+        // a tall item then short ones, the short ones go beside the tall one and then on top of each other
+        SkylinePacker packer(32, 64);
+        int x = 0, y = 0;
+        REQUIRE(packer.pack(16, 32, x, y));
+        REQUIRE(packer.pack(16, 8, x, y));
+        CHECK(x == 16);
+        CHECK(y == 0);
+        REQUIRE(packer.pack(16, 8, x, y));
+        CHECK(x == 16);
+        CHECK(y == 8);
+        CHECK(packer.getMaxHeight() == 32);
+    }
+
+    TEST_CASE("no_overlap") {
+        std::mt19937 rng(1234);
+        std::uniform_int_distribution<int> size(4, 40);
+
+        SkylinePacker packer(512, 512);
+        std::vector<PackedRect> rects;
+        int failures = 0;
+        while (failures < 16)
+        {
+            PackedRect rect{0, 0, size(rng), size(rng)};
+            if (!packer.pack(rect.width, rect.height, rect.x, rect.y))
+            {
+                ++failures;
+                continue;
+            }
+            REQUIRE(rect.x >= 0);
+            REQUIRE(rect.y >= 0);
+            REQUIRE(rect.x + rect.width <= 512);
+            REQUIRE(rect.y + rect.height <= 512);
+            for (auto&& other : rects)
+                REQUIRE_FALSE(overlaps(rect, other));
+            rects.emplace_back(rect);
+        }
+
+        // the skyline always covers the whole width
+        int width = 0;
+        for (auto&& segment : packer.getSkyline())
+        {
+            CHECK(segment.x == width);
+            width += segment.width;
+        }
+        CHECK(width == 512);
+        CHECK(packer.getOccupancy() > 0.8f);
+    }
+
+    TEST_CASE("restore") {
+        // like a packer restored from a file, it has no size yet
+        SkylinePacker packer;
+        packer.restore(64, 64, {{0, 20, 32}, {32, 10, 32}});
+        CHECK(packer.getWidth() == 64);
+        CHECK(packer.getHeight() == 64);
+        int x = 0, y = 0;
+        REQUIRE(packer.pack(32, 10, x, y));
+        CHECK(x == 32);
+        CHECK(y == 10);
+        REQUIRE(packer.pack(64, 10, x, y));
+        CHECK(x == 0);
+        CHECK(y == 20);
+    }
+}
@@ -0,0 +1,112 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include <doctest.h>
+#include "audio/AudioCacheLRU.h"
+
+#include <string>
+#include <vector>
+
+USING_NS_AX;
+
+namespace
+{
+using Keys = std::vector<std::string>;
+
+bool evictAny(std::string_view)
+{
+    return true;
+}
+
+// loaded entries of 10 bytes, the last one is the most recently used
+void addLoaded(AudioCacheLRU& lru, const Keys& keys)
+{
+    for (auto&& key : keys)
+    {
+        lru.add(key);
+        lru.setSize(key, 10);
+    }
+}
+}  // namespace
+
+TEST_SUITE("audio/AudioCacheLRU") {
+    TEST_CASE("lru_order") {
+        AudioCacheLRU lru;
+        addLoaded(lru, {"a", "b", "c"});
+        CHECK_EQ(lru.getBytes(), 30u);
+
+        // the least recently used first, a was used again
+        lru.touch("a");
+        CHECK_EQ(lru.trim(20, evictAny), Keys{"b"});
+        CHECK_EQ(lru.getBytes(), 20u);
+
+        // adding an entry again only uses it
+        lru.add("c");
+        CHECK_EQ(lru.trim(5, evictAny), Keys{"a", "c"});
+        CHECK_EQ(lru.getBytes(), 0u);
+        CHECK_EQ(lru.size(), 0u);
+    }
+
+    TEST_CASE("pinning") {
+        AudioCacheLRU lru;
+        // pinned before it's cached
+        lru.setPinned("a", true);
+        addLoaded(lru, {"a", "b"});
+
+        CHECK_EQ(lru.trim(1, evictAny), Keys{"b"});
+        CHECK_EQ(lru.getBytes(), 10u);
+
+        lru.setPinned("a", false);
+        CHECK_EQ(lru.trim(1, evictAny), Keys{"a"});
+
+        // the pins outlive the entries
+        lru.setPinned("c", true);
+        addLoaded(lru, {"c"});
+        lru.clear();
+        CHECK_EQ(lru.getBytes(), 0u);
+        CHECK(lru.isPinned("c"));
+    }
+
+    TEST_CASE("budget") {
+        AudioCacheLRU lru;
+        addLoaded(lru, {"a", "b", "c"});
+
+        // unlimited
+        CHECK(lru.trim(0, evictAny).empty());
+        CHECK_EQ(lru.getBytes(), 30u);
+
+        // the size of a cache is accounted once
+        lru.setSize("b", 25);
+        CHECK_EQ(lru.getBytes(), 45u);
+        lru.remove("b");
+        CHECK_EQ(lru.getBytes(), 20u);
+
+        // a loading entry holds no bytes and an entry in use is refused, both are kept
+        lru.add("d");
+        CHECK_EQ(lru.trim(1, [](std::string_view key) { return key != "a"; }), Keys{"c"});
+        CHECK_EQ(lru.getBytes(), 10u);
+        CHECK_EQ(lru.size(), 2u);
+    }
+}
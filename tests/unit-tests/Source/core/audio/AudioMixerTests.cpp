@@ -0,0 +1,266 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "audio/AudioMixer.h"
+
+#include <limits>
+#include <vector>
+
+USING_NS_AX;
+
+
+static std::shared_ptr<AudioMixer::Sound> makeSound(std::vector<int16_t> samples, int channels, int sampleRate) {
+    auto sound        = std::make_shared<AudioMixer::Sound>();
+    sound->frames     = static_cast<uint32_t>(samples.size() / channels);
+    sound->samples    = std::move(samples);
+    sound->channels   = channels;
+    sound->sampleRate = sampleRate;
+    sound->ready      = true;
+    return sound;
+}
+
+static std::vector<float> render(AudioMixer& mixer, uint32_t frames) {
+    std::vector<float> out(frames * AudioMixer::CHANNELS);
+    mixer.render(out.data(), frames);
+    return out;
+}
+
+
+TEST_SUITE("audio/AudioMixer") {
+    TEST_CASE("volume_and_pan") {
+        AudioMixer mixer(48000);
+        auto sound = makeSound(std::vector<int16_t>(64, 16384), 1, 48000);
+
+        AudioMixer::VoiceSettings settings;
+        settings.volume = 0.5f;
+        auto voice      = mixer.play(sound, settings);
+        CHECK_NE(voice, AudioMixer::INVALID_VOICE);
+
+        auto out = render(mixer, 8);
+        for (uint32_t i = 0; i < 8; ++i) {
+            CHECK_EQ(out[i * 2], doctest::Approx(0.25f));
+            CHECK_EQ(out[i * 2 + 1], doctest::Approx(0.25f));
+        }
+
+        mixer.setPan(voice, 1.0f);
+        out = render(mixer, 8);
+        for (uint32_t i = 0; i < 8; ++i) {
+            CHECK_EQ(out[i * 2], doctest::Approx(0.0f));
+            CHECK_EQ(out[i * 2 + 1], doctest::Approx(0.25f));
+        }
+    }
+
+    TEST_CASE("resample") {
+        // a 24 kHz ramp played at 48 kHz yields the midpoints between its samples
+        std::vector<int16_t> ramp;
+        for (int i = 0; i < 32; ++i)
+            ramp.push_back(static_cast<int16_t>(i * 1024));
+        AudioMixer mixer(48000);
+        mixer.play(makeSound(ramp, 1, 24000));
+
+        auto out = render(mixer, 16);
+        for (uint32_t i = 0; i < 16; ++i)
+            CHECK_EQ(out[i * 2], doctest::Approx(i * 512 / 32768.0f));
+
+        // a stereo sound keeps its channels apart
+        AudioMixer stereo(48000);
+        stereo.play(makeSound({8192, -8192, 8192, -8192, 8192, -8192, 8192, -8192}, 2, 48000));
+        out = render(stereo, 3);
+        for (uint32_t i = 0; i < 3; ++i) {
+            CHECK_EQ(out[i * 2], doctest::Approx(0.25f));
+            CHECK_EQ(out[i * 2 + 1], doctest::Approx(-0.25f));
+        }
+    }
+
+    TEST_CASE("end_and_loop") {
+        AudioMixer mixer(48000);
+        auto sound = makeSound(std::vector<int16_t>(10, 8192), 1, 48000);
+
+        auto once = mixer.play(sound);
+        AudioMixer::VoiceSettings settings;
+        settings.loop = true;
+        auto looped   = mixer.play(sound, settings);
+
+        auto out = render(mixer, 16);
+        CHECK_EQ(out[9 * 2], doctest::Approx(0.5f));
+        CHECK_EQ(out[10 * 2], doctest::Approx(0.25f));
+        CHECK_FALSE(mixer.isPlaying(once));
+        CHECK(mixer.isPlaying(looped));
+
+        mixer.stop(looped);
+        CHECK_EQ(mixer.getStats().voices, 1);
+        out = render(mixer, 4);
+        CHECK_EQ(out[0], 0.0f);
+        CHECK_EQ(mixer.getStats().voices, 0);
+    }
+
+    TEST_CASE("invalid_pitch") {
+        AudioMixer mixer(48000);
+        auto sound = makeSound(std::vector<int16_t>(10, 8192), 1, 48000);
+
+        // a zero or negative pitch barely advances, NaN plays at the normal rate, a huge one is capped
+        AudioMixer::VoiceSettings settings;
+        settings.pitch = 0.0f;
+        auto zero      = mixer.play(sound, settings);
+        settings.pitch = -1.0f;
+        auto negative  = mixer.play(sound, settings);
+        settings.pitch = std::numeric_limits<float>::quiet_NaN();
+        auto nan       = mixer.play(sound, settings);
+
+        auto out = render(mixer, 16);
+        CHECK_EQ(out[9 * 2], doctest::Approx(0.75f));
+        CHECK_EQ(out[10 * 2], doctest::Approx(0.5f));
+        CHECK(mixer.isPlaying(zero));
+        CHECK(mixer.isPlaying(negative));
+        CHECK_FALSE(mixer.isPlaying(nan));
+
+        mixer.setPitch(zero, std::numeric_limits<float>::infinity());
+        mixer.setPitch(negative, std::numeric_limits<float>::quiet_NaN());
+        render(mixer, 2);
+        CHECK_FALSE(mixer.isPlaying(zero));
+        CHECK(mixer.isPlaying(negative));
+        render(mixer, 10);
+        CHECK_FALSE(mixer.isPlaying(negative));
+    }
+
+    TEST_CASE("virtualization") {
+        AudioMixer mixer(48000);
+        mixer.setMaxRealVoices(2);
+        mixer.setAudibilityThreshold(0.1f);
+        auto sound = makeSound(std::vector<int16_t>(1000, 8192), 1, 48000);
+
+        AudioMixer::VoiceSettings settings;
+        settings.volume = 0.2f;
+        mixer.play(sound, settings);
+        settings.volume = 0.4f;
+        mixer.play(sound, settings);
+        settings.volume   = 0.1f;
+        settings.priority = 1;
+        auto important    = mixer.play(sound, settings);
+        settings.volume   = 0.05f;
+        settings.priority = 2;
+        auto inaudible    = mixer.play(sound, settings);
+
+        // the prioritized voice and the loudest one are mixed, the others only advance
+        auto out = render(mixer, 4);
+        CHECK_EQ(out[0], doctest::Approx(0.25f * (0.1f + 0.4f)));
+        auto stats = mixer.getStats();
+        CHECK_EQ(stats.voices, 4);
+        CHECK_EQ(stats.realVoices, 2);
+        CHECK_EQ(stats.virtualVoices, 2);
+
+        // virtual voices still end on time
+        render(mixer, 996);
+        CHECK_FALSE(mixer.isPlaying(important));
+        CHECK_FALSE(mixer.isPlaying(inaudible));
+        CHECK_EQ(mixer.getStats().voices, 0);
+    }
+
+    TEST_CASE("pending_sound") {
+        AudioMixer mixer(48000);
+        auto sound = std::make_shared<AudioMixer::Sound>();
+        auto voice = mixer.play(sound);
+
+        auto out = render(mixer, 8);
+        CHECK_EQ(out[0], 0.0f);
+        CHECK(mixer.isPlaying(voice));
+
+        sound->samples.assign(8, 8192);
+        sound->frames = 8;
+        sound->ready  = true;
+        out           = render(mixer, 8);
+        CHECK_EQ(out[0], doctest::Approx(0.25f));
+    }
+
+    TEST_CASE("pending_sound_is_not_real") {
+        AudioMixer mixer(48000);
+        mixer.setMaxRealVoices(1);
+        AudioMixer::VoiceSettings settings;
+        settings.priority = 1;
+        auto pending      = mixer.play(std::make_shared<AudioMixer::Sound>(), settings);
+        mixer.play(makeSound(std::vector<int16_t>(8, 8192), 1, 48000));
+
+        // the pending voice doesn't take the only real voice from the ready one
+        auto out = render(mixer, 4);
+        CHECK_EQ(out[0], doctest::Approx(0.25f));
+        auto stats = mixer.getStats();
+        CHECK_EQ(stats.voices, 1);
+        CHECK_EQ(stats.realVoices, 1);
+        CHECK(mixer.isPlaying(pending));
+    }
+
+    TEST_CASE("has_voices") {
+        AudioMixer mixer(48000);
+        CHECK_FALSE(mixer.hasVoices());
+
+        // a pending voice counts, the output must keep running until its sound is decoded
+        auto pending = mixer.play(std::make_shared<AudioMixer::Sound>());
+        CHECK(mixer.hasVoices());
+        mixer.stop(pending);
+        CHECK_FALSE(mixer.hasVoices());
+
+        mixer.play(makeSound(std::vector<int16_t>(8, 8192), 1, 48000));
+        CHECK(mixer.hasVoices());
+        render(mixer, 4);
+        CHECK(mixer.hasVoices());
+        render(mixer, 4);
+        CHECK_FALSE(mixer.hasVoices());
+
+        mixer.play(makeSound(std::vector<int16_t>(8, 8192), 1, 48000));
+        mixer.stopAll();
+        CHECK_FALSE(mixer.hasVoices());
+    }
+
+    TEST_CASE("deterministic") {
+        auto run = [] {
+            std::vector<int16_t> noise;
+            uint32_t seed = 1;
+            for (int i = 0; i < 4000; ++i) {
+                seed = seed * 1664525u + 1013904223u;
+                noise.push_back(static_cast<int16_t>(seed >> 16));
+            }
+            auto sound = makeSound(std::move(noise), 2, 44100);
+
+            AudioMixer mixer(48000);
+            mixer.setMaxRealVoices(8);
+            for (int i = 0; i < 100; ++i) {
+                AudioMixer::VoiceSettings settings;
+                settings.volume   = 0.01f * (i % 10 + 1);
+                settings.pan      = (i % 7) / 3.0f - 1.0f;
+                settings.pitch    = 0.5f + 0.01f * i;
+                settings.loop     = i % 3 == 0;
+                settings.priority = i % 4;
+                mixer.play(sound, settings);
+            }
+
+            std::vector<int16_t> out(4096 * AudioMixer::CHANNELS);
+            for (int block = 0; block < 4; ++block)
+                mixer.render(out.data() + block * 1024 * AudioMixer::CHANNELS, 1024);
+            return out;
+        };
+
+        CHECK_EQ(run(), run());
+    }
+}
@@ -0,0 +1,189 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "audio/AudioStreamer.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+USING_NS_AX;
+
+
+namespace {
+    class FakeSource : public AudioStreamSource {
+    public:
+        using StreamResult = AudioStreamSource::StreamResult;
+
+        FakeSource(int id, std::vector<int>& log, std::mutex& logMutex) : _id(id), _log(log), _logMutex(logMutex) {}
+
+        // the results returned by the next stream() calls, the last one repeats
+        std::deque<StreamResult> results;
+        // blocks stream() until cleared
+        std::atomic<bool> hold{false};
+        std::atomic<bool> streaming{false};
+        std::atomic<int> urgency{-1};
+        std::atomic<int> calls{0};
+        std::atomic<bool> finished{false};
+
+    protected:
+        int getStreamUrgency() const override { return urgency; }
+
+        StreamResult stream() override {
+            streaming = true;
+            while (hold)
+                std::this_thread::yield();
+            {
+                std::lock_guard<std::mutex> lck(_logMutex);
+                _log.push_back(_id);
+            }
+            ++calls;
+
+            auto result = results.empty() ? StreamResult::IDLE : results.front();
+            if (results.size() > 1)
+                results.pop_front();
+            // a refilled source has nothing to do until the test says otherwise
+            if (result == StreamResult::REFILLED)
+                urgency = -1;
+            streaming = false;
+            return result;
+        }
+
+        void onStreamFinished() override { finished = true; }
+
+    private:
+        int _id;
+        std::vector<int>& _log;
+        std::mutex& _logMutex;
+    };
+
+    bool waitFor(const std::function<bool()>& condition) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+
+TEST_SUITE("audio/AudioStreamer") {
+    TEST_CASE("urgency_ordering") {
+        std::vector<int> log;
+        std::mutex logMutex;
+        FakeSource gate(0, log, logMutex), low(1, log, logMutex), mid(2, log, logMutex), high(3, log, logMutex);
+        gate.results = {FakeSource::StreamResult::FINISHED};
+        for (auto source : {&low, &mid, &high})
+            source->results = {FakeSource::StreamResult::REFILLED};
+
+        AudioStreamer streamer(1);
+        streamer.setIdleWait(std::chrono::milliseconds(1));
+
+        // keep the only worker busy on the gate while the other sources are registered
+        gate.hold    = true;
+        gate.urgency = 100;
+        streamer.add(&gate);
+        REQUIRE(waitFor([&] { return gate.streaming.load(); }));
+
+        low.urgency  = 1;
+        mid.urgency  = 2;
+        high.urgency = 3;
+        streamer.add(&low);
+        streamer.add(&high);
+        streamer.add(&mid);
+        gate.hold = false;
+
+        REQUIRE(waitFor([&] { return low.calls == 1; }));
+        CHECK(gate.finished);
+        CHECK_EQ(streamer.getStreamedBufferCount(), 3);
+        std::lock_guard<std::mutex> lck(logMutex);
+        CHECK_EQ(log, std::vector<int>{0, 3, 2, 1});
+    }
+
+    TEST_CASE("stream_states") {
+        std::vector<int> log;
+        std::mutex logMutex;
+        FakeSource source(1, log, logMutex);
+        source.results = {FakeSource::StreamResult::UNDERRUN, FakeSource::StreamResult::IDLE,
+                          FakeSource::StreamResult::REFILLED, FakeSource::StreamResult::FINISHED};
+
+        AudioStreamer streamer(2);
+        streamer.setIdleWait(std::chrono::milliseconds(1));
+        source.urgency = 0;
+        streamer.add(&source);
+        CHECK_EQ(streamer.getActiveStreams(), 1);
+
+        // an underrun and an idle pass keep the source registered, a refill makes it wait for its urgency
+        REQUIRE(waitFor([&] { return streamer.getStreamedBufferCount() == 1; }));
+        CHECK_EQ(source.calls.load(), 3);
+        CHECK_EQ(streamer.getUnderrunCount(), 1);
+        CHECK_EQ(streamer.getActiveStreams(), 1);
+        CHECK_FALSE(source.finished);
+
+        source.urgency = 0;
+        streamer.wakeup();
+        REQUIRE(waitFor([&] { return source.finished.load(); }));
+        CHECK_EQ(streamer.getActiveStreams(), 0);
+        CHECK_EQ(source.calls.load(), 4);
+        CHECK_EQ(streamer.getStreamedBufferCount(), 1);
+        CHECK_EQ(streamer.getUnderrunCount(), 1);
+    }
+
+    TEST_CASE("remove_waits_for_the_worker") {
+        std::vector<int> log;
+        std::mutex logMutex;
+        FakeSource source(1, log, logMutex);
+        source.results = {FakeSource::StreamResult::IDLE};
+
+        AudioStreamer streamer(1);
+        source.hold    = true;
+        source.urgency = 0;
+        streamer.add(&source);
+        REQUIRE(waitFor([&] { return source.streaming.load(); }));
+
+        std::atomic<bool> removed{false};
+        std::thread remover([&] {
+            streamer.remove(&source);
+            removed = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK_FALSE(removed);
+
+        source.urgency = -1;
+        source.hold    = false;
+        remover.join();
+        CHECK_FALSE(source.streaming);
+        CHECK_EQ(streamer.getActiveStreams(), 0);
+        auto calls = source.calls.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK_EQ(source.calls.load(), calls);
+    }
+}
@@ -0,0 +1,91 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "base/FixedTimestep.h"
+
+USING_NS_AX;
+
+
+TEST_SUITE("base/FixedTimestep") {
+    TEST_CASE("disabled") {
+        FixedTimestep timestep;
+        CHECK_FALSE(timestep.isEnabled());
+        CHECK_EQ(timestep.advance(1.0f), 0);
+        CHECK_EQ(timestep.getAlpha(), 0.0f);
+    }
+
+    TEST_CASE("accumulates") {
+        FixedTimestep timestep(30);
+        CHECK_EQ(timestep.getStepInterval(), doctest::Approx(1.0f / 30));
+
+        // 60 fps frames run a 30 Hz step every other frame
+        int steps = 0;
+        for (int i = 0; i < 60; ++i)
+        {
+            auto frameSteps = timestep.advance(1.0f / 60);
+            CHECK_LE(frameSteps, 1);
+            steps += frameSteps;
+        }
+        CHECK_EQ(steps, 30);
+
+        timestep.reset();
+        CHECK_EQ(timestep.advance(1.0f / 60), 0);
+        CHECK_EQ(timestep.getAlpha(), doctest::Approx(0.5f));
+    }
+
+    TEST_CASE("frames_of_one_step") {
+        FixedTimestep timestep(60);
+        for (int i = 0; i < 600; ++i)
+            CHECK_EQ(timestep.advance(1.0f / 60), 1);
+    }
+
+    TEST_CASE("caps_catch_up") {
+        FixedTimestep timestep(60, 3);
+        timestep.advance(0.25f / 60);
+
+        // a one second hitch only runs the maximum number of steps
+        CHECK_EQ(timestep.advance(1.0f), 3);
+        CHECK_EQ(timestep.getDroppedSteps(), 57u);
+        CHECK_EQ(timestep.getAlpha(), doctest::Approx(0.25f).epsilon(0.01));
+
+        // and doesn't carry over to the next frame
+        CHECK_EQ(timestep.advance(1.0f / 60), 1);
+
+        timestep.setMaxCatchUpSteps(0);
+        CHECK_EQ(timestep.getMaxCatchUpSteps(), 1);
+    }
+
+    TEST_CASE("rate_change") {
+        FixedTimestep timestep(60);
+        timestep.advance(0.5f / 60);
+        timestep.setStepsPerSecond(30);
+        CHECK_EQ(timestep.getRemainder(), 0.0f);
+        CHECK_EQ(timestep.advance(-1.0f), 0);
+
+        timestep.setStepsPerSecond(0);
+        CHECK_FALSE(timestep.isEnabled());
+        CHECK_EQ(timestep.getStepInterval(), 0.0f);
+    }
+}
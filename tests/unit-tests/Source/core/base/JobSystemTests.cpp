@@ -0,0 +1,90 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "base/JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+USING_NS_AX;
+
+
+TEST_SUITE("base/JobSystem") {
+    TEST_CASE("parallel_for") {
+        JobSystem jobSystem(4);
+        std::vector<int> values(10000, 0);
+        jobSystem.parallel_for(0, values.size(), 64, [&values](size_t first, size_t last) {
+            for (auto i = first; i < last; ++i)
+                ++values[i];
+        });
+        CHECK(std::all_of(values.begin(), values.end(), [](int value) { return value == 1; }));
+    }
+
+    TEST_CASE("dependencies") {
+        JobSystem jobSystem(4);
+        std::atomic<int> done{0};
+        std::vector<JobHandle> handles;
+        for (int i = 0; i < 32; ++i)
+            handles.push_back(jobSystem.schedule([&done] { ++done; }, JobSystem::Priority::LOW));
+
+        int seen = -1;
+        auto last = jobSystem.schedule([&] { seen = done.load(); }, handles, JobSystem::Priority::HIGH);
+        last.wait();
+        CHECK(last.isDone());
+        CHECK_EQ(seen, 32);
+    }
+
+    TEST_CASE("children") {
+        JobSystem jobSystem(4);
+        std::atomic<int> children{0};
+        std::atomic<bool> scheduled{false};
+        JobHandle parent;
+        parent = jobSystem.schedule([&] {
+            while (!scheduled)
+                std::this_thread::yield();
+            for (int i = 0; i < 16; ++i)
+                jobSystem.scheduleChild(parent, [&children] { ++children; });
+        });
+        scheduled = true;
+        parent.wait();
+        CHECK_EQ(children.load(), 16);
+    }
+
+    TEST_CASE("nested_wait") {
+        JobSystem jobSystem(2);
+        std::atomic<int> count{0};
+        auto outer = jobSystem.schedule([&] {
+            std::vector<JobHandle> inner;
+            for (int i = 0; i < 64; ++i)
+                inner.push_back(jobSystem.schedule([&count] { ++count; }));
+            for (auto& handle : inner)
+                handle.wait();
+        });
+        outer.wait();
+        CHECK_EQ(count.load(), 64);
+    }
+}
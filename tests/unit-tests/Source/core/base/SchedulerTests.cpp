@@ -0,0 +1,305 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <doctest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "base/Scheduler.h"
+
+USING_NS_AX;
+
+
+TEST_SUITE("base/Scheduler") {
+    TEST_CASE("small_function") {
+        using Function = axstd::small_function<int(int)>;
+
+        std::string suffix = "suffix";
+        auto addSize       = [suffix](int x) { return x + static_cast<int>(suffix.size()); };
+        CHECK(Function::stores_inline<decltype(addSize)>);
+        Function small(addSize);
+        CHECK_EQ(small(1), 7);
+
+        struct Large
+        {
+            char padding[128];
+            int operator()(int x) const { return x * 2; }
+        };
+        CHECK_FALSE(Function::stores_inline<Large>);
+        Function large(Large{});
+        Function moved(std::move(large));
+        CHECK_FALSE(large);
+        CHECK_EQ(moved(4), 8);
+
+        std::function<int(int)> empty;
+        CHECK_FALSE(Function(empty));
+    }
+
+    TEST_CASE("timers") {
+        Scheduler scheduler;
+        int target = 0;
+
+        // frames of 1/64 s keep the time exact
+        std::vector<float> every, delayed;
+        scheduler.schedule([&](float dt) { every.push_back(dt); }, &target, 0.25f, false, "every");
+        scheduler.schedule([&](float dt) { delayed.push_back(dt); }, &target, 0.5f, 2, 0.125f, false, "delayed");
+        CHECK(scheduler.isScheduled("every", &target));
+
+        // the first update only starts the timers
+        for (int i = 0; i <= 80; ++i)
+            scheduler.update(1.0f / 64);
+
+        CHECK_EQ(every, std::vector<float>{0.25f, 0.25f, 0.25f, 0.25f, 0.25f});
+        // the delay, then twice the interval
+        CHECK_EQ(delayed, std::vector<float>{0.125f, 0.5f, 0.5f});
+        CHECK_FALSE(scheduler.isScheduled("delayed", &target));
+
+        // a hitch catches up
+        scheduler.update(1.0f);
+        CHECK_EQ(every.size(), 9u);
+
+        scheduler.unschedule("every", &target);
+        scheduler.update(1.0f);
+        CHECK_EQ(every.size(), 9u);
+    }
+
+    TEST_CASE("timers_every_frame") {
+        Scheduler scheduler;
+        int target = 0;
+
+        std::vector<float> frames;
+        scheduler.schedule([&](float dt) { frames.push_back(dt); }, &target, 0, false, "frame");
+        scheduler.update(0.5f);
+        scheduler.update(0.25f);
+        scheduler.update(0);
+        CHECK_EQ(frames, std::vector<float>{0.25f, 0});
+    }
+
+    TEST_CASE("timers_paused") {
+        Scheduler scheduler;
+        int target = 0;
+
+        int count = 0;
+        scheduler.schedule([&](float) { ++count; }, &target, 1.0f, false, "paused");
+        scheduler.update(0);
+        scheduler.update(0.75f);
+
+        // the paused time isn't counted
+        scheduler.pauseTarget(&target);
+        CHECK(scheduler.isTargetPaused(&target));
+        scheduler.update(10.0f);
+        CHECK_EQ(count, 0);
+
+        scheduler.resumeTarget(&target);
+        scheduler.update(0.125f);
+        CHECK_EQ(count, 0);
+        scheduler.update(0.125f);
+        CHECK_EQ(count, 1);
+    }
+
+    TEST_CASE("timers_unscheduled_by_callback") {
+        Scheduler scheduler;
+        int first = 0, second = 0;
+
+        // timers due in the same frame, the first one removes the second one
+        int count = 0;
+        scheduler.schedule(
+            [&](float) {
+                ++count;
+                scheduler.unscheduleAllForTarget(&second);
+            },
+            &first, 0.5f, false, "first");
+        scheduler.schedule([&](float) { ++count; }, &second, 0.5f, false, "second");
+        scheduler.update(0);
+        scheduler.update(0.5f);
+        CHECK_EQ(count, 1);
+
+        // and a timer can unschedule itself
+        scheduler.schedule([&](float) { scheduler.unschedule("self", &second); }, &second, 0.5f, false, "self");
+        scheduler.update(0);
+        scheduler.update(0.5f);
+        CHECK_FALSE(scheduler.isScheduled("self", &second));
+    }
+
+    TEST_CASE("timers_benchmark" * doctest::skip()) {
+        Scheduler scheduler;
+        std::vector<int> targets(10000);
+
+        int count = 0;
+        for (size_t i = 0; i < targets.size(); ++i)
+            scheduler.schedule([&](float) { ++count; }, &targets[i], 1.0f + (i % 100) * 0.05f, false, "timer");
+        scheduler.update(0);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 600; ++i)
+            scheduler.update(1.0f / 60);
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        MESSAGE(targets.size() << " timers, " << elapsed / 600 << " ms per frame, " << count << " triggered");
+    }
+
+    TEST_CASE("pending_actions_in_order") {
+        Scheduler scheduler;
+        scheduler.setPendingActionBudget(0, 0);
+
+        std::vector<int> order;
+        for (int i = 0; i < 100; ++i)
+            scheduler.runOnAxmolThread([&order, i] { order.push_back(i); });
+        CHECK_EQ(scheduler.getPendingActionCount(), 100u);
+
+        scheduler.update(0);
+        REQUIRE_EQ(order.size(), 100u);
+        for (int i = 0; i < 100; ++i)
+            CHECK_EQ(order[i], i);
+    }
+
+    TEST_CASE("pending_actions_budget") {
+        Scheduler scheduler;
+        scheduler.setPendingActionBudget(0, 64);
+
+        int count = 0;
+        for (int i = 0; i < 1000; ++i)
+            scheduler.runOnAxmolThread([&count] { ++count; });
+
+        // a burst is spread over frames
+        scheduler.update(0);
+        CHECK_EQ(count, 64);
+
+        int frames = 1;
+        while (count < 1000)
+        {
+            scheduler.update(0);
+            ++frames;
+        }
+        CHECK_EQ(frames, 16);
+
+        // the time budget still runs one per frame
+        scheduler.setPendingActionBudget(0.000001f, 0);
+        scheduler.runOnAxmolThread([&count] { ++count; });
+        scheduler.runOnAxmolThread([&count] { ++count; });
+        scheduler.update(0);
+        CHECK_EQ(count, 1001);
+        scheduler.update(0);
+        CHECK_EQ(count, 1002);
+    }
+
+    TEST_CASE("pending_actions_queued_while_running") {
+        Scheduler scheduler;
+
+        // an action queuing itself again runs once per frame instead of stalling the frame
+        int count = 0;
+        std::function<void()> requeue = [&] {
+            ++count;
+            scheduler.runOnAxmolThread(requeue);
+        };
+        scheduler.runOnAxmolThread(requeue);
+        scheduler.update(0);
+        CHECK_EQ(count, 1);
+        scheduler.update(0);
+        CHECK_EQ(count, 2);
+
+        scheduler.removeAllPendingActions();
+        scheduler.update(0);
+        CHECK_EQ(count, 2);
+        CHECK_EQ(scheduler.getPendingActionCount(), 0u);
+    }
+
+    TEST_CASE("pending_actions_from_threads") {
+        Scheduler scheduler;
+        scheduler.setPendingActionBudget(0, 0);
+
+        constexpr int threadCount = 4;
+        constexpr int perThread   = 5000;
+
+        // each thread's actions run in the order it queued them
+        std::vector<int> last(threadCount, -1);
+        bool ordered = true;
+        int count    = 0;
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < perThread; ++i)
+                    scheduler.runOnAxmolThread([&, t, i] {
+                        ordered = ordered && last[t] < i;
+                        last[t] = i;
+                        ++count;
+                    });
+            });
+        }
+
+        while (count < threadCount * perThread)
+        {
+            scheduler.update(0);
+            std::this_thread::yield();
+        }
+        for (auto&& thread : threads)
+            thread.join();
+
+        CHECK(ordered);
+        CHECK_EQ(count, threadCount * perThread);
+    }
+
+    TEST_CASE("pending_actions_from_short_lived_threads") {
+        Scheduler scheduler;
+        scheduler.setPendingActionBudget(0, 0);
+
+        // each thread releases its producer when it exits
+        int count = 0;
+        for (int t = 0; t < 256; ++t)
+            std::thread([&] { scheduler.runOnAxmolThread([&] { ++count; }); }).join();
+
+        scheduler.update(0);
+        CHECK_EQ(count, 256);
+    }
+
+    TEST_CASE("pending_actions_outlive_scheduler") {
+        // a thread which queued a function exits after the scheduler is destroyed
+        auto scheduler = std::make_unique<Scheduler>();
+        std::atomic<bool> queued{false}, destroyed{false};
+        std::thread thread([&] {
+            scheduler->runOnAxmolThread([] {});
+            queued = true;
+            while (!destroyed)
+                std::this_thread::yield();
+        });
+        while (!queued)
+            std::this_thread::yield();
+        scheduler.reset();
+        destroyed = true;
+        thread.join();
+
+        // this thread queues functions to successive schedulers
+        for (int i = 0; i < 8; ++i)
+        {
+            Scheduler successive;
+            int ran = 0;
+            successive.runOnAxmolThread([&] { ++ran; });
+            successive.update(0);
+            CHECK_EQ(ran, 1);
+        }
+    }
+}
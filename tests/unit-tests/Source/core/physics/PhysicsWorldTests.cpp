@@ -0,0 +1,241 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include <doctest.h>
+#include "2d/Scene.h"
+#include "base/Director.h"
+#include "base/JobSystem.h"
+#include "physics/PhysicsBody.h"
+#include "physics/PhysicsShape.h"
+#include "physics/PhysicsWorld.h"
+
+#include <vector>
+
+USING_NS_AX;
+
+namespace
+{
+// a 20x20 box centered on position, the world isn't stepped so its body stays at the origin
+PhysicsBody* addBox(Scene* scene, const Vec2& position, bool dynamic, int category)
+{
+    auto node = Node::create();
+    scene->addChild(node);
+
+    auto body = PhysicsBody::createBox(Vec2(20.0f, 20.0f), PHYSICSBODY_MATERIAL_DEFAULT, position);
+    body->setDynamic(dynamic);
+    body->setCategoryBitmask(category);
+    node->setPhysicsBody(body);
+    return body;
+}
+
+PhysicsShape* shapeOf(PhysicsBody* body)
+{
+    return body->getShapes().at(0);
+}
+
+// a grid of static and dynamic boxes, with a gap between them
+Scene* createGridScene(int columns, int rows)
+{
+    auto scene = Scene::createWithPhysics();
+    for (int y = 0; y < rows; ++y)
+        for (int x = 0; x < columns; ++x)
+            addBox(scene, Vec2(x * 40.0f, y * 40.0f), (x + y) % 2 == 0, 1 << (x % 2));
+    return scene;
+}
+}  // namespace
+
+TEST_SUITE("physics/PhysicsWorld") {
+    TEST_CASE("ray_cast_batch") {
+        auto scene = Scene::createWithPhysics();
+        scene->retain();
+        auto world  = scene->getPhysicsWorld();
+        auto ground = addBox(scene, Vec2(0.0f, 0.0f), false, 1);
+        auto crate  = addBox(scene, Vec2(100.0f, 0.0f), true, 2);
+
+        std::vector<PhysicsRaySegment> rays = {
+            {Vec2(-50.0f, 0.0f), Vec2(50.0f, 0.0f)},
+            {Vec2(50.0f, 0.0f), Vec2(150.0f, 0.0f)},
+            {Vec2(-50.0f, 50.0f), Vec2(150.0f, 50.0f)},
+            {Vec2(-50.0f, 0.0f), Vec2(150.0f, 0.0f)},
+        };
+        std::vector<PhysicsRayCastInfo> hits(rays.size());
+
+        SUBCASE("closest_hit") {
+            CHECK_EQ(world->rayCastBatch(rays, hits), 3);
+
+            CHECK_EQ(hits[0].shape, shapeOf(ground));
+            CHECK(hits[0].contact.fuzzyEquals(Vec2(-10.0f, 0.0f), 0.01f));
+            CHECK(hits[0].normal.fuzzyEquals(Vec2(-1.0f, 0.0f), 0.01f));
+            CHECK_EQ(hits[0].fraction, doctest::Approx(0.4f));
+            CHECK_EQ(hits[0].start, rays[0].start);
+            CHECK_EQ(hits[0].end, rays[0].end);
+
+            CHECK_EQ(hits[1].shape, shapeOf(crate));
+            CHECK(hits[1].contact.fuzzyEquals(Vec2(90.0f, 0.0f), 0.01f));
+
+            CHECK_EQ(hits[2].shape, nullptr);
+
+            // the static ground is in front of the dynamic crate
+            CHECK_EQ(hits[3].shape, shapeOf(ground));
+        }
+
+        SUBCASE("category_filter") {
+            CHECK_EQ(world->rayCastBatch(rays, hits, 2), 2);
+            CHECK_EQ(hits[0].shape, nullptr);
+            CHECK_EQ(hits[1].shape, shapeOf(crate));
+            CHECK_EQ(hits[2].shape, nullptr);
+            CHECK_EQ(hits[3].shape, shapeOf(crate));
+        }
+
+        SUBCASE("sensors_are_ignored") {
+            shapeOf(ground)->setSensor(true);
+            CHECK_EQ(world->rayCastBatch(rays, hits), 2);
+            CHECK_EQ(hits[0].shape, nullptr);
+            CHECK_EQ(hits[3].shape, shapeOf(crate));
+        }
+
+        scene->release();
+    }
+
+    TEST_CASE("query_rect_batch") {
+        auto scene = Scene::createWithPhysics();
+        scene->retain();
+        auto world = scene->getPhysicsWorld();
+        addBox(scene, Vec2(0.0f, 0.0f), false, 1);
+        addBox(scene, Vec2(5.0f, 0.0f), true, 1);
+        addBox(scene, Vec2(10.0f, 0.0f), true, 2);
+
+        std::vector<Rect> rects = {Rect(-5.0f, -5.0f, 10.0f, 10.0f), Rect(200.0f, 200.0f, 10.0f, 10.0f)};
+        std::vector<int> counts(rects.size(), -1);
+
+        SUBCASE("all_found") {
+            std::vector<PhysicsShape*> shapes(rects.size() * 4);
+            CHECK_EQ(world->queryRectBatch(rects, shapes, counts), 3);
+            CHECK_EQ(counts[0], 3);
+            CHECK_EQ(counts[1], 0);
+        }
+
+        SUBCASE("category_filter") {
+            std::vector<PhysicsShape*> shapes(rects.size() * 4);
+            CHECK_EQ(world->queryRectBatch(rects, shapes, counts, 2), 1);
+            CHECK_EQ(counts[0], 1);
+            CHECK_EQ(shapes[0]->getCategoryBitmask(), 2);
+        }
+
+        SUBCASE("slices_are_truncated") {
+            // two shapes per rect, the third one found by the first rect is dropped
+            std::vector<PhysicsShape*> shapes(rects.size() * 2, nullptr);
+            CHECK_EQ(world->queryRectBatch(rects, shapes, counts), 2);
+            CHECK_EQ(counts[0], 2);
+            CHECK_EQ(counts[1], 0);
+            CHECK_NE(shapes[0], nullptr);
+            CHECK_NE(shapes[1], nullptr);
+            CHECK_NE(shapes[0], shapes[1]);
+            CHECK_EQ(shapes[2], nullptr);
+        }
+
+        scene->release();
+    }
+
+    TEST_CASE("query_point_batch") {
+        auto scene = Scene::createWithPhysics();
+        scene->retain();
+        auto world = scene->getPhysicsWorld();
+        auto left  = addBox(scene, Vec2(0.0f, 0.0f), false, 1);
+        addBox(scene, Vec2(15.0f, 0.0f), true, 2);
+
+        // inside the left box only, inside both, outside both but inside the bounding box of the pair
+        std::vector<Vec2> points = {Vec2(-5.0f, 0.0f), Vec2(7.5f, 0.0f), Vec2(7.5f, 15.0f)};
+        std::vector<int> counts(points.size(), -1);
+
+        std::vector<PhysicsShape*> shapes(points.size() * 2);
+        CHECK_EQ(world->queryPointBatch(points, shapes, counts), 3);
+        CHECK_EQ(counts[0], 1);
+        CHECK_EQ(shapes[0], shapeOf(left));
+        CHECK_EQ(counts[1], 2);
+        CHECK_EQ(counts[2], 0);
+
+        std::vector<PhysicsShape*> oneShape(points.size());
+        CHECK_EQ(world->queryPointBatch(points, oneShape, counts, 1), 2);
+        CHECK_EQ(counts[1], 1);
+        CHECK_EQ(oneShape[1], shapeOf(left));
+
+        scene->release();
+    }
+
+    TEST_CASE("parallel_batch") {
+        if (Director::getInstance()->getJobSystem()->getWorkerCount() == 0)
+        {
+            MESSAGE("no JobSystem workers, the batches run on this thread only");
+        }
+
+        auto scene = createGridScene(12, 12);
+        scene->retain();
+        auto world = scene->getPhysicsWorld();
+
+        // more queries than a chunk, crossing the grid in both directions
+        const int count = 200;
+        std::vector<PhysicsRaySegment> rays;
+        std::vector<Rect> rects;
+        std::vector<Vec2> points;
+        for (int i = 0; i < count; ++i)
+        {
+            const float offset = static_cast<float>(i % 100) * 4.4f;
+            if (i < 100)
+                rays.push_back({Vec2(-30.0f, offset), Vec2(470.0f, offset)});
+            else
+                rays.push_back({Vec2(offset, 470.0f), Vec2(offset, -30.0f)});
+            rects.emplace_back(offset, static_cast<float>(i % 7) * 60.0f, 50.0f, 30.0f);
+            points.emplace_back(offset, static_cast<float>(i % 11) * 40.0f + 5.0f);
+        }
+
+        std::vector<PhysicsRayCastInfo> serialHits(count), parallelHits(count);
+        const int hits = world->rayCastBatch(rays, serialHits, -1, false);
+        CHECK(hits > 0);
+        CHECK_EQ(world->rayCastBatch(rays, parallelHits, -1, true), hits);
+        for (int i = 0; i < count; ++i)
+        {
+            CAPTURE(i);
+            CHECK_EQ(parallelHits[i].shape, serialHits[i].shape);
+            CHECK_EQ(parallelHits[i].contact, serialHits[i].contact);
+        }
+
+        std::vector<PhysicsShape*> serialShapes(count * 4), parallelShapes(count * 4);
+        std::vector<int> serialCounts(count), parallelCounts(count);
+        const int found = world->queryRectBatch(rects, serialShapes, serialCounts, 1, false);
+        CHECK(found > 0);
+        CHECK_EQ(world->queryRectBatch(rects, parallelShapes, parallelCounts, 1, true), found);
+        CHECK_EQ(parallelCounts, serialCounts);
+        CHECK_EQ(parallelShapes, serialShapes);
+
+        const int inside = world->queryPointBatch(points, serialShapes, serialCounts, -1, false);
+        CHECK(inside > 0);
+        CHECK_EQ(world->queryPointBatch(points, parallelShapes, parallelCounts, -1, true), inside);
+        CHECK_EQ(parallelCounts, serialCounts);
+        CHECK_EQ(parallelShapes, serialShapes);
+
+        scene->release();
+    }
+}
@@ -0,0 +1,173 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include <doctest.h>
+#include "3d/AABB.h"
+#include "base/Director.h"
+#include "base/JobSystem.h"
+#include "physics3d/Physics3D.h"
+
+#include <vector>
+
+USING_NS_AX;
+
+namespace
+{
+// a 2x2x2 box centered on position
+Physics3DRigidBody* addBox(Physics3DWorld* world, const Vec3& position, float mass)
+{
+    Physics3DRigidBodyDes des;
+    des.mass  = mass;
+    des.shape = Physics3DShape::createBox(Vec3(2.0f, 2.0f, 2.0f));
+    Mat4::createTranslation(position, &des.originalTransform);
+
+    auto body = Physics3DRigidBody::create(&des);
+    world->addPhysics3DObject(body);
+    return body;
+}
+
+Physics3DWorld* createWorld()
+{
+    Physics3DWorldDes des;
+    auto world = Physics3DWorld::create(&des);
+    world->retain();
+    return world;
+}
+}  // namespace
+
+TEST_SUITE("physics3d/Physics3DWorld") {
+    TEST_CASE("ray_cast_batch") {
+        auto world  = createWorld();
+        auto ground = addBox(world, Vec3(0.0f, 0.0f, 0.0f), 0.0f);
+        auto crate  = addBox(world, Vec3(10.0f, 0.0f, 0.0f), 1.0f);
+
+        std::vector<Physics3DWorld::RaySegment> rays = {
+            {Vec3(-5.0f, 0.0f, 0.0f), Vec3(5.0f, 0.0f, 0.0f)},
+            {Vec3(5.0f, 0.0f, 0.0f), Vec3(15.0f, 0.0f, 0.0f)},
+            {Vec3(-5.0f, 5.0f, 0.0f), Vec3(15.0f, 5.0f, 0.0f)},
+            {Vec3(15.0f, 0.0f, 0.0f), Vec3(-5.0f, 0.0f, 0.0f)},
+        };
+        std::vector<Physics3DWorld::HitResult> hits(rays.size());
+
+        CHECK_EQ(world->rayCastBatch(rays, hits), 3);
+
+        CHECK_EQ(hits[0].hitObj, ground);
+        CHECK(hits[0].hitPosition.distance(Vec3(-1.0f, 0.0f, 0.0f)) < 0.1f);
+        CHECK(hits[0].hitNormal.distance(Vec3(-1.0f, 0.0f, 0.0f)) < 0.01f);
+
+        CHECK_EQ(hits[1].hitObj, crate);
+        CHECK(hits[1].hitPosition.distance(Vec3(9.0f, 0.0f, 0.0f)) < 0.1f);
+
+        CHECK_EQ(hits[2].hitObj, nullptr);
+
+        // the closest of the two boxes
+        CHECK_EQ(hits[3].hitObj, crate);
+        CHECK(hits[3].hitNormal.distance(Vec3(1.0f, 0.0f, 0.0f)) < 0.01f);
+
+        world->release();
+    }
+
+    TEST_CASE("query_aabb_batch") {
+        auto world = createWorld();
+        addBox(world, Vec3(0.0f, 0.0f, 0.0f), 0.0f);
+        addBox(world, Vec3(0.5f, 0.0f, 0.0f), 1.0f);
+        addBox(world, Vec3(1.0f, 0.0f, 0.0f), 1.0f);
+
+        std::vector<AABB> boxes = {AABB(Vec3(-0.5f, -0.5f, -0.5f), Vec3(0.5f, 0.5f, 0.5f)),
+                                   AABB(Vec3(20.0f, 20.0f, 20.0f), Vec3(21.0f, 21.0f, 21.0f))};
+        std::vector<int> counts(boxes.size(), -1);
+
+        SUBCASE("all_found") {
+            std::vector<Physics3DObject*> objects(boxes.size() * 4);
+            CHECK_EQ(world->queryAABBBatch(boxes, objects, counts), 3);
+            CHECK_EQ(counts[0], 3);
+            CHECK_EQ(counts[1], 0);
+        }
+
+        SUBCASE("slices_are_truncated") {
+            // two objects per box, the third one found by the first box is dropped
+            std::vector<Physics3DObject*> objects(boxes.size() * 2, nullptr);
+            CHECK_EQ(world->queryAABBBatch(boxes, objects, counts), 2);
+            CHECK_EQ(counts[0], 2);
+            CHECK_EQ(counts[1], 0);
+            CHECK_NE(objects[0], nullptr);
+            CHECK_NE(objects[1], nullptr);
+            CHECK_NE(objects[0], objects[1]);
+            CHECK_EQ(objects[2], nullptr);
+        }
+
+        world->release();
+    }
+
+    TEST_CASE("parallel_batch") {
+        if (Director::getInstance()->getJobSystem()->getWorkerCount() == 0)
+        {
+            MESSAGE("no JobSystem workers, the batches run on this thread only");
+        }
+
+        // a grid of static and dynamic boxes, with a gap between them
+        auto world = createWorld();
+        for (int z = 0; z < 8; ++z)
+            for (int x = 0; x < 8; ++x)
+                addBox(world, Vec3(x * 4.0f, 0.0f, z * 4.0f), (x + z) % 2 == 0 ? 0.0f : 1.0f);
+
+        // more queries than a chunk, crossing the grid in both directions
+        const int count = 200;
+        std::vector<Physics3DWorld::RaySegment> rays;
+        std::vector<AABB> boxes;
+        for (int i = 0; i < count; ++i)
+        {
+            const float offset = static_cast<float>(i % 100) * 0.3f;
+            if (i < 100)
+                rays.push_back({Vec3(-5.0f, 0.0f, offset), Vec3(35.0f, 0.0f, offset)});
+            else
+                rays.push_back({Vec3(offset, 0.0f, 35.0f), Vec3(offset, 0.0f, -5.0f)});
+            const Vec3 center(offset, 0.0f, static_cast<float>(i % 7) * 4.0f);
+            boxes.emplace_back(center - Vec3(2.5f, 1.0f, 1.5f), center + Vec3(2.5f, 1.0f, 1.5f));
+        }
+
+        std::vector<Physics3DWorld::HitResult> serialHits(count), parallelHits(count);
+        const int hits = world->rayCastBatch(rays, serialHits, false);
+        CHECK(hits > 0);
+        CHECK_EQ(world->rayCastBatch(rays, parallelHits, true), hits);
+        for (int i = 0; i < count; ++i)
+        {
+            CAPTURE(i);
+            CHECK_EQ(parallelHits[i].hitObj, serialHits[i].hitObj);
+            if (serialHits[i].hitObj)
+                CHECK_EQ(parallelHits[i].hitPosition, serialHits[i].hitPosition);
+        }
+
+        std::vector<Physics3DObject*> serialObjects(count * 4), parallelObjects(count * 4);
+        std::vector<int> serialCounts(count), parallelCounts(count);
+        const int found = world->queryAABBBatch(boxes, serialObjects, serialCounts, false);
+        CHECK(found > 0);
+        CHECK_EQ(world->queryAABBBatch(boxes, parallelObjects, parallelCounts, true), found);
+        CHECK_EQ(parallelCounts, serialCounts);
+        CHECK_EQ(parallelObjects, serialObjects);
+
+        world->release();
+    }
+}
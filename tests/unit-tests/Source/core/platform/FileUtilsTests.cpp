@@ -229,6 +229,30 @@ TEST_SUITE("platform/FileUtils") {
 
             CHECK(fu->removeFile(file1));
         }
+
+        SUBCASE("getFileView") {
+            REQUIRE(fu->writeStringToFile("Hello!", file1));
+            auto small = fu->getFileView(file1);
+            CHECK(not small.isMapped());
+            CHECK(std::string_view((const char*)small.data(), small.size()) == "Hello!");
+
+            // large files are mapped, copies share the mapping
+            std::string content(256 * 1024, 'x');
+            content.back() = 'y';
+            REQUIRE(fu->writeStringToFile(content, file2));
+            auto large = fu->getFileView(file2);
+            REQUIRE(large.size() == content.size());
+            auto copy = large;
+            large.clear();
+            CHECK(large.isNull());
+            CHECK(copy.data()[0] == 'x');
+            CHECK(copy.data()[content.size() - 1] == 'y');
+            copy.clear();
+
+            CHECK(fu->removeFile(file2));
+            CHECK(fu->getFileView(file2).isNull());
+            CHECK(fu->removeFile(file1));
+        }
     }
 
 
@@ -0,0 +1,98 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "platform/FullPathCache.h"
+
+#include <thread>
+#include <vector>
+
+USING_NS_AX;
+
+
+TEST_SUITE("platform/FullPathCache") {
+    TEST_CASE("find_emplace") {
+        FullPathCache cache;
+        std::string value;
+        CHECK(not cache.find("a.png", value));
+
+        cache.emplace("a.png", "/res/a.png", cache.generation());
+        REQUIRE(cache.find("a.png", value));
+        CHECK(value == "/res/a.png");
+        REQUIRE(cache.find("a.png", value));
+
+        auto stats = cache.getStats();
+        CHECK(stats.lookups == 3);
+        CHECK(stats.sharedHits == 1);
+        CHECK(stats.localHits == 1);
+    }
+
+    TEST_CASE("clear_drops_old_generation") {
+        FullPathCache cache;
+        std::string value;
+        auto generation = cache.generation();
+        cache.emplace("a.png", "/old/a.png", generation);
+        REQUIRE(cache.find("a.png", value));
+
+        cache.clear();
+        CHECK(not cache.find("a.png", value));
+        CHECK(cache.snapshot().empty());
+
+        // resolved before the clear, against the old search paths
+        cache.emplace("a.png", "/old/a.png", generation);
+        CHECK(not cache.find("a.png", value));
+
+        cache.emplace("a.png", "/new/a.png", cache.generation());
+        REQUIRE(cache.find("a.png", value));
+        CHECK(value == "/new/a.png");
+    }
+
+    TEST_CASE("concurrent_lookups") {
+        FullPathCache cache;
+        for (int i = 0; i < 64; ++i)
+            cache.emplace(std::to_string(i), "/res/" + std::to_string(i), cache.generation());
+
+        std::vector<std::thread> threads;
+        std::atomic<int> errors{0};
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&cache, &errors, t] {
+                std::string value;
+                for (int n = 0; n < 1000; ++n)
+                {
+                    auto key = std::to_string((n + t) % 64);
+                    if (!cache.find(key, value) || value != "/res/" + key)
+                        ++errors;
+                    if (t == 0 && n % 100 == 0)
+                        cache.emplace("extra" + std::to_string(n), "/res/extra", cache.generation());
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        CHECK(errors == 0);
+        CHECK(cache.getStats().lookups == 4000);
+    }
+}
@@ -0,0 +1,127 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "platform/FileUtils.h"
+#include "platform/Image.h"
+
+#include <string.h>
+#include <vector>
+
+USING_NS_AX;
+
+namespace
+{
+class TestImage : public Image
+{
+public:
+    using Image::initWithImageFileThreadSafe;
+};
+
+// a PVRv3 RGBA8888 4x4 texture with 3 mipmaps, each level filled with its index + 1
+std::vector<uint8_t> makeMipmappedPVR()
+{
+    const uint32_t header[] = {
+        0x03525650,  // version, 'PVR' 3
+        0,           // flags
+        0x61626772,  // pixel format, low and high words of RGBA8888
+        0x08080808,
+        0,  // color space
+        0,  // channel type
+        4,  // height
+        4,  // width
+        1,  // depth
+        1,  // surfaces
+        1,  // faces
+        3,  // mipmaps
+        0,  // metadata length
+    };
+    // the levels are at least 2x2 blocks
+    const int levelSizes[] = {4 * 4 * 4, 2 * 2 * 4, 2 * 2 * 4};
+
+    std::vector<uint8_t> data(sizeof(header));
+    memcpy(data.data(), header, sizeof(header));
+    for (int level = 0; level < 3; ++level)
+        data.insert(data.end(), levelSizes[level], static_cast<uint8_t>(level + 1));
+    return data;
+}
+
+void checkMipmaps(Image& image)
+{
+    REQUIRE_EQ(image.getNumberOfMipmaps(), 3);
+    const uint8_t* begin = image.getData();
+    const uint8_t* end   = begin + image.getDataLen();
+    for (int level = 0; level < 3; ++level)
+    {
+        auto& mipmap = image.getMipmaps()[level];
+        INFO("level ", level);
+        // the mipmaps must live in the image, not in the buffer or the file it was decoded from
+        CHECK(mipmap.address >= begin);
+        CHECK(mipmap.address + mipmap.len <= end);
+        for (int i = 0; i < mipmap.len; ++i)
+            REQUIRE_EQ(mipmap.address[i], level + 1);
+    }
+}
+}  // namespace
+
+TEST_SUITE("platform/Image") {
+    TEST_CASE("pvr_mipmaps_from_data") {
+        auto data = makeMipmappedPVR();
+
+        Image* image = new Image();
+        REQUIRE(image->initWithImageData(data.data(), static_cast<ssize_t>(data.size())));
+        // the caller's buffer isn't needed once decoded
+        std::fill(data.begin(), data.end(), 0);
+        data.clear();
+        data.shrink_to_fit();
+
+        checkMipmaps(*image);
+        image->release();
+    }
+
+    TEST_CASE("pvr_mipmaps_from_file") {
+        auto fu   = FileUtils::getInstance();
+        auto path = fu->getWritablePath() + "image_mipmaps_test.pvr";
+        auto data = makeMipmappedPVR();
+
+        Data fileData;
+        fileData.copy(data.data(), static_cast<ssize_t>(data.size()));
+        REQUIRE(fu->writeDataToFile(fileData, path));
+
+        Image* image = new Image();
+        REQUIRE(image->initWithImageFile(path));
+        CHECK_EQ(image->getWidth(), 4);
+        CHECK_EQ(image->getHeight(), 4);
+        checkMipmaps(*image);
+        image->release();
+
+        // the thread safe path of the async loads decodes from a file view too
+        auto threadSafeImage = new TestImage();
+        REQUIRE(threadSafeImage->initWithImageFileThreadSafe(path));
+        checkMipmaps(*threadSafeImage);
+        threadSafeImage->release();
+
+        fu->removeFile(path);
+    }
+}
@@ -0,0 +1,113 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "renderer/Renderer.h"
+#include "renderer/TrianglesCommand.h"
+
+#include <memory>
+#include <vector>
+
+USING_NS_AX;
+
+namespace
+{
+// a quad in world space with a given material, without a texture or a program
+class TestQuad : public TrianglesCommand
+{
+public:
+    TestQuad(uint32_t materialID, float x, float y, float size, float z = 0, float globalOrder = 0)
+    {
+        for (int i = 0; i < 4; ++i)
+            _verts[i].vertices = Vec3(x + (i & 1) * size, y + (i >> 1) * size, z);
+        _triangles   = Triangles(_verts, _indices, 4, 6);
+        _materialID  = materialID;
+        _globalOrder = globalOrder;
+    }
+
+private:
+    V3F_C4B_T2F _verts[4];
+    unsigned short _indices[6] = {0, 1, 2, 2, 1, 3};
+};
+
+class TestRenderer : public Renderer
+{
+public:
+    // reorders the commands like drawBatchedTriangles, returns the saved batches
+    size_t reorder(std::vector<TrianglesCommand*>& commands)
+    {
+        _queuedTriangleCommands = commands;
+        _vertexOut              = _verts;
+        _filledVertex           = 0;
+        auto saved              = reorderQueuedTriangles();
+        commands                = _queuedTriangleCommands;
+        _queuedTriangleCommands.clear();
+        return saved;
+    }
+};
+}  // namespace
+
+TEST_SUITE("renderer/BatchReorder") {
+    TEST_CASE("merges_disjoint_commands") {
+        auto renderer = std::make_unique<TestRenderer>();
+        TestQuad a(1, 0, 0, 10), b(2, 100, 0, 10), c(1, 200, 0, 10);
+
+        std::vector<TrianglesCommand*> commands{&a, &b, &c};
+        CHECK_EQ(renderer->reorder(commands), 1);
+        CHECK_EQ(commands, std::vector<TrianglesCommand*>{&a, &c, &b});
+    }
+
+    TEST_CASE("keeps_overlapping_commands_in_order") {
+        auto renderer = std::make_unique<TestRenderer>();
+        // b covers part of c, c can't be drawn before it
+        TestQuad a(1, 0, 0, 10), b(2, 100, 0, 10), c(1, 105, 5, 10);
+
+        std::vector<TrianglesCommand*> commands{&a, &b, &c};
+        CHECK_EQ(renderer->reorder(commands), 0);
+        CHECK_EQ(commands, std::vector<TrianglesCommand*>{&a, &b, &c});
+    }
+
+    TEST_CASE("keeps_other_planes_and_global_orders_in_order") {
+        auto renderer = std::make_unique<TestRenderer>();
+        TestQuad a(1, 0, 0, 10), b(2, 100, 0, 10, 1), c(1, 200, 0, 10, 1);
+        TestQuad d(1, 0, 0, 10), e(2, 100, 0, 10, 0, 1), f(1, 200, 0, 10, 0, 1);
+
+        std::vector<TrianglesCommand*> planes{&a, &b, &c};
+        CHECK_EQ(renderer->reorder(planes), 0);
+        CHECK_EQ(planes, std::vector<TrianglesCommand*>{&a, &b, &c});
+
+        std::vector<TrianglesCommand*> globalOrders{&d, &e, &f};
+        CHECK_EQ(renderer->reorder(globalOrders), 0);
+        CHECK_EQ(globalOrders, std::vector<TrianglesCommand*>{&d, &e, &f});
+    }
+
+    TEST_CASE("merges_past_several_batches") {
+        auto renderer = std::make_unique<TestRenderer>();
+        TestQuad a(1, 0, 0, 10), b(2, 20, 0, 10), c(3, 40, 0, 10), d(2, 60, 0, 10), e(1, 80, 0, 10);
+
+        std::vector<TrianglesCommand*> commands{&a, &b, &c, &d, &e};
+        CHECK_EQ(renderer->reorder(commands), 2);
+        CHECK_EQ(commands, std::vector<TrianglesCommand*>{&a, &e, &b, &d, &c});
+    }
+}
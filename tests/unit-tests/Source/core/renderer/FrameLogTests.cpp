@@ -0,0 +1,188 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "renderer/backend/null/DriverNull.h"
+#include "renderer/backend/Buffer.h"
+#include "renderer/backend/CommandBuffer.h"
+#include "renderer/backend/RenderPassDescriptor.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+USING_NS_AX;
+using namespace ax::backend;
+
+namespace
+{
+// not installed with DriverBase::setInstance, the app keeps its own driver. Destroyed at exit, after the Director
+DriverNull& getDriver()
+{
+    static DriverNull driver;
+    return driver;
+}
+}  // namespace
+
+TEST_SUITE("renderer/FrameLog") {
+    TEST_CASE("records_a_frame") {
+        auto& driver       = getDriver();
+        auto commandBuffer = driver.newCommandBuffer();
+        auto buffer        = driver.newBuffer(64, BufferType::ARRAY_BUFFER, BufferUsage::DYNAMIC);
+        uint8_t data[64]   = {};
+
+        commandBuffer->beginFrame();
+        commandBuffer->beginRenderPass(nullptr, RenderPassDescriptor{});
+        commandBuffer->setViewport(0, 0, 320, 240);
+        buffer->updateData(data, 48);
+        buffer->updateSubData(data, 48, 16);
+        commandBuffer->drawArrays(PrimitiveType::TRIANGLE, 3, 6);
+        commandBuffer->drawElements(PrimitiveType::TRIANGLE, IndexFormat::U_SHORT, 12, 24);
+        commandBuffer->drawElementsInstanced(PrimitiveType::TRIANGLE, IndexFormat::U_SHORT, 6, 0, 4);
+        commandBuffer->endRenderPass();
+
+        // the frame isn't complete yet
+        const auto frameIndex = driver.getCurrentFrameLog().frameIndex;
+        CHECK_EQ(driver.getCurrentFrameLog().getDrawCallCount(), 3);
+
+        commandBuffer->endFrame();
+
+        auto& log = driver.getLastFrameLog();
+        CHECK_EQ(log.frameIndex, frameIndex);
+        CHECK_EQ(log.renderPasses, 1);
+        CHECK_EQ(log.viewportChanges, 1);
+        CHECK_EQ(log.bufferUploads, 2);
+        CHECK_EQ(log.bufferUploadSize, 64);
+        REQUIRE_EQ(log.getDrawCallCount(), 3);
+        CHECK_EQ(log.getElementCount(), 6 + 12 + 6 * 4);
+
+        CHECK_FALSE(log.drawCalls[0].indexed);
+        CHECK_EQ(log.drawCalls[0].start, 3);
+        CHECK_EQ(log.drawCalls[0].count, 6);
+        CHECK(log.drawCalls[1].indexed);
+        CHECK_EQ(log.drawCalls[1].start, 24);
+        CHECK_EQ(log.drawCalls[2].instanceCount, 4);
+
+        buffer->release();
+        commandBuffer->release();
+    }
+
+    TEST_CASE("rolls_over_frames") {
+        auto& driver       = getDriver();
+        auto commandBuffer = driver.newCommandBuffer();
+        auto buffer        = driver.newBuffer(32, BufferType::ARRAY_BUFFER, BufferUsage::STATIC);
+        uint8_t data[32]   = {};
+
+        std::vector<FrameLog> completed;
+        driver.setFrameLogCallback([&completed](const FrameLog& log) { completed.push_back(log); });
+
+        commandBuffer->beginFrame();
+        commandBuffer->drawArrays(PrimitiveType::LINE, 0, 2);
+        commandBuffer->endFrame();
+
+        // an upload between frames is accounted to the next one
+        buffer->updateData(data, 32);
+        CHECK(driver.getCurrentFrameLog().drawCalls.empty());
+        CHECK_EQ(driver.getCurrentFrameLog().bufferUploads, 1);
+
+        commandBuffer->beginFrame();
+        commandBuffer->setScissorRect(true, 0, 0, 10, 10);
+        commandBuffer->endFrame();
+
+        driver.setFrameLogCallback(nullptr);
+
+        REQUIRE_EQ(completed.size(), 2);
+        CHECK_EQ(completed[1].frameIndex, completed[0].frameIndex + 1);
+        CHECK_EQ(completed[0].getDrawCallCount(), 1);
+        CHECK_EQ(completed[0].bufferUploads, 0);
+        CHECK_EQ(completed[1].getDrawCallCount(), 0);
+        CHECK_EQ(completed[1].bufferUploads, 1);
+        CHECK_EQ(completed[1].bufferUploadSize, 32);
+        CHECK_EQ(completed[1].scissorChanges, 1);
+
+        CHECK_EQ(driver.getLastFrameLog().frameIndex, completed[1].frameIndex);
+        CHECK_EQ(driver.getCurrentFrameLog().frameIndex, completed[1].frameIndex + 1);
+        CHECK(driver.getCurrentFrameLog().drawCalls.empty());
+
+        buffer->release();
+        commandBuffer->release();
+    }
+
+    TEST_CASE("streams_through_three_regions") {
+        auto& driver       = getDriver();
+        auto commandBuffer = driver.newCommandBuffer();
+        auto buffer        = driver.newBuffer(16, BufferType::ARRAY_BUFFER, BufferUsage::DYNAMIC);
+        auto staticBuffer  = driver.newBuffer(16, BufferType::ARRAY_BUFFER, BufferUsage::STATIC);
+        CHECK_EQ(staticBuffer->mapStreaming(), nullptr);
+
+        std::vector<FrameLog> completed;
+        driver.setFrameLogCallback([&completed](const FrameLog& log) { completed.push_back(log); });
+
+        constexpr int FRAMES = 8;
+        std::vector<uint8_t*> regions;
+        for (int frame = 0; frame < FRAMES; ++frame)
+        {
+            commandBuffer->beginFrame();
+            auto region = static_cast<uint8_t*>(buffer->mapStreaming());
+            REQUIRE(region);
+            // a frame writes one region however often it maps it
+            CHECK_EQ(buffer->mapStreaming(), region);
+            memset(region, frame + 1, 16);
+            buffer->flushMappedRange(0, 16);
+            commandBuffer->drawArrays(PrimitiveType::TRIANGLE, 0, 3);
+            commandBuffer->endFrame();
+            regions.push_back(region);
+
+            // the two previous frames may still be read by the GPU, their regions are untouched
+            for (int previous = (std::max)(frame - 2, 0); previous < frame; ++previous)
+                CHECK_EQ(regions[previous][0], previous + 1);
+        }
+
+        driver.setFrameLogCallback(nullptr);
+
+        REQUIRE_EQ(completed.size(), FRAMES);
+        for (int frame = 0; frame < FRAMES; ++frame)
+        {
+            CAPTURE(frame);
+            CHECK_EQ(completed[frame].bufferUploads, 1);
+            if (frame < 3)
+            {
+                // the first pass over the ring has no fence to wait on
+                CHECK_EQ(completed[frame].fenceWaits, 0);
+                for (int previous = 0; previous < frame; ++previous)
+                    CHECK_NE(regions[previous], regions[frame]);
+            }
+            else
+            {
+                // wrapped around, the region of three frames ago is reused once its fence was waited on
+                CHECK_EQ(completed[frame].fenceWaits, 1);
+                CHECK_EQ(regions[frame], regions[frame - 3]);
+            }
+        }
+
+        staticBuffer->release();
+        buffer->release();
+        commandBuffer->release();
+    }
+}
@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "renderer/Renderer.h"
+#include "renderer/CustomCommand.h"
+
+#include <random>
+
+USING_NS_AX;
+
+
+static std::vector<RenderCommand*> sortedCommands(const std::vector<float>& globalOrders,
+                                                  std::vector<CustomCommand>& storage)
+{
+    storage.resize(globalOrders.size());
+    RenderQueue queue;
+    for (size_t i = 0; i < globalOrders.size(); ++i)
+    {
+        storage[i].init(globalOrders[i]);
+        queue.emplace_back(&storage[i]);
+    }
+    queue.sort();
+
+    std::vector<RenderCommand*> result;
+    for (ssize_t i = 0; i < queue.size(); ++i)
+        result.push_back(queue[i]);
+    return result;
+}
+
+static std::vector<RenderCommand*> stableSortedCommands(std::vector<CustomCommand>& storage)
+{
+    std::vector<RenderCommand*> expected;
+    for (auto& command : storage)
+        expected.push_back(&command);
+    std::stable_sort(expected.begin(), expected.end(), [](RenderCommand* a, RenderCommand* b) {
+        // the zero queue keeps submit order and sits between the negative and positive queues
+        return a->getGlobalOrder() < b->getGlobalOrder();
+    });
+    return expected;
+}
+
+namespace
+{
+class DepthCommand : public CustomCommand
+{
+public:
+    void initTransparent3D(float depth)
+    {
+        init(0.0f);
+        set3D(true);
+        setTransparent(true);
+        _depth = depth;
+    }
+};
+}  // namespace
+
+TEST_SUITE("renderer/RenderQueue") {
+    TEST_CASE("sort_small") {
+        std::vector<CustomCommand> storage;
+        auto result = sortedCommands({3.f, -1.f, 0.f, 2.f, -5.f, 3.f, 0.f, 1.f}, storage);
+        CHECK_EQ(result, stableSortedCommands(storage));
+    }
+
+    TEST_CASE("sort_large_is_stable") {
+        std::mt19937 rng(2024);
+        std::vector<float> orders(5000);
+        for (auto& order : orders)
+            order = static_cast<float>(static_cast<int>(rng() % 201) - 100) * 0.5f;
+
+        std::vector<CustomCommand> storage;
+        auto result = sortedCommands(orders, storage);
+        CHECK_EQ(result, stableSortedCommands(storage));
+    }
+
+    TEST_CASE("sort_already_ordered") {
+        std::vector<float> orders(1000);
+        for (size_t i = 0; i < orders.size(); ++i)
+            orders[i] = static_cast<float>(i / 10 + 1);
+
+        std::vector<CustomCommand> storage;
+        auto result = sortedCommands(orders, storage);
+        CHECK_EQ(result, stableSortedCommands(storage));
+    }
+
+    TEST_CASE("sort_negative_zero_depth") {
+        // the same order below and above the radix sort threshold
+        for (size_t count : {8, 200})
+        {
+            CAPTURE(count);
+            std::vector<DepthCommand> storage(count);
+            RenderQueue queue;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float depths[] = {0.0f, -0.0f, 1.0f, -0.0f, 0.0f, -2.0f};
+                storage[i].initTransparent3D(depths[i % 6]);
+                queue.emplace_back(&storage[i]);
+            }
+            queue.sort();
+
+            std::vector<RenderCommand*> expected;
+            for (auto& command : storage)
+                expected.push_back(&command);
+            std::stable_sort(expected.begin(), expected.end(),
+                             [](RenderCommand* a, RenderCommand* b) { return a->getDepth() > b->getDepth(); });
+
+            auto& sorted = queue.getSubQueue(RenderQueue::QUEUE_GROUP::TRANSPARENT_3D);
+            CHECK_EQ(sorted, expected);
+        }
+    }
+}
@@ -0,0 +1,196 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include <doctest.h>
+#include "renderer/TextureCache.h"
+#include "renderer/UploadQueue.h"
+#include "base/Director.h"
+#include "base/JobSystem.h"
+#include "base/Scheduler.h"
+#include "platform/FileUtils.h"
+#include "platform/Image.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+USING_NS_AX;
+
+namespace
+{
+// writes count small PNG files, returns their paths
+std::vector<std::string> writeImages(std::string_view prefix, int count)
+{
+    std::vector<std::string> paths;
+    for (int i = 0; i < count; ++i)
+    {
+        uint8_t pixels[8 * 8 * 4];
+        memset(pixels, i * 16, sizeof(pixels));
+
+        Image image;
+        image.initWithRawData(pixels, sizeof(pixels), 8, 8, 8);
+        auto path = fmt::format("{}{}_{}.png", FileUtils::getInstance()->getWritablePath(), prefix, i);
+        REQUIRE(image.saveToFile(path, false));
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+// runs frames until done returns true, false after 5 seconds
+bool runFramesUntil(const std::function<bool()>& done)
+{
+    auto director = Director::getInstance();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done())
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        director->getScheduler()->update(1.0f / 60);
+        director->getUploadQueue()->update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void destroy(TextureCache* cache)
+{
+    cache->waitForQuit();
+    cache->release();
+}
+}  // namespace
+
+TEST_SUITE("renderer/TextureCache") {
+    TEST_CASE("async_callbacks_in_request_order") {
+        auto paths = writeImages("tc_order", 8);
+
+        // a single decoder completes the requests of one priority in request order
+        auto cache = new TextureCache();
+        cache->setAsyncDecodeConcurrency(1);
+
+        std::vector<int> completed;
+        for (int i = 0; i < static_cast<int>(paths.size()); ++i)
+        {
+            cache->addImageAsync(paths[i], [&completed, i](Texture2D* texture) {
+                CHECK(texture);
+                completed.push_back(i);
+            });
+        }
+        REQUIRE(runFramesUntil([&] { return completed.size() == paths.size(); }));
+        CHECK_EQ(completed, std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7});
+
+        // cached by now, the callback runs right away
+        bool cached = false;
+        cache->addImageAsync(paths[3], [&cached](Texture2D* texture) { cached = texture != nullptr; });
+        CHECK(cached);
+
+        destroy(cache);
+    }
+
+    TEST_CASE("async_parallel_decodes") {
+        auto paths = writeImages("tc_parallel", 16);
+
+        auto cache = new TextureCache();
+        cache->setAsyncDecodeConcurrency(4);
+
+        std::vector<Texture2D*> textures(paths.size());
+        size_t completed = 0;
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            cache->addImageAsync(paths[i], [&, i](Texture2D* texture) {
+                textures[i] = texture;
+                ++completed;
+            });
+        }
+        REQUIRE(runFramesUntil([&] { return completed == paths.size(); }));
+        for (size_t i = 0; i < paths.size(); ++i)
+            CHECK_EQ(textures[i], cache->getTextureForKey(paths[i]));
+
+        destroy(cache);
+    }
+
+    TEST_CASE("unbind_cancels_the_request") {
+        auto paths = writeImages("tc_cancel", 4);
+
+        auto cache = new TextureCache();
+        cache->setAsyncDecodeConcurrency(1);
+
+        std::vector<int> completed;
+        cache->addImageAsync(paths[0], [&completed](Texture2D*) { completed.push_back(0); }, "first");
+        cache->addImageAsync(paths[1], [&completed](Texture2D*) { completed.push_back(1); }, "second");
+        cache->addImageAsync(paths[2], [&completed](Texture2D*) { completed.push_back(2); }, "third");
+        cache->unbindImageAsync("second");
+
+        // the last request completes after the cancelled one
+        REQUIRE(runFramesUntil([&] { return !completed.empty() && completed.back() == 2; }));
+        CHECK_EQ(completed, std::vector<int>{0, 2});
+        CHECK(cache->getTextureForKey(paths[0]));
+        CHECK_FALSE(cache->getTextureForKey(paths[1]));
+
+        // unbinding all cancels every request in flight, not the later ones
+        completed.clear();
+        cache->addImageAsync(paths[1], [&completed](Texture2D*) { completed.push_back(1); });
+        cache->unbindAllImageAsync();
+        cache->addImageAsync(paths[3], [&completed](Texture2D*) { completed.push_back(3); });
+        REQUIRE(runFramesUntil([&] { return !completed.empty(); }));
+        CHECK_EQ(completed, std::vector<int>{3});
+        CHECK_FALSE(cache->getTextureForKey(paths[1]));
+
+        destroy(cache);
+    }
+
+    TEST_CASE("async_decode_concurrency") {
+        auto cache = new TextureCache();
+
+        // the default leaves a worker to the other jobs
+        const int workers = Director::getInstance()->getJobSystem()->getWorkerCount();
+        CHECK_EQ(cache->getAsyncDecodeConcurrency(), (std::max)(1, workers - 1));
+
+        cache->setAsyncDecodeConcurrency(3);
+        CHECK_EQ(cache->getAsyncDecodeConcurrency(), 3);
+
+        // read from another thread while it changes
+        std::atomic<bool> stop{false};
+        std::atomic<bool> unexpected{false};
+        std::thread reader([&] {
+            while (!stop.load())
+            {
+                const int concurrency = cache->getAsyncDecodeConcurrency();
+                if (concurrency != 2 && concurrency != 3)
+                    unexpected = true;
+            }
+        });
+        for (int i = 0; i < 1000; ++i)
+            cache->setAsyncDecodeConcurrency(2 + i % 2);
+        stop = true;
+        reader.join();
+        CHECK_FALSE(unexpected.load());
+
+        cache->setAsyncDecodeConcurrency(0);
+        CHECK_EQ(cache->getAsyncDecodeConcurrency(), (std::max)(1, workers - 1));
+
+        destroy(cache);
+    }
+}
@@ -0,0 +1,99 @@
+/****************************************************************************
+ Copyright (c) 2019-present Axmol Engine contributors (see AUTHORS.md).
+
+ https://axmol.dev/
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <doctest.h>
+#include "renderer/UploadQueue.h"
+
+#include <vector>
+
+USING_NS_AX;
+
+
+TEST_SUITE("renderer/UploadQueue") {
+    TEST_CASE("byte_budget") {
+        UploadQueue queue;
+        queue.setBudget(0, 100);
+
+        std::vector<int> ran;
+        for (int i = 0; i < 5; ++i)
+            queue.enqueue(&queue, 60, [&ran, i] { ran.push_back(i); });
+        CHECK_EQ(queue.getQueueDepth(), 5);
+        CHECK_EQ(queue.getPendingBytes(), 300);
+
+        queue.update();
+        CHECK_EQ(ran, std::vector<int>{0, 1});
+        CHECK_EQ(queue.getUploadedBytes(), 120);
+        CHECK_EQ(queue.getPendingBytes(), 180);
+
+        queue.update();
+        queue.update();
+        CHECK_EQ(ran, std::vector<int>{0, 1, 2, 3, 4});
+        CHECK_EQ(queue.getQueueDepth(), 0);
+        CHECK_EQ(queue.getPendingBytes(), 0);
+    }
+
+    TEST_CASE("at_least_one_per_frame") {
+        UploadQueue queue;
+        queue.setBudget(0, 10);
+
+        int ran = 0;
+        queue.enqueue(&queue, 1000, [&ran] { ++ran; });
+        queue.enqueue(&queue, 1000, [&ran] { ++ran; });
+        queue.update();
+        CHECK_EQ(ran, 1);
+    }
+
+    TEST_CASE("frame_uploads_ignore_budget") {
+        UploadQueue queue;
+        queue.setBudget(0, 10);
+
+        int ran = 0;
+        for (int i = 0; i < 3; ++i)
+            queue.enqueueForFrame(&queue, 1000, [&ran] { ++ran; });
+        queue.updateFrame();
+        CHECK_EQ(ran, 3);
+
+        queue.update();
+        CHECK_EQ(queue.getUploadedBytes(), 3000);
+    }
+
+    TEST_CASE("cancel_and_flush") {
+        UploadQueue queue;
+        int a = 0, b = 0;
+        std::vector<int> ran;
+        queue.enqueue(&a, 10, [&ran] { ran.push_back(1); });
+        queue.enqueue(&b, 20, [&ran] { ran.push_back(2); });
+        queue.enqueueForFrame(&a, 30, [&ran] { ran.push_back(3); });
+        queue.enqueue(&b, 40, [&ran] { ran.push_back(4); });
+
+        queue.cancel(&a);
+        CHECK_EQ(queue.getQueueDepth(), 2);
+        CHECK_EQ(queue.getPendingBytes(), 60);
+
+        queue.flush(&b);
+        CHECK_EQ(ran, std::vector<int>{2, 4});
+        CHECK_EQ(queue.getQueueDepth(), 0);
+        CHECK_EQ(queue.getPendingBytes(), 0);
+    }
+}